@@ -0,0 +1,129 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "renderer/engine_bvh.hpp"
+#include "renderer/engine_camera.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 OBJECT_COUNT = 100'000;
+constexpr u32 POINT_COUNT = 10'000;
+
+// Boxes of 0.5 to 2 units on a jittered grid, about the layout of the instance grid the app spawns
+std::vector<Aabb> makeScene() {
+	std::mt19937 random{42};
+	std::uniform_real_distribution jitter{-1.f, 1.f};
+	std::uniform_real_distribution size{.5f, 2.f};
+	std::vector<Aabb> boxes(OBJECT_COUNT);
+	constexpr u32 SIDE = 317;
+	for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+		const glm::vec3 center{static_cast<float>(i % SIDE) * 4.f + jitter(random), jitter(random),
+		                       static_cast<float>(i / SIDE) * 4.f + jitter(random)};
+		const glm::vec3 extent = glm::vec3{size(random), size(random), size(random)} * 0.5f;
+		boxes[i] = {.min = center - extent, .max = center + extent};
+	}
+	return boxes;
+}
+
+// Points spread over the box around the scene
+std::vector<glm::vec3> makePoints(const std::vector<Aabb>& boxes) {
+	Aabb bounds{};
+	for (const Aabb& box : boxes) {
+		bounds.grow(box);
+	}
+	std::mt19937 random{7};
+	std::uniform_real_distribution unit{0.f, 1.f};
+	std::vector<glm::vec3> points(POINT_COUNT);
+	for (glm::vec3& point : points) {
+		point = glm::mix(bounds.min, bounds.max, glm::vec3{unit(random), unit(random), unit(random)});
+	}
+	return points;
+}
+
+void BM_BvhBuild(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	VkEngineBvh bvh;
+	for (auto _ : state) {
+		bvh.build(boxes);
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	state.counters["nodes"] = bvh.getNodeCount();
+}
+BENCHMARK(BM_BvhBuild)->Unit(benchmark::kMillisecond);
+
+void BM_BvhRefitAll(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	VkEngineBvh bvh;
+	bvh.build(boxes);
+	for (auto _ : state) {
+		bvh.refit(boxes);
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+}
+BENCHMARK(BM_BvhRefitAll)->Unit(benchmark::kMicrosecond);
+
+// A camera above the scene looking across it, items are frustum queries
+void BM_BvhQueryFrustum(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	VkEngineBvh bvh;
+	bvh.build(boxes);
+	VkEngineCamera camera{};
+	camera.setViewTarget({-20.f, 30.f, -20.f}, {600.f, 0.f, 600.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+	const FrustumPlanesSoA planes = toPlanesSoA(camera.extractFrustumPlanes());
+
+	std::vector<u32> objects;
+	for (auto _ : state) {
+		objects.clear();
+		bvh.queryFrustum(planes, objects);
+		benchmark::DoNotOptimize(objects.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.counters["visible"] = static_cast<double>(objects.size());
+}
+BENCHMARK(BM_BvhQueryFrustum)->Unit(benchmark::kMicrosecond);
+
+// Rays from each point to the next, items are rays
+void BM_BvhRaycast(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	VkEngineBvh bvh;
+	bvh.build(boxes);
+	const std::vector<glm::vec3> points = makePoints(boxes);
+	std::vector<Ray> rays(POINT_COUNT);
+	for (u32 i = 0; i < POINT_COUNT; ++i) {
+		rays[i] = {.origin = points[i], .direction = glm::normalize(points[(i + 1) % POINT_COUNT] - points[i])};
+	}
+
+	for (auto _ : state) {
+		float distance = 0.f;
+		for (const Ray& ray : rays) {
+			benchmark::DoNotOptimize(bvh.raycast(ray, distance));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_BvhRaycast)->Unit(benchmark::kMillisecond);
+
+void BM_BvhQueryNearest(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	VkEngineBvh bvh;
+	bvh.build(boxes);
+	const std::vector<glm::vec3> points = makePoints(boxes);
+
+	for (auto _ : state) {
+		float distance = 0.f;
+		for (const glm::vec3& point : points) {
+			benchmark::DoNotOptimize(bvh.queryNearest(point, distance));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_BvhQueryNearest)->Unit(benchmark::kMillisecond);
+}  // namespace
+}  // namespace vke
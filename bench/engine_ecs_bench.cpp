@@ -0,0 +1,179 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/engine_ecs.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 ENTITY_COUNT = 1'000'000;
+// Renderable entities spawned and despawned by the churn cases
+constexpr u32 CHURN_ENTITY_COUNT = 100'000;
+
+// Only used to move half the entities to another archetype and back
+struct BenchmarkTagComponent {
+	u32 value = 0;
+};
+
+std::vector<Entity> populate(VkEngineWorld& world) {
+	std::vector<Entity> entities;
+	entities.reserve(ENTITY_COUNT);
+	for (u32 i = 0; i < ENTITY_COUNT; ++i) {
+		TransformComponent transform{};
+		transform.setTranslation({static_cast<float>(i), 0.f, 0.f});
+		entities.push_back(world.createEntity(transform, WorldMatrixComponent{}));
+	}
+	return entities;
+}
+
+void BM_EcsCreate(benchmark::State& state) {
+	for (auto _ : state) {
+		VkEngineWorld world;
+		benchmark::DoNotOptimize(populate(world).data());
+		state.PauseTiming();
+		// The world is destroyed out of the measured time
+		world.clear();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsCreate)->Unit(benchmark::kMillisecond);
+
+void BM_EcsWriteOneColumn(benchmark::State& state) {
+	VkEngineWorld world;
+	populate(world);
+	for (auto _ : state) {
+		world.forEachChunk<TransformComponent>([](const u32 count, const Entity*, TransformComponent* transforms) {
+			for (u32 i = 0; i < count; ++i) {
+				transforms[i].setTranslation(transforms[i].getTranslation() + glm::vec3{0.f, 1.f, 0.f});
+			}
+		});
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsWriteOneColumn)->Unit(benchmark::kMillisecond);
+
+void BM_EcsReadTwoColumns(benchmark::State& state) {
+	VkEngineWorld world;
+	populate(world);
+	for (auto _ : state) {
+		world.forEachChunk<TransformComponent, WorldMatrixComponent>(
+		    [](const u32 count, const Entity*, const TransformComponent* transforms, WorldMatrixComponent* matrices) {
+			    for (u32 i = 0; i < count; ++i) {
+				    matrices[i].matrix[3] = glm::vec4(transforms[i].getTranslation(), 1.f);
+			    }
+		    });
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsReadTwoColumns)->Unit(benchmark::kMillisecond);
+
+// Half the entities moved to another archetype and back, items are the structural changes
+void BM_EcsAddRemove(benchmark::State& state) {
+	VkEngineWorld world;
+	const std::vector<Entity> entities = populate(world);
+	for (auto _ : state) {
+		for (u32 i = 0; i < ENTITY_COUNT; i += 2) {
+			world.addComponent(entities[i], BenchmarkTagComponent{i});
+		}
+		for (u32 i = 0; i < ENTITY_COUNT; i += 2) {
+			world.removeComponent<BenchmarkTagComponent>(entities[i]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsAddRemove)->Unit(benchmark::kMillisecond);
+
+void BM_EcsDestroy(benchmark::State& state) {
+	VkEngineWorld world;
+	for (auto _ : state) {
+		state.PauseTiming();
+		const std::vector<Entity> entities = populate(world);
+		state.ResumeTiming();
+		for (const Entity entity : entities) {
+			world.destroyEntity(entity);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsDestroy)->Unit(benchmark::kMillisecond);
+
+// Spawns renderable entities into a fresh world, one call per entity or one batch. range(0) is non zero for the batch.
+void BM_EcsSpawnRenderables(benchmark::State& state) {
+	const bool batched = state.range(0) != 0;
+	const RenderComponent render{};
+	std::vector<Entity> entities;
+	entities.reserve(CHURN_ENTITY_COUNT);
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto world = std::make_unique<VkEngineWorld>();
+		entities.clear();
+		state.ResumeTiming();
+		if (batched) {
+			world->createEntities(CHURN_ENTITY_COUNT, entities, TransformComponent{}, WorldMatrixComponent{}, render);
+		} else {
+			for (u32 i = 0; i < CHURN_ENTITY_COUNT; ++i) {
+				entities.push_back(world->createEntity(TransformComponent{}, WorldMatrixComponent{}, render));
+			}
+		}
+		state.PauseTiming();
+		world.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * CHURN_ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsSpawnRenderables)->ArgName("batched")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Despawns every renderable entity in random order, one call per entity or one batch. range(0) is non zero for the
+// batch.
+void BM_EcsDespawnRenderables(benchmark::State& state) {
+	const bool batched = state.range(0) != 0;
+	VkEngineWorld world;
+	std::mt19937 random{42};
+	std::vector<Entity> entities;
+	for (auto _ : state) {
+		state.PauseTiming();
+		entities.clear();
+		world.createEntities(CHURN_ENTITY_COUNT, entities, TransformComponent{}, WorldMatrixComponent{},
+		                     RenderComponent{});
+		std::ranges::shuffle(entities, random);
+		state.ResumeTiming();
+		if (batched) {
+			world.destroyEntities(entities);
+		} else {
+			for (const Entity entity : entities) {
+				world.destroyEntity(entity);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * CHURN_ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsDespawnRenderables)->ArgName("batched")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Spawns a batch into the slots and chunks a despawn left behind, the steady state of a scene respawning its objects
+void BM_EcsRespawnFromPools(benchmark::State& state) {
+	VkEngineWorld world;
+	std::vector<Entity> entities;
+	world.createEntities(CHURN_ENTITY_COUNT, entities, TransformComponent{}, WorldMatrixComponent{}, RenderComponent{});
+	for (auto _ : state) {
+		state.PauseTiming();
+		world.destroyEntities(entities);
+		entities.clear();
+		state.ResumeTiming();
+		world.createEntities(CHURN_ENTITY_COUNT, entities, TransformComponent{}, WorldMatrixComponent{},
+		                     RenderComponent{});
+	}
+	state.SetItemsProcessed(state.iterations() * CHURN_ENTITY_COUNT);
+}
+BENCHMARK(BM_EcsRespawnFromPools)->Unit(benchmark::kMillisecond);
+}  // namespace
+}  // namespace vke
@@ -0,0 +1,88 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_frustum_culling.hpp"
+#include "renderer/engine_spatial.hpp"
+
+namespace vke {
+namespace {
+FrustumPlanesSoA makePlanes() {
+	VkEngineCamera camera{};
+	camera.setViewTarget({0.f, 0.f, -40.f}, {0.f, 0.f, 0.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), 16.f / 9.f, 0.1f, 200.f);
+	return toPlanesSoA(camera.extractFrustumPlanes());
+}
+
+// Spheres scattered in a cube the camera sees about half of
+BoundingSpheresSoA makeSpheres(const u32 count) {
+	std::mt19937 random{7};
+	std::uniform_real_distribution position{-60.f, 60.f};
+	std::uniform_real_distribution radius{0.1f, 2.f};
+
+	BoundingSpheresSoA spheres{};
+	spheres.resize(count);
+	for (u32 i = 0; i < count; ++i) {
+		spheres.centerX[i] = position(random);
+		spheres.centerY[i] = position(random);
+		spheres.centerZ[i] = position(random);
+		spheres.radius[i] = radius(random);
+	}
+	return spheres;
+}
+
+// Single threaded kernel throughput, range(0) is the CullingKernel and range(1) the sphere count
+void BM_CullSpheres(benchmark::State& state) {
+	const auto kernel = static_cast<CullingKernel>(state.range(0));
+	if (!isCullingKernelSupported(kernel)) {
+		state.SkipWithError("Kernel not supported by this build or CPU");
+		return;
+	}
+	const auto count = static_cast<u32>(state.range(1));
+	const FrustumPlanesSoA planes = makePlanes();
+	const BoundingSpheresSoA spheres = makeSpheres(count);
+	std::vector<u32> visible(count);
+
+	u32 visibleCount = 0;
+	for (auto _ : state) {
+		visibleCount = cullSpheres(kernel, planes, spheres, 0, count, visible.data());
+		benchmark::DoNotOptimize(visible.data());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["visible"] = visibleCount;
+}
+BENCHMARK(BM_CullSpheres)
+    ->ArgNames({"kernel", "spheres"})
+    ->ArgsProduct({{static_cast<i64>(CullingKernel::Scalar), static_cast<i64>(CullingKernel::Sse2),
+                    static_cast<i64>(CullingKernel::Avx2)},
+                   {1'003, 100'000, 1'000'000}});
+
+// VkEngineFrustumCuller scaling, range(0) is the thread count including the caller and range(1) the sphere count
+void BM_FrustumCuller(benchmark::State& state) {
+	const auto threadCount = static_cast<u32>(state.range(0));
+	const auto count = static_cast<u32>(state.range(1));
+	ThreadPool threadPool(threadCount - 1);
+	VkEngineFrustumCuller culler(threadPool);
+	const FrustumPlanesSoA planes = makePlanes();
+	const BoundingSpheresSoA spheres = makeSpheres(count);
+	std::vector<u32> visible;
+
+	for (auto _ : state) {
+		culler.cull(planes, spheres, visible);
+		benchmark::DoNotOptimize(visible.data());
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FrustumCuller)
+    ->ArgNames({"threads", "spheres"})
+    ->ArgsProduct({{1, 2, 4, 8}, {1'000'000}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace
+}  // namespace vke
@@ -0,0 +1,104 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_occlusion_culling.hpp"
+
+namespace vke {
+namespace {
+glm::mat4 makeViewProjection() {
+	VkEngineCamera camera{};
+	camera.setViewDirection({0.f, 0.f, 0.f}, {0.f, 0.f, 1.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), 2.f, 0.1f, 200.f);
+	return camera.getProjectionMatrix() * camera.getViewMatrix();
+}
+
+// Unit quads of random size spread in front of the camera, the kind of large walls occluders are picked for
+struct OccluderScene {
+	std::vector<glm::vec3> positions{{-.5f, -.5f, 0.f}, {.5f, -.5f, 0.f}, {.5f, .5f, 0.f}, {-.5f, .5f, 0.f}};
+	std::vector<u32> indices{0, 1, 2, 2, 3, 0};
+	std::vector<glm::mat4> worlds{};
+
+	explicit OccluderScene(const u32 count) {
+		std::mt19937 random{11};
+		std::uniform_real_distribution position{-20.f, 20.f};
+		std::uniform_real_distribution depth{10.f, 60.f};
+		std::uniform_real_distribution size{1.f, 8.f};
+		worlds.reserve(count);
+		for (u32 i = 0; i < count; ++i) {
+			const glm::mat4 translation =
+			    glm::translate(glm::mat4{1.f}, {position(random), position(random) * .5f, depth(random)});
+			worlds.push_back(glm::scale(translation, {size(random), size(random), 1.f}));
+		}
+	}
+};
+
+// range(0) occluder quads, two triangles each
+void BM_OcclusionRasterize(benchmark::State& state) {
+	const auto quadCount = static_cast<u32>(state.range(0));
+	const OccluderScene scene(quadCount);
+	ThreadPool threadPool(0);
+	VkEngineOcclusionCuller culler(threadPool);
+	const glm::mat4 viewProjection = makeViewProjection();
+
+	for (auto _ : state) {
+		culler.beginFrame(viewProjection);
+		for (const glm::mat4& world : scene.worlds) {
+			culler.addOccluder(scene.positions, scene.indices, world);
+		}
+		culler.rasterize();
+		benchmark::DoNotOptimize(culler.getDepthBuffer().data());
+	}
+	state.SetItemsProcessed(state.iterations() * culler.getStats().occluderTriangles);
+	state.counters["triangles"] = culler.getStats().occluderTriangles;
+}
+BENCHMARK(BM_OcclusionRasterize)->ArgName("quads")->Arg(64)->Arg(512)->Arg(4096);
+
+// range(0) objects tested against the depth buffer of 512 occluder quads
+void BM_OcclusionTest(benchmark::State& state) {
+	const auto count = static_cast<u32>(state.range(0));
+	const OccluderScene scene(512);
+	ThreadPool threadPool(0);
+	VkEngineOcclusionCuller culler(threadPool);
+	culler.beginFrame(makeViewProjection());
+	for (const glm::mat4& world : scene.worlds) {
+		culler.addOccluder(scene.positions, scene.indices, world);
+	}
+	culler.rasterize();
+
+	std::mt19937 random{5};
+	std::uniform_real_distribution position{-40.f, 40.f};
+	std::uniform_real_distribution depth{15.f, 120.f};
+	std::uniform_real_distribution radius{.2f, 2.f};
+	BoundingSpheresSoA spheres{};
+	spheres.resize(count);
+	for (u32 i = 0; i < count; ++i) {
+		spheres.centerX[i] = position(random);
+		spheres.centerY[i] = position(random) * .5f;
+		spheres.centerZ[i] = depth(random);
+		spheres.radius[i] = radius(random);
+	}
+
+	std::vector<u32> visible;
+	for (auto _ : state) {
+		state.PauseTiming();
+		visible.resize(count);
+		for (u32 i = 0; i < count; ++i) {
+			visible[i] = i;
+		}
+		state.ResumeTiming();
+		culler.cull(spheres, visible);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["occluded"] = culler.getStats().occludedObjects;
+}
+BENCHMARK(BM_OcclusionTest)->ArgName("objects")->Arg(10'000)->Arg(100'000);
+}  // namespace
+}  // namespace vke
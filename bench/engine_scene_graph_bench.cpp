@@ -0,0 +1,80 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "core/engine_transform_system.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 NODE_COUNT = 100'000;
+
+enum class Shape : int {
+	// Chained one below the other
+	Deep,
+	// All children of one root
+	Wide,
+};
+
+enum class Change : int {
+	All,
+	RootMoved,
+	LeafMoved,
+	Still,
+};
+
+// The transform system on a hierarchy of 100k nodes, one thread. range(0) is the Shape, range(1) what changes
+// between the updates.
+void BM_SceneGraphUpdate(benchmark::State& state) {
+	const auto shape = static_cast<Shape>(state.range(0));
+	const auto change = static_cast<Change>(state.range(1));
+
+	ThreadPool threadPool(0);
+	VkEngineWorld world;
+	VkEngineTransformSystem transformSystem(threadPool);
+	std::vector<Entity> nodes;
+	nodes.reserve(NODE_COUNT);
+	for (u32 i = 0; i < NODE_COUNT; ++i) {
+		TransformComponent transform{};
+		transform.setTranslation({0.f, 0.01f, 0.f});
+		transform.setRotation(eulerToQuat({0.f, glm::radians(0.1f), 0.f}));
+		nodes.push_back(world.createEntity(transform, WorldMatrixComponent{}));
+	}
+	for (u32 i = 1; i < NODE_COUNT; ++i) {
+		transformSystem.getSceneGraph().setParent(world, nodes[i], shape == Shape::Deep ? nodes[i - 1] : nodes[0]);
+	}
+	transformSystem.update(world);
+	state.counters["layoutMs"] = transformSystem.getSceneGraph().getStats().layoutMs;
+
+	TransformComponent& root = *world.getComponent<TransformComponent>(nodes.front());
+	TransformComponent& leaf = *world.getComponent<TransformComponent>(nodes.back());
+	for (auto _ : state) {
+		switch (change) {
+			case Change::All:
+				transformSystem.invalidate();
+				break;
+			case Change::RootMoved:
+				root.setTranslation(root.getTranslation());
+				break;
+			case Change::LeafMoved:
+				leaf.setTranslation(leaf.getTranslation());
+				break;
+			case Change::Still:
+				break;
+		}
+		transformSystem.update(world);
+	}
+	state.SetItemsProcessed(state.iterations() * NODE_COUNT);
+	state.counters["updated"] = transformSystem.getSceneGraph().getStats().updatedNodes;
+}
+BENCHMARK(BM_SceneGraphUpdate)
+    ->ArgNames({"wide", "change"})
+    ->ArgsProduct({{static_cast<int>(Shape::Deep), static_cast<int>(Shape::Wide)},
+                   {static_cast<int>(Change::All), static_cast<int>(Change::RootMoved),
+                    static_cast<int>(Change::LeafMoved), static_cast<int>(Change::Still)}})
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace
+}  // namespace vke
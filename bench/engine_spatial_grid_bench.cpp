@@ -0,0 +1,171 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "renderer/engine_bvh.hpp"
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_spatial_grid.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 OBJECT_COUNT = 100'000;
+// Work of each simulated frame on top of keeping the index up to date
+constexpr u32 FRAME_FRUSTUMS = 4;
+constexpr u32 FRAME_RAYS = 1000;
+// Moved objects placed in the grid by a single worker at once
+constexpr u32 UPDATE_GRAIN = 1024;
+// Same as VkEngineSpatialSystem::REBUILD_COST_RATIO
+constexpr float REBUILD_COST_RATIO = 1.3f;
+
+enum class IndexType : int {
+	Bvh,
+	Grid,
+};
+
+// Boxes of 0.5 to 2 units on a jittered grid, about the layout of the instance grid the app spawns
+std::vector<Aabb> makeScene() {
+	std::mt19937 random{42};
+	std::uniform_real_distribution jitter{-1.f, 1.f};
+	std::uniform_real_distribution size{.5f, 2.f};
+	std::vector<Aabb> boxes(OBJECT_COUNT);
+	constexpr u32 SIDE = 317;
+	for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+		const glm::vec3 center{static_cast<float>(i % SIDE) * 4.f + jitter(random), jitter(random),
+		                       static_cast<float>(i / SIDE) * 4.f + jitter(random)};
+		const glm::vec3 extent = glm::vec3{size(random), size(random), size(random)} * 0.5f;
+		boxes[i] = {.min = center - extent, .max = center + extent};
+	}
+	return boxes;
+}
+
+// Per frame cost of keeping each index up to date and querying it while a share of the boxes drifts, one thread.
+// range(0) is the IndexType, range(1) the percentage of the objects moved every frame. The BVH pays for its rebuilds
+// when they are due, synchronously here. Only the index work is timed.
+void BM_SpatialIndexFrame(benchmark::State& state) {
+	const auto type = static_cast<IndexType>(state.range(0));
+	const auto movedCount = static_cast<u32>(state.range(1) * OBJECT_COUNT / 100);
+
+	std::vector<Aabb> boxes = makeScene();
+	Aabb bounds{};
+	for (const Aabb& box : boxes) {
+		bounds.grow(box);
+	}
+	std::mt19937 random{7};
+	std::uniform_real_distribution unit{0.f, 1.f};
+	std::vector<Ray> rays(FRAME_RAYS);
+	for (Ray& ray : rays) {
+		ray.origin = glm::mix(bounds.min, bounds.max, glm::vec3{unit(random), unit(random), unit(random)});
+		ray.direction = glm::normalize(glm::vec3{unit(random), unit(random), unit(random)} - 0.5f);
+	}
+	VkEngineCamera camera{};
+	camera.setViewTarget({-20.f, 30.f, -20.f}, {600.f, 0.f, 600.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+	const FrustumPlanesSoA planes = toPlanesSoA(camera.extractFrustumPlanes());
+
+	ThreadPool threadPool(0);
+	VkEngineBvh bvh;
+	VkEngineSpatialGrid grid;
+	float buildCost = 0.f;
+	if (type == IndexType::Bvh) {
+		bvh.build(boxes);
+		buildCost = bvh.computeCost();
+	} else {
+		grid.reset(OBJECT_COUNT);
+		grid.beginUpdate();
+		for (u32 object = 0; object < OBJECT_COUNT; ++object) {
+			grid.update(object, boxes[object]);
+		}
+	}
+
+	std::vector<u32> objects;
+	const auto query = [&](const auto& index) {
+		for (u32 i = 0; i < FRAME_FRUSTUMS; ++i) {
+			objects.clear();
+			index.queryFrustum(planes, objects);
+		}
+		float distance = 0.f;
+		for (const Ray& ray : rays) {
+			benchmark::DoNotOptimize(index.raycast(ray, distance));
+		}
+	};
+
+	std::uniform_real_distribution offset{-1.f, 1.f};
+	std::vector<u32> moved;
+	u32 frame = 0;
+	u32 rebuilds = 0;
+	for (auto _ : state) {
+		state.PauseTiming();
+		// Distinct objects within a frame, the grid may only update an object from one worker at once
+		moved.clear();
+		for (u32 i = 0; i < movedCount; ++i) {
+			const u32 object = (frame * movedCount + i) % OBJECT_COUNT;
+			const glm::vec3 delta{offset(random), 0.f, offset(random)};
+			boxes[object] = {.min = boxes[object].min + delta, .max = boxes[object].max + delta};
+			moved.push_back(object);
+		}
+		++frame;
+		state.ResumeTiming();
+
+		if (type == IndexType::Bvh) {
+			bvh.refit(boxes, moved);
+			if (bvh.computeCost() > REBUILD_COST_RATIO * buildCost) {
+				bvh.build(boxes);
+				buildCost = bvh.computeCost();
+				++rebuilds;
+			}
+			query(bvh);
+		} else {
+			grid.beginUpdate();
+			threadPool.parallelFor(movedCount, UPDATE_GRAIN,
+			                       [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+				                       for (u32 i = begin; i < end; ++i) {
+					                       grid.update(moved[i], boxes[moved[i]]);
+				                       }
+			                       });
+			query(grid);
+		}
+	}
+	state.counters["rebuilds"] = rebuilds;
+}
+BENCHMARK(BM_SpatialIndexFrame)
+    ->ArgNames({"grid", "moved%"})
+    ->ArgsProduct({{static_cast<int>(IndexType::Bvh), static_cast<int>(IndexType::Grid)}, {1, 5, 25, 50, 100}})
+    ->Unit(benchmark::kMillisecond);
+
+// Moves every object back and forth between two layouts up to 2 units apart, often across cells, items are updates
+void BM_GridUpdate(benchmark::State& state) {
+	const std::vector<Aabb> boxes = makeScene();
+	std::vector<Aabb> movedBoxes = boxes;
+	std::mt19937 random{3};
+	std::uniform_real_distribution offset{-2.f, 2.f};
+	for (Aabb& box : movedBoxes) {
+		const glm::vec3 delta{offset(random), 0.f, offset(random)};
+		box = {.min = box.min + delta, .max = box.max + delta};
+	}
+
+	VkEngineSpatialGrid grid;
+	grid.reset(OBJECT_COUNT);
+	grid.beginUpdate();
+	for (u32 object = 0; object < OBJECT_COUNT; ++object) {
+		grid.update(object, boxes[object]);
+	}
+
+	u32 frame = 0;
+	for (auto _ : state) {
+		const std::vector<Aabb>& layout = ++frame % 2 == 0 ? boxes : movedBoxes;
+		grid.beginUpdate();
+		for (u32 object = 0; object < OBJECT_COUNT; ++object) {
+			grid.update(object, layout[object]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+}
+BENCHMARK(BM_GridUpdate)->Unit(benchmark::kMillisecond);
+}  // namespace
+}  // namespace vke
@@ -0,0 +1,139 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/engine_ecs.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace {
+constexpr u32 TRANSFORM_COUNT = 1'000'000;
+constexpr u32 TRANSFORM_GRAIN = 1024;
+
+// Same split as VkEngineRenderSystem::renderGameObjectsParallel
+constexpr u32 MIN_DRAWS_PER_SECONDARY = 256;
+
+struct DrawPacket {
+	u32 pipeline = 0;
+	u32 mesh = 0;
+	u32 object = 0;
+};
+
+// What a recorded vkCmdPushConstants + vkCmdDrawIndexed pair costs the driver: the push constant block copied into
+// the command stream with a small header
+struct DrawRecord {
+	u32 opcode = 0;
+	u32 indexCount = 0;
+	std::array<float, 32> pushConstants{};
+};
+
+// Stand-in for recording secondary command buffers without a device. range(0) is the thread count including the
+// caller, range(1) the draw count. Each slot appends to its own stream like a secondary with its own command pool.
+void BM_RecordDrawsParallel(benchmark::State& state) {
+	const auto threadCount = static_cast<u32>(state.range(0));
+	const auto drawCount = static_cast<u32>(state.range(1));
+	ThreadPool threadPool(threadCount - 1);
+
+	std::mt19937 random{3};
+	std::vector<DrawPacket> packets(drawCount);
+	for (u32 i = 0; i < drawCount; ++i) {
+		packets[i] = {.pipeline = static_cast<u32>(random() % 2), .mesh = static_cast<u32>(random() % 64), .object = i};
+	}
+	std::ranges::sort(packets, [](const DrawPacket& a, const DrawPacket& b) {
+		return a.pipeline != b.pipeline ? a.pipeline < b.pipeline : a.mesh < b.mesh;
+	});
+	std::vector<std::array<float, 32>> objectData(drawCount);
+	for (u32 i = 0; i < drawCount; ++i) {
+		objectData[i].fill(static_cast<float>(i));
+	}
+
+	const u32 maxSlots = std::max(1u, drawCount / MIN_DRAWS_PER_SECONDARY);
+	const u32 slotCount = std::min(threadPool.getThreadCount(), maxSlots);
+	const u32 drawsPerSlot = (drawCount + slotCount - 1) / slotCount;
+	std::vector<std::vector<DrawRecord>> streams(slotCount);
+	for (auto& stream : streams) {
+		stream.reserve(2 * drawsPerSlot);
+	}
+
+	for (auto _ : state) {
+		threadPool.parallelFor(drawCount, drawsPerSlot, [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+			std::vector<DrawRecord>& stream = streams[begin / drawsPerSlot];
+			stream.clear();
+			// Bind elision restarts with every secondary
+			u32 boundMesh = ~0u;
+			for (u32 i = begin; i < end; ++i) {
+				const DrawPacket& packet = packets[i];
+				if (packet.mesh != boundMesh) {
+					stream.push_back({.opcode = 1, .indexCount = packet.mesh});
+					boundMesh = packet.mesh;
+				}
+				DrawRecord& draw = stream.emplace_back();
+				draw.opcode = 2;
+				draw.indexCount = 36;
+				std::memcpy(draw.pushConstants.data(), objectData[packet.object].data(), sizeof(draw.pushConstants));
+			}
+		});
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * drawCount);
+	state.counters["secondaries"] = static_cast<double>(slotCount);
+}
+BENCHMARK(BM_RecordDrawsParallel)
+    ->ArgNames({"threads", "draws"})
+    ->ArgsProduct({{1, 2, 4, 8}, {50'000}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// One loop of independent matrix builds spread over the pool. range(0) is the thread count including the caller,
+// range(1) pins the workers to their own core.
+void BM_ParallelForTransforms(benchmark::State& state) {
+	const auto threadCount = static_cast<u32>(state.range(0));
+	ThreadPool threadPool(threadCount - 1, state.range(1) != 0);
+
+	std::vector<vke::TransformComponent> transforms(TRANSFORM_COUNT);
+	for (u32 i = 0; i < TRANSFORM_COUNT; ++i) {
+		const auto value = static_cast<float>(i);
+		transforms[i].setTranslation({value, 0.f, -value});
+		transforms[i].setRotation(vke::eulerToQuat(glm::radians(glm::vec3{value * 0.1f, value * 0.2f, value * 0.3f})));
+	}
+	std::vector<glm::mat4> matrices(TRANSFORM_COUNT);
+
+	for (auto _ : state) {
+		threadPool.parallelFor(TRANSFORM_COUNT, TRANSFORM_GRAIN,
+		                       [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+			                       for (u32 i = begin; i < end; ++i) {
+				                       matrices[i] = transforms[i].mat4();
+			                       }
+		                       });
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * TRANSFORM_COUNT);
+}
+BENCHMARK(BM_ParallelForTransforms)
+    ->ArgNames({"threads", "pinned"})
+    ->ArgsProduct({{1, 2, 4, 8}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// Scheduling cost alone, range(0) empty jobs run and waited on
+void BM_RunEmptyJobs(benchmark::State& state) {
+	const auto jobCount = static_cast<u32>(state.range(0));
+	ThreadPool threadPool(3);
+	for (auto _ : state) {
+		JobCounter counter;
+		for (u32 i = 0; i < jobCount; ++i) {
+			threadPool.run([]() {}, counter);
+		}
+		threadPool.wait(counter);
+	}
+	state.SetItemsProcessed(state.iterations() * jobCount);
+}
+BENCHMARK(BM_RunEmptyJobs)->Arg(1000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+}  // namespace
@@ -0,0 +1,121 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+#include "core/engine_transform_system.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 OBJECT_COUNT = 100'000;
+
+// Transform the ECS replaced, Euler angles in degrees turned into a matrix by a chain of glm calls per object
+struct EulerTransform {
+	glm::vec3 translation{};
+	glm::vec3 rotation{};
+	glm::vec3 scale{1.f, 1.f, 1.f};
+
+	[[nodiscard]] glm::mat4 mat4() const {
+		auto transform = glm::translate(glm::mat4{1.f}, translation);
+		transform = glm::rotate(transform, glm::radians(rotation.y), {0.f, 1.f, 0.f});
+		transform = glm::rotate(transform, glm::radians(rotation.x), {1.f, 0.f, 0.f});
+		transform = glm::rotate(transform, glm::radians(rotation.z), {0.f, 0.f, 1.f});
+		return glm::scale(transform, scale);
+	}
+};
+
+std::vector<EulerTransform> makeEulerTransforms() {
+	std::mt19937 random{1};
+	std::uniform_real_distribution position{-100.f, 100.f};
+	std::uniform_real_distribution angle{-180.f, 180.f};
+	std::vector<EulerTransform> transforms(OBJECT_COUNT);
+	for (EulerTransform& transform : transforms) {
+		transform.translation = {position(random), position(random), position(random)};
+		transform.rotation = {angle(random), angle(random), angle(random)};
+	}
+	return transforms;
+}
+
+std::vector<Entity> populate(VkEngineWorld& world) {
+	std::vector<Entity> entities;
+	for (const EulerTransform& euler : makeEulerTransforms()) {
+		TransformComponent transform{};
+		transform.setTranslation(euler.translation);
+		transform.setRotation(eulerToQuat(glm::radians(euler.rotation)));
+		transform.setScale(euler.scale);
+		entities.push_back(world.createEntity(transform, WorldMatrixComponent{}));
+	}
+	return entities;
+}
+
+// The per object path every frame before the transform system, for all 100k objects
+void BM_TransformsEulerChain(benchmark::State& state) {
+	const std::vector<EulerTransform> transforms = makeEulerTransforms();
+	std::vector<glm::mat4> matrices(OBJECT_COUNT);
+	for (auto _ : state) {
+		for (u32 i = 0; i < OBJECT_COUNT; ++i) {
+			matrices[i] = transforms[i].mat4();
+		}
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+}
+BENCHMARK(BM_TransformsEulerChain)->Unit(benchmark::kMicrosecond);
+
+// The same per object glm chain on quaternions, reading and writing the ECS columns like the transform system
+void BM_TransformsQuatChain(benchmark::State& state) {
+	VkEngineWorld world;
+	populate(world);
+	for (auto _ : state) {
+		world.forEachChunk<TransformComponent, WorldMatrixComponent>(
+		    [](const u32 count, const Entity*, const TransformComponent* transforms, WorldMatrixComponent* matrices) {
+			    for (u32 i = 0; i < count; ++i) {
+				    const glm::mat4 world = glm::translate(glm::mat4{1.f}, transforms[i].getTranslation()) *
+				                            glm::mat4_cast(transforms[i].getRotation());
+				    matrices[i].matrix = glm::scale(world, transforms[i].getScale());
+			    }
+		    });
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+}
+BENCHMARK(BM_TransformsQuatChain)->Unit(benchmark::kMicrosecond);
+
+// VkEngineTransformSystem on one thread, range(0) is the percentage of the objects moved before each update
+void BM_TransformSystem(benchmark::State& state) {
+	const auto movedPercent = static_cast<u32>(state.range(0));
+	VkEngineWorld world;
+	const std::vector<Entity> entities = populate(world);
+	ThreadPool threadPool(0);
+	VkEngineTransformSystem transformSystem(threadPool);
+	transformSystem.update(world);
+
+	const u32 stride = movedPercent == 0 ? 0 : 100 / movedPercent;
+	std::vector<TransformComponent*> moved;
+	for (u32 i = 0; stride != 0 && i < OBJECT_COUNT; i += stride) {
+		moved.push_back(world.getComponent<TransformComponent>(entities[i]));
+	}
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		if (movedPercent == 100) {
+			transformSystem.invalidate();
+		} else {
+			for (TransformComponent* transform : moved) {
+				transform->setTranslation(transform->getTranslation());
+			}
+		}
+		state.ResumeTiming();
+		transformSystem.update(world);
+	}
+	state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	state.counters["updated"] = transformSystem.getStats().updatedTransforms;
+}
+BENCHMARK(BM_TransformSystem)->ArgName("moved%")->Arg(100)->Arg(10)->Arg(0)->Unit(benchmark::kMicrosecond);
+}  // namespace
+}  // namespace vke
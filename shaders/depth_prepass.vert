@@ -0,0 +1,28 @@
+#version 460
+
+// position only stream, see VkEngineModel::getPositionAttributeDescriptions
+layout (location = 0) in vec3 position;
+
+// must match simple.vert bit for bit, the main pass tests depth with EQUAL
+invariant gl_Position;
+
+// per frame uniforms, see VkEngineGlobalUniforms
+layout (set = 2, binding = 0) uniform Globals {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 lightDirection;
+    vec4 time;
+} globals;
+
+// transform holds the world matrix of the object
+layout (push_constant) uniform Push {
+    mat4 transform;
+    vec3 color;
+    uint materialIndex;
+} push;
+
+void main()
+{
+    gl_Position = globals.projectionView * (push.transform * vec4(position, 1.0));
+}
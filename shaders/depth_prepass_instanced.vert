@@ -0,0 +1,24 @@
+#version 460
+
+// position only stream, see VkEngineModel::getPositionAttributeDescriptions
+layout (location = 0) in vec3 position;
+
+// per instance stream, same locations as instanced.vert
+layout (location = 4) in mat4 instanceTransform;
+
+// must match instanced.vert bit for bit, the main pass tests depth with EQUAL
+invariant gl_Position;
+
+// per frame uniforms, see VkEngineGlobalUniforms
+layout (set = 2, binding = 0) uniform Globals {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 lightDirection;
+    vec4 time;
+} globals;
+
+void main()
+{
+    gl_Position = globals.projectionView * (instanceTransform * vec4(position, 1.0));
+}
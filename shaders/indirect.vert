@@ -0,0 +1,46 @@
+#version 460
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec3 normal;
+layout (location = 3) in vec2 uv;
+
+layout (location = 0) out vec3 fragColor;
+layout (location = 1) out vec2 fragUV;
+layout (location = 2) flat out uint fragMaterial;
+layout (location = 3) out vec3 fragViewNormal;
+
+struct ObjectData {
+    mat4 transform;
+    vec4 color;
+    vec4 boundingSphere;
+    uint modelIndex;
+    uint materialIndex;
+    uint pad1;
+    uint pad2;
+};
+
+// per frame uniforms, see VkEngineGlobalUniforms
+layout (set = 2, binding = 0) uniform Globals {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 lightDirection;
+    vec4 time;
+} globals;
+
+// set 0 is the bindless heap, set 1 the clustered lights, the culling pass stores the object index in firstInstance
+layout (std430, set = 3, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+void main()
+{
+    vec3 light = globals.lightDirection.xyz;
+    mat4 transform = objects[gl_InstanceIndex].transform;
+
+    gl_Position = globals.projectionView * (transform * vec4(position, 1.0));
+    fragColor = objects[gl_InstanceIndex].color.rgb * normal*dot(normal, light);
+    fragUV = uv;
+    fragMaterial = objects[gl_InstanceIndex].materialIndex;
+    // inverse transpose so that non uniform scales keep the normal perpendicular to the surface
+    fragViewNormal = mat3(globals.view) * (transpose(inverse(mat3(transform))) * normal);
+}
@@ -0,0 +1,40 @@
+#version 460
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec3 normal;
+layout (location = 3) in vec2 uv;
+
+// per instance stream, advanced once per drawn instance
+layout (location = 4) in mat4 instanceTransform;
+layout (location = 8) in vec4 instanceColor;
+layout (location = 9) in uint instanceMaterial;
+
+// must match the depth prepass bit for bit, the main pass tests depth with EQUAL
+invariant gl_Position;
+
+layout (location = 0) out vec3 fragColor;
+layout (location = 1) out vec2 fragUV;
+layout (location = 2) flat out uint fragMaterial;
+layout (location = 3) out vec3 fragViewNormal;
+
+// per frame uniforms, see VkEngineGlobalUniforms
+layout (set = 2, binding = 0) uniform Globals {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 lightDirection;
+    vec4 time;
+} globals;
+
+void main()
+{
+    vec3 light = globals.lightDirection.xyz;
+
+    gl_Position = globals.projectionView * (instanceTransform * vec4(position, 1.0));
+    fragColor = instanceColor.rgb * normal*dot(normal, light);
+    fragUV = uv;
+    fragMaterial = instanceMaterial;
+    // inverse transpose so that non uniform scales keep the normal perpendicular to the surface
+    fragViewNormal = mat3(globals.view) * (transpose(inverse(mat3(instanceTransform))) * normal);
+}
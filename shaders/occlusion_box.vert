@@ -0,0 +1,26 @@
+#version 460
+
+// Bounding box of an object, drawn inside an occlusion query against the depth of the frame. No vertex input, the 36
+// vertices of the 12 triangles are picked from the 8 corners of a cube.
+
+layout (push_constant) uniform Push {
+    mat4 viewProjection;
+    // world space bounding sphere, the box is the one around it
+    vec4 centerRadius;
+} push;
+
+const uint cubeIndices[36] = uint[](
+    0, 1, 3, 0, 3, 2,  // -z
+    4, 6, 7, 4, 7, 5,  // +z
+    0, 4, 5, 0, 5, 1,  // -y
+    2, 3, 7, 2, 7, 6,  // +y
+    0, 2, 6, 0, 6, 4,  // -x
+    1, 5, 7, 1, 7, 3   // +x
+);
+
+void main()
+{
+    uint corner = cubeIndices[gl_VertexIndex];
+    vec3 offset = vec3(float(corner & 1u), float((corner >> 1) & 1u), float((corner >> 2) & 1u)) * 2.0 - 1.0;
+    gl_Position = push.viewProjection * vec4(push.centerRadius.xyz + offset * push.centerRadius.w, 1.0);
+}
@@ -1,13 +1,95 @@
 #version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
 layout (location = 0) in vec3 fragColor;
+layout (location = 1) in vec2 fragUV;
+layout (location = 2) flat in uint fragMaterial;
+layout (location = 3) in vec3 fragViewNormal;
+
 layout (location = 0) out vec4 outColor;
 
-layout (push_constant) uniform Push {
-    mat4 transform;
-    vec3 color;
-} push;
+struct Material {
+    vec4 baseColor;
+    uint albedoTexture;
+    uint albedoSampler;
+    uint pad0;
+    uint pad1;
+};
+
+// bindless heap, see VkEngineBindlessHeap
+layout (set = 0, binding = 0) uniform texture2D textures[];
+layout (set = 0, binding = 1) uniform sampler samplers[];
+layout (std430, set = 0, binding = 2) readonly buffer Materials { Material materials[]; } storageBuffers[];
+
+// VkEngineBindlessHeap::MATERIAL_BUFFER_SLOT
+const uint MATERIAL_BUFFER_SLOT = 0;
+
+// clustered lights, see VkEngineLightSystem and light_cluster.comp
+struct Light {
+    vec4 positionRange;
+    vec4 colorIntensity;
+    vec4 directionCosOuter;
+    vec4 spot;
+};
+
+layout (set = 1, binding = 0) uniform Clusters {
+    mat4 inverseProjection;
+    // light count in w
+    uvec4 gridSize;
+    vec4 screenSize;
+    // near, far, scale, bias
+    vec4 depthSlicing;
+} clusters;
+
+layout (std430, set = 1, binding = 1) readonly buffer Lights { Light lights[]; };
+layout (std430, set = 1, binding = 2) readonly buffer Counts { uint counts[]; };
+layout (std430, set = 1, binding = 3) readonly buffer Indices { uint indices[]; };
+
+// VkEngineLightSystem::MAX_LIGHTS_PER_CLUSTER
+const uint MAX_LIGHTS_PER_CLUSTER = 128;
 
 
+// sum of the lights of the cluster the fragment falls in, in view space
+vec3 clusteredLighting() {
+    // position rebuilt from the depth, the normal interpolated so that smooth meshes are not lit per face
+    vec2 screenUV = gl_FragCoord.xy / clusters.screenSize.xy;
+    vec4 viewPosition = clusters.inverseProjection * vec4(screenUV * 2.0 - 1.0, gl_FragCoord.z, 1.0);
+    vec3 position = viewPosition.xyz / viewPosition.w;
+    vec3 normal = normalize(fragViewNormal);
+
+    uvec3 grid = clusters.gridSize.xyz;
+    uvec2 tile = min(uvec2(screenUV * vec2(grid.xy)), grid.xy - 1);
+    float slice = log(max(position.z, clusters.depthSlicing.x)) * clusters.depthSlicing.z - clusters.depthSlicing.w;
+    uint cluster = tile.x + tile.y * grid.x + min(uint(max(slice, 0.0)), grid.z - 1) * grid.x * grid.y;
+
+    vec3 lighting = vec3(0.0);
+    uint count = counts[cluster];
+    for (uint i = 0; i < count; ++i) {
+        Light light = lights[indices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+        vec3 toLight = light.positionRange.xyz - position;
+        float distanceSquared = dot(toLight, toLight);
+        vec3 direction = toLight * inversesqrt(distanceSquared);
+
+        // inverse square falloff windowed to reach zero at the range
+        float ratio = distanceSquared / (light.positionRange.w * light.positionRange.w);
+        float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+        float attenuation = window * window / (distanceSquared + 1.0);
+
+        if (light.directionCosOuter.w > -1.0) {
+            float cosAngle = dot(-direction, light.directionCosOuter.xyz);
+            attenuation *= smoothstep(light.directionCosOuter.w, light.spot.x, cosAngle);
+        }
+
+        lighting += light.colorIntensity.rgb * light.colorIntensity.w * attenuation * max(dot(normal, direction), 0.0);
+    }
+    return lighting;
+}
+
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    Material material = storageBuffers[MATERIAL_BUFFER_SLOT].materials[fragMaterial];
+    // instanced and indirect draws mix materials within a draw
+    vec4 albedo = texture(sampler2D(textures[nonuniformEXT(material.albedoTexture)],
+                                    samplers[nonuniformEXT(material.albedoSampler)]), fragUV);
+
+    outColor = vec4(fragColor + clusteredLighting(), 1.0) * material.baseColor * albedo;
 }
\ No newline at end of file
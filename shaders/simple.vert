@@ -5,19 +5,40 @@ layout (location = 1) in vec3 color;
 layout (location = 2) in vec3 normal;
 layout (location = 3) in vec2 uv;
 
+// must match the depth prepass bit for bit, the main pass tests depth with EQUAL
+invariant gl_Position;
+
 layout (location = 0) out vec3 fragColor;
+layout (location = 1) out vec2 fragUV;
+layout (location = 2) flat out uint fragMaterial;
+layout (location = 3) out vec3 fragViewNormal;
+
+// per frame uniforms, see VkEngineGlobalUniforms
+layout (set = 2, binding = 0) uniform Globals {
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 lightDirection;
+    vec4 time;
+} globals;
 
+// transform holds the world matrix of the object
 layout (push_constant) uniform Push {
     mat4 transform;
     vec3 color;
+    uint materialIndex;
 } push;
 
 void main()
 {
-    vec3 light = normalize(vec3(1.0, 2.0, 3.0));
+    vec3 light = globals.lightDirection.xyz;
     float dist = distance(position, vec3(2.0, 3.0, 5.0));
     vec3 outCol = color * (max(0.0f, dot(normal,light))  * (1.0f / (dist * dist)));
 
-    gl_Position = push.transform * vec4(position, 1.0);
-    fragColor = normal*dot(normal, light);
+    gl_Position = globals.projectionView * (push.transform * vec4(position, 1.0));
+    fragColor = push.color * normal*dot(normal, light);
+    fragUV = uv;
+    fragMaterial = push.materialIndex;
+    // inverse transpose so that non uniform scales keep the normal perpendicular to the surface
+    fragViewNormal = mat3(globals.view) * (transpose(inverse(mat3(push.transform))) * normal);
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_bindless_heap.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "engine_buffer.hpp"
+#include "utils/logger.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 DESIRED_SAMPLED_IMAGES = 16384;
+constexpr u32 DESIRED_SAMPLERS = 256;
+constexpr u32 DESIRED_STORAGE_BUFFERS = 4096;
+}  // namespace
+
+u32 VkEngineBindlessHeap::SlotAllocator::allocate() {
+	if (!freeSlots.empty()) {
+		const u32 slot = freeSlots.back();
+		freeSlots.pop_back();
+		return slot;
+	}
+
+	if (next >= capacity) {
+		throw std::runtime_error("Bindless heap is full");
+	}
+	return next++;
+}
+
+void VkEngineBindlessHeap::SlotAllocator::release(const u32 slot) {
+	assert(slot < next && "Releasing a slot that was never allocated");
+	freeSlots.push_back(slot);
+}
+
+
+VkEngineBindlessHeap::VkEngineBindlessHeap(std::shared_ptr<VkEngineDevice> device) : mVkDevice(std::move(device)) {
+	createDescriptorSet();
+	createDefaultResources();
+}
+
+VkEngineBindlessHeap::~VkEngineBindlessHeap() {
+	vkDestroySampler(mVkDevice->getDevice(), pDefaultSampler, nullptr);
+	vkDestroyImageView(mVkDevice->getDevice(), pDefaultImageView, nullptr);
+	vmaDestroyImage(mVkDevice->getAllocator(), pDefaultImage, pDefaultImageMemory);
+	vkDestroyDescriptorPool(mVkDevice->getDevice(), pDescriptorPool, nullptr);
+}
+
+
+void VkEngineBindlessHeap::createDescriptorSet() {
+	// Update after bind descriptors have their own, usually much higher, limits
+	VkPhysicalDeviceVulkan12Properties properties12{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+	VkPhysicalDeviceProperties2 properties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+	                                       .pNext = &properties12};
+	vkGetPhysicalDeviceProperties2(mVkDevice->getPhysicalDevice(), &properties);
+
+	mSampledImageSlots.capacity =
+	    std::min({DESIRED_SAMPLED_IMAGES, properties12.maxDescriptorSetUpdateAfterBindSampledImages,
+	              properties12.maxPerStageDescriptorUpdateAfterBindSampledImages});
+	mSamplerSlots.capacity = std::min({DESIRED_SAMPLERS, properties12.maxDescriptorSetUpdateAfterBindSamplers,
+	                                   properties12.maxPerStageDescriptorUpdateAfterBindSamplers});
+	mStorageBufferSlots.capacity =
+	    std::min({DESIRED_STORAGE_BUFFERS, properties12.maxDescriptorSetUpdateAfterBindStorageBuffers,
+	              properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+	mStorageBufferSlots.next = RESERVED_STORAGE_BUFFERS;
+
+	constexpr VkShaderStageFlags stages =
+	    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+	const std::array bindings{
+	    VkDescriptorSetLayoutBinding{.binding = BINDING_SAMPLED_IMAGES,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+	                                 .descriptorCount = mSampledImageSlots.capacity,
+	                                 .stageFlags = stages},
+	    VkDescriptorSetLayoutBinding{.binding = BINDING_SAMPLERS,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+	                                 .descriptorCount = mSamplerSlots.capacity,
+	                                 .stageFlags = stages},
+	    VkDescriptorSetLayoutBinding{.binding = BINDING_STORAGE_BUFFERS,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+	                                 .descriptorCount = mStorageBufferSlots.capacity,
+	                                 .stageFlags = stages},
+	};
+
+	// Slots that were never written are fine as long as no shader reads them, and new slots may be written while
+	// frames using the set are still in flight
+	constexpr VkDescriptorBindingFlags bindingFlag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+	                                                 VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+	                                                 VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+	constexpr std::array<VkDescriptorBindingFlags, 3> bindingFlags{bindingFlag, bindingFlag, bindingFlag};
+
+	const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+	    .bindingCount = static_cast<u32>(bindingFlags.size()),
+	    .pBindingFlags = bindingFlags.data()};
+
+	const VkDescriptorSetLayoutCreateInfo layoutInfo{
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .pNext = &bindingFlagsInfo,
+	    .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+	    .bindingCount = static_cast<u32>(bindings.size()),
+	    .pBindings = bindings.data()};
+
+	pSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(layoutInfo);
+
+	const std::array poolSizes{
+	    VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .descriptorCount = mSampledImageSlots.capacity},
+	    VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_SAMPLER, .descriptorCount = mSamplerSlots.capacity},
+	    VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+	                         .descriptorCount = mStorageBufferSlots.capacity},
+	};
+
+	const VkDescriptorPoolCreateInfo poolInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+	                                          .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+	                                          .maxSets = 1,
+	                                          .poolSizeCount = static_cast<u32>(poolSizes.size()),
+	                                          .pPoolSizes = poolSizes.data()};
+
+	VK_CHECK(vkCreateDescriptorPool(mVkDevice->getDevice(), &poolInfo, nullptr, &pDescriptorPool));
+
+	const VkDescriptorSetAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	                                            .descriptorPool = pDescriptorPool,
+	                                            .descriptorSetCount = 1,
+	                                            .pSetLayouts = &pSetLayout};
+
+	VK_CHECK(vkAllocateDescriptorSets(mVkDevice->getDevice(), &allocInfo, &pDescriptorSet));
+
+	VKINFO("Bindless heap: {} sampled images, {} samplers, {} storage buffers", mSampledImageSlots.capacity,
+	       mSamplerSlots.capacity, mStorageBufferSlots.capacity);
+}
+
+
+void VkEngineBindlessHeap::createDefaultResources() {
+	constexpr VkImageCreateInfo imageInfo{
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = VK_FORMAT_R8G8B8A8_UNORM,
+	    .extent = {1, 1, 1},
+	    .mipLevels = 1,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .tiling = VK_IMAGE_TILING_OPTIMAL,
+	    .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+	    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+	};
+
+	mVkDevice->createImageWithInfo(imageInfo, pDefaultImage, pDefaultImageMemory);
+
+	constexpr u32 white = 0xFFFFFFFF;
+	VkEngineBuffer stagingBuffer{mVkDevice,
+	                             sizeof(white),
+	                             1,
+	                             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                             VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+	                             VMA_MEMORY_USAGE_AUTO};
+	VK_CHECK(stagingBuffer.map());
+	stagingBuffer.writeToBuffer(&white);
+	VK_CHECK(stagingBuffer.flush());
+
+	constexpr VkImageSubresourceRange colorRange{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	                                             .baseMipLevel = 0,
+	                                             .levelCount = 1,
+	                                             .baseArrayLayer = 0,
+	                                             .layerCount = 1};
+
+	auto* const commandBuffer = mVkDevice->beginSingleTimeCommands();
+
+	const VkImageMemoryBarrier2 toTransfer{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+	                                       .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+	                                       .srcAccessMask = VK_ACCESS_2_NONE,
+	                                       .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+	                                       .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+	                                       .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+	                                       .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                                       .image = pDefaultImage,
+	                                       .subresourceRange = colorRange};
+
+	const VkDependencyInfo toTransferDependency{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+	                                            .imageMemoryBarrierCount = 1,
+	                                            .pImageMemoryBarriers = &toTransfer};
+	vkCmdPipelineBarrier2(commandBuffer, &toTransferDependency);
+
+	constexpr VkBufferImageCopy region{
+	    .imageSubresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1},
+	    .imageExtent = {1, 1, 1},
+	};
+	vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.getBuffer(), pDefaultImage,
+	                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	const VkImageMemoryBarrier2 toShaderRead{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+	                                         .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+	                                         .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+	                                         .dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+	                                         .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+	                                         .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                                         .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	                                         .image = pDefaultImage,
+	                                         .subresourceRange = colorRange};
+
+	const VkDependencyInfo toShaderReadDependency{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+	                                              .imageMemoryBarrierCount = 1,
+	                                              .pImageMemoryBarriers = &toShaderRead};
+	vkCmdPipelineBarrier2(commandBuffer, &toShaderReadDependency);
+
+	mVkDevice->endSingleTimeCommands(&commandBuffer);
+
+	const VkImageViewCreateInfo viewInfo{.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	                                     .image = pDefaultImage,
+	                                     .viewType = VK_IMAGE_VIEW_TYPE_2D,
+	                                     .format = imageInfo.format,
+	                                     .subresourceRange = colorRange};
+	VK_CHECK(vkCreateImageView(mVkDevice->getDevice(), &viewInfo, nullptr, &pDefaultImageView));
+
+	const VkSamplerCreateInfo samplerInfo{
+	    .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+	    .magFilter = VK_FILTER_LINEAR,
+	    .minFilter = VK_FILTER_LINEAR,
+	    .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+	    .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .anisotropyEnable = VK_TRUE,
+	    .maxAnisotropy = mVkDevice->getPhysicalDeviceProperties().limits.maxSamplerAnisotropy,
+	    .maxLod = VK_LOD_CLAMP_NONE,
+	};
+	VK_CHECK(vkCreateSampler(mVkDevice->getDevice(), &samplerInfo, nullptr, &pDefaultSampler));
+
+	[[maybe_unused]] const u32 defaultTexture = registerSampledImage(pDefaultImageView);
+	[[maybe_unused]] const u32 defaultSampler = registerSampler(pDefaultSampler);
+	assert(defaultTexture == DEFAULT_TEXTURE && defaultSampler == DEFAULT_SAMPLER);
+}
+
+
+u32 VkEngineBindlessHeap::registerSampledImage(const VkImageView imageView, const VkImageLayout layout) {
+	const u32 slot = mSampledImageSlots.allocate();
+
+	const VkDescriptorImageInfo imageInfo{.imageView = imageView, .imageLayout = layout};
+	const VkWriteDescriptorSet write{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	                                 .dstSet = pDescriptorSet,
+	                                 .dstBinding = BINDING_SAMPLED_IMAGES,
+	                                 .dstArrayElement = slot,
+	                                 .descriptorCount = 1,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+	                                 .pImageInfo = &imageInfo};
+	vkUpdateDescriptorSets(mVkDevice->getDevice(), 1, &write, 0, nullptr);
+
+	return slot;
+}
+
+u32 VkEngineBindlessHeap::registerSampler(const VkSampler sampler) {
+	const u32 slot = mSamplerSlots.allocate();
+
+	const VkDescriptorImageInfo samplerInfo{.sampler = sampler};
+	const VkWriteDescriptorSet write{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	                                 .dstSet = pDescriptorSet,
+	                                 .dstBinding = BINDING_SAMPLERS,
+	                                 .dstArrayElement = slot,
+	                                 .descriptorCount = 1,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+	                                 .pImageInfo = &samplerInfo};
+	vkUpdateDescriptorSets(mVkDevice->getDevice(), 1, &write, 0, nullptr);
+
+	return slot;
+}
+
+u32 VkEngineBindlessHeap::registerStorageBuffer(const VkDescriptorBufferInfo& bufferInfo) {
+	const u32 slot = mStorageBufferSlots.allocate();
+	writeStorageBuffer(slot, bufferInfo);
+	return slot;
+}
+
+void VkEngineBindlessHeap::writeStorageBuffer(const u32 slot, const VkDescriptorBufferInfo& bufferInfo) const {
+	const VkWriteDescriptorSet write{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	                                 .dstSet = pDescriptorSet,
+	                                 .dstBinding = BINDING_STORAGE_BUFFERS,
+	                                 .dstArrayElement = slot,
+	                                 .descriptorCount = 1,
+	                                 .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+	                                 .pBufferInfo = &bufferInfo};
+	vkUpdateDescriptorSets(mVkDevice->getDevice(), 1, &write, 0, nullptr);
+}
+
+
+void VkEngineBindlessHeap::bind(const VkCommandBuffer* const commandBuffer, const VkPipelineBindPoint bindPoint,
+                                const VkPipelineLayout layout) const {
+	vkCmdBindDescriptorSets(*commandBuffer, bindPoint, layout, SET_INDEX, 1, &pDescriptorSet, 0, nullptr);
+}
+
+}  // namespace vke
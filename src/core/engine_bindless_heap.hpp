@@ -0,0 +1,85 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "engine_device.hpp"
+
+namespace vke {
+
+// Global descriptor heap: a single update after bind set holding partially bound arrays of sampled images, samplers
+// and storage buffers. It is bound once at set 0 by every graphics pipeline and resources are addressed from the
+// shaders by their slot, so drawing with another texture or material never needs a new descriptor set.
+class VkEngineBindlessHeap {
+   public:
+	static constexpr u32 SET_INDEX = 0;
+
+	static constexpr u32 BINDING_SAMPLED_IMAGES = 0;
+	static constexpr u32 BINDING_SAMPLERS = 1;
+	static constexpr u32 BINDING_STORAGE_BUFFERS = 2;
+
+	// Written by the heap itself and always valid: a 1x1 white texture and a linear repeat sampler
+	static constexpr u32 DEFAULT_TEXTURE = 0;
+	static constexpr u32 DEFAULT_SAMPLER = 0;
+
+	// Storage buffer slots below RESERVED_STORAGE_BUFFERS are engine wide tables at fixed indices
+	static constexpr u32 MATERIAL_BUFFER_SLOT = 0;
+	static constexpr u32 RESERVED_STORAGE_BUFFERS = 1;
+
+	explicit VkEngineBindlessHeap(std::shared_ptr<VkEngineDevice> device);
+
+	~VkEngineBindlessHeap();
+
+	VkEngineBindlessHeap(const VkEngineBindlessHeap&) = delete;
+
+	VkEngineBindlessHeap& operator=(const VkEngineBindlessHeap&) = delete;
+
+	// Register functions write the descriptor right away and return its slot. Released slots are recycled, so a
+	// resource must only be released once no frame in flight references it anymore.
+	u32 registerSampledImage(VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	u32 registerSampler(VkSampler sampler);
+	u32 registerStorageBuffer(const VkDescriptorBufferInfo& bufferInfo);
+	void writeStorageBuffer(u32 slot, const VkDescriptorBufferInfo& bufferInfo) const;
+
+	void releaseSampledImage(u32 slot) { mSampledImageSlots.release(slot); }
+	void releaseSampler(u32 slot) { mSamplerSlots.release(slot); }
+	void releaseStorageBuffer(u32 slot) { mStorageBufferSlots.release(slot); }
+
+	void bind(const VkCommandBuffer* commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const;
+
+	[[nodiscard]] VkDescriptorSetLayout getSetLayout() const { return pSetLayout; }
+	[[nodiscard]] VkDescriptorSet getDescriptorSet() const { return pDescriptorSet; }
+
+   private:
+	struct SlotAllocator {
+		u32 capacity = 0;
+		u32 next = 0;
+		std::vector<u32> freeSlots{};
+
+		u32 allocate();
+		void release(u32 slot);
+	};
+
+	void createDescriptorSet();
+	void createDefaultResources();
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+
+	VkDescriptorSetLayout pSetLayout = VK_NULL_HANDLE;
+	VkDescriptorPool pDescriptorPool = VK_NULL_HANDLE;
+	VkDescriptorSet pDescriptorSet = VK_NULL_HANDLE;
+
+	SlotAllocator mSampledImageSlots{};
+	SlotAllocator mSamplerSlots{};
+	SlotAllocator mStorageBufferSlots{};
+
+	VkImage pDefaultImage = VK_NULL_HANDLE;
+	VmaAllocation pDefaultImageMemory = VK_NULL_HANDLE;
+	VkImageView pDefaultImageView = VK_NULL_HANDLE;
+	VkSampler pDefaultSampler = VK_NULL_HANDLE;
+};
+
+}  // namespace vke
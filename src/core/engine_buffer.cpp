@@ -44,6 +44,7 @@ VkEngineBuffer::VkEngineBuffer(std::shared_ptr<VkEngineDevice> device, const VkD
 }
 
 VkEngineBuffer::~VkEngineBuffer() {
+	unmap();
 	if (pBuffer != VK_NULL_HANDLE) {
 		vmaDestroyBuffer(mDevice->getAllocator(), pBuffer, pDataBufferMemory);
 	}
@@ -6,7 +6,7 @@
 
 #include <utils/logger.hpp>
 namespace vke {
-void KeyboardController::moveInPlaneXZ(GLFWwindow* pwindow, float dt, VkEngineGameObjects& gameObjects) const {
+void KeyboardController::moveInPlaneXZ(GLFWwindow* pwindow, float dt, TransformComponent& transform) const {
 	glm::vec3 rot{0.0f};
 
 	rot.y += static_cast<float>(glfwGetKey(pwindow, mKeyMapping.lookRight) == GLFW_PRESS);
@@ -14,16 +14,18 @@ void KeyboardController::moveInPlaneXZ(GLFWwindow* pwindow, float dt, VkEngineGa
 	rot.x += static_cast<float>(glfwGetKey(pwindow, mKeyMapping.lookUp) == GLFW_PRESS);
 	rot.x -= static_cast<float>(glfwGetKey(pwindow, mKeyMapping.lookDown) == GLFW_PRESS);
 
-	// Check for null
+	// Pitch and yaw are only recovered from the quaternion while looking around, moving needs no trigonometry
+	glm::quat rotation = transform.getRotation();
 	if (glm::dot(rot, rot) > glm::epsilon<float>()) {
-		gameObjects.mTransform.rotation += glm::normalize(rot) * lookSpeed * dt;
+		const glm::vec2 pitchYaw = quatToPitchYaw(rotation);
+		const glm::vec3 delta = glm::normalize(rot) * lookSpeed * dt;
+		rotation = eulerToQuat({glm::clamp(pitchYaw.x + delta.x, -1.5f, 1.5f), pitchYaw.y + delta.y, 0.f});
+		transform.setRotation(rotation);
 	}
 
-	gameObjects.mTransform.rotation.x = glm::clamp(gameObjects.mTransform.rotation.x, -1.5f, 1.5f);
-	gameObjects.mTransform.rotation.y = glm::mod(gameObjects.mTransform.rotation.y, glm::two_pi<float>());
-
-	const float yaw = gameObjects.mTransform.rotation.y;
-	const glm::vec3 forward = {glm::sin(yaw), 0.f, glm::cos(yaw)};
+	// Rotated z axis flattened on the XZ plane, never degenerate since the pitch stays within +-1.5
+	const glm::vec3 facing = rotation * glm::vec3{0.f, 0.f, 1.f};
+	const glm::vec3 forward = glm::normalize(glm::vec3{facing.x, 0.f, facing.z});
 	const glm::vec3 right = {forward.z, 0.f, -forward.x};
 	constexpr glm::vec3 up = {0.f, -1.f, 0.f};
 
@@ -36,7 +38,7 @@ void KeyboardController::moveInPlaneXZ(GLFWwindow* pwindow, float dt, VkEngineGa
 	moveDir -= static_cast<float>(glfwGetKey(pwindow, mKeyMapping.moveDown) == GLFW_PRESS) * up;
 
 	if (glm::dot(moveDir, moveDir) > glm::epsilon<float>()) {
-		gameObjects.mTransform.translation += glm::normalize(moveDir) * moveSpeed * dt;
+		transform.setTranslation(transform.getTranslation() + glm::normalize(moveDir) * moveSpeed * dt);
 	}
 }
 }  // namespace vke
\ No newline at end of file
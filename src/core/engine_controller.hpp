@@ -24,7 +24,7 @@ class KeyboardController {
 		int lookDown = GLFW_KEY_DOWN;
 	};
 
-	void moveInPlaneXZ(GLFWwindow* pwindow, float dt, VkEngineGameObjects& gameObjects) const;
+	void moveInPlaneXZ(GLFWwindow* pwindow, float dt, TransformComponent& transform) const;
 
 
    private:
@@ -0,0 +1,220 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_descriptors.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "utils/hash.hpp"
+#include "utils/logger.hpp"
+
+namespace vke {
+
+VkEngineDescriptorAllocator::VkEngineDescriptorAllocator(const VkDevice device, const u32 initialSetsPerPool,
+                                                         const std::span<const PoolSizeRatio> ratios)
+    : pDevice(device), mRatios(ratios.begin(), ratios.end()), mSetsPerPool(initialSetsPerPool) {
+	mReadyPools.push_back(createPool(mSetsPerPool));
+}
+
+VkEngineDescriptorAllocator::~VkEngineDescriptorAllocator() {
+	for (const VkDescriptorPool pool : mReadyPools) {
+		vkDestroyDescriptorPool(pDevice, pool, nullptr);
+	}
+	for (const VkDescriptorPool pool : mFullPools) {
+		vkDestroyDescriptorPool(pDevice, pool, nullptr);
+	}
+}
+
+VkDescriptorPool VkEngineDescriptorAllocator::createPool(const u32 setCount) const {
+	std::vector<VkDescriptorPoolSize> poolSizes{};
+	poolSizes.reserve(mRatios.size());
+	for (const auto& [type, ratio] : mRatios) {
+		poolSizes.push_back(
+		    {.type = type, .descriptorCount = std::max(1u, static_cast<u32>(ratio * static_cast<float>(setCount)))});
+	}
+
+	const VkDescriptorPoolCreateInfo poolInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+	                                          .maxSets = setCount,
+	                                          .poolSizeCount = static_cast<u32>(poolSizes.size()),
+	                                          .pPoolSizes = poolSizes.data()};
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	VK_CHECK(vkCreateDescriptorPool(pDevice, &poolInfo, nullptr, &pool));
+	return pool;
+}
+
+VkDescriptorPool VkEngineDescriptorAllocator::getPool() {
+	if (!mReadyPools.empty()) {
+		const VkDescriptorPool pool = mReadyPools.back();
+		mReadyPools.pop_back();
+		return pool;
+	}
+
+	mSetsPerPool = std::min(mSetsPerPool + mSetsPerPool / 2, MAX_SETS_PER_POOL);
+	return createPool(mSetsPerPool);
+}
+
+VkDescriptorSet VkEngineDescriptorAllocator::allocate(const VkDescriptorSetLayout layout, const void* const pNext) {
+	VkDescriptorPool pool = getPool();
+
+	VkDescriptorSetAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	                                      .pNext = pNext,
+	                                      .descriptorPool = pool,
+	                                      .descriptorSetCount = 1,
+	                                      .pSetLayouts = &layout};
+
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	VkResult result = vkAllocateDescriptorSets(pDevice, &allocInfo, &set);
+
+	// The pool is exhausted, park it until the next reset and retry once with a fresh one
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+		mFullPools.push_back(pool);
+		pool = getPool();
+		allocInfo.descriptorPool = pool;
+		result = vkAllocateDescriptorSets(pDevice, &allocInfo, &set);
+	}
+	VK_CHECK(result);
+
+	mReadyPools.push_back(pool);
+	return set;
+}
+
+void VkEngineDescriptorAllocator::resetPools() {
+	for (const VkDescriptorPool pool : mReadyPools) {
+		VK_CHECK(vkResetDescriptorPool(pDevice, pool, 0));
+	}
+	for (const VkDescriptorPool pool : mFullPools) {
+		VK_CHECK(vkResetDescriptorPool(pDevice, pool, 0));
+		mReadyPools.push_back(pool);
+	}
+	mFullPools.clear();
+}
+
+
+VkEngineDescriptorLayoutCache::~VkEngineDescriptorLayoutCache() {
+	for (const auto& [key, layout] : mLayouts) {
+		vkDestroyDescriptorSetLayout(pDevice, layout, nullptr);
+	}
+}
+
+bool VkEngineDescriptorLayoutCache::LayoutKey::operator==(const LayoutKey& other) const {
+	const auto sameBinding = [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+		return a.binding == b.binding && a.descriptorType == b.descriptorType &&
+		       a.descriptorCount == b.descriptorCount && a.stageFlags == b.stageFlags &&
+		       (a.pImmutableSamplers == nullptr) == (b.pImmutableSamplers == nullptr);
+	};
+
+	return flags == other.flags && bindingFlags == other.bindingFlags && immutableSamplers == other.immutableSamplers &&
+	       std::ranges::equal(bindings, other.bindings, sameBinding);
+}
+
+size_t VkEngineDescriptorLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const {
+	size_t seed = 0;
+	hashCombine(seed, key.flags, key.bindings.size());
+	for (const auto& binding : key.bindings) {
+		hashCombine(seed, binding.binding, static_cast<u32>(binding.descriptorType), binding.descriptorCount,
+		            binding.stageFlags, binding.pImmutableSamplers != nullptr);
+	}
+	for (const VkDescriptorBindingFlags bindingFlag : key.bindingFlags) {
+		hashCombine(seed, bindingFlag);
+	}
+	for (const VkSampler sampler : key.immutableSamplers) {
+		hashCombine(seed, sampler);
+	}
+	return seed;
+}
+
+VkDescriptorSetLayout VkEngineDescriptorLayoutCache::getLayout(const VkDescriptorSetLayoutCreateInfo& createInfo) {
+	const VkDescriptorSetLayoutBindingFlagsCreateInfo* bindingFlagsInfo = nullptr;
+	for (auto* next = static_cast<const VkBaseInStructure*>(createInfo.pNext); next != nullptr; next = next->pNext) {
+		if (next->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO) {
+			bindingFlagsInfo = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo*>(next);
+		}
+	}
+
+	// Sorted by binding number so that the order the bindings were listed in doesn't matter
+	std::vector<u32> order(createInfo.bindingCount);
+	std::iota(order.begin(), order.end(), 0u);
+	std::ranges::sort(order, {}, [&](const u32 i) { return createInfo.pBindings[i].binding; });
+
+	LayoutKey key{.flags = createInfo.flags};
+	key.bindings.reserve(createInfo.bindingCount);
+	for (const u32 i : order) {
+		const auto& binding = createInfo.pBindings[i];
+		key.bindings.push_back(binding);
+		key.bindingFlags.push_back(bindingFlagsInfo != nullptr && bindingFlagsInfo->bindingCount > 0
+		                               ? bindingFlagsInfo->pBindingFlags[i]
+		                               : 0);
+		if (binding.pImmutableSamplers != nullptr) {
+			key.immutableSamplers.insert(key.immutableSamplers.end(), binding.pImmutableSamplers,
+			                             binding.pImmutableSamplers + binding.descriptorCount);
+		}
+	}
+
+	std::lock_guard lock(mMutex);
+	if (const auto it = mLayouts.find(key); it != mLayouts.end()) {
+		return it->second;
+	}
+
+	VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+	VK_CHECK(vkCreateDescriptorSetLayout(pDevice, &createInfo, nullptr, &layout));
+	mLayouts.emplace(std::move(key), layout);
+	return layout;
+}
+
+
+bool VkEngineDescriptorSetCache::Write::operator==(const Write& other) const {
+	return binding == other.binding && type == other.type && buffer.buffer == other.buffer.buffer &&
+	       buffer.offset == other.buffer.offset && buffer.range == other.buffer.range &&
+	       image.sampler == other.image.sampler && image.imageView == other.image.imageView &&
+	       image.imageLayout == other.image.imageLayout;
+}
+
+size_t VkEngineDescriptorSetCache::SetKeyHash::operator()(const SetKey& key) const {
+	size_t seed = 0;
+	hashCombine(seed, key.layout);
+	for (const auto& write : key.writes) {
+		hashCombine(seed, write.binding, static_cast<u32>(write.type), write.buffer.buffer, write.buffer.offset,
+		            write.buffer.range, write.image.sampler, write.image.imageView,
+		            static_cast<u32>(write.image.imageLayout));
+	}
+	return seed;
+}
+
+VkDescriptorSet VkEngineDescriptorSetCache::getSet(const VkDescriptorSetLayout layout,
+                                                   const std::span<const Write> writes) {
+	SetKey key{.layout = layout, .writes = {writes.begin(), writes.end()}};
+	std::ranges::sort(key.writes, {}, &Write::binding);
+
+	std::lock_guard lock(mMutex);
+	if (const auto it = mSets.find(key); it != mSets.end()) {
+		return it->second;
+	}
+
+	const VkDescriptorSet set = mAllocator.allocate(layout);
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites{};
+	descriptorWrites.reserve(key.writes.size());
+	for (const auto& write : key.writes) {
+		const bool isBuffer = write.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+		                      write.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+		                      write.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+		                      write.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+
+		descriptorWrites.push_back({.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		                            .dstSet = set,
+		                            .dstBinding = write.binding,
+		                            .descriptorCount = 1,
+		                            .descriptorType = write.type,
+		                            .pImageInfo = isBuffer ? nullptr : &write.image,
+		                            .pBufferInfo = isBuffer ? &write.buffer : nullptr});
+	}
+	vkUpdateDescriptorSets(pDevice, static_cast<u32>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+	mSets.emplace(std::move(key), set);
+	return set;
+}
+
+}  // namespace vke
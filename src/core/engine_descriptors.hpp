@@ -0,0 +1,133 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Descriptor pools that grow on demand: when the current pool runs out another one, larger by half, is created and
+// the allocation retried. Sets are never freed one by one, resetPools() recycles every pool at once.
+class VkEngineDescriptorAllocator : NO_COPY_NOR_MOVE {
+   public:
+	// Descriptors of each type created per set in a pool
+	struct PoolSizeRatio {
+		VkDescriptorType type;
+		float ratio;
+	};
+
+	VkEngineDescriptorAllocator(VkDevice device, u32 initialSetsPerPool, std::span<const PoolSizeRatio> ratios);
+
+	~VkEngineDescriptorAllocator();
+
+	VkDescriptorSet allocate(VkDescriptorSetLayout layout, const void* pNext = nullptr);
+
+	// Every set allocated so far becomes invalid, only call it once the GPU is done with them
+	void resetPools();
+
+   private:
+	VkDescriptorPool getPool();
+	VkDescriptorPool createPool(u32 setCount) const;
+
+	static constexpr u32 MAX_SETS_PER_POOL = 4096;
+
+	VkDevice pDevice = VK_NULL_HANDLE;
+	std::vector<PoolSizeRatio> mRatios{};
+	std::vector<VkDescriptorPool> mFullPools{};
+	std::vector<VkDescriptorPool> mReadyPools{};
+	u32 mSetsPerPool = 0;
+};
+
+// Descriptors of each type per set, a reasonable mix when the content of the sets is not known up front
+inline constexpr std::array<VkEngineDescriptorAllocator::PoolSizeRatio, 7> DEFAULT_POOL_RATIOS{{
+	{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4.f},
+	{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f},
+	{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f},
+	{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.f},
+	{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.f},
+	{VK_DESCRIPTOR_TYPE_SAMPLER, 1.f},
+	{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.f},
+}};
+
+
+// Set layouts deduplicated by content, asking twice for the same bindings returns the same handle. The cache owns
+// the layouts, callers must not destroy them.
+class VkEngineDescriptorLayoutCache : NO_COPY_NOR_MOVE {
+   public:
+	explicit VkEngineDescriptorLayoutCache(VkDevice device) : pDevice(device) {}
+
+	~VkEngineDescriptorLayoutCache();
+
+	// Honors VkDescriptorSetLayoutBindingFlagsCreateInfo in the pNext chain, other extension structs are not part of
+	// the key
+	VkDescriptorSetLayout getLayout(const VkDescriptorSetLayoutCreateInfo& createInfo);
+
+	[[nodiscard]] size_t size() const { return mLayouts.size(); }
+
+   private:
+	struct LayoutKey {
+		VkDescriptorSetLayoutCreateFlags flags = 0;
+		std::vector<VkDescriptorSetLayoutBinding> bindings{};
+		std::vector<VkDescriptorBindingFlags> bindingFlags{};
+		std::vector<VkSampler> immutableSamplers{};
+
+		bool operator==(const LayoutKey& other) const;
+	};
+
+	struct LayoutKeyHash {
+		size_t operator()(const LayoutKey& key) const;
+	};
+
+	VkDevice pDevice = VK_NULL_HANDLE;
+	std::unordered_map<LayoutKey, VkDescriptorSetLayout, LayoutKeyHash> mLayouts{};
+	std::mutex mMutex{};
+};
+
+
+// Descriptor sets whose content never changes, deduplicated by layout and content. The resources they point to
+// must outlive the cache, which never frees a set.
+class VkEngineDescriptorSetCache : NO_COPY_NOR_MOVE {
+   public:
+	struct Write {
+		u32 binding = 0;
+		VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		VkDescriptorBufferInfo buffer{};
+		VkDescriptorImageInfo image{};
+
+		bool operator==(const Write& other) const;
+	};
+
+	explicit VkEngineDescriptorSetCache(VkDevice device, VkEngineDescriptorAllocator& allocator)
+	    : pDevice(device), mAllocator(allocator) {}
+
+	VkDescriptorSet getSet(VkDescriptorSetLayout layout, std::span<const Write> writes);
+
+	[[nodiscard]] size_t size() const { return mSets.size(); }
+
+   private:
+	struct SetKey {
+		VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+		std::vector<Write> writes{};
+
+		bool operator==(const SetKey& other) const = default;
+	};
+
+	struct SetKeyHash {
+		size_t operator()(const SetKey& key) const;
+	};
+
+	VkDevice pDevice = VK_NULL_HANDLE;
+	VkEngineDescriptorAllocator& mAllocator;
+	std::unordered_map<SetKey, VkDescriptorSet, SetKeyHash> mSets{};
+	std::mutex mMutex{};
+};
+
+}  // namespace vke
@@ -9,6 +9,7 @@
 
 #include <set>
 #include <sstream>
+#include <string_view>
 #include <unordered_set>
 
 #include "utils/logger.hpp"
@@ -143,6 +144,15 @@ void VkEngineDevice::createDescriptorPools() {
 
 	VK_CHECK(vkCreateDescriptorPool(pDevice, &pool_info, nullptr, &pDescriptorPool));
 	mDeletionQueue.push_function([this]() { vkDestroyDescriptorPool(pDevice, pDescriptorPool, nullptr); });
+
+	pDescriptorLayoutCache = std::make_unique<VkEngineDescriptorLayoutCache>(pDevice);
+	pDescriptorAllocator = std::make_unique<VkEngineDescriptorAllocator>(pDevice, 64, DEFAULT_POOL_RATIOS);
+	pDescriptorSetCache = std::make_unique<VkEngineDescriptorSetCache>(pDevice, *pDescriptorAllocator);
+	mDeletionQueue.push_function([this]() {
+		pDescriptorSetCache.reset();
+		pDescriptorAllocator.reset();
+		pDescriptorLayoutCache.reset();
+	});
 }
 
 void VkEngineDevice::createInstance() {
@@ -239,7 +249,15 @@ void VkEngineDevice::createLogicalDevice() {
 	// vulkan 1.2 features
 	VkPhysicalDeviceVulkan12Features features12{
 	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+	    .drawIndirectCount = VK_TRUE,
 	    .descriptorIndexing = VK_TRUE,
+	    .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+	    .shaderStorageBufferArrayNonUniformIndexing = VK_TRUE,
+	    .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+	    .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+	    .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+	    .descriptorBindingPartiallyBound = VK_TRUE,
+	    .runtimeDescriptorArray = VK_TRUE,
 	    .bufferDeviceAddress = VK_TRUE,
 	};
 
@@ -250,10 +268,28 @@ void VkEngineDevice::createLogicalDevice() {
 	    .dynamicRendering = VK_TRUE,
 	};
 
+	// optional, occlusion query results predicate draws on the GPU when it is there
+	mConditionalRendering = checkConditionalRenderingSupport();
+	std::vector<const char*> deviceExtensions(mDeviceExtensions.begin(), mDeviceExtensions.end());
+	VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures{
+	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT,
+	    .pNext = &features13,  // link the 1.3 features to the conditional rendering features
+	    .conditionalRendering = VK_TRUE,
+	};
+	void* extensionFeatures = &features13;
+	if (mConditionalRendering) {
+		deviceExtensions.push_back(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME);
+		extensionFeatures = &conditionalRenderingFeatures;
+	}
+
 	VkPhysicalDeviceFeatures2 deviceFeatures2 = {
 	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-	    .pNext = &features13,  // link the 1.3 features to the 2.0 features
-	    .features = {.samplerAnisotropy = VK_TRUE, .pipelineStatisticsQuery = VK_TRUE},
+	    .pNext = extensionFeatures,  // link the extension and 1.3 features to the 2.0 features
+	    .features = {.multiDrawIndirect = VK_TRUE,
+	                 .drawIndirectFirstInstance = VK_TRUE,
+	                 .samplerAnisotropy = VK_TRUE,
+	                 .pipelineStatisticsQuery = VK_TRUE,
+	                 .inheritedQueries = VK_TRUE},
 	};
 
 	VkDeviceCreateInfo createInfo = {
@@ -261,8 +297,8 @@ void VkEngineDevice::createLogicalDevice() {
 	    .pNext = &deviceFeatures2,  // link the 2.0 features to the device create info
 	    .queueCreateInfoCount = static_cast<u32>(uniqueQueueFamilies.size()),
 	    .pQueueCreateInfos = queueCreateInfos,
-	    .enabledExtensionCount = static_cast<u32>(mDeviceExtensions.size()),
-	    .ppEnabledExtensionNames = mDeviceExtensions.data(),
+	    .enabledExtensionCount = static_cast<u32>(deviceExtensions.size()),
+	    .ppEnabledExtensionNames = deviceExtensions.data(),
 	};
 
 	// might not really be necessary anymore because device specific validation
@@ -280,6 +316,15 @@ void VkEngineDevice::createLogicalDevice() {
 	vkGetDeviceQueue(pDevice, findQueueFamilies(&pPhysicalDevice).mGraphicsFamily.value(), 0, &pGraphicsQueue);
 	vkGetDeviceQueue(pDevice, findQueueFamilies(&pPhysicalDevice).mPresentFamily.value(), 0, &pPresentQueue);
 
+	if (mConditionalRendering) {
+		pCmdBeginConditionalRendering = reinterpret_cast<PFN_vkCmdBeginConditionalRenderingEXT>(
+		    vkGetDeviceProcAddr(pDevice, "vkCmdBeginConditionalRenderingEXT"));
+		pCmdEndConditionalRendering = reinterpret_cast<PFN_vkCmdEndConditionalRenderingEXT>(
+		    vkGetDeviceProcAddr(pDevice, "vkCmdEndConditionalRenderingEXT"));
+		mConditionalRendering = pCmdBeginConditionalRendering != nullptr && pCmdEndConditionalRendering != nullptr;
+	}
+	VKINFO("Conditional rendering: {}", mConditionalRendering ? "enabled" : "unavailable");
+
 	Memory::freeMemory(queueCreateInfos, uniqueQueueFamilies.size(), MEMORY_TAG_VULKAN);
 }
 
@@ -325,7 +370,7 @@ bool VkEngineDevice::isDeviceSuitable(const VkPhysicalDevice* const device) cons
 	vkGetPhysicalDeviceFeatures2(*device, &supportedFeatures2);
 
 	return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-	       (supportedFeatures.samplerAnisotropy != 0u);
+	       (supportedFeatures.samplerAnisotropy != 0u) && (supportedFeatures.inheritedQueries != 0u);
 }
 
 void VkEngineDevice::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
@@ -462,6 +507,46 @@ bool VkEngineDevice::checkDeviceExtensionSupport(const VkPhysicalDevice* const d
 	return requiredExtensions.empty();
 }
 
+bool VkEngineDevice::checkConditionalRenderingSupport() const {
+	u32 extensionCount = 0;
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(pPhysicalDevice, nullptr, &extensionCount, nullptr));
+
+	auto* availableExtensions = Memory::allocMemory<VkExtensionProperties>(extensionCount, MEMORY_TAG_VULKAN);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(pPhysicalDevice, nullptr, &extensionCount, availableExtensions));
+
+	constexpr std::string_view extensionName = VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME;
+	bool hasExtension = false;
+	for (u32 i = 0; i < extensionCount; ++i) {
+		hasExtension |= extensionName == availableExtensions[i].extensionName;
+	}
+	Memory::freeMemory(availableExtensions, extensionCount, MEMORY_TAG_VULKAN);
+
+	if (!hasExtension) {
+		return false;
+	}
+
+	VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures{
+	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT};
+	VkPhysicalDeviceFeatures2 features2{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+	                                    .pNext = &conditionalRenderingFeatures};
+	vkGetPhysicalDeviceFeatures2(pPhysicalDevice, &features2);
+	return conditionalRenderingFeatures.conditionalRendering != VK_FALSE;
+}
+
+void VkEngineDevice::cmdBeginConditionalRendering(const VkCommandBuffer commandBuffer, const VkBuffer buffer,
+                                                  const VkDeviceSize offset) const {
+	const VkConditionalRenderingBeginInfoEXT beginInfo{
+	    .sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT,
+	    .buffer = buffer,
+	    .offset = offset,
+	};
+	pCmdBeginConditionalRendering(commandBuffer, &beginInfo);
+}
+
+void VkEngineDevice::cmdEndConditionalRendering(const VkCommandBuffer commandBuffer) const {
+	pCmdEndConditionalRendering(commandBuffer);
+}
+
 QueueFamilyIndices VkEngineDevice::findQueueFamilies(const VkPhysicalDevice* const device) const {
 	QueueFamilyIndices indices{};
 
@@ -630,4 +715,24 @@ void VkEngineDevice::createImageWithInfo(const VkImageCreateInfo& imageInfo, VkI
 }
 
 
+bool VkEngineDevice::allocateTransientMemory(const VkMemoryRequirements& requirements,
+                                             VmaAllocation& memory) const {
+	// Tile based GPUs can keep transient attachments in on-chip memory, never committing physical pages
+	constexpr VmaAllocationCreateInfo lazyAllocInfo{.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+	                                                .usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED,
+	                                                .priority = 1.0f};
+
+	if (vmaAllocateMemory(pAllocator, &requirements, &lazyAllocInfo, &memory, nullptr) == VK_SUCCESS) {
+		return true;
+	}
+
+	constexpr VmaAllocationCreateInfo deviceAllocInfo{.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+	                                                  .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+	                                                  .priority = 1.0f};
+
+	VK_CHECK(vmaAllocateMemory(pAllocator, &requirements, &deviceAllocInfo, &memory, nullptr));
+	return false;
+}
+
+
 }  // namespace vke
\ No newline at end of file
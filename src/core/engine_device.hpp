@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 
+#include "engine_descriptors.hpp"
 #include "engine_window.hpp"
 
 #ifdef NDEBUG
@@ -111,10 +112,21 @@ class VkEngineDevice {
 	[[nodiscard]] const VkDevice& getDevice() const { return pDevice; }
 	[[nodiscard]] const VmaAllocator& getAllocator() const { return pAllocator; }
 	[[nodiscard]] const VkPhysicalDevice& getPhysicalDevice() const { return pPhysicalDevice; }
+	// ImGui only, it frees its sets individually
 	[[nodiscard]] const VkDescriptorPool& getDescriptorPool() const { return pDescriptorPool; }
+	[[nodiscard]] VkEngineDescriptorLayoutCache& getDescriptorLayoutCache() const { return *pDescriptorLayoutCache; }
+	// Long lived sets, never reset
+	[[nodiscard]] VkEngineDescriptorAllocator& getDescriptorAllocator() const { return *pDescriptorAllocator; }
+	[[nodiscard]] VkEngineDescriptorSetCache& getDescriptorSetCache() const { return *pDescriptorSetCache; }
 	[[nodiscard]] const VkCommandPool& getCommandPool() const { return pCommandPool; }
 	[[nodiscard]] DeletionQueue& getDeletionQueue() { return mDeletionQueue; }
 
+	// VK_EXT_conditional_rendering is enabled when the device has it, the begin/end helpers must not be called
+	// otherwise
+	[[nodiscard]] bool hasConditionalRendering() const { return mConditionalRendering; }
+	void cmdBeginConditionalRendering(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) const;
+	void cmdEndConditionalRendering(VkCommandBuffer commandBuffer) const;
+
 
 	[[nodiscard]] SwapChainSupportDetails getSwapChainSupport() const {
 		return querySwapChainSupport(&pPhysicalDevice);
@@ -138,6 +150,10 @@ class VkEngineDevice {
 	                       uint32_t layerCount) const;
 	void createImageWithInfo(const VkImageCreateInfo& imageInfo, VkImage& image, VmaAllocation& imageMemory) const;
 
+	// Block backing transient attachments, which are then bound at their own offsets (or aliased when the lifetimes
+	// don't overlap). Returns true when the block landed in lazily allocated memory.
+	bool allocateTransientMemory(const VkMemoryRequirements& requirements, VmaAllocation& memory) const;
+
 	VkPhysicalDeviceProperties mProperties{};
 
    private:
@@ -172,6 +188,8 @@ class VkEngineDevice {
 
 	bool checkDeviceExtensionSupport(const VkPhysicalDevice* device) const;
 
+	[[nodiscard]] bool checkConditionalRenderingSupport() const;
+
 	SwapChainSupportDetails querySwapChainSupport(const VkPhysicalDevice* device) const;
 
 	const std::shared_ptr<VkEngineWindow> pWindow{};
@@ -182,6 +200,9 @@ class VkEngineDevice {
 	VkCommandBufferPool pCommandBufferPool{};
 	VkCommandPool pCommandPool = VK_NULL_HANDLE;
 	VkDescriptorPool pDescriptorPool = VK_NULL_HANDLE;
+	std::unique_ptr<VkEngineDescriptorLayoutCache> pDescriptorLayoutCache{};
+	std::unique_ptr<VkEngineDescriptorAllocator> pDescriptorAllocator{};
+	std::unique_ptr<VkEngineDescriptorSetCache> pDescriptorSetCache{};
 	VkInstance pInstance = VK_NULL_HANDLE;
 	VkDebugUtilsMessengerEXT pDebugMessenger = VK_NULL_HANDLE;
 	VkPhysicalDevice pPhysicalDevice = VK_NULL_HANDLE;
@@ -190,6 +211,10 @@ class VkEngineDevice {
 	VkQueue pGraphicsQueue = VK_NULL_HANDLE;
 	VkQueue pPresentQueue = VK_NULL_HANDLE;
 
+	bool mConditionalRendering = false;
+	PFN_vkCmdBeginConditionalRenderingEXT pCmdBeginConditionalRendering = nullptr;
+	PFN_vkCmdEndConditionalRenderingEXT pCmdEndConditionalRendering = nullptr;
+
 	const std::array<const char*, 1> mValidationLayer{"VK_LAYER_KHRONOS_validation"};
 
 	// TODO: make it more bullet proof for cross platform
@@ -4,4 +4,323 @@
 
 #include "engine_ecs.hpp"
 
-namespace vke {}  // namespace vke
\ No newline at end of file
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include "utils/logger.hpp"
+
+namespace vke {
+namespace {
+std::array<ComponentInfo, MAX_COMPONENTS> gComponentInfos{};
+u32 gComponentCount = 0;
+std::mutex gComponentMutex{};
+
+u32 alignUp(const u32 value, const u32 alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+void moveComponent(const ComponentInfo& info, std::byte* destination, std::byte* source) {
+	if (info.moveConstruct != nullptr) {
+		info.moveConstruct(destination, source);
+	} else {
+		std::memcpy(destination, source, info.size);
+	}
+}
+
+void destroyComponent(const ComponentInfo& info, std::byte* component) {
+	if (info.destroy != nullptr) {
+		info.destroy(component);
+	}
+}
+}  // namespace
+
+glm::mat4 TransformComponent::mat4() const {
+	const float x = mRotation.x;
+	const float y = mRotation.y;
+	const float z = mRotation.z;
+	const float w = mRotation.w;
+	const float xx = x * x;
+	const float yy = y * y;
+	const float zz = z * z;
+	const float xy = x * y;
+	const float xz = x * z;
+	const float yz = y * z;
+	const float wx = w * x;
+	const float wy = w * y;
+	const float wz = w * z;
+
+	return {{mScale.x * (1.f - 2.f * (yy + zz)), mScale.x * 2.f * (xy + wz), mScale.x * 2.f * (xz - wy), 0.f},
+	        {mScale.y * 2.f * (xy - wz), mScale.y * (1.f - 2.f * (xx + zz)), mScale.y * 2.f * (yz + wx), 0.f},
+	        {mScale.z * 2.f * (xz + wy), mScale.z * 2.f * (yz - wx), mScale.z * (1.f - 2.f * (xx + yy)), 0.f},
+	        {mTranslation.x, mTranslation.y, mTranslation.z, 1.f}};
+}
+
+glm::quat eulerToQuat(const glm::vec3& angles) {
+	return glm::angleAxis(angles.y, glm::vec3{0.f, 1.f, 0.f}) * glm::angleAxis(angles.x, glm::vec3{1.f, 0.f, 0.f}) *
+	       glm::angleAxis(angles.z, glm::vec3{0.f, 0.f, 1.f});
+}
+
+glm::vec2 quatToPitchYaw(const glm::quat& rotation) {
+	// The rotated z axis is (cos pitch sin yaw, -sin pitch, cos pitch cos yaw)
+	const glm::vec3 forward = rotation * glm::vec3{0.f, 0.f, 1.f};
+	return {glm::asin(glm::clamp(-forward.y, -1.f, 1.f)), glm::atan(forward.x, forward.z)};
+}
+
+
+const ComponentInfo& ComponentRegistry::getInfo(const ComponentId id) {
+	// Written once before the id is handed out, the static initialization of the id publishes it
+	return gComponentInfos[id];
+}
+
+ComponentId ComponentRegistry::registerComponent(const ComponentInfo& info) {
+	std::lock_guard lock(gComponentMutex);
+	if (gComponentCount == MAX_COMPONENTS) {
+		throw std::runtime_error("Too many component types");
+	}
+	gComponentInfos[gComponentCount] = info;
+	return gComponentCount++;
+}
+
+
+VkEngineArchetype::VkEngineArchetype(const ComponentMask mask) : mMask(mask) {
+	mColumnOffsets.fill(NO_COLUMN);
+
+	u32 rowSize = sizeof(Entity);
+	for (ComponentMask bits = mask; bits != 0; bits &= bits - 1) {
+		const auto id = static_cast<ComponentId>(std::countr_zero(bits));
+		mColumns.push_back({.id = id, .info = ComponentRegistry::getInfo(id)});
+		rowSize += mColumns.back().info.size;
+	}
+
+	// Every column may lose up to a cache line to its alignment, what is left is shared by the rows
+	const u32 padding = ECS_CACHE_LINE * static_cast<u32>(mColumns.size() + 1);
+	mChunkCapacity = (ECS_CHUNK_BYTES - padding) / rowSize;
+	if (mChunkCapacity == 0) {
+		throw std::runtime_error("The components of an archetype do not fit in a chunk");
+	}
+
+	u32 offset = alignUp(mChunkCapacity * static_cast<u32>(sizeof(Entity)), ECS_CACHE_LINE);
+	for (Column& column : mColumns) {
+		column.offset = offset;
+		mColumnOffsets[column.id] = offset;
+		offset = alignUp(offset + mChunkCapacity * column.info.size, ECS_CACHE_LINE);
+	}
+}
+
+VkEngineArchetype::~VkEngineArchetype() {
+	clear();
+	for (std::byte* data : mSpareChunks) {
+		::operator delete(data, std::align_val_t{ECS_CACHE_LINE});
+	}
+}
+
+std::byte* VkEngineArchetype::getComponent(const u32 row, const ComponentId id) const {
+	const EcsChunk& chunk = mChunks[row / mChunkCapacity];
+	return chunk.data + mColumnOffsets[id] + (row % mChunkCapacity) * ComponentRegistry::getInfo(id).size;
+}
+
+std::byte* VkEngineArchetype::takeChunk() {
+	if (mSpareChunks.empty()) {
+		return static_cast<std::byte*>(::operator new(ECS_CHUNK_BYTES, std::align_val_t{ECS_CACHE_LINE}));
+	}
+	std::byte* data = mSpareChunks.back();
+	mSpareChunks.pop_back();
+	return data;
+}
+
+void VkEngineArchetype::reserve(const u32 rowCount) {
+	const u32 chunkCount = (rowCount + mChunkCapacity - 1) / mChunkCapacity;
+	const auto available = static_cast<u32>(mChunks.size() + mSpareChunks.size());
+	if (chunkCount <= available) {
+		return;
+	}
+	mChunks.reserve(chunkCount);
+	mSpareChunks.reserve(chunkCount);
+	for (u32 i = available; i < chunkCount; ++i) {
+		mSpareChunks.push_back(
+		    static_cast<std::byte*>(::operator new(ECS_CHUNK_BYTES, std::align_val_t{ECS_CACHE_LINE})));
+	}
+}
+
+u32 VkEngineArchetype::allocateRow(const Entity entity) {
+	if (mChunks.empty() || mChunks.back().count == mChunkCapacity) {
+		mChunks.push_back({.data = takeChunk(), .count = 0, .archetype = this});
+	}
+
+	EcsChunk& chunk = mChunks.back();
+	chunk.getEntities()[chunk.count++] = entity;
+	return mEntityCount++;
+}
+
+Entity VkEngineArchetype::removeRow(const u32 row) {
+	const u32 last = mEntityCount - 1;
+	for (const Column& column : mColumns) {
+		std::byte* destination = getComponent(row, column.id);
+		destroyComponent(column.info, destination);
+		if (row != last) {
+			std::byte* source = getComponent(last, column.id);
+			moveComponent(column.info, destination, source);
+			destroyComponent(column.info, source);
+		}
+	}
+
+	Entity moved{};
+	if (row != last) {
+		moved = mChunks[last / mChunkCapacity].getEntities()[last % mChunkCapacity];
+		mChunks[row / mChunkCapacity].getEntities()[row % mChunkCapacity] = moved;
+	}
+
+	--mEntityCount;
+	if (--mChunks.back().count == 0) {
+		mSpareChunks.push_back(mChunks.back().data);
+		mChunks.pop_back();
+	}
+	return moved;
+}
+
+void VkEngineArchetype::clear() {
+	for (const EcsChunk& chunk : mChunks) {
+		for (const Column& column : mColumns) {
+			if (column.info.destroy == nullptr) {
+				continue;
+			}
+			for (u32 row = 0; row < chunk.count; ++row) {
+				column.info.destroy(chunk.data + column.offset + row * column.info.size);
+			}
+		}
+		mSpareChunks.push_back(chunk.data);
+	}
+	mChunks.clear();
+	mEntityCount = 0;
+}
+
+
+VkEngineWorld::VkEngineWorld() {
+	// Entities created without components
+	getArchetype(0);
+}
+
+void VkEngineWorld::destroyEntity(const Entity entity) {
+	if (!isAlive(entity)) {
+		VKWARN("Destroying a dead entity");
+		return;
+	}
+
+	EntityRecord& record = mRecords[entity.index];
+	if (const Entity moved = record.archetype->removeRow(record.row); moved.isValid()) {
+		mRecords[moved.index].row = record.row;
+	}
+	record.archetype = nullptr;
+	++record.generation;
+	mFreeIndices.push_back(entity.index);
+	--mAliveCount;
+	++mStructureVersion;
+}
+
+void VkEngineWorld::destroyEntities(const std::span<const Entity> entities) {
+	// Highest rows first: the row filling each hole is never one of the batch still to destroy, and the rows are
+	// walked backwards through memory rather than in the order of the handles
+	mDestroyBatch.clear();
+	for (const Entity entity : entities) {
+		if (!isAlive(entity)) {
+			VKWARN("Destroying a dead entity");
+			continue;
+		}
+		mDestroyBatch.push_back(entity);
+	}
+	std::ranges::sort(mDestroyBatch, [this](const Entity a, const Entity b) {
+		const EntityRecord& first = mRecords[a.index];
+		const EntityRecord& second = mRecords[b.index];
+		return first.archetype != second.archetype ? first.archetype < second.archetype : first.row > second.row;
+	});
+
+	mFreeIndices.reserve(mFreeIndices.size() + mDestroyBatch.size());
+	for (const Entity entity : mDestroyBatch) {
+		destroyEntity(entity);
+	}
+}
+
+void VkEngineWorld::clear() {
+	for (const auto& archetype : mArchetypes) {
+		archetype->clear();
+	}
+	for (u32 index = 0; index < mRecords.size(); ++index) {
+		if (EntityRecord& record = mRecords[index]; record.archetype != nullptr) {
+			record.archetype = nullptr;
+			++record.generation;
+			mFreeIndices.push_back(index);
+		}
+	}
+	mAliveCount = 0;
+	++mStructureVersion;
+}
+
+bool VkEngineWorld::isAlive(const Entity entity) const {
+	return entity.index < mRecords.size() && mRecords[entity.index].archetype != nullptr &&
+	       mRecords[entity.index].generation == entity.generation;
+}
+
+VkEngineArchetype& VkEngineWorld::getArchetype(const ComponentMask mask) {
+	if (const auto it = mArchetypesByMask.find(mask); it != mArchetypesByMask.end()) {
+		return *it->second;
+	}
+	auto& archetype = mArchetypes.emplace_back(std::make_unique<VkEngineArchetype>(mask));
+	mArchetypesByMask.emplace(mask, archetype.get());
+	return *archetype;
+}
+
+VkEngineArchetype& VkEngineWorld::getAddEdge(VkEngineArchetype& archetype, const ComponentId id) {
+	if (archetype.mAddEdges[id] == nullptr) {
+		archetype.mAddEdges[id] = &getArchetype(archetype.getMask() | ComponentMask{1} << id);
+	}
+	return *archetype.mAddEdges[id];
+}
+
+VkEngineArchetype& VkEngineWorld::getRemoveEdge(VkEngineArchetype& archetype, const ComponentId id) {
+	if (archetype.mRemoveEdges[id] == nullptr) {
+		archetype.mRemoveEdges[id] = &getArchetype(archetype.getMask() & ~(ComponentMask{1} << id));
+	}
+	return *archetype.mRemoveEdges[id];
+}
+
+Entity VkEngineWorld::allocateEntity(VkEngineArchetype& archetype) {
+	Entity entity{};
+	if (!mFreeIndices.empty()) {
+		entity.index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+	} else {
+		entity.index = static_cast<u32>(mRecords.size());
+		mRecords.emplace_back();
+	}
+
+	EntityRecord& record = mRecords[entity.index];
+	entity.generation = record.generation;
+	record.archetype = &archetype;
+	record.row = archetype.allocateRow(entity);
+	++mAliveCount;
+	++mStructureVersion;
+	return entity;
+}
+
+void VkEngineWorld::moveEntity(const Entity entity, VkEngineArchetype& target) {
+	EntityRecord& record = mRecords[entity.index];
+	VkEngineArchetype& source = *record.archetype;
+
+	const u32 row = target.allocateRow(entity);
+	for (const auto& column : source.mColumns) {
+		if ((target.getMask() & ComponentMask{1} << column.id) != 0) {
+			moveComponent(column.info, target.getComponent(row, column.id), source.getComponent(record.row, column.id));
+		}
+	}
+
+	// The moved from components are destroyed with the rest of the row
+	if (const Entity moved = source.removeRow(record.row); moved.isValid()) {
+		mRecords[moved.index].row = record.row;
+	}
+	record.archetype = &target;
+	record.row = row;
+	++mStructureVersion;
+}
+}  // namespace vke
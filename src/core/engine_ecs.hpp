@@ -5,55 +5,411 @@
 #pragma once
 
 
-#include <atomic>
+#include <array>
+#include <cassert>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
-#include "engine_model.hpp"
+#include "engine_handles.hpp"
+#include "utils/types.hpp"
 
 namespace vke {
-struct TransformComponent {
-	glm::vec3 translation{};
-	glm::vec3 rotation{};
-	glm::vec3 scale{1.f, 1.f, 1.f};
+// Translation, unit quaternion rotation and scale. The rotation comes first on a 16 byte boundary and the whole
+// component fits in 48 bytes, three 16 byte loads. Writes go through the setters so that VkEngineTransformSystem only
+// rebuilds the matrices of the objects that actually moved.
+class alignas(16) TransformComponent {
+   public:
+	[[nodiscard]] const glm::vec3& getTranslation() const { return mTranslation; }
+	[[nodiscard]] const glm::quat& getRotation() const { return mRotation; }
+	[[nodiscard]] const glm::vec3& getScale() const { return mScale; }
+
+	void setTranslation(const glm::vec3& translation) {
+		mTranslation = translation;
+		mDirty = true;
+	}
+	void setRotation(const glm::quat& rotation) {
+		mRotation = rotation;
+		mDirty = true;
+	}
+	void setScale(const glm::vec3& scale) {
+		mScale = scale;
+		mDirty = true;
+	}
+
+	[[nodiscard]] bool isDirty() const { return mDirty; }
+	void clearDirty() { mDirty = false; }
+
+	// translate * rotate * scale, the rotation matrix expanded from the quaternion without any trigonometry
+	[[nodiscard]] glm::mat4 mat4() const;
+
+   private:
+	glm::quat mRotation{1.f, 0.f, 0.f, 0.f};
+	glm::vec3 mTranslation{};
+	glm::vec3 mScale{1.f, 1.f, 1.f};
+	// A new component has no matrix built yet
+	bool mDirty = true;
+};
+static_assert(sizeof(TransformComponent) == 48);
+
+// Rotation of the Euler angles in radians applied Z then X then Y, the convention of VkEngineCamera::setViewXYZ
+[[nodiscard]] glm::quat eulerToQuat(const glm::vec3& angles);
+// Pitch (x) and yaw (y) in radians of a rotation without roll, the angles eulerToQuat({pitch, yaw, 0}) was built from
+[[nodiscard]] glm::vec2 quatToPitchYaw(const glm::quat& rotation);
+
+// Built from the TransformComponent of the same entity by VkEngineTransformSystem
+struct WorldMatrixComponent {
+	glm::mat4 matrix{1.f};
+};
+
+// What the render systems draw an entity with
+struct RenderComponent {
+	// Resolved through the VkEngineResourceRegistry the mesh was added to
+	MeshHandle mesh{};
+	glm::vec3 color = {1.f, 1.f, 1.f};
+	u32 materialIndex = 0;  // index in the material table, 0 is the default material
+	// rasterized by the CPU occlusion culler, best kept to large and simple meshes
+	bool occluder = false;
+};
+
+
+// Generational handle. The slot of a destroyed entity is reused by the next one created, which gets the next
+// generation, so a handle kept around after the destruction no longer refers to anything.
+struct Entity {
+	static constexpr u32 INVALID_INDEX = ~0u;
+
+	u32 index = INVALID_INDEX;
+	u32 generation = 0;
+
+	[[nodiscard]] bool isValid() const { return index != INVALID_INDEX; }
+	[[nodiscard]] u64 getId() const { return static_cast<u64>(generation) << 32 | index; }
+	bool operator==(const Entity&) const = default;
+};
 
+using ComponentId = u32;
+// One bit per ComponentId
+using ComponentMask = u64;
+static constexpr u32 MAX_COMPONENTS = 64;
+// Components are stored in blocks of this size, each column starting on its own cache line
+static constexpr u32 ECS_CHUNK_BYTES = 16 * 1024;
+static constexpr u32 ECS_CACHE_LINE = 64;
 
-	// TODO: optimize this ( precompute rotation matrix wikipedia )
-	[[nodiscard]] glm::mat4 mat4() const {
-		auto transform = glm::translate(glm::mat4{1.f}, translation);
-		transform = glm::rotate(transform, glm::radians(rotation.y), {0.f, 1.f, 0.f});
-		transform = glm::rotate(transform, glm::radians(rotation.x), {1.f, 0.f, 0.f});
-		transform = glm::rotate(transform, glm::radians(rotation.z), {0.f, 0.f, 1.f});
-		transform = glm::scale(transform, scale);
-		return transform;
+// How the storage moves and destroys a component it only knows the id of
+struct ComponentInfo {
+	u32 size = 0;
+	u32 alignment = 0;
+	// nullptr for trivially copyable types, copied with memcpy
+	void (*moveConstruct)(void* destination, void* source) = nullptr;
+	// nullptr for trivially destructible types
+	void (*destroy)(void* component) = nullptr;
+
+	template <typename T>
+	static ComponentInfo of() {
+		static_assert(alignof(T) <= ECS_CACHE_LINE, "Component columns are only aligned to a cache line");
+
+		ComponentInfo info{.size = sizeof(T), .alignment = alignof(T)};
+		if constexpr (!std::is_trivially_copyable_v<T>) {
+			info.moveConstruct = [](void* destination, void* source) {
+				new (destination) T(std::move(*static_cast<T*>(source)));
+			};
+		}
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			info.destroy = [](void* component) { static_cast<T*>(component)->~T(); };
+		}
+		return info;
+	}
+};
+
+// Any type can be a component, it gets an id the first time it is used as one
+class ComponentRegistry {
+   public:
+	template <typename T>
+	static ComponentId getId() {
+		static const ComponentId id = registerComponent(ComponentInfo::of<T>());
+		return id;
 	}
+
+	[[nodiscard]] static const ComponentInfo& getInfo(ComponentId id);
+
+   private:
+	static ComponentId registerComponent(const ComponentInfo& info);
 };
 
+template <typename... Ts>
+ComponentMask componentMask() {
+	return (ComponentMask{0} | ... | (ComponentMask{1} << ComponentRegistry::getId<Ts>()));
+}
+
 
-// has a private constructor so we can't create an instance of this class
-// without using the static createGameObject() method which increments the id
-class VkEngineGameObjects {
+class VkEngineArchetype;
+
+// ECS_CHUNK_BYTES block of an archetype: the handles of its entities, then one column per component, so a query
+// only pulls the cache lines of the columns it reads
+struct EcsChunk {
+	std::byte* data = nullptr;
+	u32 count = 0;
+	const VkEngineArchetype* archetype = nullptr;
+
+	[[nodiscard]] Entity* getEntities() const { return reinterpret_cast<Entity*>(data); }
+	// T must be a component of the archetype
+	template <typename T>
+	[[nodiscard]] T* getColumn() const;
+};
+
+// Storage of the entities having exactly the same set of components. Rows are kept dense, removing one moves the last
+// row of the archetype into the hole. Emptied chunks are kept for the next rows rather than freed, so entities spawned
+// and despawned around a chunk boundary do not allocate every time.
+class VkEngineArchetype : NO_COPY_NOR_MOVE {
    public:
-	using ObjectID = uint32_t;
+	static constexpr u32 NO_COLUMN = ~0u;
 
-	VkEngineGameObjects(const VkEngineGameObjects&) = delete;
-	VkEngineGameObjects& operator=(const VkEngineGameObjects&) = delete;
-	VkEngineGameObjects(VkEngineGameObjects&&) noexcept = default;
-	VkEngineGameObjects& operator=(VkEngineGameObjects&&) noexcept = default;
+	explicit VkEngineArchetype(ComponentMask mask);
 
-	static VkEngineGameObjects createGameObject() {
-		static std::atomic<ObjectID> id{0};
-		return VkEngineGameObjects{++id};
-	}
+	~VkEngineArchetype();
 
-	ObjectID getId() const noexcept { return mId; }
+	[[nodiscard]] ComponentMask getMask() const { return mMask; }
+	[[nodiscard]] u32 getChunkCapacity() const { return mChunkCapacity; }
+	[[nodiscard]] u32 getEntityCount() const { return mEntityCount; }
+	[[nodiscard]] const std::vector<EcsChunk>& getChunks() const { return mChunks; }
+	[[nodiscard]] u32 getColumnOffset(const ComponentId id) const { return mColumnOffsets[id]; }
 
-	std::shared_ptr<VkEngineModel> pModel{};
-	glm::vec3 mColor = {1.f, 1.f, 1.f};
-	TransformComponent mTransform{};
+	[[nodiscard]] std::byte* getComponent(u32 row, ComponentId id) const;
+
+	// Makes room for `rowCount` rows in all, allocating the chunks missing up front
+	void reserve(u32 rowCount);
+	// Appends a row for `entity`, its components are left for the caller to construct
+	u32 allocateRow(Entity entity);
+	// Destroys the components of the row and moves the last row into it. Returns the entity that was moved, invalid
+	// when `row` was the last one.
+	Entity removeRow(u32 row);
+	// Destroys every row, the chunks are kept for reuse
+	void clear();
 
    private:
-	explicit VkEngineGameObjects(const ObjectID id) noexcept : mId(id) {}
+	friend class VkEngineWorld;
+
+	[[nodiscard]] std::byte* takeChunk();
+
+	struct Column {
+		ComponentId id = 0;
+		u32 offset = 0;
+		ComponentInfo info{};
+	};
+
+	ComponentMask mMask = 0;
+	std::vector<Column> mColumns{};
+	std::array<u32, MAX_COMPONENTS> mColumnOffsets{};
+	u32 mChunkCapacity = 0;
+	std::vector<EcsChunk> mChunks{};
+	// Chunks without rows, freed with the archetype
+	std::vector<std::byte*> mSpareChunks{};
+	u32 mEntityCount = 0;
 
-	ObjectID mId;
+	// Archetype reached by adding or removing a component, filled on first use by the world
+	std::array<VkEngineArchetype*, MAX_COMPONENTS> mAddEdges{};
+	std::array<VkEngineArchetype*, MAX_COMPONENTS> mRemoveEdges{};
 };
+
+template <typename T>
+T* EcsChunk::getColumn() const {
+	const u32 offset = archetype->getColumnOffset(ComponentRegistry::getId<T>());
+	assert(offset != VkEngineArchetype::NO_COLUMN && "Component not in the archetype of the chunk");
+	return reinterpret_cast<T*>(data + offset);
+}
+
+
+// Entities and their components, grouped by archetype. Adding or removing a component is a structural change: it
+// moves the entity to another archetype and invalidates the chunks and pointers handed out before.
+class VkEngineWorld : NO_COPY_NOR_MOVE {
+   public:
+	VkEngineWorld();
+
+	~VkEngineWorld() = default;
+
+	template <typename... Ts>
+	Entity createEntity(Ts... components);
+	// Creates `count` entities holding copies of `components` and appends their handles to `entities`. The archetype
+	// is looked up and its chunks allocated once for the whole batch.
+	template <typename... Ts>
+	void createEntities(u32 count, std::vector<Entity>& entities, const Ts&... components);
+	void destroyEntity(Entity entity);
+	// Skips the dead entities, like destroyEntity
+	void destroyEntities(std::span<const Entity> entities);
+	// Destroys every entity, the handles handed out so far all become stale
+	void clear();
+	[[nodiscard]] bool isAlive(Entity entity) const;
+
+	// Replaces the component when the entity already has one
+	template <typename T>
+	T& addComponent(Entity entity, T component);
+	template <typename T>
+	void removeComponent(Entity entity);
+	// nullptr when the entity is dead or has no such component
+	template <typename T>
+	[[nodiscard]] T* getComponent(Entity entity) const;
+
+	// The queries never change the structure of the world, hence const, the components they hand out stay writable.
+	// Chunks of every archetype holding at least Ts, for callers spreading them over threads
+	template <typename... Ts>
+	void collectChunks(std::vector<EcsChunk>& chunks) const;
+	// fn(count, entities, Ts* columns...) per chunk holding at least Ts
+	template <typename... Ts, typename Fn>
+	void forEachChunk(Fn&& fn) const;
+	// fn(entity, Ts&...) per entity holding at least Ts
+	template <typename... Ts, typename Fn>
+	void forEach(Fn&& fn) const;
+	template <typename... Ts>
+	[[nodiscard]] u32 count() const;
+
+	[[nodiscard]] u32 getEntityCount() const { return mAliveCount; }
+	[[nodiscard]] u32 getArchetypeCount() const { return static_cast<u32>(mArchetypes.size()); }
+	// Bumped by every structural change, the chunks and pointers handed out under an older version are stale
+	[[nodiscard]] u64 getStructureVersion() const { return mStructureVersion; }
+
+   private:
+	struct EntityRecord {
+		VkEngineArchetype* archetype = nullptr;
+		u32 row = 0;
+		u32 generation = 0;
+	};
+
+	VkEngineArchetype& getArchetype(ComponentMask mask);
+	VkEngineArchetype& getAddEdge(VkEngineArchetype& archetype, ComponentId id);
+	VkEngineArchetype& getRemoveEdge(VkEngineArchetype& archetype, ComponentId id);
+	// Takes a free slot and a row of `archetype`, the components of the row are left to construct
+	Entity allocateEntity(VkEngineArchetype& archetype);
+	// Moves the components both archetypes share, the others are destroyed or left to construct
+	void moveEntity(Entity entity, VkEngineArchetype& target);
+
+	// Few enough that queries match them with a linear scan of the masks
+	std::vector<std::unique_ptr<VkEngineArchetype>> mArchetypes{};
+	std::unordered_map<ComponentMask, VkEngineArchetype*> mArchetypesByMask{};
+	std::vector<EntityRecord> mRecords{};
+	std::vector<u32> mFreeIndices{};
+	// Scratch of destroyEntities
+	std::vector<Entity> mDestroyBatch{};
+	u32 mAliveCount = 0;
+	u64 mStructureVersion = 0;
+};
+
+
+template <typename... Ts>
+Entity VkEngineWorld::createEntity(Ts... components) {
+	VkEngineArchetype& archetype = getArchetype(componentMask<Ts...>());
+	const Entity entity = allocateEntity(archetype);
+	const u32 row = mRecords[entity.index].row;
+	(new (archetype.getComponent(row, ComponentRegistry::getId<Ts>())) Ts(std::move(components)), ...);
+	return entity;
+}
+
+template <typename... Ts>
+void VkEngineWorld::createEntities(const u32 count, std::vector<Entity>& entities, const Ts&... components) {
+	VkEngineArchetype& archetype = getArchetype(componentMask<Ts...>());
+	archetype.reserve(archetype.getEntityCount() + count);
+	const auto freeIndices = static_cast<u32>(mFreeIndices.size());
+	if (count > freeIndices) {
+		mRecords.reserve(mRecords.size() + count - freeIndices);
+	}
+	entities.reserve(entities.size() + count);
+
+	for (u32 i = 0; i < count; ++i) {
+		const Entity entity = allocateEntity(archetype);
+		const u32 row = mRecords[entity.index].row;
+		(new (archetype.getComponent(row, ComponentRegistry::getId<Ts>())) Ts(components), ...);
+		entities.push_back(entity);
+	}
+}
+
+template <typename T>
+T& VkEngineWorld::addComponent(const Entity entity, T component) {
+	assert(isAlive(entity) && "Adding a component to a dead entity");
+	const ComponentId id = ComponentRegistry::getId<T>();
+	const EntityRecord& record = mRecords[entity.index];
+	if ((record.archetype->getMask() & ComponentMask{1} << id) != 0) {
+		T& existing = *reinterpret_cast<T*>(record.archetype->getComponent(record.row, id));
+		existing = std::move(component);
+		return existing;
+	}
+
+	VkEngineArchetype& target = getAddEdge(*record.archetype, id);
+	moveEntity(entity, target);
+	return *new (target.getComponent(record.row, id)) T(std::move(component));
+}
+
+template <typename T>
+void VkEngineWorld::removeComponent(const Entity entity) {
+	assert(isAlive(entity) && "Removing a component from a dead entity");
+	const ComponentId id = ComponentRegistry::getId<T>();
+	const EntityRecord& record = mRecords[entity.index];
+	if ((record.archetype->getMask() & ComponentMask{1} << id) != 0) {
+		moveEntity(entity, getRemoveEdge(*record.archetype, id));
+	}
+}
+
+template <typename T>
+T* VkEngineWorld::getComponent(const Entity entity) const {
+	if (!isAlive(entity)) {
+		return nullptr;
+	}
+	const ComponentId id = ComponentRegistry::getId<T>();
+	const EntityRecord& record = mRecords[entity.index];
+	if ((record.archetype->getMask() & ComponentMask{1} << id) == 0) {
+		return nullptr;
+	}
+	return reinterpret_cast<T*>(record.archetype->getComponent(record.row, id));
+}
+
+template <typename... Ts>
+void VkEngineWorld::collectChunks(std::vector<EcsChunk>& chunks) const {
+	const ComponentMask mask = componentMask<Ts...>();
+	chunks.clear();
+	for (const auto& archetype : mArchetypes) {
+		if ((archetype->getMask() & mask) == mask) {
+			chunks.insert(chunks.end(), archetype->getChunks().begin(), archetype->getChunks().end());
+		}
+	}
+}
+
+template <typename... Ts, typename Fn>
+void VkEngineWorld::forEachChunk(Fn&& fn) const {
+	const ComponentMask mask = componentMask<Ts...>();
+	for (const auto& archetype : mArchetypes) {
+		if ((archetype->getMask() & mask) != mask) {
+			continue;
+		}
+		for (const EcsChunk& chunk : archetype->getChunks()) {
+			fn(chunk.count, chunk.getEntities(), chunk.getColumn<Ts>()...);
+		}
+	}
+}
+
+template <typename... Ts, typename Fn>
+void VkEngineWorld::forEach(Fn&& fn) const {
+	forEachChunk<Ts...>([&](const u32 count, const Entity* entities, Ts*... columns) {
+		for (u32 i = 0; i < count; ++i) {
+			fn(entities[i], columns[i]...);
+		}
+	});
+}
+
+template <typename... Ts>
+u32 VkEngineWorld::count() const {
+	const ComponentMask mask = componentMask<Ts...>();
+	u32 total = 0;
+	for (const auto& archetype : mArchetypes) {
+		if ((archetype->getMask() & mask) == mask) {
+			total += archetype->getEntityCount();
+		}
+	}
+	return total;
+}
 }  // namespace vke
+
+
+template <>
+struct std::hash<vke::Entity> {
+	std::size_t operator()(const vke::Entity& entity) const noexcept { return std::hash<u64>{}(entity.getId()); }
+};
@@ -0,0 +1,129 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/types.hpp"
+
+namespace vke {
+
+class VkEngineModel;
+
+// 32 bit generational handle of a resource of type T held by a VkEngineResourceRegistry. The low bits index the slot
+// of the resource, the high bits are the generation of the slot it was handed out with. Releasing the resource bumps
+// the generation, every handle still around then fails to resolve in O(1) instead of reaching whatever reuses the
+// slot. The generation wraps after GENERATION_MASK + 1 releases of a single slot.
+template <typename T>
+struct ResourceHandle {
+	static constexpr u32 INDEX_BITS = 20;
+	static constexpr u32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static constexpr u32 GENERATION_MASK = ~0u >> INDEX_BITS;
+	static constexpr u32 INVALID = ~0u;
+
+	u32 value = INVALID;
+
+	[[nodiscard]] static ResourceHandle make(const u32 index, const u32 generation) {
+		return {.value = generation << INDEX_BITS | index};
+	}
+
+	[[nodiscard]] bool isValid() const { return value != INVALID; }
+	[[nodiscard]] u32 getIndex() const { return value & INDEX_MASK; }
+	[[nodiscard]] u32 getGeneration() const { return value >> INDEX_BITS; }
+	bool operator==(const ResourceHandle&) const = default;
+};
+
+using MeshHandle = ResourceHandle<VkEngineModel>;
+
+// Slots of the resources of one type. A released resource stays alive until the frames that may still use it are
+// done, only then is it destroyed and its slot recycled.
+template <typename T>
+class ResourcePool {
+   public:
+	using Handle = ResourceHandle<T>;
+
+	Handle add(std::unique_ptr<T> resource) {
+		assert(resource != nullptr && "Added a null resource");
+		u32 index = 0;
+		if (!mFreeSlots.empty()) {
+			index = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		} else {
+			index = static_cast<u32>(mSlots.size());
+			// The last index would make the handle of generation GENERATION_MASK read as INVALID
+			if (index >= Handle::INDEX_MASK) {
+				throw std::runtime_error("Resource pool is full");
+			}
+			mSlots.emplace_back();
+		}
+
+		Slot& slot = mSlots[index];
+		slot.resource = std::move(resource);
+		++mCount;
+		return Handle::make(index, slot.generation);
+	}
+
+	// Null when the handle is invalid or its resource was released, even if it is not destroyed yet
+	[[nodiscard]] T* get(const Handle handle) const {
+		if (handle.getIndex() >= mSlots.size()) {
+			return nullptr;
+		}
+		const Slot& slot = mSlots[handle.getIndex()];
+		return slot.generation == handle.getGeneration() ? slot.resource.get() : nullptr;
+	}
+
+	// Invalidates the handle right away, the resource is destroyed by the first collect at or past `frame`
+	void release(const Handle handle, const u64 frame) {
+		if (get(handle) == nullptr) {
+			assert(false && "Released a stale resource handle");
+			return;
+		}
+		Slot& slot = mSlots[handle.getIndex()];
+		slot.generation = (slot.generation + 1) & Handle::GENERATION_MASK;
+		mReleased.push_back({.index = handle.getIndex(), .frame = frame});
+		--mCount;
+	}
+
+	// Destroys the resources released up to `frame` and recycles their slots
+	void collect(const u64 frame) {
+		// Released in frame order, the ready ones are a prefix
+		const auto ready = std::ranges::find_if(mReleased, [frame](const Release& release) {
+			return release.frame > frame;
+		});
+		for (auto it = mReleased.begin(); it != ready; ++it) {
+			mSlots[it->index].resource.reset();
+			mFreeSlots.push_back(it->index);
+		}
+		mReleased.erase(mReleased.begin(), ready);
+	}
+
+	// Live resources, the released ones waiting for their frame are not counted
+	[[nodiscard]] u32 getCount() const { return mCount; }
+	[[nodiscard]] u32 getReleasedCount() const { return static_cast<u32>(mReleased.size()); }
+	// One past the highest index handed out, for callers keeping arrays indexed by handle
+	[[nodiscard]] u32 getCapacity() const { return static_cast<u32>(mSlots.size()); }
+
+   private:
+	struct Slot {
+		std::unique_ptr<T> resource{};
+		u32 generation = 0;
+	};
+
+	struct Release {
+		u32 index = 0;
+		u64 frame = 0;
+	};
+
+	std::vector<Slot> mSlots{};
+	std::vector<u32> mFreeSlots{};
+	std::vector<Release> mReleased{};
+	u32 mCount = 0;
+};
+
+}  // namespace vke
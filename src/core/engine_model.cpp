@@ -32,6 +32,10 @@ VkEngineModel::VkEngineModel(std::shared_ptr<VkEngineDevice> device, const MeshD
     : mDevice{std::move(device)}, mIndexCount{meshData.pIndices.size()} {
 	createIndexBuffers(meshData.pIndices);
 	createVertexBuffers(meshData.pVertices);
+	createPositionBuffer(meshData.pVertices);
+	computeBounds(meshData.pVertices);
+
+	mLods.push_back({.firstIndex = 0, .indexCount = static_cast<u32>(mIndexCount)});
 }
 
 VkEngineModel::~VkEngineModel() { VKINFO("Destroyed model"); }
@@ -55,6 +59,18 @@ std::array<VkVertexInputAttributeDescription, 4> VkEngineModel::getAttributeDesc
 }
 
 
+std::array<VkVertexInputBindingDescription, 1> VkEngineModel::getPositionBindingDescriptions() {
+	return std::array{VkVertexInputBindingDescription{
+	    .binding = 0, .stride = sizeof(glm::vec3), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX}};
+}
+
+
+std::array<VkVertexInputAttributeDescription, 1> VkEngineModel::getPositionAttributeDescriptions() {
+	return std::array{VkVertexInputAttributeDescription{
+	    .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = 0}};
+}
+
+
 void VkEngineModel::bind(const VkCommandBuffer* const commandBuffer) const {
 	constexpr std::array<VkDeviceSize, 1> offsets{};
 	vkCmdBindVertexBuffers(*commandBuffer, 0, 1, &mVertexBuffer->getBuffer(), offsets.data());
@@ -62,8 +78,16 @@ void VkEngineModel::bind(const VkCommandBuffer* const commandBuffer) const {
 }
 
 
-void VkEngineModel::draw(const VkCommandBuffer* const commandBuffer) const {
-	vkCmdDrawIndexed(*commandBuffer, static_cast<uint32_t>(mIndexCount), 1, 0, 0, 0);
+void VkEngineModel::bindPositions(const VkCommandBuffer* const commandBuffer) const {
+	constexpr std::array<VkDeviceSize, 1> offsets{};
+	vkCmdBindVertexBuffers(*commandBuffer, 0, 1, &mPositionBuffer->getBuffer(), offsets.data());
+	vkCmdBindIndexBuffer(*commandBuffer, mIndexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+}
+
+
+void VkEngineModel::draw(const VkCommandBuffer* const commandBuffer, const u32 instanceCount,
+                         const u32 firstInstance) const {
+	vkCmdDrawIndexed(*commandBuffer, static_cast<uint32_t>(mIndexCount), instanceCount, 0, 0, firstInstance);
 }
 
 
@@ -103,8 +127,42 @@ void VkEngineModel::createVertexBuffers(const std::span<const Vertex>& vertices)
 }
 
 
+void VkEngineModel::createPositionBuffer(const std::span<const Vertex>& vertices) {
+	mPositions.resize(vertices.size());
+	std::ranges::transform(vertices, mPositions.begin(), &Vertex::mPosition);
+	createVkBuffer(std::span<const glm::vec3>(mPositions), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, mPositionBuffer);
+}
+
+
 void VkEngineModel::createIndexBuffers(const std::span<const u32>& indices) {
 	createVkBuffer(indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, mIndexBuffer);
+	mIndices.assign(indices.begin(), indices.end());
+}
+
+
+void VkEngineModel::computeBounds(const std::span<const Vertex>& vertices) {
+	if (vertices.empty()) {
+		return;
+	}
+
+	// Centered on the AABB, not minimal but a single pass and tight enough for culling
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
+	for (const auto& vertex : vertices) {
+		min = glm::min(min, vertex.mPosition);
+		max = glm::max(max, vertex.mPosition);
+	}
+
+	const glm::vec3 center = (min + max) * 0.5f;
+	float radiusSquared = 0.f;
+	for (const auto& vertex : vertices) {
+		const glm::vec3 offset = vertex.mPosition - center;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
+
+	mBoundingSphere = glm::vec4(center, std::sqrt(radiusSquared));
+	mBoundsMin = min;
+	mBoundsMax = max;
 }
 
 std::unique_ptr<VkEngineModel> VkEngineModel::createModelFromFile(std::shared_ptr<VkEngineDevice> device, const std::string& filepath) {
@@ -11,6 +11,7 @@
 // glm
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
+#include <limits>
 #include <span>
 #include <utils/memory.hpp>
 
@@ -33,6 +34,9 @@ class VkEngineModel {
 
 	static std::array<VkVertexInputBindingDescription, 1> getBindingDescriptions();
 	static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions();
+	// Position only stream at binding 0, location 0, for passes that only need depth
+	static std::array<VkVertexInputBindingDescription, 1> getPositionBindingDescriptions();
+	static std::array<VkVertexInputAttributeDescription, 1> getPositionAttributeDescriptions();
 
 
 	struct MeshData {
@@ -50,6 +54,13 @@ class VkEngineModel {
 		}
 	};
 
+	// Contiguous range of the index buffer drawn while the viewer is closer than maxDistance
+	struct Lod {
+		u32 firstIndex = 0;
+		u32 indexCount = 0;
+		float maxDistance = std::numeric_limits<float>::max();
+	};
+
 	VkEngineModel(std::shared_ptr<VkEngineDevice> device, const MeshData& meshData);
 
 	~VkEngineModel();
@@ -61,7 +72,20 @@ class VkEngineModel {
 	static std::unique_ptr<VkEngineModel> createModelFromFile(std::shared_ptr<VkEngineDevice> device,
 	                                                          const std::string& filepath);
 	void bind(const VkCommandBuffer* commandBuffer) const;
-	void draw(const VkCommandBuffer* commandBuffer) const;
+	// Binds the position stream in place of the interleaved vertices, the index buffer is shared
+	void bindPositions(const VkCommandBuffer* commandBuffer) const;
+	void draw(const VkCommandBuffer* commandBuffer, u32 instanceCount = 1, u32 firstInstance = 0) const;
+
+	[[nodiscard]] u32 getIndexCount() const { return static_cast<u32>(mIndexCount); }
+	[[nodiscard]] const std::vector<Lod>& getLods() const { return mLods; }
+	// Object space bounding sphere, center in xyz and radius in w
+	[[nodiscard]] const glm::vec4& getBoundingSphere() const { return mBoundingSphere; }
+	// Object space axis aligned box around the vertices
+	[[nodiscard]] const glm::vec3& getBoundsMin() const { return mBoundsMin; }
+	[[nodiscard]] const glm::vec3& getBoundsMax() const { return mBoundsMax; }
+	// Host copies of the positions and indices, read by the CPU occlusion culler
+	[[nodiscard]] const std::vector<glm::vec3>& getPositions() const { return mPositions; }
+	[[nodiscard]] const std::vector<u32>& getIndices() const { return mIndices; }
 
    private:
 	template <typename T>
@@ -71,13 +95,25 @@ class VkEngineModel {
 
 	void createVertexBuffers(const std::span<const Vertex>& vertices);
 
+	void createPositionBuffer(const std::span<const Vertex>& vertices);
+
 	void createIndexBuffers(const std::span<const u32>& indices);
 
+	void computeBounds(const std::span<const Vertex>& vertices);
+
 	std::unique_ptr<VkEngineBuffer> mVertexBuffer{};
 	std::unique_ptr<VkEngineBuffer> mIndexBuffer{};
+	// Copy of the vertex positions, tightly packed so depth only passes fetch 12 bytes per vertex instead of a Vertex
+	std::unique_ptr<VkEngineBuffer> mPositionBuffer{};
+	std::vector<glm::vec3> mPositions{};
+	std::vector<u32> mIndices{};
 	std::shared_ptr<VkEngineDevice> mDevice{};
 
 	VkCommandBuffer mCommandBuffer = VK_NULL_HANDLE;
 	size_t mIndexCount = 0;
+	std::vector<Lod> mLods{};
+	glm::vec4 mBoundingSphere{0.f};
+	glm::vec3 mBoundsMin{0.f};
+	glm::vec3 mBoundsMax{0.f};
 };
 }  // namespace vke
\ No newline at end of file
@@ -120,6 +120,11 @@ void VkEnginePipeline::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo)
 	    // Optional
 	};
 
+	const auto bindingDescriptions = VkEngineModel::getBindingDescriptions();
+	const auto attributeDescriptions = VkEngineModel::getAttributeDescriptions();
+	configInfo.bindingDescriptions = {bindingDescriptions.begin(), bindingDescriptions.end()};
+	configInfo.attributeDescriptions = {attributeDescriptions.begin(), attributeDescriptions.end()};
+
 	configInfo.pDynamicStateEnables = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
 
 	configInfo.dynamicStateInfo = {
@@ -130,6 +135,29 @@ void VkEnginePipeline::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo)
 	};
 }
 
+void VkEnginePipeline::depthPrepassConfigInfo(PipelineConfigInfo& configInfo) {
+	configInfo.attachmentFormats.color = VK_FORMAT_UNDEFINED;
+
+	const auto bindingDescriptions = VkEngineModel::getPositionBindingDescriptions();
+	const auto attributeDescriptions = VkEngineModel::getPositionAttributeDescriptions();
+	configInfo.bindingDescriptions = {bindingDescriptions.begin(), bindingDescriptions.end()};
+	configInfo.attributeDescriptions = {attributeDescriptions.begin(), attributeDescriptions.end()};
+}
+
+void VkEnginePipeline::depthEqualConfigInfo(PipelineConfigInfo& configInfo) {
+	configInfo.depthStencilInfo.depthCompareOp = VK_COMPARE_OP_EQUAL;
+	configInfo.depthStencilInfo.depthWriteEnable = VK_FALSE;
+}
+
+void VkEnginePipeline::occlusionQueryConfigInfo(PipelineConfigInfo& configInfo) {
+	configInfo.attachmentFormats.color = VK_FORMAT_UNDEFINED;
+	configInfo.bindingDescriptions.clear();
+	configInfo.attributeDescriptions.clear();
+	configInfo.rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+	configInfo.depthStencilInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+	configInfo.depthStencilInfo.depthWriteEnable = VK_FALSE;
+}
+
 char* VkEnginePipeline::readFile(const std::string& filename, size_t& bufferSize) {
 	std::ifstream file{filename, std::ios::ate | std::ios::binary};
 
@@ -152,17 +180,21 @@ void VkEnginePipeline::createGraphicsPipeline(const std::string& vertShader, con
 	assert(configInfo.pipelineLayout != VK_NULL_HANDLE &&
 	       "Cannot create graphics pipeline: no pipelineLayout provided in "
 	       "configInfo");
-	assert(configInfo.renderPass != VK_NULL_HANDLE &&
-	       "Cannot create graphics pipeline: no renderPass provided in "
+	assert((configInfo.attachmentFormats.color != VK_FORMAT_UNDEFINED ||
+	        configInfo.attachmentFormats.depth != VK_FORMAT_UNDEFINED) &&
+	       "Cannot create graphics pipeline: no attachment format provided in "
 	       "configInfo");
 
+	const bool hasFragment = !fragShader.empty();
 	size_t vertShaderSize = 0;
 	size_t fragShaderSize = 0;
 	char* vertShaderCode = readFile(vertShader, vertShaderSize);
-	char* fragShaderCode = readFile(fragShader, fragShaderSize);
+	char* fragShaderCode = hasFragment ? readFile(fragShader, fragShaderSize) : nullptr;
 
 	createShaderModule(vertShaderCode, vertShaderSize, &mShaders.pVertShaderModule);
-	createShaderModule(fragShaderCode, fragShaderSize, &mShaders.pFragShaderModule);
+	if (hasFragment) {
+		createShaderModule(fragShaderCode, fragShaderSize, &mShaders.pFragShaderModule);
+	}
 
 	std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{
 	    {{.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -182,20 +214,30 @@ void VkEnginePipeline::createGraphicsPipeline(const std::string& vertShader, con
 	      .pName = "main",
 	      .pSpecializationInfo = nullptr}}};
 
-	const auto bindingDescriptions = VkEngineModel::getBindingDescriptions();
-	const auto attributeDescriptions = VkEngineModel::getAttributeDescriptions();
-
 	const VkPipelineVertexInputStateCreateInfo vertexInputInfo{
 	    .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-	    .vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size()),
-	    .pVertexBindingDescriptions = bindingDescriptions.data(),
-	    .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
-	    .pVertexAttributeDescriptions = attributeDescriptions.data(),
+	    .vertexBindingDescriptionCount = static_cast<uint32_t>(configInfo.bindingDescriptions.size()),
+	    .pVertexBindingDescriptions = configInfo.bindingDescriptions.data(),
+	    .vertexAttributeDescriptionCount = static_cast<uint32_t>(configInfo.attributeDescriptions.size()),
+	    .pVertexAttributeDescriptions = configInfo.attributeDescriptions.data(),
 	};
 
+	// Drawn inside dynamic rendering, so only the attachment formats are needed, not a render pass
+	const bool hasColor = configInfo.attachmentFormats.color != VK_FORMAT_UNDEFINED;
+	const VkPipelineRenderingCreateInfo renderingInfo{
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+	    .colorAttachmentCount = hasColor ? 1u : 0u,
+	    .pColorAttachmentFormats = hasColor ? &configInfo.attachmentFormats.color : nullptr,
+	    .depthAttachmentFormat = configInfo.attachmentFormats.depth,
+	};
+
+	VkPipelineColorBlendStateCreateInfo colorBlendInfo = configInfo.colorBlendInfo;
+	colorBlendInfo.attachmentCount = hasColor ? colorBlendInfo.attachmentCount : 0;
+
 	const VkGraphicsPipelineCreateInfo pipelineInfo{
 	    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-	    .stageCount = 2,
+	    .pNext = &renderingInfo,
+	    .stageCount = hasFragment ? 2u : 1u,
 	    .pStages = shaderStages.data(),
 	    .pVertexInputState = &vertexInputInfo,
 	    .pInputAssemblyState = &configInfo.inputAssemblyInfo,
@@ -203,11 +245,11 @@ void VkEnginePipeline::createGraphicsPipeline(const std::string& vertShader, con
 	    .pRasterizationState = &configInfo.rasterizationInfo,
 	    .pMultisampleState = &configInfo.multisampleInfo,
 	    .pDepthStencilState = &configInfo.depthStencilInfo,
-	    .pColorBlendState = &configInfo.colorBlendInfo,
+	    .pColorBlendState = &colorBlendInfo,
 	    .pDynamicState = &configInfo.dynamicStateInfo,
 	    .layout = configInfo.pipelineLayout,
-	    .renderPass = configInfo.renderPass,
-	    .subpass = configInfo.subpass,
+	    .renderPass = VK_NULL_HANDLE,
+	    .subpass = 0,
 	    .basePipelineHandle = VK_NULL_HANDLE,
 	    .basePipelineIndex = -1,
 	};
@@ -232,12 +274,15 @@ void VkEnginePipeline::createGraphicsPipeline(const std::string& vertShader, con
 	};
 
 	VK_CHECK(vkCreateQueryPool(mDevice->getDevice(), &queryPoolInfo, nullptr, &mPipelineData.queryPool));
+	mPipelineData.pipelineStatistics = queryPoolInfo.pipelineStatistics;
 
 	VK_CHECK(
 	    vkCreateGraphicsPipelines(mDevice->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pGraphicsPipeline));
 
 	Memory::freeMemory(vertShaderCode, vertShaderSize, MEMORY_TAG_TEXTURE);
-	Memory::freeMemory(fragShaderCode, fragShaderSize, MEMORY_TAG_TEXTURE);
+	if (hasFragment) {
+		Memory::freeMemory(fragShaderCode, fragShaderSize, MEMORY_TAG_TEXTURE);
+	}
 }
 
 void VkEnginePipeline::getQueryPool() {
@@ -260,4 +305,47 @@ void VkEnginePipeline::createShaderModule(const char* const code, const size_t c
 
 	VK_CHECK(vkCreateShaderModule(mDevice->getDevice(), &createInfo, nullptr, shaderModule));
 }
-}  // namespace vke
\ No newline at end of file
+
+
+VkEngineComputePipeline::VkEngineComputePipeline(std::shared_ptr<VkEngineDevice> device, const std::string& compShader,
+                                                 const VkPipelineLayout pipelineLayout)
+    : mDevice(std::move(device)) {
+	assert(pipelineLayout != VK_NULL_HANDLE && "Cannot create compute pipeline: no pipelineLayout provided");
+
+	size_t compShaderSize = 0;
+	char* compShaderCode = VkEnginePipeline::readFile(compShader, compShaderSize);
+
+	const VkShaderModuleCreateInfo moduleInfo = {.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+	                                             .codeSize = compShaderSize,
+	                                             .pCode = reinterpret_cast<const u32*>(compShaderCode)};
+
+	VK_CHECK(vkCreateShaderModule(mDevice->getDevice(), &moduleInfo, nullptr, &pCompShaderModule));
+
+	const VkComputePipelineCreateInfo pipelineInfo{
+	    .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+	    .stage = {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	              .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+	              .module = pCompShaderModule,
+	              .pName = "main"},
+	    .layout = pipelineLayout,
+	    .basePipelineHandle = VK_NULL_HANDLE,
+	    .basePipelineIndex = -1,
+	};
+
+	VK_CHECK(
+	    vkCreateComputePipelines(mDevice->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pComputePipeline));
+
+	Memory::freeMemory(compShaderCode, compShaderSize, MEMORY_TAG_TEXTURE);
+}
+
+VkEngineComputePipeline::~VkEngineComputePipeline() {
+	VKINFO("Destroyed compute pipeline");
+
+	vkDestroyShaderModule(mDevice->getDevice(), pCompShaderModule, nullptr);
+	vkDestroyPipeline(mDevice->getDevice(), pComputePipeline, nullptr);
+}
+
+void VkEngineComputePipeline::bind(const VkCommandBuffer* const commandBuffer) const {
+	vkCmdBindPipeline(*commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pComputePipeline);
+}
+}  // namespace vke
@@ -12,8 +12,15 @@ namespace vke {
 // Forward declaration
 struct PipelineConfigInfo;
 
+// Formats of the attachments of the dynamic rendering pass a pipeline draws in, UNDEFINED when there is none
+struct AttachmentFormats {
+	VkFormat color = VK_FORMAT_UNDEFINED;
+	VkFormat depth = VK_FORMAT_UNDEFINED;
+};
+
 struct VkPipelineData {
 	VkQueryPool queryPool = VK_NULL_HANDLE;
+	VkQueryPipelineStatisticFlags pipelineStatistics = 0;
 	std::vector<uint64_t> pipelineStats{};
 	std::vector<std::string> pipelineStatNames{};
 };
@@ -22,6 +29,7 @@ class VkEnginePipeline {
    public:
 	explicit VkEnginePipeline() = delete;
 
+	// An empty fragShader builds a vertex only pipeline, for depth only passes
 	VkEnginePipeline(std::shared_ptr<VkEngineDevice> device, const std::string& vertShader, const std::string& fragShader,
 	                 const PipelineConfigInfo& configInfo);
 
@@ -32,14 +40,21 @@ class VkEnginePipeline {
 	VkEnginePipeline& operator=(const VkEnginePipeline&) = delete;
 
 	static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
+	// Depth only pass ahead of the main pass: no color attachment and positions as the only vertex input
+	static void depthPrepassConfigInfo(PipelineConfigInfo& configInfo);
+	// Main pass after a depth prepass: only the fragments that won the prepass are shaded, depth is left untouched
+	static void depthEqualConfigInfo(PipelineConfigInfo& configInfo);
+	// Bounding boxes drawn inside occlusion queries: vertices generated in the shader, depth tested but not written,
+	// both faces rasterized
+	static void occlusionQueryConfigInfo(PipelineConfigInfo& configInfo);
 
 	void bind(const VkCommandBuffer* commandBuffer) const;
 	void getQueryPool();
 	const VkPipelineData& getPipelineData() const { return mPipelineData; }
 
-   private:
 	static char* readFile(const std::string& filename, size_t& bufferSize);
 
+   private:
 	void createGraphicsPipeline(const std::string& vertShader, const std::string& fragShader,
 	                            const PipelineConfigInfo& configInfo);
 
@@ -53,6 +68,27 @@ class VkEnginePipeline {
 	VkPipelineData mPipelineData{};
 };
 
+class VkEngineComputePipeline {
+   public:
+	explicit VkEngineComputePipeline() = delete;
+
+	VkEngineComputePipeline(std::shared_ptr<VkEngineDevice> device, const std::string& compShader,
+	                        VkPipelineLayout pipelineLayout);
+
+	~VkEngineComputePipeline();
+
+	VkEngineComputePipeline(const VkEngineComputePipeline&) = delete;
+
+	VkEngineComputePipeline& operator=(const VkEngineComputePipeline&) = delete;
+
+	void bind(const VkCommandBuffer* commandBuffer) const;
+
+   private:
+	std::shared_ptr<VkEngineDevice> mDevice{};
+	VkPipeline pComputePipeline = VK_NULL_HANDLE;
+	VkShaderModule pCompShaderModule = VK_NULL_HANDLE;
+};
+
 struct PipelineConfigInfo {
 	PipelineConfigInfo() { VkEnginePipeline::defaultPipelineConfigInfo(*this); }
 
@@ -67,11 +103,12 @@ struct PipelineConfigInfo {
 	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
 	VkPipelineColorBlendStateCreateInfo colorBlendInfo{};
 	VkPipelineDepthStencilStateCreateInfo depthStencilInfo{};
+	std::vector<VkVertexInputBindingDescription> bindingDescriptions{};
+	std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
 	std::array<VkDynamicState, 2> pDynamicStateEnables{};
 	VkPipelineDynamicStateCreateInfo dynamicStateInfo{};
-	VkRenderPass renderPass = VK_NULL_HANDLE;
+	AttachmentFormats attachmentFormats{};
 	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-	u32 subpass = 0;
 };
 
 
@@ -0,0 +1,14 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_resources.hpp"
+
+namespace vke {
+
+void VkEngineResourceRegistry::beginFrame() {
+	++mFrame;
+	std::apply([this](auto&... pools) { (pools.collect(mFrame), ...); }, mPools);
+}
+
+}  // namespace vke
@@ -0,0 +1,62 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <tuple>
+
+#include "engine_handles.hpp"
+#include "engine_model.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Owns the meshes shared across systems and hands out 32 bit handles to them, so that the components and the hot
+// loops carry plain integers instead of reference counted pointers. A release only takes effect on the GPU side once
+// the frames in flight that may have recorded the resource are done.
+class VkEngineResourceRegistry : NO_COPY_NOR_MOVE {
+   public:
+	template <typename T>
+	ResourceHandle<T> add(std::unique_ptr<T> resource) {
+		return getWritablePool<T>().add(std::move(resource));
+	}
+
+	// Null when the handle is stale, see ResourcePool::get
+	template <typename T>
+	[[nodiscard]] T* get(const ResourceHandle<T> handle) const {
+		return getPool<T>().get(handle);
+	}
+
+	template <typename T>
+	[[nodiscard]] bool isValid(const ResourceHandle<T> handle) const {
+		return get(handle) != nullptr;
+	}
+
+	// The handle stops resolving now, the resource is destroyed MAX_FRAMES_IN_FLIGHT frames later
+	template <typename T>
+	void release(const ResourceHandle<T> handle) {
+		getWritablePool<T>().release(handle, mFrame + MAX_FRAMES_IN_FLIGHT);
+	}
+
+	// Called once per frame after the fence of the frame about to be recorded was waited on, destroys the resources no
+	// frame in flight can reference anymore
+	void beginFrame();
+
+	template <typename T>
+	[[nodiscard]] const ResourcePool<T>& getPool() const {
+		return std::get<ResourcePool<T>>(mPools);
+	}
+
+   private:
+	template <typename T>
+	[[nodiscard]] ResourcePool<T>& getWritablePool() {
+		return std::get<ResourcePool<T>>(mPools);
+	}
+
+	std::tuple<ResourcePool<VkEngineModel>> mPools{};
+	u64 mFrame = 0;
+};
+
+}  // namespace vke
@@ -0,0 +1,167 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_scene_graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "utils/logger.hpp"
+
+namespace vke {
+
+bool VkEngineSceneGraph::setParent(VkEngineWorld& world, const Entity child, const Entity parent) {
+	if (!world.isAlive(child) || !world.isAlive(parent)) {
+		VKWARN("Parenting a dead entity");
+		return false;
+	}
+
+	// Only a member can have descendants, so the walk up from the parent is skipped for the others
+	if (world.getComponent<HierarchyComponent>(child) != nullptr) {
+		for (Entity ancestor = parent; ancestor.isValid();) {
+			if (ancestor == child) {
+				VKWARN("Parenting an entity to one of its descendants");
+				return false;
+			}
+			const auto* hierarchy = world.getComponent<HierarchyComponent>(ancestor);
+			ancestor = hierarchy != nullptr ? hierarchy->parent : Entity{};
+		}
+	}
+
+	if (world.getComponent<HierarchyComponent>(parent) == nullptr) {
+		world.addComponent(parent, HierarchyComponent{});
+	}
+	world.addComponent(child, HierarchyComponent{.parent = parent});
+	mLayoutDirty = true;
+	return true;
+}
+
+void VkEngineSceneGraph::clearParent(VkEngineWorld& world, const Entity child) {
+	if (auto* hierarchy = world.getComponent<HierarchyComponent>(child)) {
+		hierarchy->parent = Entity{};
+		mLayoutDirty = true;
+	}
+}
+
+u32 VkEngineSceneGraph::update(VkEngineWorld& world, ThreadPool& threadPool, bool rebuildAll) {
+	if (mLayoutDirty || mStructureVersion != world.getStructureVersion()) {
+		const auto start = std::chrono::high_resolution_clock::now();
+		layout(world);
+		mStats.layoutMs =
+		    std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		mLayoutDirty = false;
+		mStructureVersion = world.getStructureVersion();
+		// The copy of the world matrices went with the old layout
+		rebuildAll = true;
+	}
+
+	std::atomic<u32> updated{0};
+	const auto levelCount = static_cast<u32>(mLevelOffsets.size() - 1);
+	u32 level = 0;
+	while (level < levelCount) {
+		const u32 begin = mLevelOffsets[level];
+		const u32 width = mLevelOffsets[level + 1] - begin;
+		if (width > NODES_PER_TASK) {
+			// Siblings never depend on each other, a wide level is split over the pool
+			threadPool.parallelFor(width, NODES_PER_TASK, [&](const u32 first, const u32 last, u32 /*workerIndex*/) {
+				updated.fetch_add(propagate(begin + first, begin + last, rebuildAll), std::memory_order::relaxed);
+			});
+			++level;
+			continue;
+		}
+
+		u32 last = level + 1;
+		while (last < levelCount && mLevelOffsets[last + 1] - mLevelOffsets[last] <= NODES_PER_TASK) {
+			++last;
+		}
+		updated.fetch_add(propagate(begin, mLevelOffsets[last], rebuildAll), std::memory_order::relaxed);
+		level = last;
+	}
+
+	mStats.nodes = static_cast<u32>(mEntities.size());
+	mStats.levels = levelCount;
+	mStats.updatedNodes = updated.load(std::memory_order::relaxed);
+	return mStats.updatedNodes;
+}
+
+void VkEngineSceneGraph::layout(VkEngineWorld& world) {
+	mMembers.clear();
+	world.forEach<HierarchyComponent, TransformComponent, WorldMatrixComponent>(
+	    [&](const Entity entity, const HierarchyComponent& hierarchy, TransformComponent& transform,
+	        WorldMatrixComponent& matrix) {
+		    mMembers.push_back(
+		        {.entity = entity, .parent = hierarchy.parent, .transform = &transform, .matrix = &matrix});
+	    });
+
+	mMemberIds.resize(mMembers.size());
+	std::ranges::transform(mMembers, mMemberIds.begin(), [](const Member& member) { return member.entity.getId(); });
+	std::ranges::sort(mMemberIds);
+	const auto isMember = [&](const Entity entity) {
+		return entity.isValid() && std::ranges::binary_search(mMemberIds, entity.getId());
+	};
+
+	// Children of the same parent end up side by side
+	std::ranges::sort(mMembers, {}, [](const Member& member) { return member.parent.getId(); });
+
+	mEntities.clear();
+	mParents.clear();
+	mTransforms.clear();
+	mMatrices.clear();
+	mLevelOffsets.clear();
+	const auto addNode = [&](const Member& member, const u32 parent) {
+		mEntities.push_back(member.entity);
+		mParents.push_back(parent);
+		mTransforms.push_back(member.transform);
+		mMatrices.push_back(member.matrix);
+	};
+
+	// A member whose parent is dead or not a member is a root, the members of a cycle are never reached
+	for (const Member& member : mMembers) {
+		if (!isMember(member.parent)) {
+			addNode(member, NO_PARENT);
+		}
+	}
+
+	u32 levelBegin = 0;
+	while (levelBegin < mEntities.size()) {
+		const auto levelEnd = static_cast<u32>(mEntities.size());
+		mLevelOffsets.push_back(levelBegin);
+		for (u32 node = levelBegin; node < levelEnd; ++node) {
+			const u64 id = mEntities[node].getId();
+			const auto children =
+			    std::ranges::equal_range(mMembers, id, {}, [](const Member& member) { return member.parent.getId(); });
+			for (const Member& child : children) {
+				addNode(child, node);
+			}
+		}
+		levelBegin = levelEnd;
+	}
+	mLevelOffsets.push_back(static_cast<u32>(mEntities.size()));
+
+	mWorldMatrices.resize(mEntities.size());
+	mDirty.resize(mEntities.size());
+}
+
+u32 VkEngineSceneGraph::propagate(const u32 begin, const u32 end, const bool rebuildAll) {
+	u32 updated = 0;
+	for (u32 node = begin; node < end; ++node) {
+		const u32 parent = mParents[node];
+		TransformComponent& transform = *mTransforms[node];
+		const bool dirty = rebuildAll || transform.isDirty() || (parent != NO_PARENT && mDirty[parent] != 0);
+		mDirty[node] = dirty ? 1 : 0;
+		if (!dirty) {
+			continue;
+		}
+
+		const glm::mat4 local = transform.mat4();
+		mWorldMatrices[node] = parent == NO_PARENT ? local : mWorldMatrices[parent] * local;
+		mMatrices[node]->matrix = mWorldMatrices[node];
+		transform.clearDirty();
+		++updated;
+	}
+	return updated;
+}
+
+}  // namespace vke
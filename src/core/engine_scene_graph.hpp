@@ -0,0 +1,82 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "engine_ecs.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Member of a transform hierarchy. Its TransformComponent is relative to the parent, its WorldMatrixComponent is still
+// in world space. The roots of a hierarchy carry one with an invalid parent.
+struct HierarchyComponent {
+	Entity parent{};
+};
+
+struct SceneGraphStats {
+	u32 nodes = 0;
+	u32 levels = 0;
+	u32 updatedNodes = 0;
+	float layoutMs = 0.f;
+};
+
+// World matrices of the hierarchy members. The nodes are laid out breadth first, level after level and the siblings
+// side by side, so a parent always precedes its children and propagation is one linear pass. A node is rebuilt when
+// its own transform or one of its ancestors changed, an untouched subtree costs a flag check per node.
+class VkEngineSceneGraph {
+   public:
+	// Nodes of a level handed to a single worker. Narrower levels are swept in a row on the calling thread.
+	static constexpr u32 NODES_PER_TASK = 1024;
+
+	// Makes both entities hierarchy members as needed. Returns false when `parent` is `child` or one of its
+	// descendants, or when either is dead.
+	bool setParent(VkEngineWorld& world, Entity child, Entity parent);
+	// The child becomes a root with its subtree, its transform is now in world space
+	void clearParent(VkEngineWorld& world, Entity child);
+
+	// Lays the nodes out again if the hierarchy or the structure of the world changed, then rebuilds the world matrices
+	// of the dirty nodes, of all of them with `rebuildAll`. Returns the number of nodes rebuilt.
+	u32 update(VkEngineWorld& world, ThreadPool& threadPool, bool rebuildAll);
+
+	[[nodiscard]] const SceneGraphStats& getStats() const { return mStats; }
+
+   private:
+	static constexpr u32 NO_PARENT = ~0u;
+
+	void layout(VkEngineWorld& world);
+	// Nodes [begin, end) in order, the range may span levels
+	u32 propagate(u32 begin, u32 end, bool rebuildAll);
+
+	// Breadth first order
+	std::vector<Entity> mEntities{};
+	std::vector<u32> mParents{};
+	std::vector<TransformComponent*> mTransforms{};
+	std::vector<WorldMatrixComponent*> mMatrices{};
+	// Copy of the world matrices in node order, the children read their parent from it
+	std::vector<glm::mat4> mWorldMatrices{};
+	// Whether the node was rebuilt by the current update, so its children are too
+	std::vector<u8> mDirty{};
+	// Level l holds the nodes [mLevelOffsets[l], mLevelOffsets[l + 1])
+	std::vector<u32> mLevelOffsets{0};
+
+	// Scratch of layout
+	struct Member {
+		Entity entity;
+		Entity parent;
+		TransformComponent* transform;
+		WorldMatrixComponent* matrix;
+	};
+	std::vector<Member> mMembers{};
+	std::vector<u64> mMemberIds{};
+
+	bool mLayoutDirty = true;
+	u64 mStructureVersion = 0;
+	SceneGraphStats mStats{};
+};
+
+}  // namespace vke
@@ -23,10 +23,10 @@ VkEngineSwapChain::VkEngineSwapChain(std::shared_ptr<VkEngineDevice> device, con
 void VkEngineSwapChain::init() {
 	createSwapChain();
 	createImageViews();
-	createRenderPass();
-	createDepthResources();
-	createFramebuffers();
 	createSyncObjects();
+
+	// Depth is a transient image of the render graph, only its format is picked here
+	mDepthFormat = findDepthFormat();
 }
 
 
@@ -166,138 +166,6 @@ void VkEngineSwapChain::createImageViews() {
 	}
 }
 
-void VkEngineSwapChain::createRenderPass() {
-	constexpr VkAttachmentDescription depthAttachment{
-	    .format = VK_FORMAT_D24_UNORM_S8_UINT,
-	    .samples = VK_SAMPLE_COUNT_1_BIT,
-	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-	    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-	    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-	    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-	    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-	    .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-	};
-
-	const VkAttachmentDescription colorAttachment{
-	    .format = getSwapChainImageFormat(),
-	    .samples = VK_SAMPLE_COUNT_1_BIT,
-	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-	    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-	    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-	    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-	    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-	    .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-	};
-
-
-	static constexpr VkAttachmentReference depthAttachmentRef{
-	    .attachment = 1,
-	    .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-	};
-
-
-	static constexpr VkAttachmentReference colorAttachmentRef{
-	    .attachment = 0,
-	    .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-	};
-
-	constexpr VkSubpassDescription subpass{
-	    .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-	    .colorAttachmentCount = 1,
-	    .pColorAttachments = &colorAttachmentRef,
-	    .pDepthStencilAttachment = &depthAttachmentRef,
-	};
-
-	constexpr VkSubpassDependency dependency{
-	    .srcSubpass = VK_SUBPASS_EXTERNAL,
-	    .dstSubpass = 0,
-	    .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-	    .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-	    .srcAccessMask = 0,
-	    .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-	};
-
-	const std::array attachments = {colorAttachment, depthAttachment};
-
-	const VkRenderPassCreateInfo renderPassInfo{
-	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-	    .attachmentCount = static_cast<u32>(attachments.size()),
-	    .pAttachments = attachments.data(),
-	    .subpassCount = 1,
-	    .pSubpasses = &subpass,
-	    .dependencyCount = 1,
-	    .pDependencies = &dependency,
-	};
-
-	VK_CHECK(vkCreateRenderPass(mDevice->getDevice(), &renderPassInfo, nullptr, &pRenderPass));
-	mDeletionQueue.push_function([this]() { vkDestroyRenderPass(mDevice->getDevice(), pRenderPass, nullptr); });
-}
-
-void VkEngineSwapChain::createFramebuffers() {
-	ppSwapChainFramebuffers = Memory::allocMemory<VkFramebuffer>(getImageCount(), MEMORY_TAG_VULKAN);
-
-	for (size_t i = 0; i < getImageCount(); ++i) {
-		std::array attachments = {mSwapChainImages.ppImageViews[i], mDepthImages.ppImageViews[i]};
-
-		const VkFramebufferCreateInfo framebufferInfo{
-		    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-		    .renderPass = pRenderPass,
-		    .attachmentCount = static_cast<u32>(attachments.size()),
-		    .pAttachments = attachments.data(),
-		    .width = getSwapChainExtent().width,
-		    .height = getSwapChainExtent().height,
-		    .layers = 1,
-		};
-
-		VK_CHECK(vkCreateFramebuffer(mDevice->getDevice(), &framebufferInfo, nullptr, &ppSwapChainFramebuffers[i]));
-	}
-}
-
-void VkEngineSwapChain::createDepthResources() {
-	mDepthImages.ppImages = Memory::allocMemory<VkImage>(getImageCount(), MEMORY_TAG_VULKAN);
-	mDepthImages.ppImageMemorys = Memory::allocMemory<VmaAllocation>(getImageCount(), MEMORY_TAG_VULKAN);
-	mDepthImages.ppImageViews = Memory::allocMemory<VkImageView>(getImageCount(), MEMORY_TAG_VULKAN);
-
-	mDepthFormat = findDepthFormat();
-
-	for (size_t i = 0; i < getImageCount(); i++) {
-		const VkImageCreateInfo imageInfo{
-		    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-		    .imageType = VK_IMAGE_TYPE_2D,
-		    .format = mDepthFormat,
-		    .extent = {.width = getSwapChainExtent().width, .height = getSwapChainExtent().height, .depth = 1},
-		    .mipLevels = 1,
-		    .arrayLayers = 1,
-		    .samples = VK_SAMPLE_COUNT_1_BIT,
-		    .tiling = VK_IMAGE_TILING_OPTIMAL,
-		    .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-		    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-		    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-		};
-
-		mDevice->createImageWithInfo(imageInfo, mDepthImages.ppImages[i], mDepthImages.ppImageMemorys[i]);
-
-		const VkImageViewCreateInfo viewInfo{
-		    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-		    .image = mDepthImages.ppImages[i],
-		    .viewType = VK_IMAGE_VIEW_TYPE_2D,
-		    .format = mDepthFormat,
-		    .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
-		                         .baseMipLevel = 0,
-		                         .levelCount = 1,
-		                         .baseArrayLayer = 0,
-		                         .layerCount = 1},
-		};
-
-		VK_CHECK(vkCreateImageView(mDevice->getDevice(), &viewInfo, nullptr, &mDepthImages.ppImageViews[i]));
-		mDeletionQueue.push_function([this, i]() {
-			vkDestroyImageView(mDevice->getDevice(), mDepthImages.ppImageViews[i], nullptr);
-			vmaDestroyImage(mDevice->getAllocator(), mDepthImages.ppImages[i], mDepthImages.ppImageMemorys[i]);
-		});
-	}
-}
-
-
 void VkEngineSwapChain::createSyncObjects() {
 	mSyncPrimitives.ppInFlightImages = Memory::allocMemory<VkFence>(getImageCount(), MEMORY_TAG_VULKAN);
 
@@ -21,20 +21,20 @@ class VkEngineSwapChain {
 
 	VkEngineSwapChain& operator=(const VkEngineSwapChain&) = delete;
 
-	[[nodiscard]] const VkFramebuffer& getFrameBuffer(const u32 index) const { return ppSwapChainFramebuffers[index]; }
+	[[nodiscard]] const VkImage& getImage(const u32 index) const { return mSwapChainImages.ppImages[index]; }
 
 	[[nodiscard]] const VkImageView& getImageView(const u32 index) const {
 		return mSwapChainImages.ppImageViews[index];
 	}
 
 	[[nodiscard]] const VkSwapchainKHR& getSwapChain() const { return pSwapChain; }
-	[[nodiscard]] const VkRenderPass& getRenderPass() const { return pRenderPass; }
 	[[nodiscard]] std::shared_ptr<VkEngineDevice> getEngineDevice() const { return mDevice; }
 	[[nodiscard]] const VkFormat& getSwapChainImageFormat() const { return mSwapChainImageFormat; }
 	[[nodiscard]] const VkExtent2D& getSwapChainExtent() const { return mSwapChainExtent; }
 	[[nodiscard]] u32 getWidth() const { return mSwapChainExtent.width; }
 	[[nodiscard]] u32 getHeight() const { return mSwapChainExtent.height; }
 	[[nodiscard]] u32 getImageCount() const { return mSwapChainImageCount; }
+	[[nodiscard]] const VkFormat& getDepthFormat() const { return mDepthFormat; }
 	[[nodiscard]] VkFormat findDepthFormat() const;
 
 	VkResult acquireNextImage(u32* imageIndex) const;
@@ -57,12 +57,6 @@ class VkEngineSwapChain {
 
 	void createImageViews();
 
-	void createDepthResources();
-
-	void createRenderPass();
-
-	void createFramebuffers();
-
 	void createSyncObjects();
 
 	// Helper functions
@@ -75,18 +69,15 @@ class VkEngineSwapChain {
 	std::shared_ptr<VkEngineDevice> mDevice{};
 	DeletionQueue mDeletionQueue{};
 
-	VkRenderPass pRenderPass = VK_NULL_HANDLE;
 	VkSwapchainKHR pSwapChain = VK_NULL_HANDLE;
 
 	VkImageRessource mSwapChainImages{};
-	VkImageRessource mDepthImages{};
 	SyncPrimitives mSyncPrimitives{};
 	VkFormat mSwapChainImageFormat{};
 	VkFormat mDepthFormat{};
 	VkExtent2D mSwapChainExtent{};
 	VkExtent2D mWindowExtent{};
 
-	VkFramebuffer* ppSwapChainFramebuffers = nullptr;
 	std::shared_ptr<VkEngineSwapChain> pOldSwapChain = nullptr;
 
 	u32 mSwapChainImageCount = 0;
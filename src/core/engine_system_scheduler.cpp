@@ -0,0 +1,113 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_system_scheduler.hpp"
+
+#include <thread>
+
+namespace vke {
+
+namespace {
+float elapsedMs(const std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+VkEngineSystemScheduler::VkEngineSystemScheduler(ThreadPool& threadPool) : mThreadPool(threadPool) {}
+
+VkEngineSystemScheduler::SystemId VkEngineSystemScheduler::addSystem(std::string name, const SystemAccess& access,
+                                                                     SystemFunc function) {
+	mSystems.push_back({.name = std::move(name), .access = access, .function = std::move(function)});
+	mPendingDependencies = std::make_unique<std::atomic<u32>[]>(mSystems.size());
+	return static_cast<SystemId>(mSystems.size() - 1);
+}
+
+void VkEngineSystemScheduler::run() {
+	const auto systemCount = static_cast<SystemId>(mSystems.size());
+
+	// An edge from every earlier conflicting system. The edges a chain makes redundant only cost a decrement.
+	mRoots.clear();
+	u32 enabledCount = 0;
+	for (SystemId s = 0; s < systemCount; ++s) {
+		System& system = mSystems[s];
+		system.dependents.clear();
+		system.timing = {};
+		if (!system.enabled) {
+			continue;
+		}
+
+		u32 dependencies = 0;
+		for (SystemId earlier = 0; earlier < s; ++earlier) {
+			if (mSystems[earlier].enabled && mSystems[earlier].access.conflictsWith(system.access)) {
+				mSystems[earlier].dependents.push_back(s);
+				++dependencies;
+			}
+		}
+		mPendingDependencies[s].store(dependencies, std::memory_order::relaxed);
+		if (dependencies == 0) {
+			mRoots.push_back(s);
+		}
+		++enabledCount;
+	}
+
+	mFrameStart = std::chrono::steady_clock::now();
+	mRemainingSystems.store(enabledCount, std::memory_order::relaxed);
+
+	JobCounter counter;
+	for (const SystemId root : mRoots) {
+		schedule(root, counter);
+	}
+
+	// Helps the pool while running the main thread systems as soon as they are ready
+	while (mRemainingSystems.load(std::memory_order::acquire) != 0) {
+		SystemId ready = 0;
+		bool mainThreadReady = false;
+		{
+			std::lock_guard lock(mMainThreadMutex);
+			if (!mMainThreadReady.empty()) {
+				ready = mMainThreadReady.back();
+				mMainThreadReady.pop_back();
+				mainThreadReady = true;
+			}
+		}
+
+		if (mainThreadReady) {
+			runSystem(ready, 0, counter);
+		} else if (!mThreadPool.tryRunJob()) {
+			std::this_thread::yield();
+		}
+	}
+	mThreadPool.wait(counter);
+
+	mFrameMs = elapsedMs(mFrameStart);
+}
+
+void VkEngineSystemScheduler::schedule(const SystemId system, JobCounter& counter) {
+	if (mSystems[system].access.mainThread) {
+		std::lock_guard lock(mMainThreadMutex);
+		mMainThreadReady.push_back(system);
+		return;
+	}
+
+	mThreadPool.run([this, system, &counter](const u32 workerIndex) { runSystem(system, workerIndex, counter); },
+	                counter);
+}
+
+void VkEngineSystemScheduler::runSystem(const SystemId system, const u32 workerIndex, JobCounter& counter) {
+	System& current = mSystems[system];
+	current.timing.workerIndex = workerIndex;
+	current.timing.startMs = elapsedMs(mFrameStart);
+	current.function();
+	current.timing.endMs = elapsedMs(mFrameStart);
+	current.timing.ran = true;
+
+	for (const SystemId dependent : current.dependents) {
+		if (mPendingDependencies[dependent].fetch_sub(1, std::memory_order::acq_rel) == 1) {
+			schedule(dependent, counter);
+		}
+	}
+	mRemainingSystems.fetch_sub(1, std::memory_order::release);
+}
+
+}  // namespace vke
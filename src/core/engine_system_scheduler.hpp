@@ -0,0 +1,119 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine_ecs.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Components a system reads and writes. State living outside the world, like the camera, is declared by its type the
+// same way and takes a component id of its own.
+struct SystemAccess {
+	ComponentMask reads = 0;
+	ComponentMask writes = 0;
+	// GLFW input and windows may only be touched from the main thread
+	bool mainThread = false;
+
+	template <typename... Ts>
+	SystemAccess& read() {
+		reads |= componentMask<Ts...>();
+		return *this;
+	}
+
+	template <typename... Ts>
+	SystemAccess& write() {
+		writes |= componentMask<Ts...>();
+		return *this;
+	}
+
+	SystemAccess& onMainThread() {
+		mainThread = true;
+		return *this;
+	}
+
+	// Two systems conflict when one of them writes what the other touches
+	[[nodiscard]] bool conflictsWith(const SystemAccess& other) const {
+		return (writes & (other.reads | other.writes)) != 0 || (reads & other.writes) != 0;
+	}
+};
+
+// When a system ran during the last frame, in ms since the scheduler started the frame, and on which worker
+struct SystemTiming {
+	float startMs = 0.f;
+	float endMs = 0.f;
+	u32 workerIndex = 0;
+	bool ran = false;
+};
+
+// Runs the systems of a frame on the thread pool, each one after the earlier systems it conflicts with. Systems
+// touching disjoint components run concurrently, and may themselves spread their work with parallelFor.
+class VkEngineSystemScheduler {
+   public:
+	using SystemId = u32;
+	using SystemFunc = std::function<void()>;
+
+	explicit VkEngineSystemScheduler(ThreadPool& threadPool);
+
+	VkEngineSystemScheduler(const VkEngineSystemScheduler&) = delete;
+
+	VkEngineSystemScheduler& operator=(const VkEngineSystemScheduler&) = delete;
+
+	// Conflicting systems run in the order they were added
+	SystemId addSystem(std::string name, const SystemAccess& access, SystemFunc function);
+
+	// A disabled system is left out of the graph, the systems depending on it no longer wait for it
+	void setEnabled(SystemId system, bool enabled) { mSystems[system].enabled = enabled; }
+
+	// Builds the dependency graph of the enabled systems and runs it, blocks until every system has run. Must be
+	// called from the thread that created the pool, the main thread systems run on it.
+	void run();
+
+	[[nodiscard]] u32 getSystemCount() const { return static_cast<u32>(mSystems.size()); }
+	[[nodiscard]] const std::string& getName(const SystemId system) const { return mSystems[system].name; }
+	// Of the last run
+	[[nodiscard]] const SystemTiming& getTiming(const SystemId system) const { return mSystems[system].timing; }
+	[[nodiscard]] float getFrameMs() const { return mFrameMs; }
+
+   private:
+	struct System {
+		std::string name;
+		SystemAccess access;
+		SystemFunc function;
+		bool enabled = true;
+		// Rebuilt by every run
+		std::vector<SystemId> dependents{};
+		SystemTiming timing{};
+	};
+
+	// Queues the system on the pool, or for the main thread
+	void schedule(SystemId system, JobCounter& counter);
+	void runSystem(SystemId system, u32 workerIndex, JobCounter& counter);
+
+	ThreadPool& mThreadPool;
+	std::vector<System> mSystems{};
+	// Per system, dependencies still running during a run
+	std::unique_ptr<std::atomic<u32>[]> mPendingDependencies{};
+	std::vector<SystemId> mRoots{};
+	std::atomic<u32> mRemainingSystems{0};
+
+	// Main thread systems whose dependencies are done
+	std::mutex mMainThreadMutex{};
+	std::vector<SystemId> mMainThreadReady{};
+
+	std::chrono::steady_clock::time_point mFrameStart{};
+	float mFrameMs = 0.f;
+};
+
+}  // namespace vke
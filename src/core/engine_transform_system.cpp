@@ -0,0 +1,212 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_transform_system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <numeric>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VKE_TRANSFORMS_SSE2 1
+#endif
+
+namespace vke {
+namespace {
+// Rotation and scale part of the 8 matrices of an iteration, column major, the translation is copied as is
+constexpr u32 BASIS_COMPONENTS = 9;
+using BasisLanes = std::array<std::array<float, 8>, BASIS_COMPONENTS>;
+
+#if defined(__AVX2__) || defined(VKE_TRANSFORMS_SSE2)
+#if defined(__AVX2__)
+constexpr u32 LANES = 8;
+using Floats = __m256;
+
+Floats load(const float* source) { return _mm256_loadu_ps(source); }
+void store(float* destination, const Floats value) { _mm256_storeu_ps(destination, value); }
+Floats set1(const float value) { return _mm256_set1_ps(value); }
+Floats add(const Floats a, const Floats b) { return _mm256_add_ps(a, b); }
+Floats sub(const Floats a, const Floats b) { return _mm256_sub_ps(a, b); }
+Floats mul(const Floats a, const Floats b) { return _mm256_mul_ps(a, b); }
+#else
+constexpr u32 LANES = 4;
+using Floats = __m128;
+
+Floats load(const float* source) { return _mm_loadu_ps(source); }
+void store(float* destination, const Floats value) { _mm_storeu_ps(destination, value); }
+Floats set1(const float value) { return _mm_set1_ps(value); }
+Floats add(const Floats a, const Floats b) { return _mm_add_ps(a, b); }
+Floats sub(const Floats a, const Floats b) { return _mm_sub_ps(a, b); }
+Floats mul(const Floats a, const Floats b) { return _mm_mul_ps(a, b); }
+#endif
+
+// Lanes [offset, offset + LANES) of the batch into the columns [lane, lane + LANES) of `basis`, the rotation matrix of
+// each unit quaternion scaled by column
+void buildBasis(const TransformBatchSoA& batch, const u32 offset, const u32 lane, BasisLanes& basis) {
+	const Floats x = load(batch.rotationX.data() + offset);
+	const Floats y = load(batch.rotationY.data() + offset);
+	const Floats z = load(batch.rotationZ.data() + offset);
+	const Floats w = load(batch.rotationW.data() + offset);
+	const Floats scaleX = load(batch.scaleX.data() + offset);
+	const Floats scaleY = load(batch.scaleY.data() + offset);
+	const Floats scaleZ = load(batch.scaleZ.data() + offset);
+
+	// Doubled once so that every term below is a single product
+	const Floats x2 = add(x, x);
+	const Floats y2 = add(y, y);
+	const Floats z2 = add(z, z);
+	const Floats xx = mul(x, x2);
+	const Floats yy = mul(y, y2);
+	const Floats zz = mul(z, z2);
+	const Floats xy = mul(x, y2);
+	const Floats xz = mul(x, z2);
+	const Floats yz = mul(y, z2);
+	const Floats wx = mul(w, x2);
+	const Floats wy = mul(w, y2);
+	const Floats wz = mul(w, z2);
+	const Floats one = set1(1.f);
+
+	store(basis[0].data() + lane, mul(scaleX, sub(one, add(yy, zz))));
+	store(basis[1].data() + lane, mul(scaleX, add(xy, wz)));
+	store(basis[2].data() + lane, mul(scaleX, sub(xz, wy)));
+	store(basis[3].data() + lane, mul(scaleY, sub(xy, wz)));
+	store(basis[4].data() + lane, mul(scaleY, sub(one, add(xx, zz))));
+	store(basis[5].data() + lane, mul(scaleY, add(yz, wx)));
+	store(basis[6].data() + lane, mul(scaleZ, add(xz, wy)));
+	store(basis[7].data() + lane, mul(scaleZ, sub(yz, wx)));
+	store(basis[8].data() + lane, mul(scaleZ, sub(one, add(xx, yy))));
+}
+#endif
+}  // namespace
+
+void TransformBatchSoA::resize(const u32 count) {
+	for (auto* component : {&translationX, &translationY, &translationZ, &rotationX, &rotationY, &rotationZ, &rotationW,
+	                        &scaleX, &scaleY, &scaleZ}) {
+		component->resize(count);
+	}
+	indices.resize(count);
+}
+
+void TransformBatchSoA::set(const u32 lane, const TransformComponent& transform, const u32 index) {
+	const glm::vec3& translation = transform.getTranslation();
+	const glm::quat& rotation = transform.getRotation();
+	const glm::vec3& scale = transform.getScale();
+	translationX[lane] = translation.x;
+	translationY[lane] = translation.y;
+	translationZ[lane] = translation.z;
+	rotationX[lane] = rotation.x;
+	rotationY[lane] = rotation.y;
+	rotationZ[lane] = rotation.z;
+	rotationW[lane] = rotation.w;
+	scaleX[lane] = scale.x;
+	scaleY[lane] = scale.y;
+	scaleZ[lane] = scale.z;
+	indices[lane] = index;
+}
+
+void buildWorldMatrices(const TransformBatchSoA& batch, const u32 count, WorldMatrixComponent* const matrices) {
+	u32 i = 0;
+
+#if defined(__AVX2__) || defined(VKE_TRANSFORMS_SSE2)
+	BasisLanes basis{};
+	for (; i + 8 <= count; i += 8) {
+		for (u32 lane = 0; lane < 8; lane += LANES) {
+			buildBasis(batch, i + lane, lane, basis);
+		}
+
+		for (u32 lane = 0; lane < 8; ++lane) {
+			matrices[batch.indices[i + lane]].matrix = {
+			    {basis[0][lane], basis[1][lane], basis[2][lane], 0.f},
+			    {basis[3][lane], basis[4][lane], basis[5][lane], 0.f},
+			    {basis[6][lane], basis[7][lane], basis[8][lane], 0.f},
+			    {batch.translationX[i + lane], batch.translationY[i + lane], batch.translationZ[i + lane], 1.f}};
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		const float x = batch.rotationX[i];
+		const float y = batch.rotationY[i];
+		const float z = batch.rotationZ[i];
+		const float w = batch.rotationW[i];
+		const float sx = batch.scaleX[i];
+		const float sy = batch.scaleY[i];
+		const float sz = batch.scaleZ[i];
+		const float xx = 2.f * x * x;
+		const float yy = 2.f * y * y;
+		const float zz = 2.f * z * z;
+		const float xy = 2.f * x * y;
+		const float xz = 2.f * x * z;
+		const float yz = 2.f * y * z;
+		const float wx = 2.f * w * x;
+		const float wy = 2.f * w * y;
+		const float wz = 2.f * w * z;
+
+		matrices[batch.indices[i]].matrix = {
+		    {sx * (1.f - yy - zz), sx * (xy + wz), sx * (xz - wy), 0.f},
+		    {sy * (xy - wz), sy * (1.f - xx - zz), sy * (yz + wx), 0.f},
+		    {sz * (xz + wy), sz * (yz - wx), sz * (1.f - xx - yy), 0.f},
+		    {batch.translationX[i], batch.translationY[i], batch.translationZ[i], 1.f}};
+	}
+}
+
+VkEngineTransformSystem::VkEngineTransformSystem(ThreadPool& threadPool)
+    : mThreadPool(threadPool), mWorkerBatches(threadPool.getThreadCount()) {}
+
+void VkEngineTransformSystem::update(VkEngineWorld& world) {
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	world.collectChunks<TransformComponent, WorldMatrixComponent>(mChunks);
+	std::erase_if(mChunks, [](const EcsChunk& chunk) {
+		return (chunk.archetype->getMask() & componentMask<HierarchyComponent>()) != 0;
+	});
+	const auto chunkCount = static_cast<u32>(mChunks.size());
+	mChunkCounts.assign(chunkCount, 0);
+
+	// A batch holds at most one chunk, the widest archetype decides the size
+	u32 maxRows = 0;
+	for (const EcsChunk& chunk : mChunks) {
+		maxRows = std::max(maxRows, chunk.archetype->getChunkCapacity());
+	}
+	for (auto& batch : mWorkerBatches) {
+		if (batch.indices.size() < maxRows) {
+			batch.resize(maxRows);
+		}
+	}
+
+	// A chunk only writes the matrices of its own rows, the workers never touch the same matrix
+	mThreadPool.parallelFor(chunkCount, CHUNKS_PER_TASK, [&](const u32 begin, const u32 end, const u32 workerIndex) {
+		TransformBatchSoA& batch = mWorkerBatches[workerIndex];
+		for (u32 c = begin; c < end; ++c) {
+			const EcsChunk& chunk = mChunks[c];
+			auto* const transforms = chunk.getColumn<TransformComponent>();
+			u32 count = 0;
+			for (u32 row = 0; row < chunk.count; ++row) {
+				if (!mRebuildAll && !transforms[row].isDirty()) {
+					continue;
+				}
+				batch.set(count++, transforms[row], row);
+				transforms[row].clearDirty();
+			}
+
+			buildWorldMatrices(batch, count, chunk.getColumn<WorldMatrixComponent>());
+			mChunkCounts[c] = count;
+		}
+	});
+
+	const u32 hierarchyUpdates = mSceneGraph.update(world, mThreadPool, mRebuildAll);
+	mRebuildAll = false;
+
+	mStats = {
+	    .updatedTransforms = std::accumulate(mChunkCounts.begin(), mChunkCounts.end(), hierarchyUpdates),
+	    .updateMs =
+	        std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count(),
+	};
+}
+
+}  // namespace vke
@@ -0,0 +1,74 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "engine_ecs.hpp"
+#include "engine_scene_graph.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+struct TransformStats {
+	u32 updatedTransforms = 0;
+	float updateMs = 0.f;
+};
+
+// Transforms gathered in structure of arrays form, one lane per object, with the index of the matrix each one builds
+struct TransformBatchSoA {
+	std::vector<float> translationX{};
+	std::vector<float> translationY{};
+	std::vector<float> translationZ{};
+	std::vector<float> rotationX{};
+	std::vector<float> rotationY{};
+	std::vector<float> rotationZ{};
+	std::vector<float> rotationW{};
+	std::vector<float> scaleX{};
+	std::vector<float> scaleY{};
+	std::vector<float> scaleZ{};
+	std::vector<u32> indices{};
+
+	void resize(u32 count);
+	void set(u32 lane, const TransformComponent& transform, u32 index);
+};
+
+// Builds the matrices of lanes [0, count) of `batch` into matrices[batch.indices[lane]], 8 lanes per iteration (AVX2,
+// 2x SSE or scalar depending on the build). The rotations are quaternions, a matrix takes products and sums only.
+void buildWorldMatrices(const TransformBatchSoA& batch, u32 count, WorldMatrixComponent* matrices);
+
+// Keeps the WorldMatrixComponent of every entity with a TransformComponent up to date. Only the transforms written
+// since the last update are gathered and rebuilt, a still scene costs a scan of the flags. The hierarchy members are
+// left to the scene graph, which runs once the flat entities are done.
+class VkEngineTransformSystem {
+   public:
+	// ECS chunks scanned by a single worker at once
+	static constexpr u32 CHUNKS_PER_TASK = 16;
+
+	explicit VkEngineTransformSystem(ThreadPool& threadPool);
+
+	// Rebuilds the matrices of the dirty transforms and clears their flags
+	void update(VkEngineWorld& world);
+
+	// Makes the next update rebuild every matrix
+	void invalidate() { mRebuildAll = true; }
+
+	[[nodiscard]] const TransformStats& getStats() const { return mStats; }
+	[[nodiscard]] VkEngineSceneGraph& getSceneGraph() { return mSceneGraph; }
+	[[nodiscard]] const VkEngineSceneGraph& getSceneGraph() const { return mSceneGraph; }
+
+   private:
+	ThreadPool& mThreadPool;
+	std::vector<EcsChunk> mChunks{};
+	// One per worker, only ever touched by that worker
+	std::vector<TransformBatchSoA> mWorkerBatches{};
+	std::vector<u32> mChunkCounts{};
+	VkEngineSceneGraph mSceneGraph{};
+	bool mRebuildAll = false;
+	TransformStats mStats{};
+};
+
+}  // namespace vke
@@ -1,23 +1,129 @@
 #include "app.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <core/engine_controller.hpp>
+#include <core/engine_system_scheduler.hpp>
+#include <core/engine_transform_system.hpp>
 
+#include "engine_gpu_driven_system.hpp"
+#include "engine_occlusion_queries.hpp"
 #include "engine_render_system.hpp"
+#include "engine_spatial_system.hpp"
 #include "utils/logger.hpp"
 
 namespace vke {
 
-struct GlobalUBO {
-	glm::mat4 view;
-	glm::vec3 light = glm::normalize(glm::vec3(1.0f, -3.0f, -1.0f));
+enum class RenderMode : int {
+	Direct,
+	Instanced,
+	GpuDriven,
 };
 
+// Light counts the frame time is measured at by the light sweep, up to the largest count the UI allows
+constexpr std::array LIGHT_SWEEP_COUNTS{0, 500, 1000, 2500, 5000, 7500, 10000};
+// Grid sizes the instance sweep draws, each once per render mode recording its draws on the CPU
+constexpr std::array INSTANCE_SWEEP_COUNTS{10'000u, 25'000u, 50'000u, 100'000u};
+constexpr std::array INSTANCE_SWEEP_MODES{RenderMode::Direct, RenderMode::Instanced};
+constexpr std::array INSTANCE_SWEEP_MODE_NAMES{"direct", "instanced"};
+// Frames left to settle after a sweep changed the scene, then frames averaged per step
+constexpr u32 SWEEP_WARMUP_FRAMES = 30;
+constexpr u32 SWEEP_MEASURED_FRAMES = 120;
+
+namespace {
+// Average frame time of each step of a sweep, measured once the scene the step set up has settled
+class FrameSweep {
+   public:
+	explicit FrameSweep(const size_t stepCount) : mFrameMs(stepCount, 0.f) {}
+
+	void start() {
+		mStep = 0;
+		mFrames = 0;
+		mTime = 0.f;
+		std::ranges::fill(mFrameMs, 0.f);
+	}
+
+	// Accounts for a frame of the current step. True once the step is measured, the caller then sets up the next step,
+	// or its own scene again when the sweep is over.
+	bool addFrame(const float frameTime) {
+		if (++mFrames > SWEEP_WARMUP_FRAMES) {
+			mTime += frameTime;
+		}
+		if (mFrames < SWEEP_WARMUP_FRAMES + SWEEP_MEASURED_FRAMES) {
+			return false;
+		}
+
+		mFrameMs[mStep] = mTime * 1000.f / static_cast<float>(SWEEP_MEASURED_FRAMES);
+		mFrames = 0;
+		mTime = 0.f;
+		if (++mStep == static_cast<int>(mFrameMs.size())) {
+			mStep = -1;
+		}
+		return true;
+	}
+
+	[[nodiscard]] bool isRunning() const { return mStep >= 0; }
+	// Step being measured, -1 when no sweep runs
+	[[nodiscard]] int getStep() const { return mStep; }
+	[[nodiscard]] const std::vector<float>& getFrameMs() const { return mFrameMs; }
+
+   private:
+	std::vector<float> mFrameMs{};
+	int mStep = -1;
+	u32 mFrames = 0;
+	float mTime = 0.f;
+};
+
+// Height of a thread row of the system timeline
+constexpr float SYSTEM_TIMELINE_ROW_HEIGHT = 18.f;
+
+// One row per thread of the pool, with a bar per system of the last run spanning the time it took
+void drawSystemTimeline(const VkEngineSystemScheduler& scheduler, const u32 threadCount) {
+	const ImVec2 origin = ImGui::GetCursorScreenPos();
+	const ImVec2 size{std::max(ImGui::GetContentRegionAvail().x, 1.f),
+	                  SYSTEM_TIMELINE_ROW_HEIGHT * static_cast<float>(threadCount)};
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	drawList->AddRectFilled(origin, {origin.x + size.x, origin.y + size.y}, IM_COL32(30, 30, 30, 255));
+
+	const float pixelsPerMs = size.x / std::max(scheduler.getFrameMs(), 1e-3f);
+	const u32 systemCount = scheduler.getSystemCount();
+	for (u32 system = 0; system < systemCount; ++system) {
+		const SystemTiming& timing = scheduler.getTiming(system);
+		if (!timing.ran) {
+			continue;
+		}
+
+		const ImVec2 min{origin.x + timing.startMs * pixelsPerMs,
+		                 origin.y + SYSTEM_TIMELINE_ROW_HEIGHT * static_cast<float>(timing.workerIndex)};
+		const ImVec2 max{std::max(origin.x + timing.endMs * pixelsPerMs, min.x + 1.f),
+		                 min.y + SYSTEM_TIMELINE_ROW_HEIGHT - 1.f};
+		const float hue = static_cast<float>(system) / static_cast<float>(systemCount);
+		drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.6f, 0.7f));
+
+		const std::string& name = scheduler.getName(system);
+		if (ImGui::CalcTextSize(name.c_str()).x < max.x - min.x) {
+			drawList->AddText({min.x + 2.f, min.y + 2.f}, IM_COL32_WHITE, name.c_str());
+		}
+		if (ImGui::IsMouseHoveringRect(min, max)) {
+			ImGui::SetTooltip("%s: %.3f ms on thread %u", name.c_str(), timing.endMs - timing.startMs,
+			                  timing.workerIndex);
+		}
+	}
+	ImGui::Dummy(size);
+}
+}  // namespace
+
 App::App()
     : mVkWindow(std::make_shared<VkEngineWindow>(WIDTH, HEIGHT, "VkEngine")),
       mVkDevice(std::make_shared<VkEngineDevice>(mVkWindow)),
       mVkRenderer(mVkDevice, mVkWindow) { // error
 	initImGUI();
+	pBindlessHeap = std::make_unique<VkEngineBindlessHeap>(mVkDevice);
+	pMaterialTable = std::make_unique<VkEngineMaterialTable>(mVkDevice, *pBindlessHeap);
+	createGridMaterials();
 	loadGameObjects();
 }
 
@@ -33,47 +139,106 @@ void App::initImGUI() const {
 	    .QueueFamily = mVkDevice->findPhysicalQueueFamilies().mGraphicsFamily.value(),
 	    .Queue = mVkDevice->getGraphicsQueue(),
 	    .DescriptorPool = mVkDevice->getDescriptorPool(),
-	    .RenderPass = mVkRenderer.getSwapChainRenderPass(),
 	    .MinImageCount = 2,
 	    .ImageCount = 2,
 	    .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
+	    .UseDynamicRendering = true,
 	};
 
+	// ImGui is drawn by a render graph pass, inside vkCmdBeginRendering
+	const VkFormat colorFormat = mVkRenderer.getAttachmentFormats().color;
+#if IMGUI_VERSION_NUM >= 19090
+	init_info.PipelineRenderingCreateInfo = {.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+	                                         .colorAttachmentCount = 1,
+	                                         .pColorAttachmentFormats = &colorFormat};
+#else
+	init_info.ColorAttachmentFormat = colorFormat;
+#endif
+
 	ImGui_ImplVulkan_Init(&init_info);
 }
 
 
 void App::run() {
-	VkEngineBuffer globalUBO{mVkDevice,
-	                         sizeof(GlobalUBO),
-	                         1,
-	                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-	                         VMA_ALLOCATION_CREATE_MAPPED_BIT,
-	                         VMA_MEMORY_USAGE_CPU_TO_GPU,
-	                         mVkDevice->getPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment};
-
-	const VkEngineRenderSystem renderSystem(mVkDevice, mVkRenderer.getSwapChainRenderPass());
+	VkEngineGlobalUniforms globalUniforms(mVkDevice);
+	VkEngineLightSystem lightSystem(mVkDevice);
+	VkEngineTransformSystem transformSystem(mThreadPool);
+	VkEngineSpatialSystem spatialSystem(mThreadPool, mResources);
+	VkEngineRenderSystem renderSystem(mVkDevice, mVkRenderer.getAttachmentFormats(), *pBindlessHeap, lightSystem,
+	                                  globalUniforms, mResources, mThreadPool);
+	VkEngineGpuDrivenSystem gpuDrivenSystem(mVkDevice, mVkRenderer.getAttachmentFormats(), *pBindlessHeap,
+	                                        lightSystem, globalUniforms, mResources);
+	VkEngineOcclusionQueries occlusionQueries(mVkDevice, mVkRenderer.getAttachmentFormats());
+	renderSystem.setSpatialIndex(&spatialSystem);
+	auto renderMode = RenderMode::Instanced;
+	int gridInstanceCount = 10000;
+	bool frustumCulling = renderSystem.isFrustumCullingEnabled();
+	bool parallelRecording = true;
+	bool depthPrepass = false;
+	bool occlusionCulling = gpuDrivenSystem.isOcclusionCullingEnabled();
+	bool cpuOcclusionCulling = renderSystem.isOcclusionCullingEnabled();
+	bool useOcclusionQueries = false;
+	bool conditionalRendering = occlusionQueries.isConditionalRenderingEnabled();
+	float occlusionQueryRadius = occlusionQueries.getMinRadius();
+	// Fragment shader invocations of the last frame drawn without and with the depth prepass, to compare overdraw
+	std::array<u64, 2> fragmentInvocations{};
+	bool lastFramePrepass = false;
+	int lightCount = 1000;
+	bool moveLights = true;
+	float lightTime = 0.f;
+	float elapsedTime = 0.f;
+	FrameSweep lightSweep(LIGHT_SWEEP_COUNTS.size());
+	// Step s draws INSTANCE_SWEEP_COUNTS[s / modes] objects with INSTANCE_SWEEP_MODES[s % modes]
+	FrameSweep instanceSweep(INSTANCE_SWEEP_COUNTS.size() * INSTANCE_SWEEP_MODES.size());
+	std::array<u32, INSTANCE_SWEEP_COUNTS.size() * INSTANCE_SWEEP_MODES.size()> instanceSweepDrawCalls{};
+	auto instanceSweepRestoreMode = renderMode;
+	// Last object picked with the mouse and how far along the ray
+	Entity pickedEntity{};
+	float pickedDistance = 0.f;
+
+	spawnLights(static_cast<u32>(lightCount));
 
 	VkEngineCamera camera{};
 	camera.setViewTarget({-1.0f, -2.0f, -2.0f}, {0.0f, 0.0f, 2.5f});
 
-	VkEngineGameObjects viewerObject = VkEngineGameObjects::createGameObject();
+	TransformComponent viewerTransform{};
 	constexpr KeyboardController cameraController{};
+	float frameTime = 0.f;
+
+	// Systems of the frame, ordered by what they declare to touch. The camera and the lights live outside the world and
+	// are declared by their type.
+	VkEngineSystemScheduler scheduler(mThreadPool);
+	scheduler.addSystem("camera", SystemAccess{}.write<VkEngineCamera>().onMainThread(), [&]() {
+		cameraController.moveInPlaneXZ(mVkWindow->getWindow(), frameTime, viewerTransform);
+		camera.setViewRotation(viewerTransform.getTranslation(), viewerTransform.getRotation());
+		camera.setPerspectiveProjection(glm::radians(50.f), mVkRenderer.getAspectRatio(), 0.1f, 1000.f);
+	});
+	const auto lightsSystem = scheduler.addSystem("lights", SystemAccess{}.write<Light>(), [&]() {
+		lightTime += frameTime;
+		animateLights(lightTime);
+	});
+	// Only the objects moved since the last frame are rebuilt, the culling and the draws read the matrices
+	scheduler.addSystem("transforms",
+	                    SystemAccess{}.read<HierarchyComponent>().write<TransformComponent, WorldMatrixComponent>(),
+	                    [&]() { transformSystem.update(mWorld); });
+	scheduler.addSystem("spatial index",
+	                    SystemAccess{}.read<WorldMatrixComponent, RenderComponent>().write<VkEngineSpatialSystem>(),
+	                    [&]() { spatialSystem.update(mWorld); });
+	const auto drawListSystem = scheduler.addSystem(
+	    "draw list",
+	    SystemAccess{}.read<VkEngineCamera, WorldMatrixComponent, RenderComponent, VkEngineSpatialSystem>(), [&]() {
+		    renderSystem.buildDrawList(mVkRenderer.getFrameIndex(), mWorld, camera,
+		                               renderMode == RenderMode::Instanced);
+	    });
 
 	auto currentTime = std::chrono::high_resolution_clock::now();
 	while (!mVkWindow->shouldClose()) {
 		glfwPollEvents();  // poll for events
 
 		auto newTime = std::chrono::high_resolution_clock::now();
-		const float frameTime = std::chrono::duration<float>(newTime - currentTime).count();
+		frameTime = std::chrono::duration<float>(newTime - currentTime).count();
 		currentTime = newTime;
-
-		cameraController.moveInPlaneXZ(mVkWindow->getWindow(), frameTime, viewerObject);
-		camera.setViewXYZ(viewerObject.mTransform.translation, viewerObject.mTransform.rotation);
-
-
-		const float aspect = mVkRenderer.getAspectRatio();
-		camera.setPerspectiveProjection(glm::radians(50.f), aspect, 0.1f, 1000.f);
+		elapsedTime += frameTime;
 
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
@@ -85,26 +250,315 @@ void App::run() {
 			            renderSystem.getPipeline()->getPipelineData().pipelineStats[i]);
 		}
 
+		// The statistics are those of the previous frame
+		fragmentInvocations[lastFramePrepass] = renderSystem.getPipeline()->getPipelineData().pipelineStats[5];
+
 		ImGui::Text("%s: %f %s", "Frame Time", frameTime * 1000, "ms");
+		ImGui::Combo("Render mode", reinterpret_cast<int*>(&renderMode), "Direct\0Instanced\0GPU driven\0");
+		if (renderMode == RenderMode::GpuDriven) {
+			// Everything the culling pass rejected never reaches input assembly
+			const u64 submitted = gpuDrivenSystem.getSubmittedPrimitiveCount();
+			const u64 assembled = renderSystem.getPipeline()->getPipelineData().pipelineStats[1];
+			ImGui::Text("Primitives submitted: %llu, culled: %llu", submitted,
+			            submitted > assembled ? submitted - assembled : 0ull);
+			if (ImGui::Checkbox("Occlusion culling", &occlusionCulling)) {
+				gpuDrivenSystem.setOcclusionCulling(occlusionCulling);
+			}
+			ImGui::Text("Visible objects: %u, occluded: %u", gpuDrivenSystem.getCullStats().visibleObjects,
+			            gpuDrivenSystem.getCullStats().occludedObjects);
+		} else {
+			ImGui::Text("Draw calls: %u, instances: %u, mesh binds avoided: %u",
+			            renderSystem.getRenderStats().drawCalls, renderSystem.getRenderStats().instances,
+			            renderSystem.getRenderStats().meshBindsAvoided);
+			if (ImGui::Checkbox("Frustum culling", &frustumCulling)) {
+				renderSystem.setFrustumCulling(frustumCulling);
+			}
+			if (renderMode == RenderMode::Direct) {
+				ImGui::Checkbox("Parallel recording", &parallelRecording);
+				ImGui::Checkbox("Occlusion queries", &useOcclusionQueries);
+			}
+			if (renderMode == RenderMode::Direct && useOcclusionQueries) {
+				ImGui::BeginDisabled(!occlusionQueries.hasConditionalRendering());
+				if (ImGui::Checkbox("Conditional rendering", &conditionalRendering)) {
+					occlusionQueries.setConditionalRendering(conditionalRendering);
+				}
+				ImGui::EndDisabled();
+				if (ImGui::SliderFloat("Min queried radius", &occlusionQueryRadius, 0.f, 10.f)) {
+					occlusionQueries.setMinRadius(occlusionQueryRadius);
+				}
+				const auto& queryStats = occlusionQueries.getStats();
+				ImGui::Text("Queries: %u, occluded: %u, draws skipped on the host: %u", queryStats.issuedQueries,
+				            queryStats.occludedQueries, queryStats.skippedDraws);
+			}
+			ImGui::Text("Visible objects: %u / %u (%u threads)", renderSystem.getRenderStats().visibleObjects,
+			            mWorld.getEntityCount(), mThreadPool.getThreadCount());
+			if (ImGui::Checkbox("CPU occlusion culling", &cpuOcclusionCulling)) {
+				renderSystem.setOcclusionCulling(cpuOcclusionCulling);
+			}
+			if (cpuOcclusionCulling) {
+				// Throughput of the software rasterizer and of the bounding box tests, in millions per second
+				const auto& occlusionStats = renderSystem.getOcclusionStats();
+				const float trianglesPerUs = static_cast<float>(occlusionStats.occluderTriangles) /
+				                             std::max(occlusionStats.rasterizeMs * 1e3f, 1.f);
+				const float testsPerUs =
+				    static_cast<float>(occlusionStats.testedObjects) / std::max(occlusionStats.testMs * 1e3f, 1.f);
+				ImGui::Text("Occluder triangles: %u (%.3f ms, %.1f M/s), occluded: %u / %u (%.3f ms, %.1f M/s)",
+				            occlusionStats.occluderTriangles, occlusionStats.rasterizeMs, trianglesPerUs,
+				            occlusionStats.occludedObjects, occlusionStats.testedObjects, occlusionStats.testMs,
+				            testsPerUs);
+			}
+			ImGui::Checkbox("Depth pre-pass", &depthPrepass);
+			const VkExtent2D extent = mVkRenderer.getSwapChainExtent();
+			const double pixelCount = std::max(1.0, static_cast<double>(extent.width) * extent.height);
+			ImGui::Text("Fragments per pixel: %.2f without pre-pass, %.2f with",
+			            static_cast<double>(fragmentInvocations[0]) / pixelCount,
+			            static_cast<double>(fragmentInvocations[1]) / pixelCount);
+		}
+		const auto& graphStats = mVkRenderer.getRenderGraph().getStats();
+		ImGui::Text("Render graph: %u passes (%u culled), %u barriers", graphStats.passes, graphStats.culledPasses,
+		            graphStats.barriers);
+		ImGui::Text("Transient memory: %.2f MiB (%.2f MiB without aliasing)",
+		            static_cast<double>(graphStats.transientMemory) / (1024.0 * 1024.0),
+		            static_cast<double>(graphStats.transientMemoryUnaliased) / (1024.0 * 1024.0));
+		ImGui::Text("Transforms updated: %u (%.3f ms)", transformSystem.getStats().updatedTransforms,
+		            transformSystem.getStats().updateMs);
+		const SceneGraphStats& sceneGraphStats = transformSystem.getSceneGraph().getStats();
+		ImGui::Text("Hierarchy: %u nodes in %u levels, %u updated", sceneGraphStats.nodes, sceneGraphStats.levels,
+		            sceneGraphStats.updatedNodes);
+		// The grid updates moved objects at a constant cost, BM_SpatialIndexFrame compares both indices per frame
+		int spatialIndexType = static_cast<int>(spatialSystem.getIndexType());
+		if (ImGui::Combo("Spatial index", &spatialIndexType, "BVH\0Grid\0")) {
+			spatialSystem.setIndexType(static_cast<SpatialIndexType>(spatialIndexType));
+		}
+		const SpatialStats& spatialStats = spatialSystem.getStats();
+		if (spatialSystem.getIndexType() == SpatialIndexType::Bvh) {
+			ImGui::Text("BVH: %u objects, %u nodes, %u moved, cost x%.2f, %u builds, %u rebuilds (%.3f ms)",
+			            spatialStats.objects, spatialSystem.getBvh().getNodeCount(), spatialStats.movedObjects,
+			            spatialStats.costRatio, spatialStats.builds, spatialStats.rebuilds, spatialStats.updateMs);
+		} else {
+			ImGui::Text("Grid: %u objects, %u entries (%u stale), %u moved (%.3f ms)", spatialStats.objects,
+			            spatialSystem.getGrid().getEntryCount(), spatialSystem.getGrid().getStaleEntryCount(),
+			            spatialStats.movedObjects, spatialStats.updateMs);
+		}
+		// Queried between the frames, the tree is the one of the previous frame as long as the scene kept its objects
+		if (spatialSystem.isCurrent(mWorld)) {
+			const glm::mat4 inverseViewProjection =
+			    glm::inverse(camera.getProjectionMatrix() * camera.getViewMatrix());
+			if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !ImGui::GetIO().WantCaptureMouse) {
+				// Vulkan clip space, y down and depth from 0 at the near plane to 1 at the far one
+				const ImVec2 mouse = ImGui::GetMousePos();
+				const ImVec2 display = ImGui::GetIO().DisplaySize;
+				const glm::vec2 ndc{2.f * mouse.x / std::max(display.x, 1.f) - 1.f,
+				                    2.f * mouse.y / std::max(display.y, 1.f) - 1.f};
+				const glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, 0.f, 1.f);
+				const glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.f, 1.f);
+				const glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+				const Ray ray{.origin = origin,
+				              .direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin)};
+				const u32 picked = spatialSystem.raycast(ray, pickedDistance);
+				pickedEntity =
+				    picked != VkEngineSpatialSystem::NO_OBJECT ? spatialSystem.getEntity(picked) : Entity{};
+			}
+
+			float nearestDistance = 0.f;
+			const glm::vec3 eye = glm::vec3(glm::inverse(camera.getViewMatrix())[3]);
+			const u32 nearest = spatialSystem.queryNearest(eye, nearestDistance);
+			if (nearest != VkEngineSpatialSystem::NO_OBJECT) {
+				ImGui::Text("Nearest object: %u at %.2f", spatialSystem.getEntity(nearest).index, nearestDistance);
+			}
+		}
+		if (pickedEntity.isValid() && mWorld.isAlive(pickedEntity)) {
+			ImGui::Text("Picked object: %u at %.2f", pickedEntity.index, pickedDistance);
+		}
+		// Of the previous frame, the systems run once the frame in flight has been acquired
+		ImGui::Text("Systems: %.3f ms", scheduler.getFrameMs());
+		drawSystemTimeline(scheduler, mThreadPool.getThreadCount());
+		ImGui::Text("ECS: %u entities in %u archetypes", mWorld.getEntityCount(), mWorld.getArchetypeCount());
+		ImGui::InputInt("Grid instances", &gridInstanceCount, 1000, 10000);
+		if (ImGui::Button("Spawn grid")) {
+			vkDeviceWaitIdle(mVkDevice->getDevice());
+			spawnInstanceGrid(static_cast<u32>(std::max(gridInstanceCount, 0)));
+			spawnLights(static_cast<u32>(lightCount));
+		}
+
+		if (ImGui::SliderInt("Lights", &lightCount, 0, LIGHT_SWEEP_COUNTS.back())) {
+			spawnLights(static_cast<u32>(lightCount));
+		}
+		ImGui::Checkbox("Move lights", &moveLights);
+		if (ImGui::Button("Light sweep") && !lightSweep.isRunning()) {
+			lightSweep.start();
+			spawnLights(static_cast<u32>(LIGHT_SWEEP_COUNTS[0]));
+		}
+		// Frame time against the light count
+		if (lightSweep.isRunning()) {
+			ImGui::Text("Measuring %zu lights...", mLights.size());
+			if (lightSweep.addFrame(frameTime)) {
+				spawnLights(static_cast<u32>(lightSweep.isRunning() ? LIGHT_SWEEP_COUNTS[lightSweep.getStep()]
+				                                                    : lightCount));
+			}
+		}
+		ImGui::PlotLines("Frame time (ms)", lightSweep.getFrameMs().data(),
+		                 static_cast<int>(lightSweep.getFrameMs().size()), 0, nullptr, 0.f,
+		                 std::numeric_limits<float>::max(), ImVec2(0.f, 80.f));
+		for (size_t step = 0; step < LIGHT_SWEEP_COUNTS.size(); ++step) {
+			ImGui::Text("%5d lights: %.3f ms", LIGHT_SWEEP_COUNTS[step], lightSweep.getFrameMs()[step]);
+		}
 
+		// Frame time and draw calls of the direct and instanced paths on grids of growing size, logged once done so
+		// that a headless run on lavapipe leaves the comparison behind
+		const auto setInstanceSweepStep = [&](const size_t step) {
+			renderMode = INSTANCE_SWEEP_MODES[step % INSTANCE_SWEEP_MODES.size()];
+			if (step % INSTANCE_SWEEP_MODES.size() == 0) {
+				vkDeviceWaitIdle(mVkDevice->getDevice());
+				spawnInstanceGrid(INSTANCE_SWEEP_COUNTS[step / INSTANCE_SWEEP_MODES.size()]);
+				spawnLights(static_cast<u32>(lightCount));
+			}
+		};
+		if (ImGui::Button("Instance sweep") && !instanceSweep.isRunning()) {
+			instanceSweepRestoreMode = renderMode;
+			instanceSweep.start();
+			instanceSweepDrawCalls.fill(0);
+			setInstanceSweepStep(0);
+		}
+		if (instanceSweep.isRunning()) {
+			const auto step = static_cast<size_t>(instanceSweep.getStep());
+			ImGui::Text("Measuring %u instances...", mWorld.getEntityCount());
+			instanceSweepDrawCalls[step] = renderSystem.getRenderStats().drawCalls;
+			if (instanceSweep.addFrame(frameTime)) {
+				if (instanceSweep.isRunning()) {
+					setInstanceSweepStep(step + 1);
+				} else {
+					renderMode = instanceSweepRestoreMode;
+					for (size_t i = 0; i < instanceSweepDrawCalls.size(); ++i) {
+						VKINFO("{} instances, {}: {:.3f} ms, {} draw calls",
+						       INSTANCE_SWEEP_COUNTS[i / INSTANCE_SWEEP_MODES.size()],
+						       INSTANCE_SWEEP_MODE_NAMES[i % INSTANCE_SWEEP_MODES.size()],
+						       instanceSweep.getFrameMs()[i], instanceSweepDrawCalls[i]);
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < instanceSweepDrawCalls.size(); ++i) {
+			ImGui::Text("%6u instances, %s: %.3f ms, %u draw calls",
+			            INSTANCE_SWEEP_COUNTS[i / INSTANCE_SWEEP_MODES.size()],
+			            INSTANCE_SWEEP_MODE_NAMES[i % INSTANCE_SWEEP_MODES.size()], instanceSweep.getFrameMs()[i],
+			            instanceSweepDrawCalls[i]);
+		}
+		scheduler.setEnabled(lightsSystem, moveLights);
+		// The GPU driven path culls in a compute pass of its own
+		scheduler.setEnabled(drawListSystem, renderMode != RenderMode::GpuDriven);
 
 		if (auto* commandBuffer = mVkRenderer.beginFrame()) {
 			const u32 frameIndex = mVkRenderer.getFrameIndex();
+			mResources.beginFrame();
+			occlusionQueries.beginFrame(frameIndex);
+
+			// Draws are predicated on the boxes queried by the previous frames, only in direct mode where every object
+			// has a draw of its own
+			const bool queries = useOcclusionQueries && renderMode == RenderMode::Direct;
+			renderSystem.setOcclusionQueries(queries ? &occlusionQueries : nullptr);
 
-			GlobalUBO ubo{
-			    .view = camera.getProjectionMatrix() * camera.getViewMatrix(),
-			};
+			// Needs the frame in flight, the instanced draw list is written straight to its instance buffer
+			scheduler.run();
 
-			// globalUBO.writeToIndex(&ubo, frameIndex);
-			// VK_CHECK(globalUBO.flushIndex(frameIndex));
+			// Written once here, every draw of the frame reads the camera from it
+			globalUniforms.update(frameIndex, camera, elapsedTime, frameTime);
 
 			// Render
-			vkCmdResetQueryPool(commandBuffer, renderSystem.getPipeline()->getPipelineData().queryPool, 0, 1);
-			mVkRenderer.beginSwapChainRenderPass(&commandBuffer);
-			vkCmdBeginQuery(commandBuffer, renderSystem.getPipeline()->getPipelineData().queryPool, 0, 0);
-			renderSystem.renderGameObjects(&commandBuffer, mVkGameObjects, camera);
-			vkCmdEndQuery(commandBuffer, renderSystem.getPipeline()->getPipelineData().queryPool, 0);
-			mVkRenderer.endSwapChainRenderPass(&commandBuffer);
+			auto& graph = mVkRenderer.getRenderGraph();
+			const RenderGraphImage backBuffer = mVkRenderer.getBackBuffer();
+			const RenderGraphImageDesc depthDesc{.format = mVkRenderer.getAttachmentFormats().depth,
+			                                     .extent = mVkRenderer.getSwapChainExtent()};
+			const RenderGraphImage depth = graph.createImage("depth", depthDesc);
+
+			RenderGraphBuffer predicates{};
+			if (queries) {
+				predicates = occlusionQueries.importPredicates(graph);
+			}
+
+			// Bins the lights of the frame into the froxels of the camera, read by every forward fragment shader
+			const VkEngineLightSystem::ClusterOutputs clusters =
+			    lightSystem.addClusterPass(mVkRenderer, camera, mLights);
+
+			VkEngineGpuDrivenSystem::CullOutputs cullOutputs{};
+			if (renderMode == RenderMode::GpuDriven) {
+				cullOutputs = gpuDrivenSystem.addCullPasses(mVkRenderer, mWorld, camera);
+			}
+
+			// Positions only, so the forward pass shades each pixel once. Always recorded inline, the secondaries of
+			// the frame are left to the forward pass.
+			const bool prepass = depthPrepass && renderMode != RenderMode::GpuDriven;
+			if (prepass) {
+				auto prepassPass = graph.addPass("depth prepass");
+				prepassPass.setDepthAttachment(depth, VK_ATTACHMENT_LOAD_OP_CLEAR);
+				if (predicates.isValid()) {
+					prepassPass.read(predicates, RenderGraphUsage::ConditionalRendering);
+				}
+				prepassPass.setExecute([&, frameIndex, renderMode](const RenderGraphContext& context) {
+					if (renderMode == RenderMode::Direct) {
+						renderSystem.renderGameObjects(&context.commandBuffer, DepthMode::Prepass);
+					} else {
+						renderSystem.renderGameObjectsInstanced(&context.commandBuffer, frameIndex,
+						                                        DepthMode::Prepass);
+					}
+				});
+			}
+			lastFramePrepass = prepass;
+
+			const bool recordSecondaries = renderMode == RenderMode::Direct && parallelRecording;
+			const DepthMode depthMode = prepass ? DepthMode::EqualTest : DepthMode::Forward;
+			auto forwardPass = graph.addPass("forward");
+			forwardPass.addColorAttachment(backBuffer, VK_ATTACHMENT_LOAD_OP_CLEAR, {{0.f, 0.f, 0.f, 0.f}})
+			    .setDepthAttachment(depth, prepass ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR, 1.f,
+			                        prepass);
+			forwardPass.read(clusters.counts, RenderGraphUsage::StorageGraphics)
+			    .read(clusters.indices, RenderGraphUsage::StorageGraphics);
+			if (recordSecondaries) {
+				forwardPass.setSecondaryContents();
+			}
+			if (predicates.isValid()) {
+				forwardPass.read(predicates, RenderGraphUsage::ConditionalRendering);
+			}
+			if (cullOutputs.commands.isValid()) {
+				forwardPass.read(cullOutputs.objects, RenderGraphUsage::StorageGraphics)
+				    .read(cullOutputs.commands, RenderGraphUsage::IndirectBuffer)
+				    .read(cullOutputs.counts, RenderGraphUsage::IndirectBuffer);
+			}
+			forwardPass.setExecute([&, frameIndex, renderMode, recordSecondaries,
+			                        depthMode](const RenderGraphContext& context) {
+				switch (renderMode) {
+					case RenderMode::Direct:
+						if (recordSecondaries) {
+							renderSystem.renderGameObjectsParallel(context, mVkRenderer, depthMode);
+						} else {
+							renderSystem.renderGameObjects(&context.commandBuffer, depthMode);
+						}
+						break;
+					case RenderMode::Instanced:
+						renderSystem.renderGameObjectsInstanced(&context.commandBuffer, frameIndex, depthMode);
+						break;
+					case RenderMode::GpuDriven:
+						gpuDrivenSystem.renderGameObjects(&context.commandBuffer, frameIndex);
+						break;
+				}
+			});
+
+			if (renderMode == RenderMode::GpuDriven) {
+				gpuDrivenSystem.addDepthPyramidPass(mVkRenderer, depth, camera);
+			}
+			if (queries) {
+				occlusionQueries.addQueryPasses(graph, depth, camera.getProjectionMatrix() * camera.getViewMatrix());
+			}
+
+			mVkRenderer.addImGuiPass(backBuffer);
+
+			// Secondary command buffers may be the only content of the forward pass, so the statistics query wraps the
+			// whole graph and is inherited by the secondaries
+			const auto& pipelineData = renderSystem.getPipeline()->getPipelineData();
+			vkCmdResetQueryPool(commandBuffer, pipelineData.queryPool, 0, 1);
+			vkCmdBeginQuery(commandBuffer, pipelineData.queryPool, 0, 0);
+			mVkRenderer.executeRenderGraph(&commandBuffer, pipelineData.pipelineStatistics);
+			vkCmdEndQuery(commandBuffer, pipelineData.queryPool, 0);
 			mVkRenderer.endFrame();
 		}
 		renderSystem.getPipeline()->getQueryPool();
@@ -117,14 +571,97 @@ void App::loadGameObjects() {
 	VKINFO("Loading models...");
 
 
-	const std::shared_ptr pVkModel =
-	    VkEngineModel::createModelFromFile(mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/obj/pig.obj");
+	mModel =
+	    mResources.add(VkEngineModel::createModelFromFile(mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/obj/pig.obj"));
+
+	TransformComponent transform{};
+	transform.setTranslation({0.f, 0.f, 2.5f});
+	transform.setScale(glm::vec3(-1));
+	mWorld.createEntity(transform, WorldMatrixComponent{}, RenderComponent{.mesh = mModel});
+}
+
+void App::createGridMaterials() {
+	// A few tints so the grid shows draws with different materials sharing one pipeline and one descriptor set
+	constexpr std::array tints{glm::vec4{1.f}, glm::vec4{1.f, .45f, .45f, 1.f}, glm::vec4{.45f, 1.f, .45f, 1.f},
+	                           glm::vec4{.45f, .45f, 1.f, 1.f}};
+
+	for (const auto& tint : tints) {
+		mGridMaterials.push_back(pMaterialTable->createMaterial({.baseColor = tint}));
+	}
+}
+
+void App::spawnLights(const u32 count) {
+	mLights.clear();
+	mLightOrbits.clear();
+	mLights.reserve(count);
+	mLightOrbits.reserve(count);
+
+	// Area covered by the objects, with a margin so a lone object still gets lights around it
+	glm::vec2 areaMin{-10.f};
+	glm::vec2 areaMax{10.f};
+	if (mWorld.count<TransformComponent>() != 0) {
+		areaMin = glm::vec2{std::numeric_limits<float>::max()};
+		areaMax = glm::vec2{std::numeric_limits<float>::lowest()};
+		mWorld.forEach<TransformComponent>([&](Entity /*entity*/, const TransformComponent& transform) {
+			const glm::vec3& translation = transform.getTranslation();
+			const glm::vec2 position{translation.x, translation.z};
+			areaMin = glm::min(areaMin, position - 5.f);
+			areaMax = glm::max(areaMax, position + 5.f);
+		});
+	}
+
+	// Fixed seed, so the sweeps of two runs light the scene the same way
+	std::mt19937 random{42};
+	std::uniform_real_distribution unit{0.f, 1.f};
+	for (u32 i = 0; i < count; ++i) {
+		const glm::vec3 center{glm::mix(areaMin.x, areaMax.x, unit(random)), -1.f - 2.f * unit(random),
+		                       glm::mix(areaMin.y, areaMax.y, unit(random))};
+		Light light{
+		    .position = center,
+		    .range = 3.f + 3.f * unit(random),
+		    .color = glm::vec3{unit(random), unit(random), unit(random)},
+		    .intensity = 5.f,
+		};
+		// One light in four is a spot looking down, up is -y
+		if (i % 4 == 0) {
+			light.direction = {0.f, 1.f, 0.f};
+			light.spotCosOuter = std::cos(glm::radians(35.f));
+			light.spotCosInner = std::cos(glm::radians(25.f));
+		}
+		mLights.push_back(light);
+		mLightOrbits.emplace_back(center, 0.5f + unit(random));
+	}
+}
+
+void App::animateLights(const float time) {
+	constexpr float orbitRadius = 1.5f;
+	for (size_t i = 0; i < mLights.size(); ++i) {
+		const float angle = time * mLightOrbits[i].w + static_cast<float>(i);
+		mLights[i].position =
+		    glm::vec3(mLightOrbits[i]) + orbitRadius * glm::vec3{std::cos(angle), 0.f, std::sin(angle)};
+	}
+}
+
+void App::spawnInstanceGrid(const u32 count) {
+	// Stress scene for draw throughput: `count` copies of the same model laid out on a square XZ grid
+	mWorld.clear();
+
+	const auto side = static_cast<u32>(std::ceil(std::sqrt(static_cast<float>(count))));
+	constexpr float spacing = 2.f;
+
+	for (u32 i = 0; i < count; ++i) {
+		TransformComponent transform{};
+		transform.setTranslation(
+		    {static_cast<float>(i % side) * spacing, 0.f, 2.5f + static_cast<float>(i / side) * spacing});
+		transform.setScale(glm::vec3(-1));
+		// The front row hides part of the grid behind it from the CPU occlusion culler
+		mWorld.createEntity(transform, WorldMatrixComponent{},
+		                    RenderComponent{.mesh = mModel,
+		                                    .materialIndex = mGridMaterials[i % mGridMaterials.size()],
+		                                    .occluder = i < side});
+	}
 
-	auto game_objects = VkEngineGameObjects::createGameObject();
-	game_objects.pModel = pVkModel;
-	game_objects.mTransform.translation = {0.f, 0.f, 2.5f};
-	game_objects.mTransform.scale = glm::vec3(-1);
-	mVkGameObjects.push_back(std::move(game_objects));
+	VKINFO("Spawned {} instances", count);
 }
 
 }  // namespace vke
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "core/engine_bindless_heap.hpp"
 #include "core/engine_device.hpp"
 #include "core/engine_ecs.hpp"
+#include "core/engine_resources.hpp"
 #include "core/engine_window.hpp"
+#include "engine_light_system.hpp"
+#include "engine_material_table.hpp"
 #include "engine_renderer.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace vke {
 class App {
@@ -22,10 +27,25 @@ class App {
 
    private:
 	void loadGameObjects();
+	void spawnInstanceGrid(u32 count);
+	void createGridMaterials();
+	// Scatters `count` point and spot lights above the area covered by the objects
+	void spawnLights(u32 count);
+	void animateLights(float time);
 
 	std::shared_ptr<VkEngineWindow> mVkWindow{};
 	std::shared_ptr<VkEngineDevice> mVkDevice{};
 	VkEngineRenderer mVkRenderer;
-	std::vector<VkEngineGameObjects> mVkGameObjects{};
+	// Outlives the world, whose entities only hold handles to its meshes
+	VkEngineResourceRegistry mResources{};
+	VkEngineWorld mWorld{};
+	MeshHandle mModel{};
+	ThreadPool mThreadPool{};
+	std::unique_ptr<VkEngineBindlessHeap> pBindlessHeap{};
+	std::unique_ptr<VkEngineMaterialTable> pMaterialTable{};
+	std::vector<u32> mGridMaterials{};
+	std::vector<Light> mLights{};
+	// Center of the circle each light moves along in xyz, angular speed in w
+	std::vector<glm::vec4> mLightOrbits{};
 };
 }  // namespace vke
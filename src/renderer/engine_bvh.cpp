@@ -0,0 +1,350 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace vke {
+namespace {
+// Cost of visiting an inner node relative to testing the box of an object
+constexpr float TRAVERSAL_COST = 1.f;
+
+struct BuildTask {
+	u32 begin;
+	u32 end;
+	u32 parent;
+	// Node whose right child this task builds, if any
+	u32 rightOf;
+};
+
+struct SahBin {
+	Aabb bounds{};
+	u32 count = 0;
+};
+
+u32 getBin(const glm::vec3& centroid, const u32 axis, const Aabb& centroidBounds, const float scale) {
+	const auto bin = static_cast<u32>((centroid[axis] - centroidBounds.min[axis]) * scale);
+	return std::min(bin, VkEngineBvh::SAH_BINS - 1);
+}
+
+// Partitions slots [begin, end) of `objects` at the cheapest of the bin boundaries of the three axes and returns the
+// first slot of the right side. Halves them by count when all the centroids are in the same spot.
+u32 splitSah(const std::span<const Aabb> boxes, const std::span<const glm::vec3> centroids, std::span<u32> objects,
+             const u32 begin, const u32 end, const Aabb& centroidBounds) {
+	constexpr u32 BINS = VkEngineBvh::SAH_BINS;
+	const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+	const u32 objectCount = end - begin;
+
+	float bestCost = std::numeric_limits<float>::max();
+	u32 bestAxis = 0;
+	u32 bestBin = 0;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		if (extent[axis] <= 0.f) {
+			continue;
+		}
+
+		const float scale = static_cast<float>(BINS) / extent[axis];
+		std::array<SahBin, BINS> bins{};
+		for (u32 slot = begin; slot < end; ++slot) {
+			SahBin& bin = bins[getBin(centroids[objects[slot]], axis, centroidBounds, scale)];
+			bin.bounds.grow(boxes[objects[slot]]);
+			++bin.count;
+		}
+
+		// The costs of every right side first, then the left sides are grown bin after bin
+		std::array<float, BINS - 1> rightCosts{};
+		Aabb right{};
+		u32 rightCount = 0;
+		for (u32 b = BINS - 1; b > 0; --b) {
+			right.grow(bins[b].bounds);
+			rightCount += bins[b].count;
+			rightCosts[b - 1] = right.getHalfArea() * static_cast<float>(rightCount);
+		}
+
+		Aabb left{};
+		u32 leftCount = 0;
+		for (u32 b = 0; b < BINS - 1; ++b) {
+			left.grow(bins[b].bounds);
+			leftCount += bins[b].count;
+			if (leftCount == 0 || leftCount == objectCount) {
+				continue;
+			}
+			const float cost = left.getHalfArea() * static_cast<float>(leftCount) + rightCosts[b];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
+			}
+		}
+	}
+
+	if (bestCost == std::numeric_limits<float>::max()) {
+		return begin + objectCount / 2;
+	}
+
+	const float scale = static_cast<float>(BINS) / extent[bestAxis];
+	const auto middle = std::partition(objects.begin() + begin, objects.begin() + end, [&](const u32 object) {
+		return getBin(centroids[object], bestAxis, centroidBounds, scale) <= bestBin;
+	});
+	return static_cast<u32>(middle - objects.begin());
+}
+}  // namespace
+
+void VkEngineBvh::build(const std::span<const Aabb> boxes) {
+	const auto objectCount = static_cast<u32>(boxes.size());
+	mNodes.clear();
+	mParents.clear();
+	mObjects.resize(objectCount);
+	std::iota(mObjects.begin(), mObjects.end(), 0u);
+	mSlotBoxes.resize(objectCount);
+	mObjectSlots.resize(objectCount);
+	mObjectLeaves.resize(objectCount);
+	mCentroids.resize(objectCount);
+	for (u32 object = 0; object < objectCount; ++object) {
+		mCentroids[object] = boxes[object].getCenter();
+	}
+
+	if (objectCount > 0) {
+		mNodes.reserve(2 * objectCount / MAX_LEAF_OBJECTS + 2);
+		mParents.reserve(2 * objectCount / MAX_LEAF_OBJECTS + 1);
+
+		// The left task is popped first, so the left child directly follows its parent
+		std::vector<BuildTask> stack{{.begin = 0, .end = objectCount, .parent = NO_NODE, .rightOf = NO_NODE}};
+		while (!stack.empty()) {
+			const BuildTask task = stack.back();
+			stack.pop_back();
+
+			const auto node = static_cast<u32>(mNodes.size());
+			if (task.rightOf != NO_NODE) {
+				// Until the skips are resolved below, an inner node keeps its right child there
+				mNodes[task.rightOf].skip = node;
+			}
+
+			Aabb bounds{};
+			Aabb centroidBounds{};
+			for (u32 slot = task.begin; slot < task.end; ++slot) {
+				bounds.grow(boxes[mObjects[slot]]);
+				centroidBounds.grow(mCentroids[mObjects[slot]]);
+			}
+			mNodes.push_back({.bounds = bounds, .skip = node + 1, .first = task.begin});
+			mParents.push_back(task.parent);
+
+			if (task.end - task.begin <= MAX_LEAF_OBJECTS) {
+				for (u32 slot = task.begin; slot < task.end; ++slot) {
+					const u32 object = mObjects[slot];
+					mSlotBoxes[slot] = boxes[object];
+					mObjectSlots[object] = slot;
+					mObjectLeaves[object] = node;
+				}
+				continue;
+			}
+
+			const u32 middle = splitSah(boxes, mCentroids, mObjects, task.begin, task.end, centroidBounds);
+			stack.push_back({.begin = middle, .end = task.end, .parent = node, .rightOf = node});
+			stack.push_back({.begin = task.begin, .end = middle, .parent = node, .rightOf = NO_NODE});
+		}
+
+		// A subtree ends where the subtree of its right child does
+		for (auto node = static_cast<u32>(mNodes.size()); node-- > 0;) {
+			if (!isLeaf(node)) {
+				mNodes[node].skip = mNodes[mNodes[node].skip].skip;
+			}
+		}
+	}
+
+	mNodes.push_back({.skip = static_cast<u32>(mNodes.size()) + 1, .first = objectCount});
+}
+
+void VkEngineBvh::refit(const std::span<const Aabb> boxes, const std::span<const u32> moved) {
+	for (const u32 object : moved) {
+		mSlotBoxes[mObjectSlots[object]] = boxes[object];
+	}
+
+	if (moved.size() * SWEEP_REFIT_DIVISOR > mObjects.size()) {
+		// Children come after their parent, a backward sweep refits them first
+		for (u32 node = getNodeCount(); node-- > 0;) {
+			refitNode(node);
+		}
+		return;
+	}
+
+	// The ancestors of a node whose bounds did not change are already up to date
+	for (const u32 object : moved) {
+		for (u32 node = mObjectLeaves[object]; node != NO_NODE; node = mParents[node]) {
+			const Aabb previous = mNodes[node].bounds;
+			refitNode(node);
+			if (mNodes[node].bounds == previous) {
+				break;
+			}
+		}
+	}
+}
+
+void VkEngineBvh::refit(const std::span<const Aabb> boxes) {
+	for (u32 slot = 0; slot < mObjects.size(); ++slot) {
+		mSlotBoxes[slot] = boxes[mObjects[slot]];
+	}
+	for (u32 node = getNodeCount(); node-- > 0;) {
+		refitNode(node);
+	}
+}
+
+void VkEngineBvh::refitNode(const u32 node) {
+	Aabb bounds{};
+	if (isLeaf(node)) {
+		for (u32 slot = mNodes[node].first; slot < getLeafEnd(node); ++slot) {
+			bounds.grow(mSlotBoxes[slot]);
+		}
+	} else {
+		bounds = mNodes[node + 1].bounds;
+		bounds.grow(mNodes[mNodes[node + 1].skip].bounds);
+	}
+	mNodes[node].bounds = bounds;
+}
+
+float VkEngineBvh::computeCost() const {
+	const u32 nodeCount = getNodeCount();
+	if (nodeCount == 0) {
+		return 0.f;
+	}
+
+	const float rootArea = std::max(mNodes[0].bounds.getHalfArea(), std::numeric_limits<float>::min());
+	float cost = 0.f;
+	for (u32 node = 0; node < nodeCount; ++node) {
+		const float area = mNodes[node].bounds.getHalfArea() / rootArea;
+		cost += isLeaf(node) ? area * static_cast<float>(getLeafEnd(node) - mNodes[node].first) : area * TRAVERSAL_COST;
+	}
+	return cost;
+}
+
+void VkEngineBvh::queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const {
+	const u32 nodeCount = getNodeCount();
+	u32 node = 0;
+	while (node < nodeCount) {
+		const BvhNode& current = mNodes[node];
+		const FrustumTest test = testFrustum(planes, current.bounds);
+		if (test == FrustumTest::Outside) {
+			node = current.skip;
+			continue;
+		}
+
+		if (test == FrustumTest::Inside) {
+			// The whole subtree is visible, its objects are the slots up to the next subtree
+			objects.insert(objects.end(), mObjects.begin() + current.first,
+			               mObjects.begin() + mNodes[current.skip].first);
+			node = current.skip;
+		} else if (isLeaf(node)) {
+			for (u32 slot = current.first; slot < getLeafEnd(node); ++slot) {
+				if (testFrustum(planes, mSlotBoxes[slot]) != FrustumTest::Outside) {
+					objects.push_back(mObjects[slot]);
+				}
+			}
+			node = current.skip;
+		} else {
+			++node;
+		}
+	}
+}
+
+u32 VkEngineBvh::raycast(const Ray& ray, float& distance) const {
+	const glm::vec3 inverseDirection = 1.f / ray.direction;
+	const u32 nodeCount = getNodeCount();
+	u32 closest = NO_OBJECT;
+	distance = ray.maxDistance;
+
+	u32 node = 0;
+	while (node < nodeCount) {
+		const BvhNode& current = mNodes[node];
+		float enter = 0.f;
+		// Only the boxes entered before the closest hit so far can hold a closer one
+		if (!intersectRay(current.bounds, ray.origin, inverseDirection, distance, enter)) {
+			node = current.skip;
+			continue;
+		}
+
+		if (isLeaf(node)) {
+			for (u32 slot = current.first; slot < getLeafEnd(node); ++slot) {
+				if (intersectRay(mSlotBoxes[slot], ray.origin, inverseDirection, distance, enter) &&
+				    (enter < distance || closest == NO_OBJECT)) {
+					distance = enter;
+					closest = mObjects[slot];
+				}
+			}
+		}
+		++node;
+	}
+	return closest;
+}
+
+u32 VkEngineBvh::queryNearest(const glm::vec3& point, float& distance) const {
+	const u32 nodeCount = getNodeCount();
+	u32 nearest = NO_OBJECT;
+	float nearestSquared = std::numeric_limits<float>::max();
+	const auto testLeaf = [&](const u32 leaf) {
+		for (u32 slot = mNodes[leaf].first; slot < getLeafEnd(leaf); ++slot) {
+			if (const float squared = distanceSquared(mSlotBoxes[slot], point); squared < nearestSquared) {
+				nearestSquared = squared;
+				nearest = mObjects[slot];
+			}
+		}
+	};
+
+	// The forward walk visits the children in build order, not closest first. Descending to the closest leaf first
+	// gives it a tight bound to reject the other subtrees with.
+	if (nodeCount > 0) {
+		u32 leaf = 0;
+		while (!isLeaf(leaf)) {
+			const u32 left = leaf + 1;
+			const u32 right = mNodes[left].skip;
+			const bool leftCloser =
+			    distanceSquared(mNodes[left].bounds, point) <= distanceSquared(mNodes[right].bounds, point);
+			leaf = leftCloser ? left : right;
+		}
+		testLeaf(leaf);
+	}
+
+	u32 node = 0;
+	while (node < nodeCount) {
+		const BvhNode& current = mNodes[node];
+		if (distanceSquared(current.bounds, point) >= nearestSquared) {
+			node = current.skip;
+			continue;
+		}
+
+		if (isLeaf(node)) {
+			testLeaf(node);
+		}
+		++node;
+	}
+
+	distance = std::sqrt(nearestSquared);
+	return nearest;
+}
+
+void VkEngineBvh::queryRadius(const glm::vec3& center, const float radius, std::vector<u32>& objects) const {
+	const float radiusSquared = radius * radius;
+	const u32 nodeCount = getNodeCount();
+	u32 node = 0;
+	while (node < nodeCount) {
+		const BvhNode& current = mNodes[node];
+		if (distanceSquared(current.bounds, center) > radiusSquared) {
+			node = current.skip;
+			continue;
+		}
+
+		if (isLeaf(node)) {
+			for (u32 slot = current.first; slot < getLeafEnd(node); ++slot) {
+				if (distanceSquared(mSlotBoxes[slot], center) <= radiusSquared) {
+					objects.push_back(mObjects[slot]);
+				}
+			}
+		}
+		++node;
+	}
+}
+
+}  // namespace vke
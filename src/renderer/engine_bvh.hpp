@@ -0,0 +1,80 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "engine_spatial.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// 32 bytes, two per cache line
+struct BvhNode {
+	Aabb bounds{};
+	// Node following the subtree in depth first order, i + 1 for a leaf
+	u32 skip = 0;
+	// First slot of the subtree, its objects are the slots up to the first slot of `skip`
+	u32 first = 0;
+};
+
+// Bounding volume hierarchy over boxes numbered by the caller. The nodes are stored depth first: the left child of a
+// node is the next one and the whole subtree is contiguous, as are the boxes of its objects, so queries walk the array
+// forward without a stack and jump over the subtrees they reject.
+class VkEngineBvh {
+   public:
+	static constexpr u32 MAX_LEAF_OBJECTS = 4;
+	static constexpr u32 SAH_BINS = 16;
+	static constexpr u32 NO_OBJECT = ~0u;
+
+	// Binned SAH build over the boxes, object i being boxes[i]
+	void build(std::span<const Aabb> boxes);
+
+	// Moves the boxes of the `moved` objects to boxes[object] and grows or shrinks their ancestors, the topology stays.
+	// The more the objects move the looser the tree gets, see computeCost.
+	void refit(std::span<const Aabb> boxes, std::span<const u32> moved);
+	// Same with every object moved
+	void refit(std::span<const Aabb> boxes);
+
+	// Expected cost of a query relative to testing the root, grows as refits loosen the tree
+	[[nodiscard]] float computeCost() const;
+
+	// Appends the objects whose box is at least partially inside the frustum
+	void queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const;
+	// Closest object whose box the ray enters, NO_OBJECT on a miss
+	u32 raycast(const Ray& ray, float& distance) const;
+	// Object whose box is closest to the point, NO_OBJECT when empty
+	u32 queryNearest(const glm::vec3& point, float& distance) const;
+	// Appends the objects whose box is within `radius` of the center
+	void queryRadius(const glm::vec3& center, float radius, std::vector<u32>& objects) const;
+
+	[[nodiscard]] u32 getObjectCount() const { return static_cast<u32>(mObjects.size()); }
+	[[nodiscard]] u32 getNodeCount() const { return mNodes.empty() ? 0 : static_cast<u32>(mNodes.size() - 1); }
+
+   private:
+	static constexpr u32 NO_NODE = ~0u;
+	// Above this share of moved objects, refitting sweeps every node rather than walking up from each leaf
+	static constexpr u32 SWEEP_REFIT_DIVISOR = 8;
+
+	[[nodiscard]] bool isLeaf(const u32 node) const { return mNodes[node].skip == node + 1; }
+	void refitNode(u32 node);
+	// Slot after the last object of a leaf
+	[[nodiscard]] u32 getLeafEnd(const u32 node) const { return mNodes[node + 1].first; }
+
+	// Followed by a sentinel whose first slot is the object count, so that every node has a next one
+	std::vector<BvhNode> mNodes{};
+	std::vector<u32> mParents{};
+	// Per slot, in leaf order, the object and its box
+	std::vector<u32> mObjects{};
+	std::vector<Aabb> mSlotBoxes{};
+	// Per object
+	std::vector<u32> mObjectSlots{};
+	std::vector<u32> mObjectLeaves{};
+	// Scratch of build
+	std::vector<glm::vec3> mCentroids{};
+};
+
+}  // namespace vke
@@ -16,25 +16,15 @@ void VkEngineCamera::setOrthographicProjection(const float left, const float rig
 	mProjectionMatrix[3][0] = -(right + left) / (right - left);
 	mProjectionMatrix[3][1] = -(bottom + top) / (top - bottom);
 	mProjectionMatrix[3][2] = -near / (far - near);
+	mNear = near;
+	mFar = far;
 }
 void VkEngineCamera::setViewDirection(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& up) {
 	const glm::vec3 w{glm::normalize(direction)};
 	const glm::vec3 u{glm::normalize(glm::cross(w, up))};
 	const glm::vec3 v{glm::cross(w, u)};
 
-	viewMatrix = glm::mat4{1.f};
-	viewMatrix[0][0] = u.x;
-	viewMatrix[1][0] = u.y;
-	viewMatrix[2][0] = u.z;
-	viewMatrix[0][1] = v.x;
-	viewMatrix[1][1] = v.y;
-	viewMatrix[2][1] = v.z;
-	viewMatrix[0][2] = w.x;
-	viewMatrix[1][2] = w.y;
-	viewMatrix[2][2] = w.z;
-	viewMatrix[3][0] = -glm::dot(u, position);
-	viewMatrix[3][1] = -glm::dot(v, position);
-	viewMatrix[3][2] = -glm::dot(w, position);
+	setViewBasis(position, u, v, w);
 }
 void VkEngineCamera::setViewTarget(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up) {
 	setViewDirection(position, target - position, up);
@@ -49,6 +39,14 @@ void VkEngineCamera::setViewXYZ(const glm::vec3& position, const glm::vec3& rota
 	const glm::vec3 u{(c1 * c3 + s1 * s2 * s3), (c2 * s3), (c1 * s2 * s3 - c3 * s1)};
 	const glm::vec3 v{(c3 * s1 * s2 - c1 * s3), (c2 * c3), (c1 * c3 * s2 + s1 * s3)};
 	const glm::vec3 w{(c2 * s1), (-s2), (c1 * c2)};
+	setViewBasis(position, u, v, w);
+}
+void VkEngineCamera::setViewRotation(const glm::vec3& position, const glm::quat& rotation) {
+	const glm::mat3 basis = glm::mat3_cast(rotation);
+	setViewBasis(position, basis[0], basis[1], basis[2]);
+}
+void VkEngineCamera::setViewBasis(const glm::vec3& position, const glm::vec3& u, const glm::vec3& v,
+                                  const glm::vec3& w) {
 	viewMatrix = glm::mat4{1.f};
 	viewMatrix[0][0] = u.x;
 	viewMatrix[1][0] = u.y;
@@ -74,5 +72,22 @@ void VkEngineCamera::setPerspectiveProjection(const float fovy, const float aspe
 	mProjectionMatrix[2][2] = zFar / (zFar - zNear);
 	mProjectionMatrix[2][3] = 1.f;
 	mProjectionMatrix[3][2] = -(zFar * zNear) / (zFar - zNear);
+	mNear = zNear;
+	mFar = zFar;
+}
+
+std::array<glm::vec4, 6> VkEngineCamera::extractFrustumPlanes() const {
+	// Gribb & Hartmann, with a [0, 1] clip depth the near plane is the third row alone
+	const glm::mat4 m = mProjectionMatrix * viewMatrix;
+	const glm::vec4 row0{m[0][0], m[1][0], m[2][0], m[3][0]};
+	const glm::vec4 row1{m[0][1], m[1][1], m[2][1], m[3][1]};
+	const glm::vec4 row2{m[0][2], m[1][2], m[2][2], m[3][2]};
+	const glm::vec4 row3{m[0][3], m[1][3], m[2][3], m[3][3]};
+
+	std::array planes = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2};
+	for (auto& plane : planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+	return planes;
 }
-}  // namespace vke
\ No newline at end of file
+}  // namespace vke
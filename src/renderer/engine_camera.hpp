@@ -6,7 +6,9 @@
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <array>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace vke {
 
@@ -19,12 +21,26 @@ class VkEngineCamera {
 	void setViewTarget(const glm::vec3& position, const glm::vec3& target,
 	                   const glm::vec3& up = glm::vec3{0.f, -1.f, 0.f});
 	void setViewXYZ(const glm::vec3& position, const glm::vec3& rotation);
+	// Same view as setViewXYZ for the quaternion of those angles, the basis is read off the quaternion without trig
+	void setViewRotation(const glm::vec3& position, const glm::quat& rotation);
+
+	// Left, right, bottom, top, near, far planes of projection * view, normalized so that dot(plane.xyz, p) + plane.w
+	// is the signed distance of p, positive inside
+	std::array<glm::vec4, 6> extractFrustumPlanes() const;
 
 	const glm::mat4& getProjectionMatrix() const { return mProjectionMatrix; }
 	const glm::mat4& getViewMatrix() const { return viewMatrix; }
+	// Distances of the clip planes given to the last projection set
+	float getNear() const { return mNear; }
+	float getFar() const { return mFar; }
 
    private:
+	// View of the orthonormal camera basis u (right), v (down) and w (forward) placed at `position`
+	void setViewBasis(const glm::vec3& position, const glm::vec3& u, const glm::vec3& v, const glm::vec3& w);
+
 	glm::mat4 mProjectionMatrix{1.f};
+	float mNear = 0.f;
+	float mFar = 1.f;
 	glm::mat4 viewMatrix{1.f};
 };
 
@@ -0,0 +1,262 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_depth_pyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "utils/logger.hpp"
+
+namespace vke {
+namespace {
+struct ReducePushConstants {
+	glm::uvec2 sourceSize{0};
+	glm::uvec2 destinationSize{0};
+};
+
+constexpr u32 REDUCE_GROUP_SIZE = 8;
+
+// What the pyramid is left in at the end of a frame, and found in by the next one
+constexpr RenderGraphState PYRAMID_READ_STATE{.stages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                              .access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                                              .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+}  // namespace
+
+VkEngineDepthPyramid::VkEngineDepthPyramid(std::shared_ptr<VkEngineDevice> device) : mVkDevice(std::move(device)) {
+	createPipeline();
+}
+
+VkEngineDepthPyramid::~VkEngineDepthPyramid() {
+	destroyPyramid();
+	vkDestroySampler(mVkDevice->getDevice(), pSampler, nullptr);
+	vkDestroyPipelineLayout(mVkDevice->getDevice(), pPipelineLayout, nullptr);
+}
+
+
+void VkEngineDepthPyramid::createPipeline() {
+	constexpr std::array<VkDescriptorSetLayoutBinding, 2> bindings{{
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT},
+	}};
+
+	const VkDescriptorSetLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	                                                 .bindingCount = static_cast<u32>(bindings.size()),
+	                                                 .pBindings = bindings.data()};
+
+	pSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(layoutInfo);
+
+	static constexpr VkPushConstantRange pushConstantRange{
+	    .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+	    .offset = 0,
+	    .size = sizeof(ReducePushConstants),
+	};
+
+	const VkPipelineLayoutCreateInfo pipelineLayoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                                    .setLayoutCount = 1,
+	                                                    .pSetLayouts = &pSetLayout,
+	                                                    .pushConstantRangeCount = 1,
+	                                                    .pPushConstantRanges = &pushConstantRange};
+
+	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &pipelineLayoutInfo, nullptr, &pPipelineLayout));
+
+	pPipeline = std::make_unique<VkEngineComputePipeline>(
+	    mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/depth_pyramid.comp.spv", pPipelineLayout);
+
+	// Only read through texelFetch, the filtering never applies
+	constexpr VkSamplerCreateInfo samplerInfo{
+	    .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+	    .magFilter = VK_FILTER_NEAREST,
+	    .minFilter = VK_FILTER_NEAREST,
+	    .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+	    .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+	    .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+	    .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+	    .maxLod = VK_LOD_CLAMP_NONE,
+	};
+	VK_CHECK(vkCreateSampler(mVkDevice->getDevice(), &samplerInfo, nullptr, &pSampler));
+}
+
+
+void VkEngineDepthPyramid::createPyramid(const VkExtent2D extent) {
+	mExtent = extent;
+	mMipLevels = static_cast<u32>(std::bit_width(std::max(extent.width, extent.height)));
+
+	const VkImageCreateInfo imageInfo{
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = PYRAMID_FORMAT,
+	    .extent = {extent.width, extent.height, 1},
+	    .mipLevels = mMipLevels,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .tiling = VK_IMAGE_TILING_OPTIMAL,
+	    .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+	    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+	    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+	};
+
+	mVkDevice->createImageWithInfo(imageInfo, pImage, pImageMemory);
+
+	VkImageViewCreateInfo viewInfo{.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	                               .image = pImage,
+	                               .viewType = VK_IMAGE_VIEW_TYPE_2D,
+	                               .format = PYRAMID_FORMAT,
+	                               .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	                                                    .baseMipLevel = 0,
+	                                                    .levelCount = mMipLevels,
+	                                                    .baseArrayLayer = 0,
+	                                                    .layerCount = 1}};
+	VK_CHECK(vkCreateImageView(mVkDevice->getDevice(), &viewInfo, nullptr, &pImageView));
+
+	mMipViews.resize(mMipLevels);
+	viewInfo.subresourceRange.levelCount = 1;
+	for (u32 level = 0; level < mMipLevels; ++level) {
+		viewInfo.subresourceRange.baseMipLevel = level;
+		VK_CHECK(vkCreateImageView(mVkDevice->getDevice(), &viewInfo, nullptr, &mMipViews[level]));
+	}
+
+	mIsInitialized = false;
+	mHasHistory = false;
+	VKINFO("Created a {}x{} depth pyramid with {} levels", extent.width, extent.height, mMipLevels);
+}
+
+
+void VkEngineDepthPyramid::destroyPyramid() {
+	if (pImage == VK_NULL_HANDLE) {
+		return;
+	}
+
+	for (const VkImageView view : mMipViews) {
+		vkDestroyImageView(mVkDevice->getDevice(), view, nullptr);
+	}
+	mMipViews.clear();
+	vkDestroyImageView(mVkDevice->getDevice(), pImageView, nullptr);
+	vmaDestroyImage(mVkDevice->getAllocator(), pImage, pImageMemory);
+
+	pImage = VK_NULL_HANDLE;
+	pImageView = VK_NULL_HANDLE;
+	pImageMemory = VK_NULL_HANDLE;
+}
+
+
+RenderGraphImage VkEngineDepthPyramid::import(VkEngineRenderGraph& graph, const VkExtent2D depthExtent) {
+	// Halving a power of two keeps every texel covering exactly 2x2 texels of the level above
+	const VkExtent2D extent{std::bit_floor(std::max(depthExtent.width, 1u)),
+	                        std::bit_floor(std::max(depthExtent.height, 1u))};
+
+	if (extent.width != mExtent.width || extent.height != mExtent.height) {
+		// Only happens when the swapchain is resized, frames still in flight may be reading the old pyramid
+		VK_CHECK(vkDeviceWaitIdle(mVkDevice->getDevice()));
+		destroyPyramid();
+		createPyramid(extent);
+	}
+	mDepthExtent = depthExtent;
+
+	const RenderGraphImage pyramid =
+	    graph.importImage("depth pyramid", pImage, pImageView,
+	                      {.format = PYRAMID_FORMAT, .extent = mExtent, .mipLevels = mMipLevels},
+	                      mIsInitialized ? PYRAMID_READ_STATE : RenderGraphState{});
+	graph.exportImage(pyramid, PYRAMID_READ_STATE);
+	mIsInitialized = true;
+
+	return pyramid;
+}
+
+
+void VkEngineDepthPyramid::addBuildPass(VkEngineRenderGraph& graph, VkEngineDescriptorAllocator& frameAllocator,
+                                        const RenderGraphImage depth, const RenderGraphImage pyramid,
+                                        const glm::mat4& viewProjection) {
+	graph.addPass("depth pyramid")
+	    .read(depth, RenderGraphUsage::SampledCompute)
+	    .write(pyramid, RenderGraphUsage::StorageCompute)
+	    .setExecute([this, &frameAllocator, depth](const RenderGraphContext& context) {
+		    const VkCommandBuffer commandBuffer = context.commandBuffer;
+		    pPipeline->bind(&commandBuffer);
+
+		    // The graph sees the pyramid as a whole, the dependencies between its levels are handled here: each level
+		    // is written while the previous one is read, in the GENERAL layout
+		    VkExtent2D sourceSize = mDepthExtent;
+		    for (u32 level = 0; level < mMipLevels; ++level) {
+			    const VkDescriptorImageInfo sourceInfo =
+			        level == 0 ? VkDescriptorImageInfo{pSampler, context.graph->getImageView(depth),
+			                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}
+			                   : VkDescriptorImageInfo{pSampler, mMipViews[level - 1], VK_IMAGE_LAYOUT_GENERAL};
+			    const VkDescriptorImageInfo destinationInfo{VK_NULL_HANDLE, mMipViews[level], VK_IMAGE_LAYOUT_GENERAL};
+
+			    const VkDescriptorSet descriptorSet = frameAllocator.allocate(pSetLayout);
+			    const std::array writes{
+			        VkWriteDescriptorSet{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			                             .dstSet = descriptorSet,
+			                             .dstBinding = 0,
+			                             .descriptorCount = 1,
+			                             .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			                             .pImageInfo = &sourceInfo},
+			        VkWriteDescriptorSet{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			                             .dstSet = descriptorSet,
+			                             .dstBinding = 1,
+			                             .descriptorCount = 1,
+			                             .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+			                             .pImageInfo = &destinationInfo},
+			    };
+			    vkUpdateDescriptorSets(mVkDevice->getDevice(), static_cast<u32>(writes.size()), writes.data(), 0,
+			                           nullptr);
+
+			    const VkExtent2D destinationSize{std::max(mExtent.width >> level, 1u),
+			                                     std::max(mExtent.height >> level, 1u)};
+			    const ReducePushConstants pushConstants{
+			        .sourceSize = {sourceSize.width, sourceSize.height},
+			        .destinationSize = {destinationSize.width, destinationSize.height},
+			    };
+
+			    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pPipelineLayout, 0, 1,
+			                            &descriptorSet, 0, nullptr);
+			    vkCmdPushConstants(commandBuffer, pPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+			                       sizeof(ReducePushConstants), &pushConstants);
+			    vkCmdDispatch(commandBuffer, (destinationSize.width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE,
+			                  (destinationSize.height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1);
+
+			    // The last level is synchronized by the graph, with the rest of the pyramid
+			    if (level + 1 < mMipLevels) {
+				    const VkImageMemoryBarrier2 levelBarrier{
+				        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+				        .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				        .srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+				        .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+				        .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+				        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+				        .image = pImage,
+				        .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				                             .baseMipLevel = level,
+				                             .levelCount = 1,
+				                             .baseArrayLayer = 0,
+				                             .layerCount = 1}};
+
+				    const VkDependencyInfo levelDependency{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+				                                           .imageMemoryBarrierCount = 1,
+				                                           .pImageMemoryBarriers = &levelBarrier};
+				    vkCmdPipelineBarrier2(commandBuffer, &levelDependency);
+			    }
+
+			    sourceSize = destinationSize;
+		    }
+	    });
+
+	mViewProjection = viewProjection;
+	mHasHistory = true;
+}
+
+
+VkDescriptorImageInfo VkEngineDepthPyramid::descriptorInfo() const {
+	return {.sampler = pSampler, .imageView = pImageView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+}
+
+}  // namespace vke
@@ -0,0 +1,74 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "core/engine_descriptors.hpp"
+#include "core/engine_device.hpp"
+#include "core/engine_pipeline.hpp"
+#include "engine_render_graph.hpp"
+
+namespace vke {
+
+// Hierarchical Z: the depth buffer reduced level by level down to 1x1, every texel holding the farthest depth of the
+// area it covers. Depth goes from 0 (near) to 1 (far) with a LESS test, so the reduction keeps the maximum and an
+// object whose nearest depth lies beyond it is hidden. The pyramid is kept across frames so culling can test against
+// the depth of the previous one.
+class VkEngineDepthPyramid : NO_COPY_NOR_MOVE {
+   public:
+	explicit VkEngineDepthPyramid(std::shared_ptr<VkEngineDevice> device);
+
+	~VkEngineDepthPyramid();
+
+	// Imports the pyramid matching a depth buffer of `depthExtent` into the graph, recreating it when the size
+	// changed. It is exported readable by compute shaders, the state the next frame imports it in.
+	RenderGraphImage import(VkEngineRenderGraph& graph, VkExtent2D depthExtent);
+
+	// Declares the pass reducing `depth`, rendered with `viewProjection`, into `pyramid`
+	void addBuildPass(VkEngineRenderGraph& graph, VkEngineDescriptorAllocator& frameAllocator, RenderGraphImage depth,
+	                  RenderGraphImage pyramid, const glm::mat4& viewProjection);
+
+	// Whether the pyramid holds the depth of an earlier frame, tests against it are meaningless otherwise
+	[[nodiscard]] bool hasHistory() const { return mHasHistory; }
+	void invalidate() { mHasHistory = false; }
+
+	// Every level through one view, for texelFetch once the pyramid has been imported
+	[[nodiscard]] VkDescriptorImageInfo descriptorInfo() const;
+	[[nodiscard]] VkExtent2D getExtent() const { return mExtent; }
+	[[nodiscard]] u32 getMipLevels() const { return mMipLevels; }
+	// View projection of the frame whose depth the pyramid holds
+	[[nodiscard]] const glm::mat4& getViewProjection() const { return mViewProjection; }
+
+   private:
+	void createPipeline();
+	void createPyramid(VkExtent2D extent);
+	void destroyPyramid();
+
+	static constexpr VkFormat PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+
+	VkDescriptorSetLayout pSetLayout = VK_NULL_HANDLE;
+	VkPipelineLayout pPipelineLayout = VK_NULL_HANDLE;
+	std::unique_ptr<VkEngineComputePipeline> pPipeline{};
+	VkSampler pSampler = VK_NULL_HANDLE;
+
+	VkImage pImage = VK_NULL_HANDLE;
+	VmaAllocation pImageMemory = VK_NULL_HANDLE;
+	VkImageView pImageView = VK_NULL_HANDLE;
+	// One view per level, the reduction writes a level while reading the one above it
+	std::vector<VkImageView> mMipViews{};
+	VkExtent2D mExtent{};
+	u32 mMipLevels = 0;
+	// Size of the depth buffer reduced into the first level, which is rounded down to a power of two
+	VkExtent2D mDepthExtent{};
+
+	// The layout is undefined until the first frame exports the pyramid
+	bool mIsInitialized = false;
+	bool mHasHistory = false;
+	glm::mat4 mViewProjection{1.f};
+};
+}  // namespace vke
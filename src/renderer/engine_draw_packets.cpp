@@ -0,0 +1,77 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_draw_packets.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace vke {
+
+u64 DrawSortKey::make(const u32 pass, const u32 pipeline, const u32 material, const u32 model,
+                      const float viewDepth) {
+	// The bits of a non negative float sort like the float itself, keeping the top 24 leaves 15 bits of mantissa
+	const u32 depthBits = std::bit_cast<u32>(std::max(viewDepth, 0.f)) >> (32 - DEPTH_BITS);
+
+	const auto pack = [](const u32 value, const u32 shift, const u32 bits) {
+		return (static_cast<u64>(value) & ((u64{1} << bits) - 1)) << shift;
+	};
+
+	return pack(pass, PASS_SHIFT, PASS_BITS) | pack(pipeline, PIPELINE_SHIFT, PIPELINE_BITS) |
+	       pack(material, MATERIAL_SHIFT, MATERIAL_BITS) | pack(model, MODEL_SHIFT, MODEL_BITS) |
+	       pack(depthBits, DEPTH_SHIFT, DEPTH_BITS);
+}
+
+void radixSortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch) {
+	constexpr u32 RADIX_BITS = 8;
+	constexpr u32 BUCKET_COUNT = 1u << RADIX_BITS;
+	constexpr u32 PASS_COUNT = 64 / RADIX_BITS;
+
+	const auto packetCount = static_cast<u32>(packets.size());
+	if (packetCount < 2) {
+		return;
+	}
+
+	// One read of the keys builds the histograms of every pass
+	std::array<std::array<u32, BUCKET_COUNT>, PASS_COUNT> histograms{};
+	for (const auto& packet : packets) {
+		for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+			++histograms[pass][packet.key >> (pass * RADIX_BITS) & (BUCKET_COUNT - 1)];
+		}
+	}
+
+	scratch.resize(packetCount);
+	DrawPacket* source = packets.data();
+	DrawPacket* destination = scratch.data();
+
+	for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+		auto& histogram = histograms[pass];
+		const u32 shift = pass * RADIX_BITS;
+
+		// A byte shared by every key leaves the order untouched
+		if (histogram[source[0].key >> shift & (BUCKET_COUNT - 1)] == packetCount) {
+			continue;
+		}
+
+		u32 offset = 0;
+		for (u32& bucket : histogram) {
+			const u32 count = bucket;
+			bucket = offset;
+			offset += count;
+		}
+
+		for (u32 i = 0; i < packetCount; ++i) {
+			destination[histogram[source[i].key >> shift & (BUCKET_COUNT - 1)]++] = source[i];
+		}
+
+		std::swap(source, destination);
+	}
+
+	if (source != packets.data()) {
+		packets.swap(scratch);
+	}
+}
+
+}  // namespace vke
@@ -0,0 +1,51 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "utils/types.hpp"
+
+namespace vke {
+
+// 64 bit draw sort key, most significant field first, so sorting the keys groups draws by pass, then pipeline, then
+// material, then model, and orders the draws sharing all of those front to back
+//   [63..60] pass  [59..52] pipeline  [51..40] material  [39..24] model  [23..0] depth
+struct DrawSortKey {
+	static constexpr u32 PASS_BITS = 4;
+	static constexpr u32 PIPELINE_BITS = 8;
+	static constexpr u32 MATERIAL_BITS = 12;
+	static constexpr u32 MODEL_BITS = 16;
+	static constexpr u32 DEPTH_BITS = 24;
+
+	static constexpr u32 DEPTH_SHIFT = 0;
+	static constexpr u32 MODEL_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+	static constexpr u32 MATERIAL_SHIFT = MODEL_SHIFT + MODEL_BITS;
+	static constexpr u32 PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static constexpr u32 PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+	static_assert(PASS_SHIFT + PASS_BITS == 64);
+
+	static u64 make(u32 pass, u32 pipeline, u32 material, u32 model, float viewDepth);
+
+	static u32 pipeline(const u64 key) { return field(key, PIPELINE_SHIFT, PIPELINE_BITS); }
+	static u32 material(const u64 key) { return field(key, MATERIAL_SHIFT, MATERIAL_BITS); }
+	static u32 model(const u64 key) { return field(key, MODEL_SHIFT, MODEL_BITS); }
+
+   private:
+	static u32 field(const u64 key, const u32 shift, const u32 bits) {
+		return static_cast<u32>(key >> shift & ((u64{1} << bits) - 1));
+	}
+};
+
+struct DrawPacket {
+	u64 key = 0;
+	u32 objectIndex = 0;
+};
+
+// Stable LSD radix sort on the full 64 bit key, 8 bits per pass. Passes where every key has the same byte are
+// skipped, which is most of them for a typical scene. `scratch` is resized as needed and can be reused across frames.
+void radixSortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+
+}  // namespace vke
@@ -0,0 +1,210 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_frustum_culling.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#include "utils/cpu_features.hpp"
+
+#if defined(VKE_X86)
+#include <immintrin.h>
+#endif
+
+namespace vke {
+namespace {
+u32 appendMask(u32 mask, const u32 base, u32* visible) {
+	u32 count = 0;
+	while (mask != 0) {
+		visible[count++] = base + static_cast<u32>(std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+	return count;
+}
+
+// Spheres [begin, end) one at a time, the reference of the SIMD kernels and the tail they leave
+u32 cullSpheresScalar(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, const u32 begin,
+                      const u32 end, u32* visible) {
+	const float* const cx = spheres.centerX.data();
+	const float* const cy = spheres.centerY.data();
+	const float* const cz = spheres.centerZ.data();
+	const float* const cr = spheres.radius.data();
+
+	u32 count = 0;
+	for (u32 i = begin; i < end; ++i) {
+		bool inside = true;
+		for (u32 p = 0; p < 6; ++p) {
+			const float dist = planes.nx[p] * cx[i] + planes.ny[p] * cy[i] + planes.nz[p] * cz[i] + planes.d[p];
+			inside &= dist >= -cr[i];
+		}
+		if (inside) {
+			visible[count++] = i;
+		}
+	}
+	return count;
+}
+
+#if defined(VKE_X86)
+// Spheres [begin, last multiple of 8 from begin) as 2 x 4 lanes, every x86-64 CPU has SSE2. `begin` is moved past
+// the spheres processed.
+u32 cullSpheresSse2(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, u32& begin, const u32 end,
+                    u32* visible) {
+	const float* const cx = spheres.centerX.data();
+	const float* const cy = spheres.centerY.data();
+	const float* const cz = spheres.centerZ.data();
+	const float* const cr = spheres.radius.data();
+
+	__m128 nx[6];
+	__m128 ny[6];
+	__m128 nz[6];
+	__m128 nd[6];
+	for (u32 p = 0; p < 6; ++p) {
+		nx[p] = _mm_set1_ps(planes.nx[p]);
+		ny[p] = _mm_set1_ps(planes.ny[p]);
+		nz[p] = _mm_set1_ps(planes.nz[p]);
+		nd[p] = _mm_set1_ps(planes.d[p]);
+	}
+	const __m128 signMask = _mm_set1_ps(-0.f);
+
+	const auto cull4 = [&](const u32 offset) {
+		const __m128 x = _mm_loadu_ps(cx + offset);
+		const __m128 y = _mm_loadu_ps(cy + offset);
+		const __m128 z = _mm_loadu_ps(cz + offset);
+		const __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(cr + offset), signMask);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (u32 p = 0; p < 6; ++p) {
+			const __m128 dist = _mm_add_ps(
+			    _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)), _mm_mul_ps(nz[p], z)), nd[p]);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negRadius));
+		}
+		return static_cast<u32>(_mm_movemask_ps(inside));
+	};
+
+	u32 count = 0;
+	u32 i = begin;
+	for (; i + 8 <= end; i += 8) {
+		const u32 mask = cull4(i) | cull4(i + 4) << 4;
+		count += appendMask(mask, i, visible + count);
+	}
+	begin = i;
+	return count;
+}
+
+// Same as cullSpheresSse2 with 8 lanes, only called once hasAvx2() said so
+VKE_TARGET_AVX2 u32 cullSpheresAvx2(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, u32& begin,
+                                    const u32 end, u32* visible) {
+	const float* const cx = spheres.centerX.data();
+	const float* const cy = spheres.centerY.data();
+	const float* const cz = spheres.centerZ.data();
+	const float* const cr = spheres.radius.data();
+
+	__m256 nx[6];
+	__m256 ny[6];
+	__m256 nz[6];
+	__m256 nd[6];
+	for (u32 p = 0; p < 6; ++p) {
+		nx[p] = _mm256_set1_ps(planes.nx[p]);
+		ny[p] = _mm256_set1_ps(planes.ny[p]);
+		nz[p] = _mm256_set1_ps(planes.nz[p]);
+		nd[p] = _mm256_set1_ps(planes.d[p]);
+	}
+	const __m256 signMask = _mm256_set1_ps(-0.f);
+
+	u32 count = 0;
+	u32 i = begin;
+	for (; i + 8 <= end; i += 8) {
+		const __m256 x = _mm256_loadu_ps(cx + i);
+		const __m256 y = _mm256_loadu_ps(cy + i);
+		const __m256 z = _mm256_loadu_ps(cz + i);
+		const __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(cr + i), signMask);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (u32 p = 0; p < 6; ++p) {
+			const __m256 dist = _mm256_add_ps(
+			    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], x), _mm256_mul_ps(ny[p], y)), _mm256_mul_ps(nz[p], z)),
+			    nd[p]);
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negRadius, _CMP_GE_OQ));
+		}
+
+		count += appendMask(static_cast<u32>(_mm256_movemask_ps(inside)), i, visible + count);
+	}
+	begin = i;
+	return count;
+}
+#endif
+}  // namespace
+
+bool isCullingKernelSupported(const CullingKernel kernel) {
+	switch (kernel) {
+		case CullingKernel::Scalar:
+			return true;
+#if defined(VKE_X86)
+		case CullingKernel::Sse2:
+			return true;
+		case CullingKernel::Avx2:
+			return hasAvx2();
+#endif
+		default:
+			return false;
+	}
+}
+
+CullingKernel getCullingKernel() {
+	static const CullingKernel kernel = isCullingKernelSupported(CullingKernel::Avx2)   ? CullingKernel::Avx2
+	                                    : isCullingKernelSupported(CullingKernel::Sse2) ? CullingKernel::Sse2
+	                                                                                    : CullingKernel::Scalar;
+	return kernel;
+}
+
+u32 cullSpheres(const CullingKernel kernel, const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres,
+                u32 begin, const u32 end, u32* visible) {
+	assert(isCullingKernelSupported(kernel) && "Culling kernel not supported by this build or CPU");
+
+	u32 count = 0;
+#if defined(VKE_X86)
+	if (kernel == CullingKernel::Avx2) {
+		count = cullSpheresAvx2(planes, spheres, begin, end, visible);
+	} else if (kernel == CullingKernel::Sse2) {
+		count = cullSpheresSse2(planes, spheres, begin, end, visible);
+	}
+#endif
+	return count + cullSpheresScalar(planes, spheres, begin, end, visible + count);
+}
+
+u32 cullSpheres(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, const u32 begin, const u32 end,
+                u32* visible) {
+	return cullSpheres(getCullingKernel(), planes, spheres, begin, end, visible);
+}
+
+void VkEngineFrustumCuller::cull(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres,
+                                 std::vector<u32>& visible) {
+	const u32 sphereCount = spheres.size();
+	const u32 chunkCount = (sphereCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+	// Every chunk writes into its own slice first, so workers never contend on an output cursor
+	visible.resize(sphereCount);
+	mChunkCounts.assign(chunkCount, 0);
+
+	const CullingKernel kernel = getCullingKernel();
+	mThreadPool.parallelFor(sphereCount, CHUNK_SIZE, [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		mChunkCounts[begin / CHUNK_SIZE] = cullSpheres(kernel, planes, spheres, begin, end, visible.data() + begin);
+	});
+
+	// Compact the slices in chunk order, which keeps the indices sorted
+	u32 visibleCount = 0;
+	for (u32 chunk = 0; chunk < chunkCount; ++chunk) {
+		if (visibleCount != chunk * CHUNK_SIZE) {
+			std::memmove(visible.data() + visibleCount, visible.data() + chunk * CHUNK_SIZE,
+			             mChunkCounts[chunk] * sizeof(u32));
+		}
+		visibleCount += mChunkCounts[chunk];
+	}
+
+	visible.resize(visibleCount);
+}
+
+}  // namespace vke
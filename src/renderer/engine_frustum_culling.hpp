@@ -0,0 +1,74 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Plane i is (nx[i], ny[i], nz[i], d[i]) with normalized normals, dot(n, p) + d >= 0 on the inner side
+struct FrustumPlanesSoA {
+	std::array<float, 6> nx{};
+	std::array<float, 6> ny{};
+	std::array<float, 6> nz{};
+	std::array<float, 6> d{};
+};
+
+// World space bounding spheres in structure of arrays form, one lane per object
+struct BoundingSpheresSoA {
+	std::vector<float> centerX{};
+	std::vector<float> centerY{};
+	std::vector<float> centerZ{};
+	std::vector<float> radius{};
+
+	void resize(const u32 count) {
+		centerX.resize(count);
+		centerY.resize(count);
+		centerZ.resize(count);
+		radius.resize(count);
+	}
+
+	[[nodiscard]] u32 size() const { return static_cast<u32>(radius.size()); }
+};
+
+// Implementations of cullSpheres, they all append the same indices
+enum class CullingKernel : u8 {
+	Scalar,
+	Sse2,
+	Avx2,
+};
+
+// Whether the build holds the kernel and the CPU running it can execute it
+[[nodiscard]] bool isCullingKernelSupported(CullingKernel kernel);
+// Widest supported kernel, the one cullSpheres runs by default
+[[nodiscard]] CullingKernel getCullingKernel();
+
+// Tests spheres [begin, end) against the frustum, 8 per iteration with the SIMD kernels, and appends the index of
+// every sphere at least partially inside to `visible`. Returns the number appended. The kernel must be supported.
+u32 cullSpheres(CullingKernel kernel, const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, u32 begin,
+                u32 end, u32* visible);
+// With the widest supported kernel
+u32 cullSpheres(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, u32 begin, u32 end, u32* visible);
+
+class VkEngineFrustumCuller {
+   public:
+	// Objects handed to a single worker at once, a multiple of the 8 wide kernel
+	static constexpr u32 CHUNK_SIZE = 4096;
+
+	explicit VkEngineFrustumCuller(ThreadPool& threadPool) : mThreadPool(threadPool) {}
+
+	// Splits the spheres across the pool and writes the visible indices, in ascending order, to `visible`
+	void cull(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, std::vector<u32>& visible);
+
+   private:
+	ThreadPool& mThreadPool;
+	std::vector<u32> mChunkCounts{};
+};
+
+}  // namespace vke
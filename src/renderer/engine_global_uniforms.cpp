@@ -0,0 +1,62 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_global_uniforms.hpp"
+
+#include "utils/logger.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+static_assert(sizeof(GlobalUniforms) == 224, "GlobalUniforms must match the std140 layout of Globals");
+
+VkEngineGlobalUniforms::VkEngineGlobalUniforms(std::shared_ptr<VkEngineDevice> device) : mVkDevice(std::move(device)) {
+	constexpr VkDescriptorSetLayoutBinding binding{
+	    .binding = 0,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	    .descriptorCount = 1,
+	    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+	};
+
+	const VkDescriptorSetLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	                                                 .bindingCount = 1,
+	                                                 .pBindings = &binding};
+
+	pSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(layoutInfo);
+
+	// Mapped for the lifetime of the buffer, updates are a plain copy and a flush
+	pBuffer = std::make_unique<VkEngineBuffer>(
+	    mVkDevice, sizeof(GlobalUniforms), MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+	    VMA_MEMORY_USAGE_AUTO, mVkDevice->getPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment);
+	VK_CHECK(pBuffer->map());
+
+	// The descriptor covers one region, the dynamic offset picks which
+	const VkEngineDescriptorSetCache::Write write{.binding = 0,
+	                                              .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	                                              .buffer = pBuffer->descriptorInfoForIndex(0)};
+	pDescriptorSet = mVkDevice->getDescriptorSetCache().getSet(pSetLayout, {&write, 1});
+}
+
+
+void VkEngineGlobalUniforms::update(const u32 frameIndex, const VkEngineCamera& camera, const float time,
+                                    const float deltaTime) {
+	mFrameIndex = frameIndex;
+	mUniforms.projection = camera.getProjectionMatrix();
+	mUniforms.view = camera.getViewMatrix();
+	mUniforms.projectionView = mUniforms.projection * mUniforms.view;
+	mUniforms.time = {time, deltaTime, 0.f, 0.f};
+
+	pBuffer->writeToIndex(&mUniforms, static_cast<int>(frameIndex));
+	VK_CHECK(pBuffer->flushIndex(static_cast<int>(frameIndex)));
+}
+
+
+void VkEngineGlobalUniforms::bind(const VkCommandBuffer* const commandBuffer, const VkPipelineBindPoint bindPoint,
+                                  const VkPipelineLayout layout) const {
+	const auto dynamicOffset = static_cast<u32>(mFrameIndex * pBuffer->getAlignmentSize());
+	vkCmdBindDescriptorSets(*commandBuffer, bindPoint, layout, SET_INDEX, 1, &pDescriptorSet, 1, &dynamicOffset);
+}
+
+}  // namespace vke
@@ -0,0 +1,52 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include "core/engine_buffer.hpp"
+#include "core/engine_device.hpp"
+#include "engine_camera.hpp"
+
+namespace vke {
+
+// std140 mirror of the Globals block of the forward and prepass shaders
+struct GlobalUniforms {
+	glm::mat4 projection{1.f};
+	glm::mat4 view{1.f};
+	glm::mat4 projectionView{1.f};
+	// Direction towards the directional light in xyz
+	glm::vec4 lightDirection{glm::normalize(glm::vec3(1.f, 2.f, 3.f)), 0.f};
+	// Seconds since the start in x, duration of the last frame in y
+	glm::vec4 time{0.f};
+};
+
+// Uniforms shared by every draw of a frame, written once per frame into the region of the frame in flight of a single
+// persistently mapped buffer. The set is bound with a dynamic offset selecting that region, so it is allocated and
+// written once and draws only push what is specific to them.
+class VkEngineGlobalUniforms : NO_COPY_NOR_MOVE {
+   public:
+	static constexpr u32 SET_INDEX = 2;
+
+	explicit VkEngineGlobalUniforms(std::shared_ptr<VkEngineDevice> device);
+
+	// Fills the uniforms from `camera`, the fence of `frameIndex` must have been waited on
+	void update(u32 frameIndex, const VkEngineCamera& camera, float time, float deltaTime);
+
+	// Binds the region written by the last update at SET_INDEX
+	void bind(const VkCommandBuffer* commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const;
+
+	[[nodiscard]] VkDescriptorSetLayout getSetLayout() const { return pSetLayout; }
+	[[nodiscard]] const GlobalUniforms& getUniforms() const { return mUniforms; }
+
+   private:
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+	// MAX_FRAMES_IN_FLIGHT regions, each aligned to minUniformBufferOffsetAlignment
+	std::unique_ptr<VkEngineBuffer> pBuffer{};
+	VkDescriptorSetLayout pSetLayout = VK_NULL_HANDLE;
+	VkDescriptorSet pDescriptorSet = VK_NULL_HANDLE;
+
+	GlobalUniforms mUniforms{};
+	u32 mFrameIndex = 0;
+};
+}  // namespace vke
@@ -0,0 +1,440 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_gpu_driven_system.hpp"
+
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "utils/logger.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+namespace {
+// std430 mirrors of the structs declared in cull.comp / indirect.vert
+struct GpuObjectData {
+	glm::mat4 transform{1.f};
+	glm::vec4 color{1.f};
+	glm::vec4 boundingSphere{0.f};
+	u32 modelIndex = 0;
+	u32 materialIndex = 0;
+	u32 pad[2]{};
+};
+
+struct GpuLodInfo {
+	u32 firstIndex = 0;
+	u32 indexCount = 0;
+	float maxDistance = 0.f;
+	u32 pad = 0;
+};
+
+struct GpuModelInfo {
+	u32 commandOffset = 0;
+	u32 lodCount = 0;
+	u32 pad[2]{};
+	std::array<GpuLodInfo, VkEngineGpuDrivenSystem::MAX_LODS> lods{};
+};
+
+struct CullPushConstants {
+	std::array<glm::vec4, 6> planes{};
+	glm::vec4 cameraPosition{0.f};
+	u32 objectCount = 0;
+};
+
+// std140 mirror of the Occlusion block of cull.comp
+struct OcclusionUniforms {
+	glm::mat4 viewProjection{1.f};
+	glm::vec2 pyramidSize{0.f};
+	u32 mipLevels = 0;
+	u32 enabled = 0;
+};
+
+static_assert(sizeof(GpuObjectData) == 112, "GpuObjectData must match the std430 layout of ObjectData");
+static_assert(sizeof(GpuModelInfo) == 80, "GpuModelInfo must match the std430 layout of ModelInfo");
+static_assert(sizeof(OcclusionUniforms) == 80, "OcclusionUniforms must match the std140 layout of Occlusion");
+
+constexpr u32 CULL_GROUP_SIZE = 64;
+constexpr u32 DESCRIPTOR_BINDING_COUNT = 5;
+}  // namespace
+
+VkEngineGpuDrivenSystem::VkEngineGpuDrivenSystem(std::shared_ptr<VkEngineDevice> device,
+                                                 const AttachmentFormats& attachmentFormats,
+                                                 const VkEngineBindlessHeap& bindlessHeap,
+                                                 const VkEngineLightSystem& lightSystem,
+                                                 const VkEngineGlobalUniforms& globalUniforms,
+                                                 const VkEngineResourceRegistry& resources)
+    : mVkDevice(std::move(device)), mBindlessHeap(bindlessHeap), mLightSystem(lightSystem),
+      mGlobalUniforms(globalUniforms), mResources(resources),
+      pDepthPyramid(std::make_unique<VkEngineDepthPyramid>(mVkDevice)) {
+	createDescriptorResources();
+	createPipelineLayouts();
+	createPipelines(attachmentFormats);
+}
+
+VkEngineGpuDrivenSystem::~VkEngineGpuDrivenSystem() {
+	vkDestroyPipelineLayout(mVkDevice->getDevice(), pCullPipelineLayout, nullptr);
+	vkDestroyPipelineLayout(mVkDevice->getDevice(), pDrawPipelineLayout, nullptr);
+}
+
+
+void VkEngineGpuDrivenSystem::createDescriptorResources() {
+	// objects, models, commands, counts, stats
+	std::array<VkDescriptorSetLayoutBinding, DESCRIPTOR_BINDING_COUNT> bindings{};
+	for (u32 i = 0; i < DESCRIPTOR_BINDING_COUNT; ++i) {
+		bindings[i] = {.binding = i,
+		               .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		               .descriptorCount = 1,
+		               .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT};
+	}
+
+	const VkDescriptorSetLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	                                                 .bindingCount = static_cast<u32>(bindings.size()),
+	                                                 .pBindings = bindings.data()};
+
+	pDescriptorSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(layoutInfo);
+
+	// depth pyramid, occlusion uniforms
+	constexpr std::array<VkDescriptorSetLayoutBinding, 2> occlusionBindings{{
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT},
+	}};
+
+	const VkDescriptorSetLayoutCreateInfo occlusionLayoutInfo{
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = static_cast<u32>(occlusionBindings.size()),
+	    .pBindings = occlusionBindings.data()};
+
+	pOcclusionSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(occlusionLayoutInfo);
+
+	// Rewritten in place whenever a buffer of the frame grows, so they come from the long lived allocator
+	for (auto& frame : mFrameResources) {
+		frame.descriptorSet = mVkDevice->getDescriptorAllocator().allocate(pDescriptorSetLayout);
+
+		frame.stats = std::make_unique<VkEngineBuffer>(
+		    mVkDevice, sizeof(GpuCullStats), 1, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		    VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT, VMA_MEMORY_USAGE_AUTO);
+		VK_CHECK(frame.stats->map());
+
+		frame.occlusion = std::make_unique<VkEngineBuffer>(
+		    mVkDevice, sizeof(OcclusionUniforms), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		    VMA_MEMORY_USAGE_AUTO);
+		VK_CHECK(frame.occlusion->map());
+	}
+}
+
+
+void VkEngineGpuDrivenSystem::createPipelineLayouts() {
+	static constexpr VkPushConstantRange cullPushConstantRange{
+	    .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+	    .offset = 0,
+	    .size = sizeof(CullPushConstants),
+	};
+
+	const std::array cullSetLayouts{pDescriptorSetLayout, pOcclusionSetLayout};
+	const VkPipelineLayoutCreateInfo cullLayoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                                .setLayoutCount = static_cast<u32>(cullSetLayouts.size()),
+	                                                .pSetLayouts = cullSetLayouts.data(),
+	                                                .pushConstantRangeCount = 1,
+	                                                .pPushConstantRanges = &cullPushConstantRange};
+
+	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &cullLayoutInfo, nullptr, &pCullPipelineLayout));
+
+	// The draw shares sets 0 to 2 with the other graphics pipelines (the bindless heap, the clustered lights and the
+	// per frame uniforms), the culling buffers move to set 3. Everything per object is read from them, nothing is
+	// pushed.
+	const std::array drawSetLayouts{mBindlessHeap.getSetLayout(), mLightSystem.getSetLayout(),
+	                                mGlobalUniforms.getSetLayout(), pDescriptorSetLayout};
+	const VkPipelineLayoutCreateInfo drawLayoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                                .setLayoutCount = static_cast<u32>(drawSetLayouts.size()),
+	                                                .pSetLayouts = drawSetLayouts.data()};
+
+	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &drawLayoutInfo, nullptr, &pDrawPipelineLayout));
+}
+
+
+void VkEngineGpuDrivenSystem::createPipelines(const AttachmentFormats& attachmentFormats) {
+	pCullPipeline = std::make_unique<VkEngineComputePipeline>(
+	    mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/cull.comp.spv", pCullPipelineLayout);
+
+	PipelineConfigInfo pipelineConfig{};
+	pipelineConfig.attachmentFormats = attachmentFormats;
+	pipelineConfig.pipelineLayout = pDrawPipelineLayout;
+
+	pDrawPipeline =
+	    std::make_unique<VkEnginePipeline>(mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/indirect.vert.spv",
+	                                       "C:/Users/zphrfx/Desktop/vkEngine/shaders/simple.frag.spv", pipelineConfig);
+}
+
+
+void VkEngineGpuDrivenSystem::reserveFrameResources(const u32 frameIndex, const u32 objectCount,
+                                                    const u32 modelCount) {
+	auto& frame = mFrameResources[frameIndex];
+
+	// The fence of this frame has been waited on by beginFrame, so neither the buffers nor the set are in use
+	const auto reserve = [this](std::unique_ptr<VkEngineBuffer>& buffer, const VkDeviceSize instanceSize,
+	                            const u32 count, const VkBufferUsageFlags usage, const bool hostVisible) {
+		if (buffer != nullptr && buffer->getInstanceCount() >= count) {
+			return false;
+		}
+
+		const u32 capacity = std::max(count, buffer != nullptr ? buffer->getInstanceCount() * 2 : 256u);
+		buffer = std::make_unique<VkEngineBuffer>(
+		    mVkDevice, instanceSize, capacity, usage,
+		    hostVisible ? VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT : 0,
+		    VMA_MEMORY_USAGE_AUTO);
+
+		if (hostVisible) {
+			VK_CHECK(buffer->map());
+		}
+		return true;
+	};
+
+	bool dirty = reserve(frame.objects, sizeof(GpuObjectData), objectCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true);
+	dirty |= reserve(frame.models, sizeof(GpuModelInfo), modelCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true);
+	dirty |= reserve(frame.commands, sizeof(VkDrawIndexedIndirectCommand), objectCount,
+	                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false);
+	dirty |= reserve(frame.counts, sizeof(u32), modelCount,
+	                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+	                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                 false);
+
+	if (!dirty) {
+		return;
+	}
+
+	const std::array bufferInfos = {frame.objects->descriptorInfo(), frame.models->descriptorInfo(),
+	                                frame.commands->descriptorInfo(), frame.counts->descriptorInfo(),
+	                                frame.stats->descriptorInfo()};
+
+	std::array<VkWriteDescriptorSet, DESCRIPTOR_BINDING_COUNT> writes{};
+	for (u32 i = 0; i < DESCRIPTOR_BINDING_COUNT; ++i) {
+		writes[i] = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		             .dstSet = frame.descriptorSet,
+		             .dstBinding = i,
+		             .descriptorCount = 1,
+		             .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		             .pBufferInfo = &bufferInfos[i]};
+	}
+
+	vkUpdateDescriptorSets(mVkDevice->getDevice(), static_cast<u32>(writes.size()), writes.data(), 0, nullptr);
+}
+
+
+void VkEngineGpuDrivenSystem::setOcclusionCulling(const bool enabled) {
+	mOcclusionCulling = enabled;
+	// Pyramids built before a gap would be tested against as if they were the previous frame
+	if (!enabled) {
+		pDepthPyramid->invalidate();
+	}
+}
+
+
+VkEngineGpuDrivenSystem::CullOutputs VkEngineGpuDrivenSystem::addCullPasses(
+    VkEngineRenderer& renderer, const VkEngineWorld& world, const VkEngineCamera& camera) {
+	const u32 frameIndex = renderer.getFrameIndex();
+	auto& graph = renderer.getRenderGraph();
+
+	// The fence of this frame has been waited on, the statistics its previous use wrote are visible
+	auto& frame = mFrameResources[frameIndex];
+	if (frame.hasPendingStats) {
+		VK_CHECK(frame.stats->invalidate());
+		mCullStats = *static_cast<const GpuCullStats*>(frame.stats->getMappedMemory());
+		frame.hasPendingStats = false;
+	}
+
+	mPyramidImage = {};
+	mMeshSlots.assign(mResources.getPool<VkEngineModel>().getCapacity(), {});
+	mSlotModels.clear();
+	mSlotCommandOffsets.clear();
+	mSlotCapacities.clear();
+	mSubmittedPrimitiveCount = 0;
+
+	// Every object may survive, so each model owns a command range as large as its object count. Objects whose mesh
+	// was released are left out.
+	u32 objectCount = 0;
+	world.forEach<WorldMatrixComponent, RenderComponent>(
+	    [&](Entity /*entity*/, const WorldMatrixComponent& /*matrix*/, const RenderComponent& render) {
+		    const VkEngineModel* model = mResources.get(render.mesh);
+		    if (model == nullptr) {
+			    return;
+		    }
+		    MeshSlot& entry = mMeshSlots[render.mesh.getIndex()];
+		    if (entry.mesh != render.mesh) {
+			    entry = {.mesh = render.mesh, .slot = static_cast<u32>(mSlotModels.size())};
+			    mSlotModels.push_back(model);
+			    mSlotCapacities.push_back(0);
+		    }
+		    ++mSlotCapacities[entry.slot];
+		    mSubmittedPrimitiveCount += mSlotModels[entry.slot]->getIndexCount() / 3;
+		    ++objectCount;
+	    });
+	if (objectCount == 0) {
+		return {};
+	}
+
+	u32 commandCount = 0;
+	for (const u32 capacity : mSlotCapacities) {
+		mSlotCommandOffsets.push_back(commandCount);
+		commandCount += capacity;
+	}
+
+	const auto modelCount = static_cast<u32>(mSlotModels.size());
+	reserveFrameResources(frameIndex, objectCount, modelCount);
+
+	auto* const models = static_cast<GpuModelInfo*>(frame.models->getMappedMemory());
+	for (u32 slot = 0; slot < modelCount; ++slot) {
+		const auto& lods = mSlotModels[slot]->getLods();
+		GpuModelInfo& model = models[slot];
+		model.commandOffset = mSlotCommandOffsets[slot];
+		model.lodCount = std::min(static_cast<u32>(lods.size()), MAX_LODS);
+		for (u32 lod = 0; lod < model.lodCount; ++lod) {
+			model.lods[lod] = {.firstIndex = lods[lod].firstIndex,
+			                   .indexCount = lods[lod].indexCount,
+			                   .maxDistance = lods[lod].maxDistance};
+		}
+	}
+
+	auto* const gpuObjects = static_cast<GpuObjectData*>(frame.objects->getMappedMemory());
+	u32 objectIndex = 0;
+	world.forEach<WorldMatrixComponent, RenderComponent>(
+	    [&](Entity /*entity*/, const WorldMatrixComponent& matrix, const RenderComponent& render) {
+		    if (mResources.get(render.mesh) == nullptr) {
+			    return;
+		    }
+		    const u32 slot = mMeshSlots[render.mesh.getIndex()].slot;
+		    gpuObjects[objectIndex++] = {.transform = matrix.matrix,
+		                                 .color = glm::vec4(render.color, 1.f),
+		                                 .boundingSphere = mSlotModels[slot]->getBoundingSphere(),
+		                                 .modelIndex = slot,
+		                                 .materialIndex = render.materialIndex};
+	    });
+
+	VK_CHECK(frame.models->flush());
+	VK_CHECK(frame.objects->flush());
+
+	const auto importBuffer = [&graph](std::string name, const VkEngineBuffer& buffer) {
+		return graph.importBuffer(std::move(name), buffer.getBuffer(), buffer.getBufferSize());
+	};
+	CullOutputs outputs{
+	    .objects = importBuffer("gpu objects", *frame.objects),
+	    .commands = importBuffer("indirect commands", *frame.commands),
+	    .counts = importBuffer("indirect counts", *frame.counts),
+	};
+	const RenderGraphBuffer stats = importBuffer("gpu cull stats", *frame.stats);
+	graph.exportBuffer(stats, {.stages = VK_PIPELINE_STAGE_2_HOST_BIT, .access = VK_ACCESS_2_HOST_READ_BIT});
+	frame.hasPendingStats = true;
+
+	// Always imported, even without occlusion culling the set read by the shader must point at a valid layout
+	mPyramidImage = pDepthPyramid->import(graph, renderer.getSwapChainExtent());
+	const OcclusionUniforms occlusion{
+	    .viewProjection = pDepthPyramid->getViewProjection(),
+	    .pyramidSize = {static_cast<float>(pDepthPyramid->getExtent().width),
+	                    static_cast<float>(pDepthPyramid->getExtent().height)},
+	    .mipLevels = pDepthPyramid->getMipLevels(),
+	    .enabled = mOcclusionCulling && pDepthPyramid->hasHistory() ? 1u : 0u,
+	};
+	frame.occlusion->writeToBuffer(&occlusion);
+	VK_CHECK(frame.occlusion->flush());
+
+	const std::array descriptorSets{frame.descriptorSet,
+	                                renderer.getFrameDescriptorAllocator().allocate(pOcclusionSetLayout)};
+	const VkDescriptorImageInfo pyramidInfo = pDepthPyramid->descriptorInfo();
+	const VkDescriptorBufferInfo occlusionInfo = frame.occlusion->descriptorInfo();
+	const std::array occlusionWrites{
+	    VkWriteDescriptorSet{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	                         .dstSet = descriptorSets[1],
+	                         .dstBinding = 0,
+	                         .descriptorCount = 1,
+	                         .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	                         .pImageInfo = &pyramidInfo},
+	    VkWriteDescriptorSet{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	                         .dstSet = descriptorSets[1],
+	                         .dstBinding = 1,
+	                         .descriptorCount = 1,
+	                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	                         .pBufferInfo = &occlusionInfo},
+	};
+	vkUpdateDescriptorSets(mVkDevice->getDevice(), static_cast<u32>(occlusionWrites.size()), occlusionWrites.data(), 0,
+	                       nullptr);
+
+	// Reset the per model counters and the statistics before the culling pass appends to them
+	graph.addPass("clear indirect counts")
+	    .write(outputs.counts, RenderGraphUsage::TransferDst)
+	    .write(stats, RenderGraphUsage::TransferDst)
+	    .setExecute([counts = outputs.counts, stats](const RenderGraphContext& context) {
+		    vkCmdFillBuffer(context.commandBuffer, context.graph->getBuffer(counts), 0, VK_WHOLE_SIZE, 0);
+		    vkCmdFillBuffer(context.commandBuffer, context.graph->getBuffer(stats), 0, VK_WHOLE_SIZE, 0);
+	    });
+
+	const CullPushConstants pushConstants{
+	    .planes = camera.extractFrustumPlanes(),
+	    .cameraPosition = glm::inverse(camera.getViewMatrix())[3],
+	    .objectCount = objectCount,
+	};
+
+	graph.addPass("gpu cull")
+	    .read(outputs.objects, RenderGraphUsage::StorageCompute)
+	    .read(outputs.counts, RenderGraphUsage::StorageCompute)
+	    .write(outputs.commands, RenderGraphUsage::StorageCompute)
+	    .write(outputs.counts, RenderGraphUsage::StorageCompute)
+	    .read(stats, RenderGraphUsage::StorageCompute)
+	    .write(stats, RenderGraphUsage::StorageCompute)
+	    .read(mPyramidImage, RenderGraphUsage::SampledCompute)
+	    .setExecute([this, descriptorSets, pushConstants](const RenderGraphContext& context) {
+		    pCullPipeline->bind(&context.commandBuffer);
+		    vkCmdBindDescriptorSets(context.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pCullPipelineLayout, 0,
+		                            static_cast<u32>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+		    vkCmdPushConstants(context.commandBuffer, pCullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+		                       sizeof(CullPushConstants), &pushConstants);
+		    vkCmdDispatch(context.commandBuffer, (pushConstants.objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1,
+		                  1);
+	    });
+
+	return outputs;
+}
+
+
+void VkEngineGpuDrivenSystem::addDepthPyramidPass(VkEngineRenderer& renderer, const RenderGraphImage depth,
+                                                  const VkEngineCamera& camera) {
+	if (!mOcclusionCulling || !mPyramidImage.isValid()) {
+		return;
+	}
+
+	pDepthPyramid->addBuildPass(renderer.getRenderGraph(), renderer.getFrameDescriptorAllocator(), depth,
+	                            mPyramidImage, camera.getProjectionMatrix() * camera.getViewMatrix());
+}
+
+
+void VkEngineGpuDrivenSystem::renderGameObjects(const VkCommandBuffer* const commandBuffer,
+                                                const u32 frameIndex) const {
+	if (mSlotModels.empty()) {
+		return;
+	}
+
+	const auto& frame = mFrameResources[frameIndex];
+
+	pDrawPipeline->bind(commandBuffer);
+	mBindlessHeap.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pDrawPipelineLayout);
+	mLightSystem.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pDrawPipelineLayout);
+	mGlobalUniforms.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pDrawPipelineLayout);
+	vkCmdBindDescriptorSets(*commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pDrawPipelineLayout, 3, 1,
+	                        &frame.descriptorSet, 0, nullptr);
+
+	for (size_t slot = 0; slot < mSlotModels.size(); ++slot) {
+		mSlotModels[slot]->bind(commandBuffer);
+		vkCmdDrawIndexedIndirectCount(*commandBuffer, frame.commands->getBuffer(),
+		                              mSlotCommandOffsets[slot] * sizeof(VkDrawIndexedIndirectCommand),
+		                              frame.counts->getBuffer(), slot * sizeof(u32), mSlotCapacities[slot],
+		                              sizeof(VkDrawIndexedIndirectCommand));
+	}
+}
+
+}  // namespace vke
@@ -0,0 +1,125 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include "core/engine_bindless_heap.hpp"
+#include "core/engine_buffer.hpp"
+#include "core/engine_device.hpp"
+#include "core/engine_ecs.hpp"
+#include "core/engine_pipeline.hpp"
+#include "core/engine_resources.hpp"
+#include "engine_camera.hpp"
+#include "engine_depth_pyramid.hpp"
+#include "engine_global_uniforms.hpp"
+#include "engine_light_system.hpp"
+#include "engine_render_graph.hpp"
+#include "engine_renderer.hpp"
+
+namespace vke {
+
+// Objects that passed the frustum test, split by the outcome of the occlusion test
+struct GpuCullStats {
+	u32 visibleObjects = 0;
+	u32 occludedObjects = 0;
+};
+
+// GPU driven path: object transforms and bounds are uploaded to storage buffers, a compute pass frustum culls them,
+// tests the survivors against the depth pyramid of the previous frame, selects a LOD and appends
+// VkDrawIndexedIndirectCommands, the forward pass then consumes them with vkCmdDrawIndexedIndirectCount
+class VkEngineGpuDrivenSystem {
+   public:
+	static constexpr u32 MAX_LODS = 4;
+
+	// Buffers written by the culling passes, the pass drawing them must read them through the graph
+	struct CullOutputs {
+		RenderGraphBuffer objects{};
+		RenderGraphBuffer commands{};
+		RenderGraphBuffer counts{};
+	};
+
+	VkEngineGpuDrivenSystem(std::shared_ptr<VkEngineDevice> device, const AttachmentFormats& attachmentFormats,
+	                        const VkEngineBindlessHeap& bindlessHeap, const VkEngineLightSystem& lightSystem,
+	                        const VkEngineGlobalUniforms& globalUniforms, const VkEngineResourceRegistry& resources);
+
+	~VkEngineGpuDrivenSystem();
+
+	VkEngineGpuDrivenSystem(const VkEngineGpuDrivenSystem&) = delete;
+
+	VkEngineGpuDrivenSystem& operator=(const VkEngineGpuDrivenSystem&) = delete;
+
+	// Uploads the objects and declares the passes clearing the counters and dispatching the culling shader, the graph
+	// places the barriers between them and the indirect draws
+	CullOutputs addCullPasses(VkEngineRenderer& renderer, const VkEngineWorld& world, const VkEngineCamera& camera);
+
+	// Declares the pass reducing the depth of the frame into the pyramid the next frame culls against, after the
+	// pass writing `depth`
+	void addDepthPyramidPass(VkEngineRenderer& renderer, RenderGraphImage depth, const VkEngineCamera& camera);
+
+	// Draws what survived culling, one indirect count draw per unique model
+	void renderGameObjects(const VkCommandBuffer* commandBuffer, u32 frameIndex) const;
+
+	// Primitives the scene would submit at LOD 0 without culling, to compare against the pipeline statistics
+	[[nodiscard]] u64 getSubmittedPrimitiveCount() const { return mSubmittedPrimitiveCount; }
+	// Read back from the GPU, they lag MAX_FRAMES_IN_FLIGHT frames behind
+	[[nodiscard]] const GpuCullStats& getCullStats() const { return mCullStats; }
+
+	void setOcclusionCulling(bool enabled);
+	[[nodiscard]] bool isOcclusionCullingEnabled() const { return mOcclusionCulling; }
+
+   private:
+	struct FrameResources {
+		std::unique_ptr<VkEngineBuffer> objects{};
+		std::unique_ptr<VkEngineBuffer> models{};
+		std::unique_ptr<VkEngineBuffer> commands{};
+		std::unique_ptr<VkEngineBuffer> counts{};
+		// GpuCullStats, written by the culling shader and read on the host
+		std::unique_ptr<VkEngineBuffer> stats{};
+		std::unique_ptr<VkEngineBuffer> occlusion{};
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+		bool hasPendingStats = false;
+	};
+
+	void createDescriptorResources();
+	void createPipelineLayouts();
+	void createPipelines(const AttachmentFormats& attachmentFormats);
+	void reserveFrameResources(u32 frameIndex, u32 objectCount, u32 modelCount);
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+	const VkEngineBindlessHeap& mBindlessHeap;
+	const VkEngineLightSystem& mLightSystem;
+	const VkEngineGlobalUniforms& mGlobalUniforms;
+	const VkEngineResourceRegistry& mResources;
+
+	VkDescriptorSetLayout pDescriptorSetLayout = VK_NULL_HANDLE;
+	VkDescriptorSetLayout pOcclusionSetLayout = VK_NULL_HANDLE;
+	VkPipelineLayout pCullPipelineLayout = VK_NULL_HANDLE;
+	VkPipelineLayout pDrawPipelineLayout = VK_NULL_HANDLE;
+
+	std::unique_ptr<VkEngineComputePipeline> pCullPipeline{};
+	std::unique_ptr<VkEnginePipeline> pDrawPipeline{};
+
+	std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> mFrameResources{};
+
+	std::unique_ptr<VkEngineDepthPyramid> pDepthPyramid{};
+	// Imported by addCullPasses, built by addDepthPyramidPass
+	RenderGraphImage mPyramidImage{};
+	bool mOcclusionCulling = true;
+	GpuCullStats mCullStats{};
+
+	// per model draw ranges of the frame being recorded, filled by addCullPasses and read by renderGameObjects
+	// Slot of each mesh with objects, indexed by handle index and tagged with the full handle so that a stale handle
+	// reusing the index is never taken for the live mesh
+	struct MeshSlot {
+		MeshHandle mesh{};
+		u32 slot = 0;
+	};
+	std::vector<MeshSlot> mMeshSlots{};
+	std::vector<const VkEngineModel*> mSlotModels{};
+	std::vector<u32> mSlotCommandOffsets{};
+	std::vector<u32> mSlotCapacities{};
+
+	u64 mSubmittedPrimitiveCount = 0;
+};
+}  // namespace vke
@@ -0,0 +1,181 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_light_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/logger.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+namespace {
+// std430 mirror of the Light struct of light_cluster.comp / simple.frag, positions and directions in view space
+struct GpuLight {
+	glm::vec4 positionRange{0.f};
+	glm::vec4 colorIntensity{0.f};
+	glm::vec4 directionCosOuter{0.f};
+	glm::vec4 spot{0.f};
+};
+
+// std140 mirror of the Clusters block of light_cluster.comp / simple.frag
+struct ClusterUniforms {
+	glm::mat4 inverseProjection{1.f};
+	// Grid size in xyz, light count in w
+	glm::uvec4 gridSize{0};
+	glm::vec4 screenSize{0.f};
+	// near, far, scale and bias turning log(view depth) into a slice index
+	glm::vec4 depthSlicing{0.f};
+};
+
+static_assert(sizeof(GpuLight) == 64, "GpuLight must match the std430 layout of Light");
+static_assert(sizeof(ClusterUniforms) == 112, "ClusterUniforms must match the std140 layout of Clusters");
+
+constexpr u32 CLUSTER_GROUP_SIZE = 64;
+static_assert(VkEngineLightSystem::CLUSTER_COUNT % CLUSTER_GROUP_SIZE == 0, "Every invocation must own a cluster");
+}  // namespace
+
+VkEngineLightSystem::VkEngineLightSystem(std::shared_ptr<VkEngineDevice> device) : mVkDevice(std::move(device)) {
+	createDescriptorResources();
+	createPipeline();
+}
+
+VkEngineLightSystem::~VkEngineLightSystem() {
+	vkDestroyPipelineLayout(mVkDevice->getDevice(), pPipelineLayout, nullptr);
+}
+
+
+void VkEngineLightSystem::createDescriptorResources() {
+	// uniforms, lights, counts, indices
+	constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	constexpr std::array<VkDescriptorSetLayoutBinding, 4> bindings{{
+	    {.binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1, .stageFlags = stages},
+	    {.binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = stages},
+	    {.binding = 2, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = stages},
+	    {.binding = 3, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = stages},
+	}};
+
+	const VkDescriptorSetLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	                                                 .bindingCount = static_cast<u32>(bindings.size()),
+	                                                 .pBindings = bindings.data()};
+
+	pSetLayout = mVkDevice->getDescriptorLayoutCache().getLayout(layoutInfo);
+
+	// Sized for MAX_LIGHTS up front, so the sets are written once and never change
+	for (auto& frame : mFrameResources) {
+		frame.uniforms = std::make_unique<VkEngineBuffer>(
+		    mVkDevice, sizeof(ClusterUniforms), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		    VMA_MEMORY_USAGE_AUTO);
+		VK_CHECK(frame.uniforms->map());
+
+		frame.lights = std::make_unique<VkEngineBuffer>(
+		    mVkDevice, sizeof(GpuLight), MAX_LIGHTS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		    VMA_MEMORY_USAGE_AUTO);
+		VK_CHECK(frame.lights->map());
+
+		frame.counts = std::make_unique<VkEngineBuffer>(mVkDevice, sizeof(u32), CLUSTER_COUNT,
+		                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO);
+		frame.indices =
+		    std::make_unique<VkEngineBuffer>(mVkDevice, sizeof(u32), CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER,
+		                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO);
+
+		const std::array bufferInfos{frame.uniforms->descriptorInfo(), frame.lights->descriptorInfo(),
+		                             frame.counts->descriptorInfo(), frame.indices->descriptorInfo()};
+		std::array<VkEngineDescriptorSetCache::Write, bindings.size()> writes{};
+		for (u32 i = 0; i < writes.size(); ++i) {
+			writes[i] = {.binding = i, .type = bindings[i].descriptorType, .buffer = bufferInfos[i]};
+		}
+		frame.descriptorSet = mVkDevice->getDescriptorSetCache().getSet(pSetLayout, writes);
+	}
+}
+
+
+void VkEngineLightSystem::createPipeline() {
+	const VkPipelineLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                            .setLayoutCount = 1,
+	                                            .pSetLayouts = &pSetLayout};
+	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &layoutInfo, nullptr, &pPipelineLayout));
+
+	pPipeline = std::make_unique<VkEngineComputePipeline>(
+	    mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/light_cluster.comp.spv", pPipelineLayout);
+}
+
+
+VkEngineLightSystem::ClusterOutputs VkEngineLightSystem::addClusterPass(VkEngineRenderer& renderer,
+                                                                        const VkEngineCamera& camera,
+                                                                        const std::span<const Light> lights) {
+	mFrameIndex = renderer.getFrameIndex();
+	auto& frame = mFrameResources[mFrameIndex];
+	auto& graph = renderer.getRenderGraph();
+
+	// Moved to view space here so neither shader needs the view matrix, and the froxels stay axis aligned
+	const glm::mat4& view = camera.getViewMatrix();
+	mLightCount = static_cast<u32>(std::min<size_t>(lights.size(), MAX_LIGHTS));
+	auto* const gpuLights = static_cast<GpuLight*>(frame.lights->getMappedMemory());
+	for (u32 i = 0; i < mLightCount; ++i) {
+		const Light& light = lights[i];
+		// Only a spot light is oriented, normalizing the direction of any other light could upload a NaN. A spot
+		// without a direction is lit like a point light.
+		const glm::vec3 direction = glm::mat3(view) * light.direction;
+		const float directionLength = glm::length(direction);
+		const bool spot = light.spotCosOuter > -1.f && directionLength > 0.f;
+		gpuLights[i] = {
+		    .positionRange = {glm::vec3(view * glm::vec4(light.position, 1.f)), light.range},
+		    .colorIntensity = {light.color, light.intensity},
+		    .directionCosOuter = spot ? glm::vec4{direction / directionLength, light.spotCosOuter}
+		                              : glm::vec4{0.f, 0.f, 0.f, -1.f},
+		    .spot = {light.spotCosInner, 0.f, 0.f, 0.f},
+		};
+	}
+	if (mLightCount != 0) {
+		VK_CHECK(frame.lights->flush());
+	}
+
+	// Slice k spans [near * (far / near)^(k / Z), near * (far / near)^((k + 1) / Z)), the slices grow with the
+	// distance like the screen footprint of a pixel does
+	const float zNear = camera.getNear();
+	const float zFar = camera.getFar();
+	const float logRatio = std::log(zFar / zNear);
+	const VkExtent2D extent = renderer.getSwapChainExtent();
+	const ClusterUniforms uniforms{
+	    .inverseProjection = glm::inverse(camera.getProjectionMatrix()),
+	    .gridSize = {GRID_X, GRID_Y, GRID_Z, mLightCount},
+	    .screenSize = {static_cast<float>(extent.width), static_cast<float>(extent.height), 0.f, 0.f},
+	    .depthSlicing = {zNear, zFar, static_cast<float>(GRID_Z) / logRatio,
+	                     static_cast<float>(GRID_Z) * std::log(zNear) / logRatio},
+	};
+	frame.uniforms->writeToBuffer(&uniforms);
+	VK_CHECK(frame.uniforms->flush());
+
+	// Every cluster writes its own count and range, nothing needs clearing beforehand
+	const ClusterOutputs outputs{
+	    .counts = graph.importBuffer("light cluster counts", frame.counts->getBuffer(), frame.counts->getBufferSize()),
+	    .indices =
+	        graph.importBuffer("light cluster indices", frame.indices->getBuffer(), frame.indices->getBufferSize()),
+	};
+
+	graph.addPass("light culling")
+	    .write(outputs.counts, RenderGraphUsage::StorageCompute)
+	    .write(outputs.indices, RenderGraphUsage::StorageCompute)
+	    .setExecute([this, descriptorSet = frame.descriptorSet](const RenderGraphContext& context) {
+		    pPipeline->bind(&context.commandBuffer);
+		    vkCmdBindDescriptorSets(context.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pPipelineLayout, 0, 1,
+		                            &descriptorSet, 0, nullptr);
+		    vkCmdDispatch(context.commandBuffer, CLUSTER_COUNT / CLUSTER_GROUP_SIZE, 1, 1);
+	    });
+
+	return outputs;
+}
+
+
+void VkEngineLightSystem::bind(const VkCommandBuffer* const commandBuffer, const VkPipelineBindPoint bindPoint,
+                               const VkPipelineLayout layout, const u32 set) const {
+	vkCmdBindDescriptorSets(*commandBuffer, bindPoint, layout, set, 1, &mFrameResources[mFrameIndex].descriptorSet, 0,
+	                        nullptr);
+}
+
+}  // namespace vke
@@ -0,0 +1,87 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+
+#include "core/engine_buffer.hpp"
+#include "core/engine_device.hpp"
+#include "core/engine_pipeline.hpp"
+#include "engine_camera.hpp"
+#include "engine_render_graph.hpp"
+#include "engine_renderer.hpp"
+
+namespace vke {
+
+// World space point or spot light, a spot light has a cone: spotCosOuter > -1
+struct Light {
+	glm::vec3 position{0.f};
+	// Distance at which the contribution reaches zero, also the bounding sphere used to bin the light
+	float range = 1.f;
+	glm::vec3 color{1.f};
+	float intensity = 1.f;
+	glm::vec3 direction{0.f, 1.f, 0.f};
+	float spotCosOuter = -1.f;
+	float spotCosInner = -1.f;
+};
+
+// Clustered forward lighting: the view frustum is split into a froxel grid (screen tiles times exponential depth
+// slices), a compute pass bins the lights into the froxels their range touches, and the forward fragment shader only
+// loops over the lights of the froxel it lands in. The lights set is bound at set 1 of the forward pipelines.
+class VkEngineLightSystem : NO_COPY_NOR_MOVE {
+   public:
+	static constexpr u32 GRID_X = 16;
+	static constexpr u32 GRID_Y = 9;
+	static constexpr u32 GRID_Z = 24;
+	static constexpr u32 CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+	// Lights past this count in one froxel are dropped
+	static constexpr u32 MAX_LIGHTS_PER_CLUSTER = 128;
+	static constexpr u32 MAX_LIGHTS = 16384;
+
+	// Buffers written by the binning pass, the passes shading with the lights must read them through the graph
+	struct ClusterOutputs {
+		RenderGraphBuffer counts{};
+		RenderGraphBuffer indices{};
+	};
+
+	explicit VkEngineLightSystem(std::shared_ptr<VkEngineDevice> device);
+
+	~VkEngineLightSystem();
+
+	// Uploads `lights` in view space and declares the pass binning them, the lights past MAX_LIGHTS are ignored.
+	// The camera must use a perspective projection.
+	ClusterOutputs addClusterPass(VkEngineRenderer& renderer, const VkEngineCamera& camera,
+	                              std::span<const Light> lights);
+
+	// Binds the lights of the frame declared last at `set`
+	void bind(const VkCommandBuffer* commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout,
+	          u32 set = 1) const;
+
+	[[nodiscard]] VkDescriptorSetLayout getSetLayout() const { return pSetLayout; }
+	[[nodiscard]] u32 getLightCount() const { return mLightCount; }
+
+   private:
+	struct FrameResources {
+		std::unique_ptr<VkEngineBuffer> uniforms{};
+		std::unique_ptr<VkEngineBuffer> lights{};
+		std::unique_ptr<VkEngineBuffer> counts{};
+		std::unique_ptr<VkEngineBuffer> indices{};
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+	};
+
+	void createDescriptorResources();
+	void createPipeline();
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+
+	VkDescriptorSetLayout pSetLayout = VK_NULL_HANDLE;
+	VkPipelineLayout pPipelineLayout = VK_NULL_HANDLE;
+	std::unique_ptr<VkEngineComputePipeline> pPipeline{};
+
+	std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> mFrameResources{};
+	u32 mFrameIndex = 0;
+	u32 mLightCount = 0;
+};
+}  // namespace vke
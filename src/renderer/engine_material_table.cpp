@@ -0,0 +1,38 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_material_table.hpp"
+
+#include "utils/logger.hpp"
+
+namespace vke {
+
+static_assert(sizeof(GpuMaterial) == 32, "GpuMaterial must match the std430 layout of Material");
+
+VkEngineMaterialTable::VkEngineMaterialTable(std::shared_ptr<VkEngineDevice> device, const VkEngineBindlessHeap& heap)
+    : mVkDevice(std::move(device)) {
+	pMaterialBuffer = std::make_unique<VkEngineBuffer>(
+	    mVkDevice, sizeof(GpuMaterial), MAX_MATERIALS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+	    VMA_MEMORY_USAGE_AUTO);
+	VK_CHECK(pMaterialBuffer->map());
+
+	heap.writeStorageBuffer(VkEngineBindlessHeap::MATERIAL_BUFFER_SLOT, pMaterialBuffer->descriptorInfo());
+
+	[[maybe_unused]] const u32 defaultMaterial = createMaterial({});
+	assert(defaultMaterial == DEFAULT_MATERIAL);
+}
+
+u32 VkEngineMaterialTable::createMaterial(const GpuMaterial& material) {
+	if (mMaterialCount >= MAX_MATERIALS) {
+		throw std::runtime_error("Material table is full");
+	}
+
+	const u32 index = mMaterialCount++;
+	pMaterialBuffer->writeToIndex(&material, static_cast<int>(index));
+	VK_CHECK(pMaterialBuffer->flushIndex(static_cast<int>(index)));
+	return index;
+}
+
+}  // namespace vke
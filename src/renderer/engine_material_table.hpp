@@ -0,0 +1,46 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "core/engine_bindless_heap.hpp"
+#include "core/engine_buffer.hpp"
+
+namespace vke {
+
+// Matches the std430 layout of Material in simple.frag
+struct GpuMaterial {
+	glm::vec4 baseColor{1.f};
+	u32 albedoTexture = VkEngineBindlessHeap::DEFAULT_TEXTURE;
+	u32 albedoSampler = VkEngineBindlessHeap::DEFAULT_SAMPLER;
+	u32 pad[2]{};
+};
+
+// Every material of the scene in one storage buffer, published in the bindless heap at MATERIAL_BUFFER_SLOT. Draws
+// only carry a material index, which the fragment shader uses to fetch the material and then its textures.
+class VkEngineMaterialTable {
+   public:
+	static constexpr u32 MAX_MATERIALS = 4096;
+	static constexpr u32 DEFAULT_MATERIAL = 0;
+
+	VkEngineMaterialTable(std::shared_ptr<VkEngineDevice> device, const VkEngineBindlessHeap& heap);
+
+	VkEngineMaterialTable(const VkEngineMaterialTable&) = delete;
+
+	VkEngineMaterialTable& operator=(const VkEngineMaterialTable&) = delete;
+
+	// Materials are immutable once created, so appending one never races with the frames in flight
+	u32 createMaterial(const GpuMaterial& material);
+
+	[[nodiscard]] u32 getMaterialCount() const { return mMaterialCount; }
+
+   private:
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+	std::unique_ptr<VkEngineBuffer> pMaterialBuffer{};
+	u32 mMaterialCount = 0;
+};
+
+}  // namespace vke
@@ -0,0 +1,306 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_occlusion_culling.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VKE_OCCLUSION_SSE2 1
+#endif
+
+namespace vke {
+namespace {
+// Vertices closer than this in clip space w are treated as crossing the near plane
+constexpr float MIN_CLIP_W = 1e-4f;
+constexpr i32 LAST_X = static_cast<i32>(VkEngineOcclusionCuller::WIDTH) - 1;
+constexpr i32 LAST_Y = static_cast<i32>(VkEngineOcclusionCuller::HEIGHT) - 1;
+
+float elapsedMs(const std::chrono::high_resolution_clock::time_point start) {
+	return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+glm::vec2 toScreen(const glm::vec4& clip) {
+	return {(clip.x / clip.w * .5f + .5f) * static_cast<float>(VkEngineOcclusionCuller::WIDTH),
+	        (clip.y / clip.w * .5f + .5f) * static_cast<float>(VkEngineOcclusionCuller::HEIGHT)};
+}
+}  // namespace
+
+VkEngineOcclusionCuller::VkEngineOcclusionCuller(ThreadPool& threadPool)
+    : mThreadPool(threadPool), mDepth(WIDTH * HEIGHT, 1.f) {}
+
+
+void VkEngineOcclusionCuller::beginFrame(const glm::mat4& viewProjection) {
+	mViewProjection = viewProjection;
+	mTriangles.clear();
+	std::ranges::fill(mDepth, 1.f);
+	mStats = {};
+}
+
+
+void VkEngineOcclusionCuller::addOccluder(const std::span<const glm::vec3> positions, const std::span<const u32> indices,
+                                          const glm::mat4& world) {
+	const glm::mat4 worldViewProjection = mViewProjection * world;
+	mClipScratch.resize(positions.size());
+	std::ranges::transform(positions, mClipScratch.begin(),
+	                       [&](const glm::vec3& position) { return worldViewProjection * glm::vec4(position, 1.f); });
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const glm::vec4& c0 = mClipScratch[indices[i]];
+		const glm::vec4& c1 = mClipScratch[indices[i + 1]];
+		const glm::vec4& c2 = mClipScratch[indices[i + 2]];
+		if (c0.w < MIN_CLIP_W || c1.w < MIN_CLIP_W || c2.w < MIN_CLIP_W) {
+			continue;
+		}
+
+		glm::vec2 p0 = toScreen(c0);
+		glm::vec2 p1 = toScreen(c1);
+		glm::vec2 p2 = toScreen(c2);
+
+		// Occluders are rasterized double sided, flipping the winding makes the inside positive for every edge
+		const float area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+		if (std::abs(area) < 1e-6f) {
+			continue;
+		}
+		if (area < 0.f) {
+			std::swap(p1, p2);
+		}
+
+		ScreenTriangle triangle{};
+		triangle.minX = std::max(static_cast<i32>(std::floor(std::min({p0.x, p1.x, p2.x}))), 0);
+		triangle.maxX = std::min(static_cast<i32>(std::ceil(std::max({p0.x, p1.x, p2.x}))), LAST_X);
+		triangle.minY = std::max(static_cast<i32>(std::floor(std::min({p0.y, p1.y, p2.y}))), 0);
+		triangle.maxY = std::min(static_cast<i32>(std::ceil(std::max({p0.y, p1.y, p2.y}))), LAST_Y);
+		if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+			continue;
+		}
+
+		const std::array vertices{p0, p1, p2};
+		for (u32 e = 0; e < 3; ++e) {
+			const glm::vec2& from = vertices[e];
+			const glm::vec2& to = vertices[(e + 1) % 3];
+			triangle.edgeA[e] = from.y - to.y;
+			triangle.edgeB[e] = to.x - from.x;
+			triangle.edgeC[e] = -(triangle.edgeA[e] * from.x + triangle.edgeB[e] * from.y);
+		}
+		triangle.depth = std::max({c0.z / c0.w, c1.z / c1.w, c2.z / c2.w});
+
+		mTriangles.push_back(triangle);
+	}
+
+	mStats.occluderTriangles = static_cast<u32>(mTriangles.size());
+}
+
+
+void VkEngineOcclusionCuller::rasterize() {
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	mThreadPool.parallelFor(HEIGHT, BAND_HEIGHT, [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		for (u32 band = begin; band < end; band += BAND_HEIGHT) {
+			rasterizeBand(band, std::min(band + BAND_HEIGHT, end));
+		}
+	});
+
+	mStats.rasterizeMs = elapsedMs(start);
+}
+
+
+void VkEngineOcclusionCuller::rasterizeBand(const u32 bandY, const u32 bandEnd) {
+	float* const depth = mDepth.data();
+
+	for (const ScreenTriangle& triangle : mTriangles) {
+		const i32 y0 = std::max(triangle.minY, static_cast<i32>(bandY));
+		const i32 y1 = std::min(triangle.maxY, static_cast<i32>(bandEnd) - 1);
+		// Groups of 8 pixels start on a multiple of 8, WIDTH being one too the last group never leaves the row
+		const i32 x0 = triangle.minX & ~7;
+		const i32 x1 = triangle.maxX;
+
+		for (i32 y = y0; y <= y1; ++y) {
+			const float py = static_cast<float>(y) + .5f;
+			float* const row = depth + static_cast<size_t>(y) * WIDTH;
+			std::array<float, 3> rowEdge{};
+			for (u32 e = 0; e < 3; ++e) {
+				rowEdge[e] = triangle.edgeB[e] * py + triangle.edgeC[e];
+			}
+
+			i32 x = x0;
+#if defined(__AVX2__)
+			const __m256 laneOffsets = _mm256_setr_ps(.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 triangleDepth = _mm256_set1_ps(triangle.depth);
+			for (; x <= x1; x += 8) {
+				const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+				__m256 covered = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (u32 e = 0; e < 3; ++e) {
+					const __m256 edge =
+					    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[e]), px), _mm256_set1_ps(rowEdge[e]));
+					covered = _mm256_and_ps(covered, _mm256_cmp_ps(edge, zero, _CMP_GE_OQ));
+				}
+				if (_mm256_movemask_ps(covered) == 0) {
+					continue;
+				}
+				const __m256 old = _mm256_loadu_ps(row + x);
+				_mm256_storeu_ps(row + x, _mm256_blendv_ps(old, _mm256_min_ps(old, triangleDepth), covered));
+			}
+#elif defined(VKE_OCCLUSION_SSE2)
+			const __m128 laneOffsets = _mm_setr_ps(.5f, 1.5f, 2.5f, 3.5f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 triangleDepth = _mm_set1_ps(triangle.depth);
+			for (; x <= x1; x += 4) {
+				const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+				__m128 covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (u32 e = 0; e < 3; ++e) {
+					const __m128 edge =
+					    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[e]), px), _mm_set1_ps(rowEdge[e]));
+					covered = _mm_and_ps(covered, _mm_cmpge_ps(edge, zero));
+				}
+				if (_mm_movemask_ps(covered) == 0) {
+					continue;
+				}
+				// SSE2 has no blend, select through the mask instead
+				const __m128 old = _mm_loadu_ps(row + x);
+				const __m128 nearest = _mm_min_ps(old, triangleDepth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(covered, nearest), _mm_andnot_ps(covered, old)));
+			}
+#endif
+
+			for (; x <= x1; ++x) {
+				const float px = static_cast<float>(x) + .5f;
+				bool covered = true;
+				for (u32 e = 0; e < 3; ++e) {
+					covered &= triangle.edgeA[e] * px + rowEdge[e] >= 0.f;
+				}
+				if (covered) {
+					row[x] = std::min(row[x], triangle.depth);
+				}
+			}
+		}
+	}
+}
+
+
+bool VkEngineOcclusionCuller::isVisible(const BoundingSpheresSoA& spheres, const u32 index) const {
+	const glm::vec3 center{spheres.centerX[index], spheres.centerY[index], spheres.centerZ[index]};
+	const float radius = spheres.radius[index];
+
+	// Screen rectangle and nearest depth of the box around the sphere
+	glm::vec2 minScreen{std::numeric_limits<float>::max()};
+	glm::vec2 maxScreen{std::numeric_limits<float>::lowest()};
+	float nearest = std::numeric_limits<float>::max();
+	for (u32 corner = 0; corner < 8; ++corner) {
+		const glm::vec3 offset{corner & 1 ? radius : -radius, corner & 2 ? radius : -radius,
+		                       corner & 4 ? radius : -radius};
+		const glm::vec4 clip = mViewProjection * glm::vec4(center + offset, 1.f);
+		if (clip.w < MIN_CLIP_W) {
+			return true;
+		}
+		const glm::vec2 screen = toScreen(clip);
+		minScreen = glm::min(minScreen, screen);
+		maxScreen = glm::max(maxScreen, screen);
+		nearest = std::min(nearest, clip.z / clip.w);
+	}
+	if (nearest <= 0.f) {
+		return true;
+	}
+
+	const i32 x0 = std::max(static_cast<i32>(std::floor(minScreen.x)), 0);
+	const i32 x1 = std::min(static_cast<i32>(std::floor(maxScreen.x)), LAST_X);
+	const i32 y0 = std::max(static_cast<i32>(std::floor(minScreen.y)), 0);
+	const i32 y1 = std::min(static_cast<i32>(std::floor(maxScreen.y)), LAST_Y);
+	if (x0 > x1 || y0 > y1) {
+		return true;
+	}
+
+	// Visible as soon as one pixel of the rectangle is at least as far as the object
+	for (i32 y = y0; y <= y1; ++y) {
+		const float* const row = mDepth.data() + static_cast<size_t>(y) * WIDTH;
+		i32 x = x0 & ~7;
+#if defined(__AVX2__)
+		const __m256 laneOffsets = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+		const __m256 first = _mm256_set1_ps(static_cast<float>(x0));
+		const __m256 last = _mm256_set1_ps(static_cast<float>(x1));
+		const __m256 objectDepth = _mm256_set1_ps(nearest);
+		for (; x <= x1; x += 8) {
+			const __m256 lanes = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+			const __m256 inside = _mm256_and_ps(_mm256_cmp_ps(lanes, first, _CMP_GE_OQ),
+			                                    _mm256_cmp_ps(lanes, last, _CMP_LE_OQ));
+			const __m256 behind = _mm256_cmp_ps(_mm256_loadu_ps(row + x), objectDepth, _CMP_GE_OQ);
+			if (_mm256_movemask_ps(_mm256_and_ps(inside, behind)) != 0) {
+				return true;
+			}
+		}
+#elif defined(VKE_OCCLUSION_SSE2)
+		const __m128 laneOffsets = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+		const __m128 first = _mm_set1_ps(static_cast<float>(x0));
+		const __m128 last = _mm_set1_ps(static_cast<float>(x1));
+		const __m128 objectDepth = _mm_set1_ps(nearest);
+		for (; x <= x1; x += 4) {
+			const __m128 lanes = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+			const __m128 inside = _mm_and_ps(_mm_cmpge_ps(lanes, first), _mm_cmple_ps(lanes, last));
+			const __m128 behind = _mm_cmpge_ps(_mm_loadu_ps(row + x), objectDepth);
+			if (_mm_movemask_ps(_mm_and_ps(inside, behind)) != 0) {
+				return true;
+			}
+		}
+#endif
+
+		for (x = std::max(x, x0); x <= x1; ++x) {
+			if (row[x] >= nearest) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+
+void VkEngineOcclusionCuller::cull(const BoundingSpheresSoA& spheres, std::vector<u32>& visible) {
+	const auto start = std::chrono::high_resolution_clock::now();
+	const auto objectCount = static_cast<u32>(visible.size());
+	mStats.testedObjects = objectCount;
+	if (mTriangles.empty() || objectCount == 0) {
+		return;
+	}
+
+	const u32 chunkCount = (objectCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	mChunkCounts.assign(chunkCount, 0);
+
+	// Each chunk compacts its own slice in place, the write cursor never passes the read cursor
+	mThreadPool.parallelFor(objectCount, CHUNK_SIZE, [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		for (u32 chunk = begin / CHUNK_SIZE; chunk * CHUNK_SIZE < end; ++chunk) {
+			const u32 chunkBegin = chunk * CHUNK_SIZE;
+			const u32 chunkEnd = std::min(chunkBegin + CHUNK_SIZE, end);
+			u32 count = 0;
+			for (u32 i = chunkBegin; i < chunkEnd; ++i) {
+				if (isVisible(spheres, visible[i])) {
+					visible[chunkBegin + count++] = visible[i];
+				}
+			}
+			mChunkCounts[chunk] = count;
+		}
+	});
+
+	u32 visibleCount = 0;
+	for (u32 chunk = 0; chunk < chunkCount; ++chunk) {
+		if (visibleCount != chunk * CHUNK_SIZE) {
+			std::memmove(visible.data() + visibleCount, visible.data() + chunk * CHUNK_SIZE,
+			             mChunkCounts[chunk] * sizeof(u32));
+		}
+		visibleCount += mChunkCounts[chunk];
+	}
+
+	visible.resize(visibleCount);
+	mStats.occludedObjects = objectCount - visibleCount;
+	mStats.testMs = elapsedMs(start);
+}
+
+}  // namespace vke
@@ -0,0 +1,84 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+#include "engine_frustum_culling.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+struct OcclusionCullStats {
+	u32 occluderTriangles = 0;
+	u32 testedObjects = 0;
+	u32 occludedObjects = 0;
+	float rasterizeMs = 0.f;
+	float testMs = 0.f;
+};
+
+// Software occlusion culling: designated occluders are rasterized on the CPU into a small depth buffer, then the
+// bounding boxes of the objects that survived frustum culling are tested against it before any draw is recorded.
+// Every pixel keeps the nearest of the farthest depths of the occluder triangles covering it, so an object whose
+// nearest depth lies beyond every pixel its screen rectangle touches is hidden. Rows are processed 8 pixels at a time
+// (AVX2, 2x SSE or scalar depending on the build) with a coverage mask per group of pixels.
+class VkEngineOcclusionCuller {
+   public:
+	static constexpr u32 WIDTH = 256;
+	static constexpr u32 HEIGHT = 128;
+	// Rows rasterized by a single worker, a band owns its rows so no two workers ever write the same pixel
+	static constexpr u32 BAND_HEIGHT = 8;
+	// Objects tested by a single worker at once
+	static constexpr u32 CHUNK_SIZE = 256;
+
+	explicit VkEngineOcclusionCuller(ThreadPool& threadPool);
+
+	// Clears the depth buffer and the occluders of the previous frame
+	void beginFrame(const glm::mat4& viewProjection);
+
+	// Projects the indexed triangle list placed with `world`, triangles crossing the near plane are dropped, which only
+	// makes the culling more conservative
+	void addOccluder(std::span<const glm::vec3> positions, std::span<const u32> indices, const glm::mat4& world);
+
+	// Rasterizes the occluders added since beginFrame, one band of rows per task
+	void rasterize();
+
+	// Removes from `visible` the objects whose bounding sphere is hidden by the occluders, the order is kept
+	void cull(const BoundingSpheresSoA& spheres, std::vector<u32>& visible);
+
+	[[nodiscard]] const OcclusionCullStats& getStats() const { return mStats; }
+	[[nodiscard]] const std::vector<float>& getDepthBuffer() const { return mDepth; }
+
+   private:
+	// Screen space triangle with the edges oriented so the inside is positive, E(x, y) = a * x + b * y + c
+	struct ScreenTriangle {
+		std::array<float, 3> edgeA{};
+		std::array<float, 3> edgeB{};
+		std::array<float, 3> edgeC{};
+		// Farthest depth of the three vertices, the whole triangle is conservatively written at this depth
+		float depth = 0.f;
+		i32 minX = 0;
+		i32 maxX = 0;
+		i32 minY = 0;
+		i32 maxY = 0;
+	};
+
+	void rasterizeBand(u32 bandY, u32 bandEnd);
+	[[nodiscard]] bool isVisible(const BoundingSpheresSoA& spheres, u32 index) const;
+
+	ThreadPool& mThreadPool;
+	glm::mat4 mViewProjection{1.f};
+	std::vector<float> mDepth{};
+	std::vector<ScreenTriangle> mTriangles{};
+	std::vector<glm::vec4> mClipScratch{};
+	std::vector<u32> mChunkCounts{};
+	OcclusionCullStats mStats{};
+};
+
+}  // namespace vke
@@ -0,0 +1,264 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_occlusion_queries.hpp"
+
+#include <algorithm>
+#include <glm/glm.hpp>
+
+#include "utils/logger.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+namespace {
+// Mirror of the push constants of occlusion_box.vert
+struct BoxPushConstants {
+	glm::mat4 viewProjection{1.f};
+	glm::vec4 centerRadius{0.f};
+};
+
+constexpr u32 BOX_VERTEX_COUNT = 36;
+
+// Results read with VK_QUERY_RESULT_WITH_AVAILABILITY_BIT, the availability follows the value
+struct HostQueryResult {
+	u32 samples = 0;
+	u32 available = 0;
+};
+
+// Results of the frame written by addQueryPasses, read by the conditional draws of the next frame
+constexpr RenderGraphState PREDICATE_STATE{.stages = VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT,
+                                           .access = VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT};
+}  // namespace
+
+VkEngineOcclusionQueries::VkEngineOcclusionQueries(std::shared_ptr<VkEngineDevice> device,
+                                                   const AttachmentFormats& attachmentFormats)
+    : mVkDevice(std::move(device)), mConditionalRendering(mVkDevice->hasConditionalRendering()) {
+	constexpr VkQueryPoolCreateInfo queryPoolInfo{
+	    .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+	    .queryType = VK_QUERY_TYPE_OCCLUSION,
+	    .queryCount = MAX_QUERIES,
+	};
+
+	for (auto& frame : mFrameResources) {
+		VK_CHECK(vkCreateQueryPool(mVkDevice->getDevice(), &queryPoolInfo, nullptr, &frame.queryPool));
+		if (hasConditionalRendering()) {
+			frame.results = std::make_unique<VkEngineBuffer>(
+			    mVkDevice, sizeof(u32), MAX_QUERIES,
+			    VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0,
+			    VMA_MEMORY_USAGE_AUTO);
+		}
+	}
+
+	createPipeline(attachmentFormats);
+}
+
+VkEngineOcclusionQueries::~VkEngineOcclusionQueries() {
+	for (const auto& frame : mFrameResources) {
+		vkDestroyQueryPool(mVkDevice->getDevice(), frame.queryPool, nullptr);
+	}
+	vkDestroyPipelineLayout(mVkDevice->getDevice(), pPipelineLayout, nullptr);
+}
+
+
+void VkEngineOcclusionQueries::createPipeline(const AttachmentFormats& attachmentFormats) {
+	static constexpr VkPushConstantRange pushConstantRange{
+	    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+	    .offset = 0,
+	    .size = sizeof(BoxPushConstants),
+	};
+
+	const VkPipelineLayoutCreateInfo layoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                            .pushConstantRangeCount = 1,
+	                                            .pPushConstantRanges = &pushConstantRange};
+	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &layoutInfo, nullptr, &pPipelineLayout));
+
+	PipelineConfigInfo pipelineConfig{};
+	pipelineConfig.attachmentFormats = attachmentFormats;
+	VkEnginePipeline::occlusionQueryConfigInfo(pipelineConfig);
+	pipelineConfig.pipelineLayout = pPipelineLayout;
+
+	pPipeline = std::make_unique<VkEnginePipeline>(
+	    mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/occlusion_box.vert.spv", "", pipelineConfig);
+}
+
+
+void VkEngineOcclusionQueries::beginFrame(const u32 frameIndex) {
+	mPreviousFrameIndex = (frameIndex + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+	mFrameIndex = frameIndex;
+	mCandidateIds.clear();
+	mCandidateSpheres.clear();
+	mStats = {};
+
+	// The previous frame is likely still running, its results are only consumed on the GPU
+	mConditionalSlots.clear();
+	const auto& previous = mFrameResources[mPreviousFrameIndex];
+	if (mConditionalRendering && previous.hasCopiedResults) {
+		for (u32 query = 0; query < previous.queriedIds.size(); ++query) {
+			mConditionalSlots.emplace(previous.queriedIds[query], query);
+		}
+	}
+
+	// The last frame using this slot is complete, its results are available without waiting. They are dropped
+	// afterwards, so a frame declaring no query passes leaves nothing stale behind.
+	auto& frame = mFrameResources[frameIndex];
+	readHostResults(frame);
+	frame.queriedIds.clear();
+	frame.hasCopiedResults = false;
+}
+
+
+void VkEngineOcclusionQueries::readHostResults(FrameResources& frame) {
+	mOccludedIds.clear();
+	const auto queryCount = static_cast<u32>(frame.queriedIds.size());
+	if (queryCount == 0) {
+		return;
+	}
+
+	std::vector<HostQueryResult> results(queryCount);
+	// VK_NOT_READY only means some queries are unavailable, which the availability words tell
+	const VkResult result = vkGetQueryPoolResults(mVkDevice->getDevice(), frame.queryPool, 0, queryCount,
+	                                              results.size() * sizeof(HostQueryResult), results.data(),
+	                                              sizeof(HostQueryResult), VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	if (result != VK_SUCCESS && result != VK_NOT_READY) {
+		VKWARN("Failed to read the occlusion query results: {}", static_cast<i32>(result));
+		return;
+	}
+
+	for (u32 query = 0; query < queryCount; ++query) {
+		if (results[query].available != 0 && results[query].samples == 0) {
+			mOccludedIds.insert(frame.queriedIds[query]);
+		}
+	}
+	mStats.occludedQueries = static_cast<u32>(mOccludedIds.size());
+}
+
+
+RenderGraphBuffer VkEngineOcclusionQueries::importPredicates(VkEngineRenderGraph& graph) {
+	if (!mConditionalRendering) {
+		return {};
+	}
+
+	// Exported by the previous frame in the state the conditional draws read it in, no barrier is needed
+	const auto& previous = mFrameResources[mPreviousFrameIndex];
+	return graph.importBuffer("occlusion predicates", previous.results->getBuffer(), previous.results->getBufferSize(),
+	                          PREDICATE_STATE);
+}
+
+
+void VkEngineOcclusionQueries::setCandidates(const std::span<const Entity> entities,
+                                             const BoundingSpheresSoA& spheres, const std::span<const u32> visible,
+                                             const glm::vec3& cameraPosition) {
+	mCandidateIds.clear();
+	mCandidateSpheres.clear();
+	mStats.skippedDraws = 0;
+
+	for (const u32 index : visible) {
+		const Entity id = entities[index];
+		if (!mConditionalRendering && mOccludedIds.contains(id)) {
+			++mStats.skippedDraws;
+		}
+
+		const float radius = spheres.radius[index];
+		if (radius < mMinRadius || mCandidateIds.size() == MAX_QUERIES) {
+			continue;
+		}
+
+		// Margin for the near plane, a box grazing the camera is clipped as well
+		const glm::vec3 center{spheres.centerX[index], spheres.centerY[index], spheres.centerZ[index]};
+		const glm::vec3 distance = glm::abs(cameraPosition - center);
+		if (std::max({distance.x, distance.y, distance.z}) < radius * 1.1f + 1.f) {
+			continue;
+		}
+
+		mCandidateIds.push_back(id);
+		mCandidateSpheres.emplace_back(center, radius);
+	}
+}
+
+
+VkEngineOcclusionQueries::Predicate VkEngineOcclusionQueries::getPredicate(const Entity id) const {
+	if (mConditionalRendering) {
+		if (const auto it = mConditionalSlots.find(id); it != mConditionalSlots.end()) {
+			return {.kind = Predicate::Kind::Conditional, .offset = it->second * sizeof(u32)};
+		}
+		return {};
+	}
+
+	return mOccludedIds.contains(id) ? Predicate{.kind = Predicate::Kind::Skip} : Predicate{};
+}
+
+
+void VkEngineOcclusionQueries::beginPredicate(const VkCommandBuffer commandBuffer, const Predicate& predicate) const {
+	if (predicate.kind == Predicate::Kind::Conditional) {
+		mVkDevice->cmdBeginConditionalRendering(
+		    commandBuffer, mFrameResources[mPreviousFrameIndex].results->getBuffer(), predicate.offset);
+	}
+}
+
+
+void VkEngineOcclusionQueries::endPredicate(const VkCommandBuffer commandBuffer, const Predicate& predicate) const {
+	if (predicate.kind == Predicate::Kind::Conditional) {
+		mVkDevice->cmdEndConditionalRendering(commandBuffer);
+	}
+}
+
+
+void VkEngineOcclusionQueries::addQueryPasses(VkEngineRenderGraph& graph, const RenderGraphImage depth,
+                                              const glm::mat4& viewProjection) {
+	auto& frame = mFrameResources[mFrameIndex];
+
+	// The candidates are only known once the passes drawing the objects ran, so the number of queries is decided
+	// when the passes execute
+	graph.addPass("reset occlusion queries").setSideEffects().setExecute([&frame](const RenderGraphContext& context) {
+		vkCmdResetQueryPool(context.commandBuffer, frame.queryPool, 0, MAX_QUERIES);
+	});
+
+	graph.addPass("occlusion queries")
+	    .setDepthAttachment(depth, VK_ATTACHMENT_LOAD_OP_LOAD, 1.f, true)
+	    .setSideEffects()
+	    .setExecute([this, &frame, viewProjection](const RenderGraphContext& context) {
+		    frame.queriedIds = mCandidateIds;
+		    mStats.issuedQueries = static_cast<u32>(mCandidateIds.size());
+		    if (mCandidateIds.empty()) {
+			    return;
+		    }
+
+		    pPipeline->bind(&context.commandBuffer);
+		    vkCmdPushConstants(context.commandBuffer, pPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+		                       sizeof(glm::mat4), &viewProjection);
+		    for (u32 query = 0; query < mCandidateSpheres.size(); ++query) {
+			    vkCmdPushConstants(context.commandBuffer, pPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+			                       offsetof(BoxPushConstants, centerRadius), sizeof(glm::vec4),
+			                       &mCandidateSpheres[query]);
+			    vkCmdBeginQuery(context.commandBuffer, frame.queryPool, query, 0);
+			    vkCmdDraw(context.commandBuffer, BOX_VERTEX_COUNT, 1, 0, 0);
+			    vkCmdEndQuery(context.commandBuffer, frame.queryPool, query);
+		    }
+	    });
+
+	frame.hasCopiedResults = mConditionalRendering;
+	if (!mConditionalRendering) {
+		return;
+	}
+
+	// Last read by the conditional draws of the previous frame
+	const RenderGraphBuffer results =
+	    graph.importBuffer("occlusion results", frame.results->getBuffer(), frame.results->getBufferSize(),
+	                       PREDICATE_STATE);
+	graph.exportBuffer(results, PREDICATE_STATE);
+
+	graph.addPass("resolve occlusion queries")
+	    .write(results, RenderGraphUsage::TransferDst)
+	    .setExecute([this, &frame, results](const RenderGraphContext& context) {
+		    const auto queryCount = static_cast<u32>(frame.queriedIds.size());
+		    if (queryCount == 0) {
+			    return;
+		    }
+		    // WAIT makes the copy wait for the queries recorded above, no barrier is needed for them
+		    vkCmdCopyQueryPoolResults(context.commandBuffer, frame.queryPool, 0, queryCount,
+		                              context.graph->getBuffer(results), 0, sizeof(u32), VK_QUERY_RESULT_WAIT_BIT);
+	    });
+}
+
+}  // namespace vke
@@ -0,0 +1,115 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/engine_buffer.hpp"
+#include "core/engine_device.hpp"
+#include "core/engine_ecs.hpp"
+#include "core/engine_pipeline.hpp"
+#include "engine_frustum_culling.hpp"
+#include "engine_render_graph.hpp"
+
+namespace vke {
+
+struct OcclusionQueryStats {
+	u32 issuedQueries = 0;
+	// Queries of the frame read back on the host that had no sample passing
+	u32 occludedQueries = 0;
+	// Visible objects left out on the host because of an occluded result, only without conditional rendering
+	u32 skippedDraws = 0;
+};
+
+// Occlusion queries on the bounding boxes of large objects, whose results predicate the draws of the next frame.
+// With VK_EXT_conditional_rendering the results of the previous frame are copied into a buffer and the GPU skips the
+// draws whose box had no sample pass. Without it the results are read on the host once the frame slot comes back
+// around, without ever waiting, and those draws are not recorded at all.
+class VkEngineOcclusionQueries : NO_COPY_NOR_MOVE {
+   public:
+	static constexpr u32 MAX_QUERIES = 1024;
+
+	// How the draw of an object depends on the queries of an earlier frame
+	struct Predicate {
+		enum class Kind : u8 { Always, Conditional, Skip };
+		Kind kind = Kind::Always;
+		// Offset of the result in the predicate buffer, for Conditional
+		VkDeviceSize offset = 0;
+	};
+
+	VkEngineOcclusionQueries(std::shared_ptr<VkEngineDevice> device, const AttachmentFormats& attachmentFormats);
+
+	~VkEngineOcclusionQueries();
+
+	// Picks up the results of the previous uses of the query pools and forgets the candidates of the last frame, the
+	// fence of `frameIndex` must have been waited on
+	void beginFrame(u32 frameIndex);
+
+	// Imports the results of the previous frame, the passes drawing predicated objects must read it as
+	// ConditionalRendering. Invalid when conditional rendering is off.
+	RenderGraphBuffer importPredicates(VkEngineRenderGraph& graph);
+
+	// Declares the passes resetting the pool, drawing the boxes of the candidates against `depth` and, with
+	// conditional rendering, copying the results for the next frame. To be declared after the passes writing `depth`.
+	void addQueryPasses(VkEngineRenderGraph& graph, RenderGraphImage depth, const glm::mat4& viewProjection);
+
+	// Objects of `visible` whose world radius is at least the minimum get a query this frame, unless the camera is
+	// inside their box: the box would be clipped and report the object as hidden. Called once the frame is culled.
+	void setCandidates(std::span<const Entity> entities, const BoundingSpheresSoA& spheres,
+	                   std::span<const u32> visible, const glm::vec3& cameraPosition);
+
+	// Safe to call concurrently while draws are recorded
+	[[nodiscard]] Predicate getPredicate(Entity id) const;
+	void beginPredicate(VkCommandBuffer commandBuffer, const Predicate& predicate) const;
+	void endPredicate(VkCommandBuffer commandBuffer, const Predicate& predicate) const;
+
+	[[nodiscard]] bool hasConditionalRendering() const { return mVkDevice->hasConditionalRendering(); }
+	// Falls back to the host read back when disabled, to compare both paths
+	void setConditionalRendering(bool enabled) { mConditionalRendering = enabled && hasConditionalRendering(); }
+	[[nodiscard]] bool isConditionalRenderingEnabled() const { return mConditionalRendering; }
+
+	void setMinRadius(const float radius) { mMinRadius = radius; }
+	[[nodiscard]] float getMinRadius() const { return mMinRadius; }
+
+	[[nodiscard]] const OcclusionQueryStats& getStats() const { return mStats; }
+
+   private:
+	struct FrameResources {
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		// One u32 per query, non zero when samples passed
+		std::unique_ptr<VkEngineBuffer> results{};
+		// Object of each query issued the last time the slot was used
+		std::vector<Entity> queriedIds{};
+		// The results were copied into `results` for conditional rendering
+		bool hasCopiedResults = false;
+	};
+
+	void createPipeline(const AttachmentFormats& attachmentFormats);
+	void readHostResults(FrameResources& frame);
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+
+	VkPipelineLayout pPipelineLayout = VK_NULL_HANDLE;
+	std::unique_ptr<VkEnginePipeline> pPipeline{};
+
+	std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> mFrameResources{};
+	u32 mFrameIndex = 0;
+	u32 mPreviousFrameIndex = 0;
+
+	// Boxes queried this frame, world space bounding spheres
+	std::vector<Entity> mCandidateIds{};
+	std::vector<glm::vec4> mCandidateSpheres{};
+
+	// Predicates of the frame being recorded
+	std::unordered_map<Entity, u32> mConditionalSlots{};
+	std::unordered_set<Entity> mOccludedIds{};
+
+	bool mConditionalRendering = false;
+	float mMinRadius = 1.f;
+	OcclusionQueryStats mStats{};
+};
+}  // namespace vke
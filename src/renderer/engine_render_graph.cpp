@@ -0,0 +1,838 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_render_graph.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#include "utils/logger.hpp"
+
+namespace vke {
+namespace {
+constexpr u32 MAX_COLOR_ATTACHMENTS = 8;
+
+constexpr VkPipelineStageFlags2 GRAPHICS_SHADER_STAGES =
+    VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+constexpr VkPipelineStageFlags2 DEPTH_TEST_STAGES =
+    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+constexpr VkAccessFlags2 WRITE_ACCESSES =
+    VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT |
+    VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+constexpr VkImageUsageFlags ATTACHMENT_USAGES = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+struct UsageInfo {
+	VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+	VkAccessFlags2 access = VK_ACCESS_2_NONE;
+	VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+	VkImageUsageFlags imageUsage = 0;
+	VkBufferUsageFlags bufferUsage = 0;
+};
+
+UsageInfo getUsageInfo(const RenderGraphUsage usage) {
+	switch (usage) {
+		case RenderGraphUsage::ColorAttachment:
+			return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			        VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0};
+		case RenderGraphUsage::DepthAttachment:
+			return {DEPTH_TEST_STAGES,
+			        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+		case RenderGraphUsage::DepthRead:
+			return {DEPTH_TEST_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+			        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+		case RenderGraphUsage::SampledGraphics:
+			return {GRAPHICS_SHADER_STAGES, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, 0};
+		case RenderGraphUsage::SampledCompute:
+			return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, 0};
+		case RenderGraphUsage::StorageGraphics:
+			return {GRAPHICS_SHADER_STAGES, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT};
+		case RenderGraphUsage::StorageCompute:
+			return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			        VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL,
+			        VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT};
+		case RenderGraphUsage::IndirectBuffer:
+			return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+			        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT};
+		case RenderGraphUsage::VertexBuffer:
+			return {VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+			        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT};
+		case RenderGraphUsage::IndexBuffer:
+			return {VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0,
+			        VK_BUFFER_USAGE_INDEX_BUFFER_BIT};
+		case RenderGraphUsage::UniformBuffer:
+			return {GRAPHICS_SHADER_STAGES | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_UNIFORM_READ_BIT,
+			        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT};
+		case RenderGraphUsage::TransferSrc:
+			return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+			        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			        VK_BUFFER_USAGE_TRANSFER_SRC_BIT};
+		case RenderGraphUsage::TransferDst:
+			return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+			        VK_BUFFER_USAGE_TRANSFER_DST_BIT};
+		case RenderGraphUsage::ConditionalRendering:
+			return {VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT, VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT,
+			        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT};
+	}
+	return {};
+}
+
+VkImageAspectFlags getAspectMask(const VkFormat format) {
+	switch (format) {
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+}
+
+bool isDepthFormat(const VkFormat format) { return (getAspectMask(format) & VK_IMAGE_ASPECT_DEPTH_BIT) != 0; }
+
+VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}  // namespace
+
+
+bool VkEngineRenderGraph::TransientKey::operator==(const TransientKey& other) const {
+	return isImage == other.isImage && imageDesc.format == other.imageDesc.format &&
+	       imageDesc.extent.width == other.imageDesc.extent.width &&
+	       imageDesc.extent.height == other.imageDesc.extent.height &&
+	       imageDesc.mipLevels == other.imageDesc.mipLevels && size == other.size && imageUsage == other.imageUsage &&
+	       bufferUsage == other.bufferUsage && firstPass == other.firstPass && lastPass == other.lastPass;
+}
+
+
+VkEngineRenderGraph::Pass& VkEngineRenderGraph::PassBuilder::pass() const { return mGraph.mPasses[mPassIndex]; }
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::read(const RenderGraphImage image,
+                                                                         const RenderGraphUsage usage) {
+	mGraph.addAccess(pass(), image.index, true, usage, true, false, false);
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::write(const RenderGraphImage image,
+                                                                          const RenderGraphUsage usage) {
+	mGraph.addAccess(pass(), image.index, true, usage, false, true, false);
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::read(const RenderGraphBuffer buffer,
+                                                                         const RenderGraphUsage usage) {
+	mGraph.addAccess(pass(), buffer.index, false, usage, true, false, false);
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::write(const RenderGraphBuffer buffer,
+                                                                          const RenderGraphUsage usage) {
+	mGraph.addAccess(pass(), buffer.index, false, usage, false, true, false);
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::addColorAttachment(
+    const RenderGraphImage image, const VkAttachmentLoadOp loadOp, const VkClearColorValue clearValue) {
+	Pass& colorPass = pass();
+	if (colorPass.colorAttachments.size() == MAX_COLOR_ATTACHMENTS) {
+		throw std::runtime_error("Too many color attachments in render graph pass " + colorPass.name);
+	}
+
+	const bool loads = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD;
+	mGraph.addAccess(colorPass, image.index, true, RenderGraphUsage::ColorAttachment, loads, true, !loads);
+	colorPass.colorAttachments.push_back(
+	    {.resource = image.index, .loadOp = loadOp, .clearValue = {.color = clearValue}});
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::setDepthAttachment(const RenderGraphImage image,
+                                                                                       const VkAttachmentLoadOp loadOp,
+                                                                                       const float clearDepth,
+                                                                                       const bool readOnly) {
+	Pass& depthPass = pass();
+	const bool loads = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD;
+	mGraph.addAccess(depthPass, image.index, true,
+	                 readOnly ? RenderGraphUsage::DepthRead : RenderGraphUsage::DepthAttachment, loads || readOnly,
+	                 !readOnly, !loads && !readOnly);
+	depthPass.depthAttachment = Attachment{
+	    .resource = image.index, .loadOp = loadOp, .clearValue = {.depthStencil = {.depth = clearDepth, .stencil = 0}}};
+	depthPass.depthReadOnly = readOnly;
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::setSecondaryContents() {
+	pass().secondaryContents = true;
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::setSideEffects() {
+	pass().sideEffects = true;
+	return *this;
+}
+
+VkEngineRenderGraph::PassBuilder& VkEngineRenderGraph::PassBuilder::setExecute(ExecuteFn execute) {
+	pass().execute = std::move(execute);
+	return *this;
+}
+
+
+VkEngineRenderGraph::VkEngineRenderGraph(std::shared_ptr<VkEngineDevice> device) : mVkDevice(std::move(device)) {}
+
+VkEngineRenderGraph::~VkEngineRenderGraph() {
+	for (auto& frame : mFrameTransients) {
+		destroyTransients(frame);
+	}
+}
+
+void VkEngineRenderGraph::reset(const u32 frameIndex) {
+	mFrameIndex = frameIndex;
+	mPassCount = 0;
+	mResourceCount = 0;
+}
+
+u32 VkEngineRenderGraph::newResource(std::string name, const bool isImage) {
+	if (mResourceCount == mResources.size()) {
+		mResources.emplace_back();
+	}
+	Resource& resource = mResources[mResourceCount];
+	resource = Resource{.name = std::move(name), .isImage = isImage};
+	return mResourceCount++;
+}
+
+void VkEngineRenderGraph::addAccess(Pass& pass, const u32 resource, const bool isImage, const RenderGraphUsage usage,
+                                    const bool isRead, const bool isWrite, const bool discards) const {
+	assert(resource < mResourceCount && mResources[resource].isImage == isImage && "Invalid render graph handle");
+
+	UsageInfo info = getUsageInfo(usage);
+	if (isWrite && (info.access & WRITE_ACCESSES) == 0) {
+		throw std::runtime_error("Render graph pass " + pass.name + " writes " + mResources[resource].name +
+		                         " through a read only usage");
+	}
+	if (!isWrite) {
+		info.access &= ~WRITE_ACCESSES;
+	}
+	if (!isImage) {
+		info.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+	}
+
+	const auto it = std::ranges::find(pass.accesses, resource, &Access::resource);
+	if (it == pass.accesses.end()) {
+		pass.accesses.push_back({.resource = resource,
+		                         .stages = info.stages,
+		                         .access = info.access,
+		                         .layout = info.layout,
+		                         .imageUsage = info.imageUsage,
+		                         .bufferUsage = info.bufferUsage,
+		                         .isRead = isRead,
+		                         .isWrite = isWrite,
+		                         .discards = discards});
+		return;
+	}
+
+	// An image is in one layout for the whole pass
+	if (it->layout != info.layout) {
+		throw std::runtime_error("Render graph pass " + pass.name + " uses " + mResources[resource].name +
+		                         " in two different layouts");
+	}
+	it->stages |= info.stages;
+	it->access |= info.access;
+	it->imageUsage |= info.imageUsage;
+	it->bufferUsage |= info.bufferUsage;
+	it->isRead |= isRead;
+	it->isWrite |= isWrite;
+	it->discards = it->discards && discards;
+}
+
+RenderGraphImage VkEngineRenderGraph::importImage(std::string name, const VkImage image, const VkImageView view,
+                                                  const RenderGraphImageDesc& desc,
+                                                  const RenderGraphState& initialState) {
+	const u32 index = newResource(std::move(name), true);
+	Resource& resource = mResources[index];
+	resource.isImported = true;
+	resource.imageDesc = desc;
+	resource.image = image;
+	resource.view = view;
+	resource.state = {.layout = initialState.layout,
+	                  .writeStages = initialState.stages,
+	                  .writeAccess = initialState.access & WRITE_ACCESSES};
+	return {index};
+}
+
+RenderGraphBuffer VkEngineRenderGraph::importBuffer(std::string name, const VkBuffer buffer, const VkDeviceSize size,
+                                                    const RenderGraphState& initialState) {
+	const u32 index = newResource(std::move(name), false);
+	Resource& resource = mResources[index];
+	resource.isImported = true;
+	resource.bufferDesc = {.size = size};
+	resource.buffer = buffer;
+	resource.state = {.writeStages = initialState.stages, .writeAccess = initialState.access & WRITE_ACCESSES};
+	return {index};
+}
+
+void VkEngineRenderGraph::exportImage(const RenderGraphImage image, const RenderGraphState& finalState) {
+	assert(image.index < mResourceCount && mResources[image.index].isImage && "Invalid render graph image");
+	mResources[image.index].finalState = finalState;
+}
+
+void VkEngineRenderGraph::exportBuffer(const RenderGraphBuffer buffer, const RenderGraphState& finalState) {
+	assert(buffer.index < mResourceCount && !mResources[buffer.index].isImage && "Invalid render graph buffer");
+	mResources[buffer.index].finalState = finalState;
+}
+
+RenderGraphImage VkEngineRenderGraph::createImage(std::string name, const RenderGraphImageDesc& desc) {
+	const u32 index = newResource(std::move(name), true);
+	mResources[index].imageDesc = desc;
+	return {index};
+}
+
+RenderGraphBuffer VkEngineRenderGraph::createBuffer(std::string name, const RenderGraphBufferDesc& desc) {
+	const u32 index = newResource(std::move(name), false);
+	mResources[index].bufferDesc = desc;
+	return {index};
+}
+
+VkEngineRenderGraph::PassBuilder VkEngineRenderGraph::addPass(std::string name) {
+	if (mPassCount == mPasses.size()) {
+		mPasses.emplace_back();
+	}
+
+	// Cleared rather than replaced so the vectors keep their storage
+	Pass& pass = mPasses[mPassCount];
+	pass.name = std::move(name);
+	pass.accesses.clear();
+	pass.colorAttachments.clear();
+	pass.depthAttachment.reset();
+	pass.depthReadOnly = false;
+	pass.secondaryContents = false;
+	pass.sideEffects = false;
+	pass.execute = nullptr;
+	pass.isAlive = false;
+
+	return {*this, mPassCount++};
+}
+
+VkImage VkEngineRenderGraph::getImage(const RenderGraphImage image) const {
+	assert(image.index < mResourceCount && mResources[image.index].isImage && "Invalid render graph image");
+	return mResources[image.index].image;
+}
+
+VkImageView VkEngineRenderGraph::getImageView(const RenderGraphImage image) const {
+	assert(image.index < mResourceCount && mResources[image.index].isImage && "Invalid render graph image");
+	return mResources[image.index].view;
+}
+
+VkBuffer VkEngineRenderGraph::getBuffer(const RenderGraphBuffer buffer) const {
+	assert(buffer.index < mResourceCount && !mResources[buffer.index].isImage && "Invalid render graph buffer");
+	return mResources[buffer.index].buffer;
+}
+
+
+void VkEngineRenderGraph::cullPasses() {
+	// Walk the passes backwards from the exported resources: a pass survives when a later pass, or the outside
+	// world, consumes something it writes. A discarding write ends the need for the previous content.
+	mNeededResources.assign(mResourceCount, 0);
+	for (u32 i = 0; i < mResourceCount; ++i) {
+		mNeededResources[i] = mResources[i].finalState.has_value() ? 1 : 0;
+	}
+
+	for (u32 p = mPassCount; p-- > 0;) {
+		Pass& pass = mPasses[p];
+		pass.isAlive = pass.sideEffects || std::ranges::any_of(pass.accesses, [this](const Access& access) {
+			               return access.isWrite && mNeededResources[access.resource] != 0;
+		               });
+		if (!pass.isAlive) {
+			continue;
+		}
+
+		for (const auto& access : pass.accesses) {
+			if (access.discards) {
+				mNeededResources[access.resource] = 0;
+			}
+		}
+		for (const auto& access : pass.accesses) {
+			if (access.isRead) {
+				mNeededResources[access.resource] = 1;
+			}
+		}
+	}
+
+	mAlivePasses.clear();
+	for (u32 p = 0; p < mPassCount; ++p) {
+		if (mPasses[p].isAlive) {
+			mAlivePasses.push_back(p);
+		}
+	}
+	mStats.culledPasses = mPassCount - static_cast<u32>(mAlivePasses.size());
+}
+
+void VkEngineRenderGraph::computeLifetimes() {
+	for (u32 i = 0; i < static_cast<u32>(mAlivePasses.size()); ++i) {
+		for (const auto& access : mPasses[mAlivePasses[i]].accesses) {
+			Resource& resource = mResources[access.resource];
+			resource.firstPass = std::min(resource.firstPass, i);
+			resource.lastPass = std::max(resource.lastPass, i);
+			resource.imageUsage |= access.imageUsage;
+			resource.bufferUsage |= access.bufferUsage;
+		}
+	}
+
+	mTransients.clear();
+	mTransientKeys.clear();
+	for (u32 i = 0; i < mResourceCount; ++i) {
+		Resource& resource = mResources[i];
+		if (resource.isImported || resource.firstPass == UINT32_MAX) {
+			continue;
+		}
+
+		resource.physicalIndex = static_cast<u32>(mTransients.size());
+		mTransients.push_back(i);
+		mTransientKeys.push_back({.isImage = resource.isImage,
+		                          .imageDesc = resource.imageDesc,
+		                          .size = resource.bufferDesc.size,
+		                          .imageUsage = resource.imageUsage,
+		                          .bufferUsage = resource.bufferUsage,
+		                          .firstPass = resource.firstPass,
+		                          .lastPass = resource.lastPass});
+	}
+}
+
+void VkEngineRenderGraph::realizeTransients() {
+	FrameTransients& frame = mFrameTransients[mFrameIndex];
+
+	// The fence of the frame has been waited on, so the previous resources of the slot can go right away
+	if (frame.keys != mTransientKeys) {
+		destroyTransients(frame);
+		frame.keys = mTransientKeys;
+		allocateTransients(frame);
+
+		VKINFO("Render graph: {} transient resources in {} bytes, {} bytes without aliasing", frame.keys.size(),
+		       frame.memory, frame.unaliasedMemory);
+	}
+
+	for (u32 i = 0; i < static_cast<u32>(mTransients.size()); ++i) {
+		Resource& resource = mResources[mTransients[i]];
+		resource.image = frame.resources[i].image;
+		resource.view = frame.resources[i].view;
+		resource.buffer = frame.resources[i].buffer;
+	}
+
+	mStats.transientResources = static_cast<u32>(mTransients.size());
+	mStats.transientMemory = frame.memory;
+	mStats.transientMemoryUnaliased = frame.unaliasedMemory;
+}
+
+void VkEngineRenderGraph::allocateTransients(FrameTransients& frame) const {
+	const auto count = static_cast<u32>(frame.keys.size());
+	frame.resources.resize(count);
+
+	std::vector<VkMemoryRequirements> requirements(count);
+	std::vector<u8> isLazy(count, 0);
+
+	for (u32 i = 0; i < count; ++i) {
+		const TransientKey& key = frame.keys[i];
+		PhysicalResource& physical = frame.resources[i];
+
+		if (key.isImage) {
+			// Images only ever used as attachments may live in lazily allocated memory on tiled GPUs
+			VkImageUsageFlags usage = key.imageUsage;
+			if ((usage & ~ATTACHMENT_USAGES) == 0) {
+				usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+				isLazy[i] = 1;
+			}
+
+			const VkImageCreateInfo imageInfo{
+			    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+			    .imageType = VK_IMAGE_TYPE_2D,
+			    .format = key.imageDesc.format,
+			    .extent = {.width = key.imageDesc.extent.width, .height = key.imageDesc.extent.height, .depth = 1},
+			    .mipLevels = key.imageDesc.mipLevels,
+			    .arrayLayers = 1,
+			    .samples = VK_SAMPLE_COUNT_1_BIT,
+			    .tiling = VK_IMAGE_TILING_OPTIMAL,
+			    .usage = usage,
+			    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			};
+
+			VK_CHECK(vkCreateImage(mVkDevice->getDevice(), &imageInfo, nullptr, &physical.image));
+			vkGetImageMemoryRequirements(mVkDevice->getDevice(), physical.image, &requirements[i]);
+		} else {
+			const VkBufferCreateInfo bufferInfo{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			                                    .size = key.size,
+			                                    .usage = key.bufferUsage,
+			                                    .sharingMode = VK_SHARING_MODE_EXCLUSIVE};
+
+			VK_CHECK(vkCreateBuffer(mVkDevice->getDevice(), &bufferInfo, nullptr, &physical.buffer));
+			vkGetBufferMemoryRequirements(mVkDevice->getDevice(), physical.buffer, &requirements[i]);
+		}
+		frame.unaliasedMemory += requirements[i].size;
+	}
+
+	// Resources can only share a block when they agree on kind, laziness and memory types. Within a block the largest
+	// are placed first, each at the lowest offset not used by a resource alive at the same time.
+	std::vector<u32> order(count);
+	std::iota(order.begin(), order.end(), 0u);
+	const auto blockKey = [&](const u32 i) {
+		return std::tuple{frame.keys[i].isImage, isLazy[i], requirements[i].memoryTypeBits};
+	};
+	std::ranges::sort(order, [&](const u32 a, const u32 b) {
+		if (blockKey(a) != blockKey(b)) {
+			return blockKey(a) < blockKey(b);
+		}
+		return requirements[a].size > requirements[b].size;
+	});
+
+	const auto livesWith = [&](const u32 a, const u32 b) {
+		return frame.keys[a].firstPass <= frame.keys[b].lastPass && frame.keys[b].firstPass <= frame.keys[a].lastPass;
+	};
+
+	std::vector<VkDeviceSize> offsets(count, 0);
+	for (u32 begin = 0; begin < count;) {
+		u32 end = begin + 1;
+		while (end < count && blockKey(order[end]) == blockKey(order[begin])) {
+			++end;
+		}
+
+		VkDeviceSize blockSize = 0;
+		VkDeviceSize blockAlignment = 1;
+		for (u32 k = begin; k < end; ++k) {
+			const u32 i = order[k];
+			const VkDeviceSize size = requirements[i].size;
+
+			VkDeviceSize offset = 0;
+			for (bool moved = true; moved;) {
+				moved = false;
+				for (u32 j = begin; j < k; ++j) {
+					const u32 placed = order[j];
+					if (livesWith(i, placed) && offset < offsets[placed] + requirements[placed].size &&
+					    offsets[placed] < offset + size) {
+						offset = alignUp(offsets[placed] + requirements[placed].size, requirements[i].alignment);
+						moved = true;
+					}
+				}
+			}
+			offsets[i] = offset;
+			blockSize = std::max(blockSize, offset + size);
+			blockAlignment = std::max(blockAlignment, requirements[i].alignment);
+
+			// Whoever used the memory before must be done with it before the first use of the newcomer
+			for (u32 j = begin; j < k; ++j) {
+				const u32 placed = order[j];
+				if (!livesWith(i, placed) && offset < offsets[placed] + requirements[placed].size &&
+				    offsets[placed] < offset + size) {
+					if (frame.keys[placed].lastPass < frame.keys[i].firstPass) {
+						frame.resources[i].aliasedPredecessors.push_back(placed);
+					} else {
+						frame.resources[placed].aliasedPredecessors.push_back(i);
+					}
+				}
+			}
+		}
+
+		const VkMemoryRequirements blockRequirements{.size = blockSize,
+		                                             .alignment = blockAlignment,
+		                                             .memoryTypeBits = requirements[order[begin]].memoryTypeBits};
+
+		VmaAllocation block = VK_NULL_HANDLE;
+		if (isLazy[order[begin]] != 0) {
+			mVkDevice->allocateTransientMemory(blockRequirements, block);
+		} else {
+			constexpr VmaAllocationCreateInfo allocInfo{.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+			VK_CHECK(vmaAllocateMemory(mVkDevice->getAllocator(), &blockRequirements, &allocInfo, &block, nullptr));
+		}
+		frame.memoryBlocks.push_back(block);
+		frame.memory += blockSize;
+
+		for (u32 k = begin; k < end; ++k) {
+			const u32 i = order[k];
+			PhysicalResource& physical = frame.resources[i];
+			if (!frame.keys[i].isImage) {
+				VK_CHECK(vmaBindBufferMemory2(mVkDevice->getAllocator(), block, offsets[i], physical.buffer, nullptr));
+				continue;
+			}
+
+			VK_CHECK(vmaBindImageMemory2(mVkDevice->getAllocator(), block, offsets[i], physical.image, nullptr));
+
+			// Depth stencil images are viewed through their depth aspect, which is what attachments and samplers use
+			const VkFormat format = frame.keys[i].imageDesc.format;
+			const VkImageViewCreateInfo viewInfo{
+			    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			    .image = physical.image,
+			    .viewType = VK_IMAGE_VIEW_TYPE_2D,
+			    .format = format,
+			    .subresourceRange = {.aspectMask =
+			                             isDepthFormat(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : getAspectMask(format),
+			                         .baseMipLevel = 0,
+			                         .levelCount = frame.keys[i].imageDesc.mipLevels,
+			                         .baseArrayLayer = 0,
+			                         .layerCount = 1},
+			};
+			VK_CHECK(vkCreateImageView(mVkDevice->getDevice(), &viewInfo, nullptr, &physical.view));
+		}
+
+		begin = end;
+	}
+}
+
+void VkEngineRenderGraph::destroyTransients(FrameTransients& frame) const {
+	for (const auto& physical : frame.resources) {
+		vkDestroyImageView(mVkDevice->getDevice(), physical.view, nullptr);
+		vkDestroyImage(mVkDevice->getDevice(), physical.image, nullptr);
+		vkDestroyBuffer(mVkDevice->getDevice(), physical.buffer, nullptr);
+	}
+	for (const VmaAllocation block : frame.memoryBlocks) {
+		vmaFreeMemory(mVkDevice->getAllocator(), block);
+	}
+
+	frame.keys.clear();
+	frame.resources.clear();
+	frame.memoryBlocks.clear();
+	frame.memory = 0;
+	frame.unaliasedMemory = 0;
+}
+
+
+void VkEngineRenderGraph::addBarrier(Resource& resource, const VkPipelineStageFlags2 stages,
+                                     const VkAccessFlags2 access, const VkImageLayout layout, const bool isWrite) {
+	SyncState& state = resource.state;
+	const bool changesLayout = resource.isImage && layout != state.layout;
+
+	VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+	bool needsBarrier = false;
+
+	if (isWrite || changesLayout) {
+		// Write after write or after read, or a layout transition, which is a write too
+		srcStages = state.writeStages | state.readStages;
+		needsBarrier = srcStages != VK_PIPELINE_STAGE_2_NONE || changesLayout;
+	} else if (state.writeStages != VK_PIPELINE_STAGE_2_NONE &&
+	           ((stages & ~state.readStages) != 0 || (access & ~state.readAccess) != 0)) {
+		// Read after write that no earlier barrier made visible to these stages yet
+		srcStages = state.writeStages;
+		needsBarrier = true;
+	}
+
+	if (needsBarrier && resource.isImage) {
+		mImageBarriers.push_back({
+		    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+		    .srcStageMask = srcStages,
+		    .srcAccessMask = state.writeAccess,
+		    .dstStageMask = stages,
+		    .dstAccessMask = access,
+		    .oldLayout = state.layout,
+		    .newLayout = layout,
+		    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		    .image = resource.image,
+		    .subresourceRange = {.aspectMask = getAspectMask(resource.imageDesc.format),
+		                         .baseMipLevel = 0,
+		                         .levelCount = VK_REMAINING_MIP_LEVELS,
+		                         .baseArrayLayer = 0,
+		                         .layerCount = VK_REMAINING_ARRAY_LAYERS},
+		});
+	} else if (needsBarrier) {
+		mBufferBarriers.push_back({.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+		                           .srcStageMask = srcStages,
+		                           .srcAccessMask = state.writeAccess,
+		                           .dstStageMask = stages,
+		                           .dstAccessMask = access,
+		                           .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		                           .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		                           .buffer = resource.buffer,
+		                           .offset = 0,
+		                           .size = VK_WHOLE_SIZE});
+	}
+
+	if (isWrite || changesLayout) {
+		state.layout = resource.isImage ? layout : VK_IMAGE_LAYOUT_UNDEFINED;
+		state.writeStages = stages;
+		state.writeAccess = isWrite ? access & WRITE_ACCESSES : VK_ACCESS_2_NONE;
+		state.readStages = isWrite ? VK_PIPELINE_STAGE_2_NONE : stages;
+		state.readAccess = isWrite ? VK_ACCESS_2_NONE : access;
+	} else {
+		state.readStages |= stages;
+		state.readAccess |= access;
+	}
+}
+
+void VkEngineRenderGraph::flushBarriers(const VkCommandBuffer commandBuffer) {
+	if (mImageBarriers.empty() && mBufferBarriers.empty()) {
+		return;
+	}
+
+	const VkDependencyInfo dependency{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+	                                  .bufferMemoryBarrierCount = static_cast<u32>(mBufferBarriers.size()),
+	                                  .pBufferMemoryBarriers = mBufferBarriers.data(),
+	                                  .imageMemoryBarrierCount = static_cast<u32>(mImageBarriers.size()),
+	                                  .pImageMemoryBarriers = mImageBarriers.data()};
+
+	vkCmdPipelineBarrier2(commandBuffer, &dependency);
+
+	mStats.barriers += static_cast<u32>(mImageBarriers.size() + mBufferBarriers.size());
+	mImageBarriers.clear();
+	mBufferBarriers.clear();
+}
+
+void VkEngineRenderGraph::recordPass(const VkCommandBuffer commandBuffer, Pass& pass, const u32 alivePassIndex,
+                                     const VkQueryPipelineStatisticFlags inheritedStatistics) {
+	const FrameTransients& frame = mFrameTransients[mFrameIndex];
+
+	for (const auto& access : pass.accesses) {
+		Resource& resource = mResources[access.resource];
+
+		// First use of memory that an earlier transient of the frame occupied, wait for it to be done
+		if (!resource.isImported && resource.firstPass == alivePassIndex) {
+			for (const u32 predecessor : frame.resources[resource.physicalIndex].aliasedPredecessors) {
+				const SyncState& previous = mResources[mTransients[predecessor]].state;
+				resource.state.writeStages |= previous.writeStages | previous.readStages;
+				resource.state.writeAccess |= previous.writeAccess;
+			}
+		}
+
+		addBarrier(resource, access.stages, access.access, access.layout, access.isWrite);
+	}
+	flushBarriers(commandBuffer);
+
+	RenderGraphContext context{.commandBuffer = commandBuffer,
+	                           .frameIndex = mFrameIndex,
+	                           .inheritedStatistics = inheritedStatistics,
+	                           .graph = this};
+
+	if (pass.colorAttachments.empty() && !pass.depthAttachment.has_value()) {
+		if (pass.execute) {
+			pass.execute(context);
+		}
+		return;
+	}
+
+	// Content nobody reads afterwards is discarded, which saves the store on tiled GPUs
+	const auto storeOp = [&](const u32 index) {
+		const Resource& resource = mResources[index];
+		return resource.finalState.has_value() || resource.lastPass > alivePassIndex ? VK_ATTACHMENT_STORE_OP_STORE
+		                                                                             : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	};
+
+	std::array<VkRenderingAttachmentInfo, MAX_COLOR_ATTACHMENTS> colorInfos{};
+	std::array<VkFormat, MAX_COLOR_ATTACHMENTS> colorFormats{};
+	for (size_t i = 0; i < pass.colorAttachments.size(); ++i) {
+		const Attachment& attachment = pass.colorAttachments[i];
+		const Resource& resource = mResources[attachment.resource];
+		colorInfos[i] = {.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+		                 .imageView = resource.view,
+		                 .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		                 .loadOp = attachment.loadOp,
+		                 .storeOp = storeOp(attachment.resource),
+		                 .clearValue = attachment.clearValue};
+		colorFormats[i] = resource.imageDesc.format;
+		context.extent = resource.imageDesc.extent;
+	}
+
+	VkRenderingAttachmentInfo depthInfo{};
+	VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+	if (pass.depthAttachment.has_value()) {
+		const Attachment& attachment = *pass.depthAttachment;
+		const Resource& resource = mResources[attachment.resource];
+		depthInfo = {.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+		             .imageView = resource.view,
+		             .imageLayout = pass.depthReadOnly ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+		                                               : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+		             .loadOp = attachment.loadOp,
+		             .storeOp = pass.depthReadOnly ? VK_ATTACHMENT_STORE_OP_NONE : storeOp(attachment.resource),
+		             .clearValue = attachment.clearValue};
+		depthFormat = resource.imageDesc.format;
+		context.extent = resource.imageDesc.extent;
+	}
+
+	const VkRenderingInfo renderingInfo{
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+	    .flags = pass.secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0u,
+	    .renderArea = {.offset = {0, 0}, .extent = context.extent},
+	    .layerCount = 1,
+	    .colorAttachmentCount = static_cast<u32>(pass.colorAttachments.size()),
+	    .pColorAttachments = colorInfos.data(),
+	    .pDepthAttachment = pass.depthAttachment.has_value() ? &depthInfo : nullptr,
+	};
+
+	const VkCommandBufferInheritanceRenderingInfo inheritance{
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+	    .colorAttachmentCount = renderingInfo.colorAttachmentCount,
+	    .pColorAttachmentFormats = colorFormats.data(),
+	    .depthAttachmentFormat = depthFormat,
+	    .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+	};
+
+	vkCmdBeginRendering(commandBuffer, &renderingInfo);
+	if (pass.secondaryContents) {
+		context.renderingInheritance = &inheritance;
+	} else {
+		const VkViewport viewport{
+		    .x = 0.0f,
+		    .y = 0.0f,
+		    .width = static_cast<float>(context.extent.width),
+		    .height = static_cast<float>(context.extent.height),
+		    .minDepth = 0.0f,
+		    .maxDepth = 1.0f,
+		};
+		const VkRect2D scissor{.offset = {0, 0}, .extent = context.extent};
+
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	}
+
+	if (pass.execute) {
+		pass.execute(context);
+	}
+	vkCmdEndRendering(commandBuffer);
+}
+
+void VkEngineRenderGraph::execute(const VkCommandBuffer commandBuffer,
+                                  const VkQueryPipelineStatisticFlags inheritedStatistics) {
+	mStats = {.passes = mPassCount};
+
+	cullPasses();
+	computeLifetimes();
+	realizeTransients();
+
+	for (u32 i = 0; i < static_cast<u32>(mAlivePasses.size()); ++i) {
+		recordPass(commandBuffer, mPasses[mAlivePasses[i]], i, inheritedStatistics);
+	}
+
+	// Hand the exported resources over in the state the outside world expects
+	for (u32 i = 0; i < mResourceCount; ++i) {
+		Resource& resource = mResources[i];
+		if (!resource.finalState.has_value()) {
+			continue;
+		}
+
+		const RenderGraphState& finalState = *resource.finalState;
+		const VkImageLayout layout =
+		    finalState.layout == VK_IMAGE_LAYOUT_UNDEFINED ? resource.state.layout : finalState.layout;
+		const bool changesLayout = resource.isImage && layout != resource.state.layout;
+		const bool hasPendingWrite =
+		    finalState.stages != VK_PIPELINE_STAGE_2_NONE && resource.state.writeStages != VK_PIPELINE_STAGE_2_NONE;
+
+		if (changesLayout || hasPendingWrite) {
+			addBarrier(resource, finalState.stages, finalState.access, layout, false);
+		}
+	}
+	flushBarriers(commandBuffer);
+}
+
+}  // namespace vke
@@ -0,0 +1,290 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "core/engine_device.hpp"
+
+namespace vke {
+
+// Handles are indices into the graph of the frame being declared, they are invalidated by the next reset
+struct RenderGraphImage {
+	static constexpr u32 INVALID = UINT32_MAX;
+	u32 index = INVALID;
+	[[nodiscard]] bool isValid() const { return index != INVALID; }
+};
+
+struct RenderGraphBuffer {
+	static constexpr u32 INVALID = UINT32_MAX;
+	u32 index = INVALID;
+	[[nodiscard]] bool isValid() const { return index != INVALID; }
+};
+
+// How a pass touches a resource, the graph derives stages, access masks, image layouts and usage flags from it
+enum class RenderGraphUsage : u8 {
+	ColorAttachment,
+	DepthAttachment,
+	DepthRead,
+	SampledGraphics,
+	SampledCompute,
+	StorageGraphics,
+	StorageCompute,
+	IndirectBuffer,
+	VertexBuffer,
+	IndexBuffer,
+	UniformBuffer,
+	TransferSrc,
+	TransferDst,
+	// Predicate buffer of vkCmdBeginConditionalRenderingEXT
+	ConditionalRendering,
+};
+
+// State an imported resource is in before the graph runs, or must be left in once it is done
+struct RenderGraphState {
+	VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+	VkAccessFlags2 access = VK_ACCESS_2_NONE;
+	VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+struct RenderGraphImageDesc {
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	VkExtent2D extent{};
+	u32 mipLevels = 1;
+};
+
+struct RenderGraphBufferDesc {
+	VkDeviceSize size = 0;
+};
+
+class VkEngineRenderGraph;
+
+// Handed to the execute callback of a pass
+struct RenderGraphContext {
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	u32 frameIndex = 0;
+	// Render area of a pass with attachments
+	VkExtent2D extent{};
+	// Only set for passes recorded into secondary command buffers, to chain into their inheritance info
+	const VkCommandBufferInheritanceRenderingInfo* renderingInheritance = nullptr;
+	VkQueryPipelineStatisticFlags inheritedStatistics = 0;
+	const VkEngineRenderGraph* graph = nullptr;
+};
+
+struct RenderGraphStats {
+	u32 passes = 0;
+	u32 culledPasses = 0;
+	u32 barriers = 0;
+	u32 transientResources = 0;
+	// Bytes backing the transient resources of the frame, and what they would take without aliasing
+	VkDeviceSize transientMemory = 0;
+	VkDeviceSize transientMemoryUnaliased = 0;
+};
+
+// Frame graph rebuilt every frame: passes declare the resources they read and write, then execute() culls the passes
+// whose results are never consumed, places the transient resources in shared memory blocks when their lifetimes do
+// not overlap, and records every pass in declaration order with the sync2 barriers it needs. Passes with attachments
+// are recorded inside vkCmdBeginRendering, no VkRenderPass or VkFramebuffer is involved.
+class VkEngineRenderGraph : NO_COPY_NOR_MOVE {
+	struct Pass;
+
+   public:
+	using ExecuteFn = std::function<void(const RenderGraphContext&)>;
+
+	class PassBuilder {
+	   public:
+		PassBuilder& read(RenderGraphImage image, RenderGraphUsage usage);
+		PassBuilder& write(RenderGraphImage image, RenderGraphUsage usage);
+		PassBuilder& read(RenderGraphBuffer buffer, RenderGraphUsage usage);
+		PassBuilder& write(RenderGraphBuffer buffer, RenderGraphUsage usage);
+
+		// Attachments are written, and read as well with VK_ATTACHMENT_LOAD_OP_LOAD. The store op is picked by the
+		// graph: the content is only stored when a later pass reads it or the image is exported.
+		PassBuilder& addColorAttachment(RenderGraphImage image, VkAttachmentLoadOp loadOp,
+		                                VkClearColorValue clearValue = {});
+		PassBuilder& setDepthAttachment(RenderGraphImage image, VkAttachmentLoadOp loadOp, float clearDepth = 1.f,
+		                                bool readOnly = false);
+
+		// The pass body only executes secondary command buffers inheriting RenderGraphContext::renderingInheritance
+		PassBuilder& setSecondaryContents();
+		// Never culled, for passes whose effects are not visible to the graph, readbacks for instance
+		PassBuilder& setSideEffects();
+		PassBuilder& setExecute(ExecuteFn execute);
+
+	   private:
+		friend class VkEngineRenderGraph;
+		PassBuilder(VkEngineRenderGraph& graph, const u32 passIndex) : mGraph(graph), mPassIndex(passIndex) {}
+		Pass& pass() const;
+
+		VkEngineRenderGraph& mGraph;
+		u32 mPassIndex;
+	};
+
+	explicit VkEngineRenderGraph(std::shared_ptr<VkEngineDevice> device);
+
+	~VkEngineRenderGraph();
+
+	// Starts declaring the graph of `frameIndex`, whose fence must have been waited on: its transient resources may
+	// be recreated
+	void reset(u32 frameIndex);
+
+	RenderGraphImage importImage(std::string name, VkImage image, VkImageView view, const RenderGraphImageDesc& desc,
+	                             const RenderGraphState& initialState = {});
+	RenderGraphBuffer importBuffer(std::string name, VkBuffer buffer, VkDeviceSize size,
+	                               const RenderGraphState& initialState = {});
+
+	// Exported resources outlive the graph: the passes writing them are kept and they are left in `finalState`
+	void exportImage(RenderGraphImage image, const RenderGraphState& finalState);
+	void exportBuffer(RenderGraphBuffer buffer, const RenderGraphState& finalState = {});
+
+	// Transient resources only live for the frame, their memory is shared with resources used at other times
+	RenderGraphImage createImage(std::string name, const RenderGraphImageDesc& desc);
+	RenderGraphBuffer createBuffer(std::string name, const RenderGraphBufferDesc& desc);
+
+	// Passes execute in declaration order
+	PassBuilder addPass(std::string name);
+
+	void execute(VkCommandBuffer commandBuffer, VkQueryPipelineStatisticFlags inheritedStatistics = 0);
+
+	// Only valid inside execute callbacks, transient resources have no backing before
+	[[nodiscard]] VkImage getImage(RenderGraphImage image) const;
+	[[nodiscard]] VkImageView getImageView(RenderGraphImage image) const;
+	[[nodiscard]] VkBuffer getBuffer(RenderGraphBuffer buffer) const;
+
+	[[nodiscard]] const RenderGraphStats& getStats() const { return mStats; }
+
+   private:
+	// Every use of a resource by a pass, merged into one entry per resource
+	struct Access {
+		u32 resource = 0;
+		VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 access = VK_ACCESS_2_NONE;
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkImageUsageFlags imageUsage = 0;
+		VkBufferUsageFlags bufferUsage = 0;
+		bool isRead = false;
+		bool isWrite = false;
+		// The previous content is not needed, the passes producing it may be culled
+		bool discards = false;
+	};
+
+	struct Attachment {
+		u32 resource = 0;
+		VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		VkClearValue clearValue{};
+	};
+
+	struct Pass {
+		std::string name{};
+		std::vector<Access> accesses{};
+		std::vector<Attachment> colorAttachments{};
+		std::optional<Attachment> depthAttachment{};
+		bool depthReadOnly = false;
+		bool secondaryContents = false;
+		bool sideEffects = false;
+		ExecuteFn execute{};
+
+		// Filled by execute()
+		bool isAlive = false;
+	};
+
+	// Barrier bookkeeping: the last write (or layout transition) and the readers already synchronized after it
+	struct SyncState {
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+		VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+	};
+
+	struct Resource {
+		std::string name{};
+		bool isImage = true;
+		bool isImported = false;
+		std::optional<RenderGraphState> finalState{};
+		RenderGraphImageDesc imageDesc{};
+		RenderGraphBufferDesc bufferDesc{};
+
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+
+		// Filled by execute(), the lifetime is in alive pass order
+		VkImageUsageFlags imageUsage = 0;
+		VkBufferUsageFlags bufferUsage = 0;
+		u32 firstPass = UINT32_MAX;
+		u32 lastPass = 0;
+		u32 physicalIndex = UINT32_MAX;
+		SyncState state{};
+	};
+
+	// What decides whether the transient resources of a frame can be reused as is
+	struct TransientKey {
+		bool isImage = true;
+		RenderGraphImageDesc imageDesc{};
+		VkDeviceSize size = 0;
+		VkImageUsageFlags imageUsage = 0;
+		VkBufferUsageFlags bufferUsage = 0;
+		u32 firstPass = 0;
+		u32 lastPass = 0;
+
+		bool operator==(const TransientKey& other) const;
+	};
+
+	struct PhysicalResource {
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+		// Transient resources placed earlier in the frame in the same memory, waited on before the first use
+		std::vector<u32> aliasedPredecessors{};
+	};
+
+	struct FrameTransients {
+		std::vector<TransientKey> keys{};
+		std::vector<PhysicalResource> resources{};
+		std::vector<VmaAllocation> memoryBlocks{};
+		VkDeviceSize memory = 0;
+		VkDeviceSize unaliasedMemory = 0;
+	};
+
+	u32 newResource(std::string name, bool isImage);
+	void addAccess(Pass& pass, u32 resource, bool isImage, RenderGraphUsage usage, bool isRead, bool isWrite,
+	               bool discards) const;
+
+	void cullPasses();
+	void computeLifetimes();
+	void realizeTransients();
+	void allocateTransients(FrameTransients& frame) const;
+	void destroyTransients(FrameTransients& frame) const;
+
+	void recordPass(VkCommandBuffer commandBuffer, Pass& pass, u32 alivePassIndex,
+	                VkQueryPipelineStatisticFlags inheritedStatistics);
+	void addBarrier(Resource& resource, VkPipelineStageFlags2 stages, VkAccessFlags2 access, VkImageLayout layout,
+	                bool isWrite);
+	void flushBarriers(VkCommandBuffer commandBuffer);
+
+	std::shared_ptr<VkEngineDevice> mVkDevice{};
+
+	// Passes and resources are recycled from frame to frame to keep their storage
+	std::vector<Pass> mPasses{};
+	u32 mPassCount = 0;
+	std::vector<Resource> mResources{};
+	u32 mResourceCount = 0;
+	std::vector<u32> mAlivePasses{};
+	std::vector<u8> mNeededResources{};
+	std::vector<u32> mTransients{};
+	std::vector<TransientKey> mTransientKeys{};
+
+	std::vector<VkImageMemoryBarrier2> mImageBarriers{};
+	std::vector<VkBufferMemoryBarrier2> mBufferBarriers{};
+
+	std::array<FrameTransients, MAX_FRAMES_IN_FLIGHT> mFrameTransients{};
+	u32 mFrameIndex = 0;
+
+	RenderGraphStats mStats{};
+};
+}  // namespace vke
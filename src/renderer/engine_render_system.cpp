@@ -3,21 +3,48 @@
 //
 
 #include "engine_render_system.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <numeric>
 #include <glm/glm.hpp>
 
 #include "utils/logger.hpp"
 #include "utils/types.hpp"
 
 namespace vke {
+// The projection and view come from the global uniforms, only the world matrix is pushed per draw
 struct PushConstants {
 	glm::mat4 transform{1.f};
 	alignas(16) glm::vec3 color{};
+	u32 materialIndex = 0;
 };
 
-VkEngineRenderSystem::VkEngineRenderSystem(std::shared_ptr<VkEngineDevice> device, const VkRenderPass renderPass)
-    : mVkDevice(std::move(device)) {
+// Index of the pipelines in the pipeline field of the draw sort keys
+constexpr u32 OPAQUE_PIPELINE = 0;
+
+// ECS chunks flattened by a single worker at once
+constexpr u32 CHUNKS_PER_TASK = 16;
+
+struct InstanceData {
+	glm::mat4 transform{1.f};
+	glm::vec4 color{1.f};
+	u32 materialIndex = 0;
+	u32 pad[3]{};
+};
+
+VkEngineRenderSystem::VkEngineRenderSystem(std::shared_ptr<VkEngineDevice> device,
+                                           const AttachmentFormats& attachmentFormats,
+                                           const VkEngineBindlessHeap& bindlessHeap,
+                                           const VkEngineLightSystem& lightSystem,
+                                           const VkEngineGlobalUniforms& globalUniforms,
+                                           const VkEngineResourceRegistry& resources, ThreadPool& threadPool)
+    : mVkDevice(std::move(device)), mBindlessHeap(bindlessHeap), mLightSystem(lightSystem),
+      mGlobalUniforms(globalUniforms), mResources(resources), mThreadPool(threadPool), mFrustumCuller(threadPool),
+      mOcclusionCuller(threadPool) {
 	createPipelineLayout();
-	createPipeline(renderPass);
+	createPipeline(attachmentFormats);
 }
 
 VkEngineRenderSystem::~VkEngineRenderSystem() {
@@ -32,49 +59,438 @@ void VkEngineRenderSystem::createPipelineLayout() {
 	    .size = sizeof(PushConstants),
 	};
 
-	constexpr VkPipelineLayoutCreateInfo pipelineLayoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-	                                                        .pNext = nullptr,
-	                                                        .setLayoutCount = 0,
-	                                                        .pSetLayouts = nullptr,
-	                                                        .pushConstantRangeCount = 1,
-	                                                        .pPushConstantRanges = &pushConstantRange};
+	// Set 0 is the bindless heap, materials and textures are reached through it, set 1 the clustered lights and set 2
+	// the per frame uniforms
+	const std::array setLayouts{mBindlessHeap.getSetLayout(), mLightSystem.getSetLayout(),
+	                            mGlobalUniforms.getSetLayout()};
+
+	const VkPipelineLayoutCreateInfo pipelineLayoutInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	                                                    .pNext = nullptr,
+	                                                    .setLayoutCount = static_cast<u32>(setLayouts.size()),
+	                                                    .pSetLayouts = setLayouts.data(),
+	                                                    .pushConstantRangeCount = 1,
+	                                                    .pPushConstantRanges = &pushConstantRange};
 
 	VK_CHECK(vkCreatePipelineLayout(mVkDevice->getDevice(), &pipelineLayoutInfo, nullptr, &pVkPipelineLayout));
 }
 
-void VkEngineRenderSystem::createPipeline(const VkRenderPass renderPass) {
-	if (pVkPipeline) {
+void VkEngineRenderSystem::createPipeline(const AttachmentFormats& attachmentFormats) {
+	if (mPipelines[0]) {
 		throw std::runtime_error("Cannot create pipeline before pipeline layout");
 	}
 
-	PipelineConfigInfo pipelineConfig{};
-	pipelineConfig.renderPass = renderPass;
-	pipelineConfig.pipelineLayout = pVkPipelineLayout;
+	const auto configure = [&](PipelineConfigInfo& config, const DepthMode depthMode) {
+		config.attachmentFormats = attachmentFormats;
+		config.pipelineLayout = pVkPipelineLayout;
+		if (depthMode == DepthMode::Prepass) {
+			VkEnginePipeline::depthPrepassConfigInfo(config);
+		} else if (depthMode == DepthMode::EqualTest) {
+			VkEnginePipeline::depthEqualConfigInfo(config);
+		}
+	};
+
+	for (u32 mode = 0; mode < DEPTH_MODE_COUNT; ++mode) {
+		const auto depthMode = static_cast<DepthMode>(mode);
+		const bool prepass = depthMode == DepthMode::Prepass;
+		// The prepass only writes depth, it has no fragment shader
+		const std::string fragShader = prepass ? "" : "C:/Users/zphrfx/Desktop/vkEngine/shaders/simple.frag.spv";
+
+		PipelineConfigInfo pipelineConfig{};
+		configure(pipelineConfig, depthMode);
+
+		mPipelines[mode] = std::make_unique<VkEnginePipeline>(
+		    mVkDevice,
+		    prepass ? "C:/Users/zphrfx/Desktop/vkEngine/shaders/depth_prepass.vert.spv"
+		            : "C:/Users/zphrfx/Desktop/vkEngine/shaders/simple.vert.spv",
+		    fragShader, pipelineConfig);
+
+		// The instanced pipelines read the model vertices from binding 0 and one InstanceData per instance from
+		// binding 1, the prepass only needs the transform
+		PipelineConfigInfo instancedConfig{};
+		configure(instancedConfig, depthMode);
+
+		instancedConfig.bindingDescriptions.push_back(
+		    {.binding = 1, .stride = sizeof(InstanceData), .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE});
+
+		for (u32 column = 0; column < 4; ++column) {
+			instancedConfig.attributeDescriptions.push_back(
+			    {.location = 4 + column,
+			     .binding = 1,
+			     .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			     .offset = static_cast<u32>(offsetof(InstanceData, transform) + column * sizeof(glm::vec4))});
+		}
+		if (!prepass) {
+			instancedConfig.attributeDescriptions.push_back({.location = 8,
+			                                                 .binding = 1,
+			                                                 .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			                                                 .offset = offsetof(InstanceData, color)});
+			instancedConfig.attributeDescriptions.push_back({.location = 9,
+			                                                 .binding = 1,
+			                                                 .format = VK_FORMAT_R32_UINT,
+			                                                 .offset = offsetof(InstanceData, materialIndex)});
+		}
+
+		mInstancedPipelines[mode] = std::make_unique<VkEnginePipeline>(
+		    mVkDevice,
+		    prepass ? "C:/Users/zphrfx/Desktop/vkEngine/shaders/depth_prepass_instanced.vert.spv"
+		            : "C:/Users/zphrfx/Desktop/vkEngine/shaders/instanced.vert.spv",
+		    fragShader, instancedConfig);
+	}
+}
+
+
+void VkEngineRenderSystem::reserveInstanceBuffer(const u32 frameIndex, const u32 instanceCount) {
+	auto& buffer = mInstanceBuffers[frameIndex];
+	if (buffer != nullptr && buffer->getInstanceCount() >= instanceCount) {
+		return;
+	}
+
+	// The fence of this frame has been waited on by beginFrame, so the old buffer is no longer read by the GPU
+	const u32 capacity = std::max(instanceCount, buffer != nullptr ? buffer->getInstanceCount() * 2 : 1024u);
+
+	buffer = std::make_unique<VkEngineBuffer>(
+	    mVkDevice, sizeof(InstanceData), capacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+	    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+	    VMA_MEMORY_USAGE_AUTO);
+
+	VK_CHECK(buffer->map());
+}
+
+
+void VkEngineRenderSystem::cullGameObjects(const VkEngineWorld& world, const VkEngineCamera& camera) {
+	// Objects are numbered chunk after chunk, the offsets let every chunk be flattened on its own
+	world.collectChunks<WorldMatrixComponent, RenderComponent>(mChunks);
+	mChunkOffsets.resize(mChunks.size());
+	u32 objectCount = 0;
+	for (size_t c = 0; c < mChunks.size(); ++c) {
+		mChunkOffsets[c] = objectCount;
+		objectCount += mChunks[c].count;
+	}
+
+	mObjectEntities.resize(objectCount);
+	mObjectMatrices.resize(objectCount);
+	mObjectRenders.resize(objectCount);
+	mObjectModels.resize(objectCount);
+	mWorldSpheres.resize(objectCount);
+	std::atomic<u32> staleObjects{0};
+
+	// Only the matrix and render columns of the chunks are read
+	const auto buildBounds = [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		for (u32 c = begin; c < end; ++c) {
+			const EcsChunk& chunk = mChunks[c];
+			const Entity* entities = chunk.getEntities();
+			const auto* matrices = chunk.getColumn<WorldMatrixComponent>();
+			const auto* renders = chunk.getColumn<RenderComponent>();
+			for (u32 row = 0; row < chunk.count; ++row) {
+				const u32 i = mChunkOffsets[c] + row;
+				const glm::mat4& matrix = matrices[row].matrix;
+				const VkEngineModel* model = mResources.get(renders[row].mesh);
+				mObjectEntities[i] = entities[row];
+				mObjectMatrices[i] = &matrix;
+				mObjectRenders[i] = &renders[row];
+				mObjectModels[i] = model;
+				if (model == nullptr) {
+					// A sphere of infinitely negative radius fails every plane
+					mWorldSpheres.centerX[i] = mWorldSpheres.centerY[i] = mWorldSpheres.centerZ[i] = 0.f;
+					mWorldSpheres.radius[i] = -std::numeric_limits<float>::infinity();
+					staleObjects.fetch_add(1, std::memory_order::relaxed);
+					continue;
+				}
+
+				const glm::vec4 sphere = model->getBoundingSphere();
+				const glm::vec4 center = matrix * glm::vec4(glm::vec3(sphere), 1.f);
+				const float scale = std::max({glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])),
+				                              glm::length(glm::vec3(matrix[2]))});
+
+				mWorldSpheres.centerX[i] = center.x;
+				mWorldSpheres.centerY[i] = center.y;
+				mWorldSpheres.centerZ[i] = center.z;
+				mWorldSpheres.radius[i] = sphere.w * scale;
+			}
+		}
+	};
+	mThreadPool.parallelFor(static_cast<u32>(mChunks.size()), CHUNKS_PER_TASK, buildBounds);
+
+	if (mFrustumCulling) {
+		const FrustumPlanesSoA planes = toPlanesSoA(camera.extractFrustumPlanes());
+		if (pSpatialIndex != nullptr && pSpatialIndex->isCurrent(world)) {
+			// Same numbering as the spatial index, its boxes are tested instead of the spheres. Sorted so the
+			// occlusion passes see the objects in the order the sphere culler gives them.
+			mVisibleObjects.clear();
+			pSpatialIndex->queryFrustum(planes, mVisibleObjects);
+			std::ranges::sort(mVisibleObjects);
+		} else {
+			mFrustumCuller.cull(planes, mWorldSpheres, mVisibleObjects);
+		}
+	} else {
+		mVisibleObjects.resize(objectCount);
+		std::iota(mVisibleObjects.begin(), mVisibleObjects.end(), 0u);
+	}
+
+	// Objects whose mesh was released are never drawn, only the sphere culler rejects them on its own
+	if (staleObjects.load(std::memory_order::relaxed) != 0) {
+		std::erase_if(mVisibleObjects, [&](const u32 index) { return mObjectModels[index] == nullptr; });
+	}
+
+	if (mOcclusionCulling) {
+		cullOccludedObjects(camera);
+	}
+}
+
+
+void VkEngineRenderSystem::cullOccludedObjects(const VkEngineCamera& camera) {
+	mOcclusionCuller.beginFrame(camera.getProjectionMatrix() * camera.getViewMatrix());
+
+	// An occluder outside the frustum cannot hide anything inside it, so only the visible ones are rasterized
+	for (const u32 index : mVisibleObjects) {
+		if (mObjectRenders[index]->occluder) {
+			const VkEngineModel& model = *mObjectModels[index];
+			mOcclusionCuller.addOccluder(model.getPositions(), model.getIndices(), *mObjectMatrices[index]);
+		}
+	}
+
+	mOcclusionCuller.rasterize();
+	mOcclusionCuller.cull(mWorldSpheres, mVisibleObjects);
+}
+
+
+void VkEngineRenderSystem::buildDrawPackets(const VkEngineWorld& world, const VkEngineCamera& camera) {
+	cullGameObjects(world, camera);
+	if (pOcclusionQueries != nullptr) {
+		pOcclusionQueries->setCandidates(mObjectEntities, mWorldSpheres, mVisibleObjects,
+		                                 glm::vec3(glm::inverse(camera.getViewMatrix())[3]));
+	}
+
+	const auto visibleCount = static_cast<u32>(mVisibleObjects.size());
+	mRenderStats = {.drawCalls = visibleCount, .instances = visibleCount, .visibleObjects = visibleCount};
+
+	// Every visible object becomes a packet keyed on its state and view depth, the sorted packets then group the
+	// draws sharing a pipeline and model and order each group front to back for early depth rejection
+	const glm::mat4& view = camera.getViewMatrix();
+	resetMeshSlots();
+	mDrawPackets.clear();
+	for (const u32 index : mVisibleObjects) {
+		const RenderComponent& render = *mObjectRenders[index];
+		const u32 slot = getMeshSlot(index);
+
+		const float viewDepth = view[0][2] * mWorldSpheres.centerX[index] + view[1][2] * mWorldSpheres.centerY[index] +
+		                        view[2][2] * mWorldSpheres.centerZ[index] + view[3][2];
+
+		// There is a single opaque pass, its field stays at 0
+		mDrawPackets.push_back({.key = DrawSortKey::make(0, OPAQUE_PIPELINE, render.materialIndex, slot,
+		                                                 viewDepth),
+		                        .objectIndex = index});
+	}
 
-	pVkPipeline =
-	    std::make_unique<VkEnginePipeline>(mVkDevice, "C:/Users/zphrfx/Desktop/vkEngine/shaders/simple.vert.spv",
-	                                       "C:/Users/zphrfx/Desktop/vkEngine/shaders/simple.frag.spv", pipelineConfig);
+	radixSortDrawPackets(mDrawPackets, mDrawPacketScratch);
 }
 
 
-void VkEngineRenderSystem::renderGameObjects(const VkCommandBuffer* const commandBuffer,
-                                             const std::vector<VkEngineGameObjects>& objects,
-                                             const VkEngineCamera& camera) const {
-	pVkPipeline->bind(commandBuffer);
+u32 VkEngineRenderSystem::recordDrawPackets(const VkCommandBuffer* const commandBuffer, const u32 begin,
+                                            const u32 end, const DepthMode depthMode) const {
+	const std::array<const VkEnginePipeline*, 1> pipelines{mPipelines[static_cast<u32>(depthMode)].get()};
 
-	const glm::mat4x4 projectionView = camera.getProjectionMatrix() * camera.getViewMatrix();
+	// The sets stay bound across pipeline changes, all pipelines share the same layout
+	mBindlessHeap.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+	mLightSystem.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+	mGlobalUniforms.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+
+	u32 meshBindsAvoided = 0;
+	u32 boundPipeline = std::numeric_limits<u32>::max();
+	MeshHandle boundMesh{};
+	const VkEngineModel* model = nullptr;
+	for (u32 i = begin; i < end; ++i) {
+		const auto& [key, index] = mDrawPackets[i];
+		const RenderComponent& render = *mObjectRenders[index];
+
+		VkEngineOcclusionQueries::Predicate predicate{};
+		if (pOcclusionQueries != nullptr) {
+			predicate = pOcclusionQueries->getPredicate(mObjectEntities[index]);
+			if (predicate.kind == VkEngineOcclusionQueries::Predicate::Kind::Skip) {
+				continue;
+			}
+		}
+
+		if (const u32 pipeline = DrawSortKey::pipeline(key); pipeline != boundPipeline) {
+			pipelines[pipeline]->bind(commandBuffer);
+			boundPipeline = pipeline;
+		}
 
-	for (const auto& gameObject : objects) {
 		const PushConstants pushConstants{
-		    .transform = projectionView * gameObject.mTransform.mat4(),
-		    .color = gameObject.mColor,
+		    .transform = *mObjectMatrices[index],
+		    .color = render.color,
+		    .materialIndex = render.materialIndex,
 		};
 
 		vkCmdPushConstants(*commandBuffer, pVkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 		                   0, sizeof(PushConstants), &pushConstants);
 
-		gameObject.pModel->bind(commandBuffer);
-		gameObject.pModel->draw(commandBuffer);
+		// Compared by handle rather than key field, model slots past the 16 bits of the key would alias. Only these
+		// skips count as avoided, the unsorted path bound the pipeline once per pass too but the mesh per object.
+		if (render.mesh != boundMesh) {
+			model = mObjectModels[index];
+			if (depthMode == DepthMode::Prepass) {
+				model->bindPositions(commandBuffer);
+			} else {
+				model->bind(commandBuffer);
+			}
+			boundMesh = render.mesh;
+		} else {
+			++meshBindsAvoided;
+		}
+
+		if (pOcclusionQueries != nullptr) {
+			pOcclusionQueries->beginPredicate(*commandBuffer, predicate);
+			model->draw(commandBuffer);
+			pOcclusionQueries->endPredicate(*commandBuffer, predicate);
+		} else {
+			model->draw(commandBuffer);
+		}
+	}
+
+	return meshBindsAvoided;
+}
+
+
+void VkEngineRenderSystem::buildDrawList(const u32 frameIndex, const VkEngineWorld& world,
+                                         const VkEngineCamera& camera, const bool instanced) {
+	if (instanced) {
+		buildInstances(frameIndex, world, camera);
+	} else {
+		buildDrawPackets(world, camera);
+	}
+}
+
+
+void VkEngineRenderSystem::renderGameObjects(const VkCommandBuffer* const commandBuffer, const DepthMode depthMode) {
+	mRenderStats.meshBindsAvoided =
+	    recordDrawPackets(commandBuffer, 0, static_cast<u32>(mDrawPackets.size()), depthMode);
+}
+
+
+void VkEngineRenderSystem::renderGameObjectsParallel(const RenderGraphContext& context, VkEngineRenderer& renderer,
+                                                     const DepthMode depthMode) {
+	const auto packetCount = static_cast<u32>(mDrawPackets.size());
+	if (packetCount == 0) {
+		return;
+	}
+
+	// One contiguous range of the sorted packets per secondary, executing the secondaries in slot order keeps the
+	// sort order intact. Small ranges are not worth the cost of an extra secondary.
+	const u32 maxSlots = std::max(1u, packetCount / MIN_DRAWS_PER_SECONDARY);
+	const u32 slotCount = std::min(mThreadPool.getThreadCount(), maxSlots);
+	const u32 drawsPerSlot = (packetCount + slotCount - 1) / slotCount;
+	const u32 usedSlots = (packetCount + drawsPerSlot - 1) / drawsPerSlot;
+
+	renderer.reserveSecondaryCommandBuffers(usedSlots);
+	mSlotMeshBindsAvoided.assign(usedSlots, 0);
+
+	const auto recordSlot = [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		const u32 slot = begin / drawsPerSlot;
+		const VkCommandBuffer secondary = renderer.beginSecondaryCommandBuffer(slot, context);
+		mSlotMeshBindsAvoided[slot] = recordDrawPackets(&secondary, begin, end, depthMode);
+		VK_CHECK(vkEndCommandBuffer(secondary));
+	};
+	mThreadPool.parallelFor(packetCount, drawsPerSlot, recordSlot);
+
+	renderer.executeSecondaryCommandBuffers(&context.commandBuffer, usedSlots);
+
+	mRenderStats.meshBindsAvoided = std::accumulate(mSlotMeshBindsAvoided.begin(), mSlotMeshBindsAvoided.end(), 0u);
+}
+
+
+void VkEngineRenderSystem::resetMeshSlots() {
+	mMeshSlots.assign(mResources.getPool<VkEngineModel>().getCapacity(), {});
+	mSlotModels.clear();
+}
+
+
+u32 VkEngineRenderSystem::getMeshSlot(const u32 objectIndex) {
+	const MeshHandle mesh = mObjectRenders[objectIndex]->mesh;
+	MeshSlot& entry = mMeshSlots[mesh.getIndex()];
+	if (entry.mesh != mesh) {
+		// Only one generation of an index resolves at a time, and the stale ones were culled
+		assert(!entry.mesh.isValid() && "Two generations of a mesh drawn in the same frame");
+		entry = {.mesh = mesh, .slot = static_cast<u32>(mSlotModels.size())};
+		mSlotModels.push_back(mObjectModels[objectIndex]);
+	}
+	return entry.slot;
+}
+
+
+void VkEngineRenderSystem::buildInstances(const u32 frameIndex, const VkEngineWorld& world,
+                                          const VkEngineCamera& camera) {
+	mRenderStats = {};
+	resetMeshSlots();
+	mSlotOffsets.clear();
+	mInstanceCount = 0;
+
+	cullGameObjects(world, camera);
+	if (mVisibleObjects.empty()) {
+		return;
+	}
+
+	// First pass: count the instances of every unique model
+	for (const u32 index : mVisibleObjects) {
+		const u32 slot = getMeshSlot(index);
+		if (slot == mSlotOffsets.size()) {
+			mSlotOffsets.push_back(0);
+		}
+		++mSlotOffsets[slot];
+	}
+
+	// Exclusive prefix sum turns the counts into the first instance of every model
+	for (u32& offset : mSlotOffsets) {
+		const u32 count = offset;
+		offset = mInstanceCount;
+		mInstanceCount += count;
+	}
+
+	reserveInstanceBuffer(frameIndex, mInstanceCount);
+	const auto& instanceBuffer = mInstanceBuffers[frameIndex];
+
+	// Second pass: scatter the instances straight into the mapped buffer, grouped by model
+	auto* const instances = static_cast<InstanceData*>(instanceBuffer->getMappedMemory());
+	mSlotCursors.assign(mSlotOffsets.begin(), mSlotOffsets.end());
+	for (const u32 index : mVisibleObjects) {
+		const RenderComponent& render = *mObjectRenders[index];
+		const u32 slot = getMeshSlot(index);
+		instances[mSlotCursors[slot]++] = {.transform = *mObjectMatrices[index],
+		                                   .color = glm::vec4(render.color, 1.f),
+		                                   .materialIndex = render.materialIndex};
+	}
+
+	VK_CHECK(instanceBuffer->flush());
+
+	mRenderStats = {.drawCalls = static_cast<u32>(mSlotModels.size()),
+	                .instances = mInstanceCount,
+	                .visibleObjects = mInstanceCount};
+}
+
+
+void VkEngineRenderSystem::renderGameObjectsInstanced(const VkCommandBuffer* const commandBuffer, const u32 frameIndex,
+                                                      const DepthMode depthMode) {
+	if (mInstanceCount == 0) {
+		return;
+	}
+
+	mInstancedPipelines[static_cast<u32>(depthMode)]->bind(commandBuffer);
+	mBindlessHeap.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+	mLightSystem.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+	mGlobalUniforms.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pVkPipelineLayout);
+
+	constexpr VkDeviceSize instanceOffset = 0;
+	vkCmdBindVertexBuffers(*commandBuffer, 1, 1, &mInstanceBuffers[frameIndex]->getBuffer(), &instanceOffset);
+
+	for (size_t slot = 0; slot < mSlotModels.size(); ++slot) {
+		const u32 end = slot + 1 < mSlotOffsets.size() ? mSlotOffsets[slot + 1] : mInstanceCount;
+
+		if (depthMode == DepthMode::Prepass) {
+			mSlotModels[slot]->bindPositions(commandBuffer);
+		} else {
+			mSlotModels[slot]->bind(commandBuffer);
+		}
+		mSlotModels[slot]->draw(commandBuffer, end - mSlotOffsets[slot], mSlotOffsets[slot]);
 	}
 }
 
@@ -4,15 +4,49 @@
 
 #pragma once
 
+#include "core/engine_bindless_heap.hpp"
+#include "core/engine_buffer.hpp"
 #include "core/engine_device.hpp"
 #include "core/engine_ecs.hpp"
 #include "core/engine_pipeline.hpp"
+#include "core/engine_resources.hpp"
 #include "engine_camera.hpp"
+#include "engine_draw_packets.hpp"
+#include "engine_renderer.hpp"
+#include "engine_frustum_culling.hpp"
+#include "engine_global_uniforms.hpp"
+#include "engine_light_system.hpp"
+#include "engine_occlusion_culling.hpp"
+#include "engine_occlusion_queries.hpp"
+#include "engine_spatial_system.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace vke {
+
+struct RenderStats {
+	u32 drawCalls = 0;
+	u32 instances = 0;
+	u32 visibleObjects = 0;
+	// Mesh rebinds skipped because the previous draw used the same mesh
+	u32 meshBindsAvoided = 0;
+};
+
+// How the draws of a pass interact with the depth buffer
+enum class DepthMode : u8 {
+	// Depth tested with LESS and written, the only pass drawing the objects
+	Forward,
+	// Positions only and no fragment shader, fills the depth buffer ahead of the EqualTest pass
+	Prepass,
+	// Depth tested with EQUAL against the prepass and not written, each pixel is shaded once
+	EqualTest,
+};
+
 class VkEngineRenderSystem {
    public:
-	VkEngineRenderSystem(std::shared_ptr<VkEngineDevice> device, VkRenderPass renderPass);
+	VkEngineRenderSystem(std::shared_ptr<VkEngineDevice> device, const AttachmentFormats& attachmentFormats,
+	                     const VkEngineBindlessHeap& bindlessHeap, const VkEngineLightSystem& lightSystem,
+	                     const VkEngineGlobalUniforms& globalUniforms, const VkEngineResourceRegistry& resources,
+	                     ThreadPool& threadPool);
 
 	~VkEngineRenderSystem();
 
@@ -20,18 +54,121 @@ class VkEngineRenderSystem {
 
 	VkEngineRenderSystem& operator=(const VkEngineRenderSystem&) = delete;
 
-	void renderGameObjects(const VkCommandBuffer* commandBuffer, const std::vector<VkEngineGameObjects>& objects,
-	                       const VkEngineCamera& camera) const;
+	// Culls the objects and builds the draw list of the frame, packets for the direct draws or the instance data of
+	// the frame in flight. Kept apart from the recording so that it runs as a system of the frame, every render call
+	// of the frame then records the same list whatever its depth mode.
+	void buildDrawList(u32 frameIndex, const VkEngineWorld& world, const VkEngineCamera& camera, bool instanced);
+
+	// Records one draw per visible object in draw sort key order, pipeline and model binds are only issued when the
+	// state actually changes
+	void renderGameObjects(const VkCommandBuffer* commandBuffer, DepthMode depthMode = DepthMode::Forward);
+
+	// Same draws as renderGameObjects, split into contiguous ranges recorded on the thread pool into secondary command
+	// buffers, which are then executed in order. The render graph pass must have been declared with secondary contents.
+	// The secondaries of a frame are shared, so at most one pass per frame may record this way.
+	void renderGameObjectsParallel(const RenderGraphContext& context, VkEngineRenderer& renderer,
+	                               DepthMode depthMode = DepthMode::Forward);
+
+	// Groups objects by model and issues one instanced draw per unique model, the per instance data is streamed
+	// through a vertex buffer owned by the frame in flight
+	void renderGameObjectsInstanced(const VkCommandBuffer* commandBuffer, u32 frameIndex,
+	                                DepthMode depthMode = DepthMode::Forward);
+
+	// Fewest draws worth recording into a secondary command buffer of their own
+	static constexpr u32 MIN_DRAWS_PER_SECONDARY = 256;
+
+	const std::unique_ptr<VkEnginePipeline>& getPipeline() const { return mPipelines[0];}
+	const RenderStats& getRenderStats() const { return mRenderStats; }
 
-	const std::unique_ptr<VkEnginePipeline>& getPipeline() const { return pVkPipeline;}
+	void setFrustumCulling(const bool enabled) { mFrustumCulling = enabled; }
+	bool isFrustumCullingEnabled() const { return mFrustumCulling; }
+
+	// Tests the objects left by frustum culling against the objects flagged as occluders, rasterized on the CPU
+	void setOcclusionCulling(const bool enabled) { mOcclusionCulling = enabled; }
+	bool isOcclusionCullingEnabled() const { return mOcclusionCulling; }
+	const OcclusionCullStats& getOcclusionStats() const { return mOcclusionCuller.getStats(); }
+
+	// Direct draws of the objects queried by `queries` in earlier frames are predicated on the results, and the visible
+	// objects become the candidates of this frame. Null disables it, instanced draws are never predicated.
+	void setOcclusionQueries(VkEngineOcclusionQueries* queries) { pOcclusionQueries = queries; }
+
+	// Frustum culling queries `spatialIndex` instead of testing every sphere, as long as it is current for
+	// the world being drawn. Null tests every sphere.
+	void setSpatialIndex(const VkEngineSpatialSystem* spatialIndex) { pSpatialIndex = spatialIndex; }
 
    private:
 	void createPipelineLayout();
-	void createPipeline(VkRenderPass renderPass);
+	void createPipeline(const AttachmentFormats& attachmentFormats);
+	void reserveInstanceBuffer(u32 frameIndex, u32 instanceCount);
+
+	// Flattens the renderable entities into the per object arrays and computes their bounding spheres on the thread
+	// pool, then fills mVisibleObjects with the indices of the objects intersecting the camera frustum and not hidden
+	// by an occluder
+	void cullGameObjects(const VkEngineWorld& world, const VkEngineCamera& camera);
+	// Rasterizes the visible occluders and drops the visible objects they hide
+	void cullOccludedObjects(const VkEngineCamera& camera);
+	// Culls, then fills and sorts mDrawPackets with one packet per visible object
+	void buildDrawPackets(const VkEngineWorld& world, const VkEngineCamera& camera);
+	// Records packets [begin, end) and returns the number of mesh binds skipped, safe to call concurrently on distinct
+	// command buffers
+	u32 recordDrawPackets(const VkCommandBuffer* commandBuffer, u32 begin, u32 end, DepthMode depthMode) const;
+	// Groups the visible objects by model and writes their instance data to the buffer of the frame
+	void buildInstances(u32 frameIndex, const VkEngineWorld& world, const VkEngineCamera& camera);
+	// Forgets the slots of the last frame, then hands out slots to meshes in order of first use
+	void resetMeshSlots();
+	u32 getMeshSlot(u32 objectIndex);
+
+	static constexpr u32 DEPTH_MODE_COUNT = 3;
 
 
 	std::shared_ptr<VkEngineDevice> mVkDevice{};
-	std::unique_ptr<VkEnginePipeline> pVkPipeline{};
+	const VkEngineBindlessHeap& mBindlessHeap;
+	const VkEngineLightSystem& mLightSystem;
+	const VkEngineGlobalUniforms& mGlobalUniforms;
+	const VkEngineResourceRegistry& mResources;
+	// Indexed by DepthMode
+	std::array<std::unique_ptr<VkEnginePipeline>, DEPTH_MODE_COUNT> mPipelines{};
+	std::array<std::unique_ptr<VkEnginePipeline>, DEPTH_MODE_COUNT> mInstancedPipelines{};
 	VkPipelineLayout pVkPipelineLayout = VK_NULL_HANDLE;
+
+	std::array<std::unique_ptr<VkEngineBuffer>, MAX_FRAMES_IN_FLIGHT> mInstanceBuffers{};
+
+	// scratch storage reused across frames to avoid per frame allocations
+	// Slot of each mesh drawn this frame, indexed by handle index and tagged with the full handle so that another
+	// generation of the index never lands in the slot of the mesh drawn
+	struct MeshSlot {
+		MeshHandle mesh{};
+		u32 slot = 0;
+	};
+	std::vector<MeshSlot> mMeshSlots{};
+	std::vector<const VkEngineModel*> mSlotModels{};
+	std::vector<u32> mSlotOffsets{};
+	std::vector<u32> mSlotCursors{};
+	u32 mInstanceCount = 0;
+	std::vector<DrawPacket> mDrawPackets{};
+	std::vector<DrawPacket> mDrawPacketScratch{};
+	std::vector<u32> mSlotMeshBindsAvoided{};
+
+	ThreadPool& mThreadPool;
+	// Entities with a WorldMatrixComponent and a RenderComponent, flattened by cullGameObjects into one index per
+	// object shared by the spheres, the visible list and the draw packets. The pointers go into the ECS chunks and
+	// are only valid for the frame.
+	std::vector<EcsChunk> mChunks{};
+	std::vector<u32> mChunkOffsets{};
+	std::vector<Entity> mObjectEntities{};
+	std::vector<const glm::mat4*> mObjectMatrices{};
+	std::vector<const RenderComponent*> mObjectRenders{};
+	// Resolved once per frame, null for the objects whose mesh was released, cullGameObjects drops them
+	std::vector<const VkEngineModel*> mObjectModels{};
+	VkEngineFrustumCuller mFrustumCuller;
+	BoundingSpheresSoA mWorldSpheres{};
+	std::vector<u32> mVisibleObjects{};
+	bool mFrustumCulling = true;
+	VkEngineOcclusionCuller mOcclusionCuller;
+	bool mOcclusionCulling = false;
+	VkEngineOcclusionQueries* pOcclusionQueries = nullptr;
+	const VkEngineSpatialSystem* pSpatialIndex = nullptr;
+
+	RenderStats mRenderStats{};
 };
 }  // namespace vke
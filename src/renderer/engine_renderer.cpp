@@ -12,6 +12,10 @@ VkEngineRenderer::VkEngineRenderer(std::shared_ptr<VkEngineDevice> device, std::
     : mVkDevice(std::move(device)), mVkWindow(std::move(window)) {
 	recreateSwapChain();
 	createCommandBuffers();
+	pRenderGraph = std::make_unique<VkEngineRenderGraph>(mVkDevice);
+	for (auto& allocator : mFrameDescriptorAllocators) {
+		allocator = std::make_unique<VkEngineDescriptorAllocator>(mVkDevice->getDevice(), 32, DEFAULT_POOL_RATIOS);
+	}
 }
 
 VkEngineRenderer::~VkEngineRenderer() { VKINFO("Destroying Renderer"); }
@@ -32,6 +36,91 @@ void VkEngineRenderer::createCommandBuffers() {
 
 void VkEngineRenderer::freeCommandBuffers() const {}
 
+void VkEngineRenderer::reserveSecondaryCommandBuffers(const u32 count) {
+	for (u32 frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+		auto& pools = mSecondaryCommandPools[frame];
+		auto& commandBuffers = mSecondaryCommandBuffers[frame];
+
+		while (pools.size() < count) {
+			const VkCommandPoolCreateInfo poolInfo{
+			    .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			    .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			    .queueFamilyIndex = mVkDevice->findPhysicalQueueFamilies().mGraphicsFamily.value(),
+			};
+
+			VkCommandPool pool = VK_NULL_HANDLE;
+			VK_CHECK(vkCreateCommandPool(mVkDevice->getDevice(), &poolInfo, nullptr, &pool));
+			mVkDevice->getDeletionQueue().push_function(
+			    [device = mVkDevice, pool] { vkDestroyCommandPool(device->getDevice(), pool, nullptr); });
+
+			const VkCommandBufferAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			                                            .commandPool = pool,
+			                                            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+			                                            .commandBufferCount = 1};
+
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VK_CHECK(vkAllocateCommandBuffers(mVkDevice->getDevice(), &allocInfo, &commandBuffer));
+
+			pools.push_back(pool);
+			commandBuffers.push_back(commandBuffer);
+		}
+	}
+}
+
+void VkEngineRenderer::resetSecondaryCommandBuffers() const {
+	// The fence of the frame has been waited on, so whole pools can be reset instead of every buffer
+	for (const VkCommandPool pool : mSecondaryCommandPools[mCurrentFrame]) {
+		VK_CHECK(vkResetCommandPool(mVkDevice->getDevice(), pool, 0));
+	}
+}
+
+VkCommandBuffer VkEngineRenderer::beginSecondaryCommandBuffer(const u32 slot, const RenderGraphContext& context) const {
+	if (!isFrameStarted) {
+		VKERROR("Cannot begin a secondary command buffer when frame not in progress.");
+	}
+	assert(slot < mSecondaryCommandBuffers[mCurrentFrame].size() && "Secondary slot was not reserved");
+	assert(context.renderingInheritance != nullptr && "The render graph pass was not declared with secondary contents");
+
+	const VkCommandBufferInheritanceInfo inheritanceInfo{
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+	    .pNext = context.renderingInheritance,
+	    .pipelineStatistics = context.inheritedStatistics,
+	};
+
+	const VkCommandBufferBeginInfo beginInfo{
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+	    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+	    .pInheritanceInfo = &inheritanceInfo,
+	};
+
+	auto* const commandBuffer = mSecondaryCommandBuffers[mCurrentFrame][slot];
+	VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+	// Dynamic state is not inherited from the primary
+	const VkViewport viewport{
+	    .x = 0.0f,
+	    .y = 0.0f,
+	    .width = static_cast<float>(context.extent.width),
+	    .height = static_cast<float>(context.extent.height),
+	    .minDepth = 0.0f,
+	    .maxDepth = 1.0f,
+	};
+	const VkRect2D scissor{.offset = {0, 0}, .extent = context.extent};
+
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	return commandBuffer;
+}
+
+void VkEngineRenderer::executeSecondaryCommandBuffers(const VkCommandBuffer* const commandBuffer,
+                                                      const u32 count) const {
+	if (count == 0) {
+		return;
+	}
+	vkCmdExecuteCommands(*commandBuffer, count, mSecondaryCommandBuffers[mCurrentFrame].data());
+}
+
 void VkEngineRenderer::recreateSwapChain() {
 	auto extent = mVkWindow->getExtent();
 
@@ -71,6 +160,17 @@ VkCommandBuffer VkEngineRenderer::beginFrame() {
 	}
 
 	isFrameStarted = true;
+	resetSecondaryCommandBuffers();
+	mFrameDescriptorAllocators[mCurrentFrame]->resetPools();
+
+	// Submission waits for the acquire at the color attachment output stage, the first barrier on the image chains
+	// to it. Its previous content is not needed.
+	pRenderGraph->reset(mCurrentFrame);
+	mBackBuffer = pRenderGraph->importImage(
+	    "backbuffer", mVkSwapChain->getImage(mCurrentImage), mVkSwapChain->getImageView(mCurrentImage),
+	    {.format = mVkSwapChain->getSwapChainImageFormat(), .extent = mVkSwapChain->getSwapChainExtent()},
+	    {.stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT});
+	pRenderGraph->exportImage(mBackBuffer, {.layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR});
 
 	auto* const commandBuffer = getCurrentCommandBuffer();
 	constexpr VkCommandBufferBeginInfo beginInfo{
@@ -108,38 +208,27 @@ void VkEngineRenderer::endFrame() {
 }
 
 
-void VkEngineRenderer::beginSwapChainRenderPass(const VkCommandBuffer* const commandBuffer) const {
-	VkClearValue clearValues[2]{};
-	clearValues[0].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
-	clearValues[1].depthStencil = {1.0f, 0};
-
-	const VkRenderPassBeginInfo renderPassInfo{
-	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-	    .renderPass = mVkSwapChain->getRenderPass(),
-	    .framebuffer = mVkSwapChain->getFrameBuffer(mCurrentImage),
-	    .renderArea = {.offset = {0, 0}, .extent = mVkSwapChain->getSwapChainExtent()},
-	    .clearValueCount = 2,
-	    .pClearValues = clearValues,
-	};
+void VkEngineRenderer::executeRenderGraph(const VkCommandBuffer* const commandBuffer,
+                                          const VkQueryPipelineStatisticFlags inheritedStatistics) const {
+	if (!isFrameStarted) {
+		VKERROR("Cannot execute the render graph when frame not in progress.");
+	}
 
-	const VkViewport viewport{
-	    .x = 0.0f,
-	    .y = 0.0f,
-	    .width = static_cast<float>(mVkSwapChain->getSwapChainExtent().width),
-	    .height = static_cast<float>(mVkSwapChain->getSwapChainExtent().height),
-	    .minDepth = 0.0f,
-	    .maxDepth = 1.0f,
-	};
+	if (*commandBuffer != getCurrentCommandBuffer()) {
+		VKERROR("Can only execute the render graph on the currently active command buffer!");
+	}
 
-	const VkRect2D scissor{
-	    .offset = {0, 0},
-	    .extent = mVkSwapChain->getSwapChainExtent(),
-	};
+	pRenderGraph->execute(*commandBuffer, inheritedStatistics);
+}
 
-	vkCmdBeginRenderPass(*commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-	vkCmdSetViewport(*commandBuffer, 0, 1, &viewport);
-	vkCmdSetScissor(*commandBuffer, 0, 1, &scissor);
+void VkEngineRenderer::addImGuiPass(const RenderGraphImage target) {
 	ImGui::Render();
+
+	pRenderGraph->addPass("imgui")
+	    .addColorAttachment(target, VK_ATTACHMENT_LOAD_OP_LOAD)
+	    .setExecute([](const RenderGraphContext& context) {
+		    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), context.commandBuffer);
+	    });
 }
 
 VkCommandBuffer VkEngineRenderer::getCurrentCommandBuffer() const {
@@ -156,18 +245,5 @@ u32 VkEngineRenderer::getFrameIndex() const {
 	return mCurrentFrame;
 }
 
-void VkEngineRenderer::endSwapChainRenderPass(const VkCommandBuffer* const commandBuffer) const {
-	if (!isFrameStarted) {
-		VKERROR("Cannot end render pass when frame not in progress.");
-	}
-
-	if (*commandBuffer != getCurrentCommandBuffer()) {
-		VKERROR("Can only end the render pass on the currently active command buffer!");
-	}
-
-	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), *commandBuffer);
-	vkCmdEndRenderPass(*commandBuffer);
-}
-
 
 }  // namespace vke
\ No newline at end of file
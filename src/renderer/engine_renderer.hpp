@@ -5,8 +5,10 @@
 #pragma once
 
 #include "core/engine_device.hpp"
+#include "core/engine_pipeline.hpp"
 #include "core/engine_swapchain.hpp"
 #include "core/engine_window.hpp"
+#include "engine_render_graph.hpp"
 
 namespace vke {
 class VkEngineRenderer {
@@ -16,15 +18,42 @@ class VkEngineRenderer {
 
 	void run();
 	void endFrame();
+	// Also resets the render graph and imports the acquired swapchain image into it as the back buffer
 	VkCommandBuffer beginFrame();
 	bool isFrameInProgress() const { return isFrameStarted; }
-	void beginSwapChainRenderPass(const VkCommandBuffer* commandBuffer) const;
-	void endSwapChainRenderPass(const VkCommandBuffer* commandBuffer) const;
+
+	// Records the render graph declared since beginFrame. `inheritedStatistics` tells the secondary command buffers
+	// which pipeline statistics query is active around the graph.
+	void executeRenderGraph(const VkCommandBuffer* commandBuffer,
+	                        VkQueryPipelineStatisticFlags inheritedStatistics = 0) const;
+	// Declares a pass drawing the ImGui frame over `target`
+	void addImGuiPass(RenderGraphImage target);
+
+	VkEngineRenderGraph& getRenderGraph() const { return *pRenderGraph; }
+	// Presented once the graph is done with it
+	RenderGraphImage getBackBuffer() const { return mBackBuffer; }
+
+	// Makes sure `count` secondary command buffers exist for every frame in flight, call it before beginning slots
+	void reserveSecondaryCommandBuffers(u32 count);
+	// Begins the secondary command buffer of `slot` for the current frame, continuing the rendering of the graph pass
+	// `context` was handed to. Every slot has its own command pool, so distinct slots can be recorded from different
+	// threads at the same time.
+	VkCommandBuffer beginSecondaryCommandBuffer(u32 slot, const RenderGraphContext& context) const;
+	// Executes slots [0, count) of the current frame in order
+	void executeSecondaryCommandBuffers(const VkCommandBuffer* commandBuffer, u32 count) const;
+
+	// Sets allocated from it live until the same frame index begins again, then the whole allocator is reset at once
+	VkEngineDescriptorAllocator& getFrameDescriptorAllocator() const {
+		return *mFrameDescriptorAllocators[mCurrentFrame];
+	}
 
 
 	u32 getFrameIndex() const;
 	float getAspectRatio() const { return mVkSwapChain->extentAspectRatio(); }
-	VkRenderPass getSwapChainRenderPass() const { return mVkSwapChain->getRenderPass(); }
+	VkExtent2D getSwapChainExtent() const { return mVkSwapChain->getSwapChainExtent(); }
+	AttachmentFormats getAttachmentFormats() const {
+		return {.color = mVkSwapChain->getSwapChainImageFormat(), .depth = mVkSwapChain->getDepthFormat()};
+	}
 	VkCommandBuffer getCurrentCommandBuffer() const;
 
    private:
@@ -32,6 +61,7 @@ class VkEngineRenderer {
 	void recreateSwapChain();
 	void createCommandBuffers();
 	void freeCommandBuffers() const;
+	void resetSecondaryCommandBuffers() const;
 
 	std::shared_ptr<VkEngineDevice> mVkDevice{};
 	std::shared_ptr<VkEngineWindow> mVkWindow{};
@@ -39,6 +69,13 @@ class VkEngineRenderer {
 
 	std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> mVkCommandBuffers{VK_NULL_HANDLE};
 
+	std::array<std::vector<VkCommandPool>, MAX_FRAMES_IN_FLIGHT> mSecondaryCommandPools{};
+	std::array<std::vector<VkCommandBuffer>, MAX_FRAMES_IN_FLIGHT> mSecondaryCommandBuffers{};
+	std::array<std::unique_ptr<VkEngineDescriptorAllocator>, MAX_FRAMES_IN_FLIGHT> mFrameDescriptorAllocators{};
+
+	std::unique_ptr<VkEngineRenderGraph> pRenderGraph{};
+	RenderGraphImage mBackBuffer{};
+
 	u32 mCurrentImage = 0;
 	u32 mCurrentFrame = 0;
 
@@ -0,0 +1,70 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_spatial.hpp"
+
+#include <algorithm>
+
+namespace vke {
+
+Aabb Aabb::transform(const Aabb& box, const glm::mat4& matrix) {
+	const glm::vec3 center = glm::vec3(matrix * glm::vec4(box.getCenter(), 1.f));
+	const glm::vec3 extent = box.getExtent();
+	const glm::vec3 transformedExtent = glm::abs(glm::vec3(matrix[0])) * extent.x +
+	                                    glm::abs(glm::vec3(matrix[1])) * extent.y +
+	                                    glm::abs(glm::vec3(matrix[2])) * extent.z;
+	return {.min = center - transformedExtent, .max = center + transformedExtent};
+}
+
+FrustumPlanesSoA toPlanesSoA(const std::array<glm::vec4, 6>& planes) {
+	FrustumPlanesSoA soa{};
+	for (u32 p = 0; p < planes.size(); ++p) {
+		soa.nx[p] = planes[p].x;
+		soa.ny[p] = planes[p].y;
+		soa.nz[p] = planes[p].z;
+		soa.d[p] = planes[p].w;
+	}
+	return soa;
+}
+
+FrustumTest testFrustum(const FrustumPlanesSoA& planes, const Aabb& box) {
+	const glm::vec3 center = box.getCenter();
+	const glm::vec3 extent = box.getExtent();
+	FrustumTest result = FrustumTest::Inside;
+	for (u32 p = 0; p < planes.d.size(); ++p) {
+		const float distance =
+		    planes.nx[p] * center.x + planes.ny[p] * center.y + planes.nz[p] * center.z + planes.d[p];
+		const float radius = std::abs(planes.nx[p]) * extent.x + std::abs(planes.ny[p]) * extent.y +
+		                     std::abs(planes.nz[p]) * extent.z;
+		if (distance + radius < 0.f) {
+			return FrustumTest::Outside;
+		}
+		if (distance - radius < 0.f) {
+			result = FrustumTest::Intersecting;
+		}
+	}
+	return result;
+}
+
+bool intersectRay(const Aabb& box, const glm::vec3& origin, const glm::vec3& inverseDirection, const float maxDistance,
+                  float& distance) {
+	const glm::vec3 t0 = (box.min - origin) * inverseDirection;
+	const glm::vec3 t1 = (box.max - origin) * inverseDirection;
+	const glm::vec3 entries = glm::min(t0, t1);
+	const glm::vec3 exits = glm::max(t0, t1);
+	const float enter = std::max({entries.x, entries.y, entries.z, 0.f});
+	const float exit = std::min({exits.x, exits.y, exits.z, maxDistance});
+	if (enter > exit) {
+		return false;
+	}
+	distance = enter;
+	return true;
+}
+
+float distanceSquared(const Aabb& box, const glm::vec3& point) {
+	const glm::vec3 offset = glm::max(glm::max(box.min - point, point - box.max), glm::vec3{0.f});
+	return glm::dot(offset, offset);
+}
+
+}  // namespace vke
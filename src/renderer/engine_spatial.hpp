@@ -0,0 +1,73 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+#include <limits>
+
+#include "engine_frustum_culling.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Axis aligned box, empty while min > max
+struct Aabb {
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+	void grow(const glm::vec3& point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void grow(const Aabb& other) {
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	[[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+	[[nodiscard]] glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+
+	// Half the surface area, only ever compared in the SAH
+	[[nodiscard]] float getHalfArea() const {
+		const glm::vec3 size = glm::max(max - min, glm::vec3{0.f});
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	bool operator==(const Aabb&) const = default;
+
+	// Box around `box` once transformed by `matrix`, from the center and the absolute of the linear part
+	[[nodiscard]] static Aabb transform(const Aabb& box, const glm::mat4& matrix);
+};
+
+struct Ray {
+	glm::vec3 origin{0.f};
+	// Normalized, so that the distances are in world units
+	glm::vec3 direction{0.f, 0.f, 1.f};
+	float maxDistance = std::numeric_limits<float>::max();
+};
+
+enum class FrustumTest : u8 {
+	Outside,
+	Intersecting,
+	Inside,
+};
+
+// Planes as returned by VkEngineCamera::extractFrustumPlanes, normal in xyz and distance in w
+FrustumPlanesSoA toPlanesSoA(const std::array<glm::vec4, 6>& planes);
+
+// Planes as extracted by VkEngineCamera, the box is outside once entirely behind one of them
+FrustumTest testFrustum(const FrustumPlanesSoA& planes, const Aabb& box);
+
+// Distance along the ray at which it enters the box, 0 when it starts inside. False when it misses the box or only
+// reaches it past `maxDistance`.
+bool intersectRay(const Aabb& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+                  float& distance);
+
+// Squared distance from the point to the closest point of the box, 0 inside
+float distanceSquared(const Aabb& box, const glm::vec3& point);
+
+}  // namespace vke
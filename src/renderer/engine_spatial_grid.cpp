@@ -0,0 +1,400 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_spatial_grid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace vke {
+namespace {
+// Cell coordinates are biased and packed on 21 bits each, cells further than 2^20 from the origin wrap around
+constexpr i32 KEY_BIAS = 1 << 20;
+constexpr u64 KEY_MASK = (1ull << 21) - 1;
+
+void atomicMin(std::atomic<i32>& value, const i32 candidate) {
+	i32 current = value.load(std::memory_order::relaxed);
+	while (candidate < current && !value.compare_exchange_weak(current, candidate, std::memory_order::relaxed)) {
+	}
+}
+
+u64 getCellCount(const glm::ivec3& lo, const glm::ivec3& hi) {
+	const glm::i64vec3 size = glm::i64vec3(hi) - glm::i64vec3(lo) + glm::i64vec3(1);
+	return static_cast<u64>(size.x * size.y * size.z);
+}
+
+void atomicMax(std::atomic<i32>& value, const i32 candidate) {
+	i32 current = value.load(std::memory_order::relaxed);
+	while (candidate > current && !value.compare_exchange_weak(current, candidate, std::memory_order::relaxed)) {
+	}
+}
+}  // namespace
+
+VkEngineSpatialGrid::VkEngineSpatialGrid(const float cellSize)
+    : mCellSize(cellSize), mInverseCellSize(1.f / cellSize) {
+	reset(0);
+}
+
+void VkEngineSpatialGrid::reset(const u32 objectCount) {
+	// Twice as many buckets as objects keeps the cells sharing a bucket few
+	const u32 bucketCount = std::bit_ceil(std::max(objectCount * 2, 64u));
+	mBucketMask = bucketCount - 1;
+	mHeads = std::make_unique<std::atomic<u32>[]>(bucketCount + 1);
+	for (u32 bucket = 0; bucket <= bucketCount; ++bucket) {
+		mHeads[bucket].store(NO_ENTRY, std::memory_order::relaxed);
+	}
+
+	mEntries.resize(2 * static_cast<size_t>(objectCount));
+	mEntryCount.store(0, std::memory_order::relaxed);
+	mStaleEntries.store(0, std::memory_order::relaxed);
+	mBoxes.assign(objectCount, Aabb{});
+	mKeys.assign(objectCount, NO_CELL);
+	mStamps.assign(objectCount, 0);
+	for (u32 axis = 0; axis < 3; ++axis) {
+		mOccupiedMin[axis].store(std::numeric_limits<i32>::max(), std::memory_order::relaxed);
+		mOccupiedMax[axis].store(std::numeric_limits<i32>::min(), std::memory_order::relaxed);
+	}
+}
+
+void VkEngineSpatialGrid::beginUpdate() {
+	const u32 objectCount = getObjectCount();
+	const u32 used = mEntryCount.load(std::memory_order::relaxed);
+	const u32 stale = mStaleEntries.load(std::memory_order::relaxed);
+	// Every object may change cell before the next call, taking one more entry each
+	if (used + objectCount <= mEntries.size() && stale * 2 <= used) {
+		return;
+	}
+
+	// At most one live entry per object is left, the next updates then fit in the other half
+	std::vector<Aabb> boxes = std::move(mBoxes);
+	std::vector<u32> stamps = std::move(mStamps);
+	reset(objectCount);
+	for (u32 object = 0; object < objectCount; ++object) {
+		if (stamps[object] != 0) {
+			update(object, boxes[object]);
+		}
+	}
+}
+
+void VkEngineSpatialGrid::update(const u32 object, const Aabb& box) {
+	const glm::vec3 size = box.max - box.min;
+	const bool oversized = std::max({size.x, size.y, size.z}) > mCellSize;
+	const glm::ivec3 cell = getCell(box.min);
+	const u64 key = oversized ? NO_CELL : getKey(cell);
+
+	mBoxes[object] = box;
+	if (mStamps[object] != 0 && mKeys[object] == key) {
+		return;
+	}
+	if (mStamps[object] != 0) {
+		mStaleEntries.fetch_add(1, std::memory_order::relaxed);
+	}
+	mKeys[object] = key;
+	const u32 stamp = ++mStamps[object];
+
+	const u32 entry = mEntryCount.fetch_add(1, std::memory_order::relaxed);
+	assert(entry < mEntries.size() && "Spatial grid updated without beginUpdate");
+	mEntries[entry] = {.object = object, .stamp = stamp, .next = NO_ENTRY};
+	if (oversized) {
+		push(mHeads[mBucketMask + 1], entry);
+		return;
+	}
+
+	push(mHeads[getBucket(key)], entry);
+	for (u32 axis = 0; axis < 3; ++axis) {
+		atomicMin(mOccupiedMin[axis], cell[axis]);
+		atomicMax(mOccupiedMax[axis], cell[axis]);
+	}
+}
+
+void VkEngineSpatialGrid::push(std::atomic<u32>& head, const u32 entry) {
+	// Released so that whoever walks the list from the new head also sees the entry
+	u32 next = head.load(std::memory_order::relaxed);
+	do {
+		mEntries[entry].next = next;
+	} while (!head.compare_exchange_weak(next, entry, std::memory_order::release, std::memory_order::relaxed));
+}
+
+glm::ivec3 VkEngineSpatialGrid::getCell(const glm::vec3& point) const {
+	return glm::ivec3(glm::floor(point * mInverseCellSize));
+}
+
+u64 VkEngineSpatialGrid::getKey(const glm::ivec3& cell) {
+	const auto pack = [](const i32 coordinate) { return static_cast<u64>(coordinate + KEY_BIAS) & KEY_MASK; };
+	return pack(cell.x) << 42 | pack(cell.y) << 21 | pack(cell.z);
+}
+
+u32 VkEngineSpatialGrid::getBucket(const u64 key) const {
+	// Fibonacci hashing, neighbouring cells land far apart
+	return static_cast<u32>((key * 0x9E3779B97F4A7C15ull) >> 32) & mBucketMask;
+}
+
+bool VkEngineSpatialGrid::getOccupiedCells(glm::ivec3& min, glm::ivec3& max) const {
+	for (u32 axis = 0; axis < 3; ++axis) {
+		min[axis] = mOccupiedMin[axis].load(std::memory_order::relaxed);
+		max[axis] = mOccupiedMax[axis].load(std::memory_order::relaxed);
+	}
+	return min.x <= max.x;
+}
+
+bool VkEngineSpatialGrid::clampToOccupied(glm::ivec3& lo, glm::ivec3& hi) const {
+	glm::ivec3 occupiedMin{0};
+	glm::ivec3 occupiedMax{0};
+	if (!getOccupiedCells(occupiedMin, occupiedMax)) {
+		return false;
+	}
+	lo = glm::max(lo, occupiedMin);
+	hi = glm::min(hi, occupiedMax);
+	return glm::all(glm::lessThanEqual(lo, hi));
+}
+
+template <typename Fn>
+void VkEngineSpatialGrid::forEachObjectInCell(const u32 head, const u64 key, Fn&& fn) const {
+	for (u32 entry = mHeads[head].load(std::memory_order::acquire); entry != NO_ENTRY; entry = mEntries[entry].next) {
+		// Other cells share the bucket
+		const u32 object = mEntries[entry].object;
+		if (mEntries[entry].stamp == mStamps[object] && mKeys[object] == key) {
+			fn(object);
+		}
+	}
+}
+
+template <typename Fn>
+bool VkEngineSpatialGrid::forEachObject(glm::ivec3 lo, glm::ivec3 hi, Fn&& fn) const {
+	const bool empty = !clampToOccupied(lo, hi);
+	if (!empty && getCellCount(lo, hi) > getObjectCount()) {
+		return false;
+	}
+
+	forEachObjectInCell(mBucketMask + 1, NO_CELL, fn);
+	if (empty) {
+		return true;
+	}
+	for (i32 z = lo.z; z <= hi.z; ++z) {
+		for (i32 y = lo.y; y <= hi.y; ++y) {
+			for (i32 x = lo.x; x <= hi.x; ++x) {
+				const u64 key = getKey({x, y, z});
+				forEachObjectInCell(getBucket(key), key, fn);
+			}
+		}
+	}
+	return true;
+}
+
+void VkEngineSpatialGrid::queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const {
+	const size_t firstResult = objects.size();
+	if (queryFrustumCells(planes, objects)) {
+		return;
+	}
+
+	// Objects far apart leave the cells between them mostly empty
+	objects.resize(firstResult);
+	for (u32 object = 0; object < getObjectCount(); ++object) {
+		if (mStamps[object] != 0 && testFrustum(planes, mBoxes[object]) != FrustumTest::Outside) {
+			objects.push_back(object);
+		}
+	}
+}
+
+bool VkEngineSpatialGrid::queryFrustumCells(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const {
+	const auto testObject = [&](const u32 object) {
+		if (testFrustum(planes, mBoxes[object]) != FrustumTest::Outside) {
+			objects.push_back(object);
+		}
+	};
+
+	const auto addObject = [&](const u32 object) { objects.push_back(object); };
+
+	glm::ivec3 lo{0};
+	glm::ivec3 hi{0};
+	if (!getOccupiedCells(lo, hi)) {
+		forEachObjectInCell(mBucketMask + 1, NO_CELL, testObject);
+		return true;
+	}
+
+	// A block or cell test costs about as much as an object test
+	i64 budget = getObjectCount();
+	// Checked axis by axis, the product of all three could overflow
+	i64 blockCount = 1;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		blockCount *= (static_cast<i64>(hi[axis]) - lo[axis]) / FRUSTUM_BLOCK_CELLS + 1;
+		if (blockCount > budget) {
+			return false;
+		}
+	}
+	forEachObjectInCell(mBucketMask + 1, NO_CELL, testObject);
+
+	// Planes do not bound a range of cells, so the occupied ones are culled by blocks first, then cell by cell within
+	// the blocks crossing a plane. The objects of a cell reach at most the end of the next one.
+	const float blockSize = mCellSize * static_cast<float>(FRUSTUM_BLOCK_CELLS);
+	for (i32 blockZ = lo.z; blockZ <= hi.z; blockZ += FRUSTUM_BLOCK_CELLS) {
+		for (i32 blockY = lo.y; blockY <= hi.y; blockY += FRUSTUM_BLOCK_CELLS) {
+			for (i32 blockX = lo.x; blockX <= hi.x; blockX += FRUSTUM_BLOCK_CELLS) {
+				const glm::ivec3 block{blockX, blockY, blockZ};
+				const glm::vec3 blockMin = glm::vec3(block) * mCellSize;
+				const FrustumTest blockTest =
+				    testFrustum(planes, {.min = blockMin, .max = blockMin + blockSize + mCellSize});
+				if (--budget < 0) {
+					return false;
+				}
+				if (blockTest == FrustumTest::Outside) {
+					continue;
+				}
+
+				const glm::ivec3 blockEnd = glm::min(block + FRUSTUM_BLOCK_CELLS - 1, hi);
+				for (i32 z = blockZ; z <= blockEnd.z; ++z) {
+					for (i32 y = blockY; y <= blockEnd.y; ++y) {
+						for (i32 x = blockX; x <= blockEnd.x; ++x) {
+							if (--budget < 0) {
+								return false;
+							}
+							FrustumTest test = blockTest;
+							if (test == FrustumTest::Intersecting) {
+								const glm::vec3 cellMin = glm::vec3(x, y, z) * mCellSize;
+								test = testFrustum(planes, {.min = cellMin, .max = cellMin + 2.f * mCellSize});
+							}
+
+							const u64 key = getKey({x, y, z});
+							if (test == FrustumTest::Inside) {
+								forEachObjectInCell(getBucket(key), key, addObject);
+							} else if (test == FrustumTest::Intersecting) {
+								forEachObjectInCell(getBucket(key), key, testObject);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+u32 VkEngineSpatialGrid::raycast(const Ray& ray, float& distance) const {
+	const glm::vec3 inverseDirection = 1.f / ray.direction;
+	u32 closest = NO_OBJECT;
+	distance = ray.maxDistance;
+	const auto testObject = [&](const u32 object) {
+		float enter = 0.f;
+		if (intersectRay(mBoxes[object], ray.origin, inverseDirection, distance, enter) &&
+		    (enter < distance || closest == NO_OBJECT)) {
+			distance = enter;
+			closest = object;
+		}
+	};
+
+	forEachObjectInCell(mBucketMask + 1, NO_CELL, testObject);
+
+	// Cells the objects reach into, one past the occupied ones
+	glm::ivec3 occupiedMin{0};
+	glm::ivec3 occupiedMax{0};
+	if (!getOccupiedCells(occupiedMin, occupiedMax)) {
+		return closest;
+	}
+	const glm::ivec3 lo = occupiedMin;
+	const glm::ivec3 hi = occupiedMax + 1;
+
+	float start = 0.f;
+	const Aabb bounds{.min = glm::vec3(lo) * mCellSize, .max = glm::vec3(hi + 1) * mCellSize};
+	if (!intersectRay(bounds, ray.origin, inverseDirection, distance, start)) {
+		return closest;
+	}
+
+	// Cell by cell along the ray (Amanatides and Woo), `next` is the distance at which it crosses into the next cell
+	glm::ivec3 cell = glm::clamp(getCell(ray.origin + ray.direction * start), lo, hi);
+	glm::ivec3 step{0};
+	glm::vec3 next{std::numeric_limits<float>::max()};
+	glm::vec3 delta{std::numeric_limits<float>::max()};
+	for (u32 axis = 0; axis < 3; ++axis) {
+		if (ray.direction[axis] > 0.f) {
+			step[axis] = 1;
+			next[axis] = (static_cast<float>(cell[axis] + 1) * mCellSize - ray.origin[axis]) * inverseDirection[axis];
+			delta[axis] = mCellSize * inverseDirection[axis];
+		} else if (ray.direction[axis] < 0.f) {
+			step[axis] = -1;
+			next[axis] = (static_cast<float>(cell[axis]) * mCellSize - ray.origin[axis]) * inverseDirection[axis];
+			delta[axis] = -mCellSize * inverseDirection[axis];
+		}
+	}
+
+	while (true) {
+		// An object reaching into the cell is listed in it or in the previous one along each axis
+		for (u32 corner = 0; corner < 8; ++corner) {
+			const glm::ivec3 owner = cell - glm::ivec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+			if (glm::all(glm::greaterThanEqual(owner, occupiedMin)) &&
+			    glm::all(glm::lessThanEqual(owner, occupiedMax))) {
+				const u64 key = getKey(owner);
+				forEachObjectInCell(getBucket(key), key, testObject);
+			}
+		}
+
+		// The objects of the cells ahead are all entered past this one
+		const u32 axis = next.x < next.y ? (next.x < next.z ? 0 : 2) : (next.y < next.z ? 1 : 2);
+		if (distance <= next[axis]) {
+			break;
+		}
+		cell[axis] += step[axis];
+		if (cell[axis] < lo[axis] || cell[axis] > hi[axis]) {
+			break;
+		}
+		next[axis] += delta[axis];
+	}
+	return closest;
+}
+
+u32 VkEngineSpatialGrid::queryNearest(const glm::vec3& point, float& distance) const {
+	u32 nearest = NO_OBJECT;
+	float nearestSquared = std::numeric_limits<float>::max();
+	const auto testObject = [&](const u32 object) {
+		if (const float squared = distanceSquared(mBoxes[object], point); squared < nearestSquared) {
+			nearestSquared = squared;
+			nearest = object;
+		}
+	};
+
+	// Every object within `radius` is tested, so the nearest found is the nearest overall once it lies within it
+	for (float radius = mCellSize;; radius *= 2.f) {
+		const glm::ivec3 lo = getCell(point - radius) - 1;
+		const glm::ivec3 hi = getCell(point + radius);
+		if (!forEachObject(lo, hi, testObject)) {
+			for (u32 object = 0; object < getObjectCount(); ++object) {
+				if (mStamps[object] != 0) {
+					testObject(object);
+				}
+			}
+			break;
+		}
+
+		glm::ivec3 occupiedMin{0};
+		glm::ivec3 occupiedMax{0};
+		const bool coversAll = !getOccupiedCells(occupiedMin, occupiedMax) ||
+		                       (glm::all(glm::lessThanEqual(lo, occupiedMin)) &&
+		                        glm::all(glm::greaterThanEqual(hi, occupiedMax)));
+		if (nearestSquared <= radius * radius || coversAll) {
+			break;
+		}
+	}
+
+	distance = std::sqrt(nearestSquared);
+	return nearest;
+}
+
+void VkEngineSpatialGrid::queryRadius(const glm::vec3& center, const float radius, std::vector<u32>& objects) const {
+	const float radiusSquared = radius * radius;
+	const auto testObject = [&](const u32 object) {
+		if (distanceSquared(mBoxes[object], center) <= radiusSquared) {
+			objects.push_back(object);
+		}
+	};
+
+	if (!forEachObject(getCell(center - radius) - 1, getCell(center + radius), testObject)) {
+		for (u32 object = 0; object < getObjectCount(); ++object) {
+			if (mStamps[object] != 0) {
+				testObject(object);
+			}
+		}
+	}
+}
+
+}  // namespace vke
@@ -0,0 +1,103 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine_spatial.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+// Reference from a cell to an object. It is stale once the object moved to another cell, the stamp of the object then
+// differs from the one it was made with.
+struct GridEntry {
+	u32 object = 0;
+	u32 stamp = 0;
+	u32 next = 0;
+};
+
+// Loose hashed grid over boxes numbered by the caller. An object is listed once, in the cell holding the min corner
+// of its box, and may reach into the next cell along each axis, so a query looks one cell further down than the
+// cells it covers. Boxes wider than a cell go to a list of their own that every query walks.
+//
+// Moving an object within its cell only updates its box, moving it to another cell pushes a new entry and leaves the
+// old one stale until the next compaction. An update is O(1) however many objects move, and unlike a BVH nothing
+// loosens as they do, which suits scenes where most objects move every frame.
+class VkEngineSpatialGrid {
+   public:
+	static constexpr u32 NO_OBJECT = ~0u;
+	static constexpr float DEFAULT_CELL_SIZE = 4.f;
+
+	explicit VkEngineSpatialGrid(float cellSize = DEFAULT_CELL_SIZE);
+
+	// Empties the grid and sizes it for objects [0, objectCount)
+	void reset(u32 objectCount);
+
+	// Compacts the entries if the updates to come could run out of them or the stale ones outnumber the live ones.
+	// Called before each batch of updates, never concurrently with them.
+	void beginUpdate();
+
+	// Moves the object to `box`. Lock free and safe to call concurrently for distinct objects, the queries must wait
+	// until the updates are done.
+	void update(u32 object, const Aabb& box);
+
+	// Same queries as VkEngineBvh
+	void queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const;
+	u32 raycast(const Ray& ray, float& distance) const;
+	u32 queryNearest(const glm::vec3& point, float& distance) const;
+	void queryRadius(const glm::vec3& center, float radius, std::vector<u32>& objects) const;
+
+	[[nodiscard]] u32 getObjectCount() const { return static_cast<u32>(mBoxes.size()); }
+	[[nodiscard]] u32 getEntryCount() const { return mEntryCount.load(std::memory_order::relaxed); }
+	[[nodiscard]] u32 getStaleEntryCount() const { return mStaleEntries.load(std::memory_order::relaxed); }
+	[[nodiscard]] float getCellSize() const { return mCellSize; }
+
+   private:
+	static constexpr u32 NO_ENTRY = ~0u;
+	// Cell of the objects never placed and of the oversized ones
+	static constexpr u64 NO_CELL = ~0ull;
+	// Side of the blocks of cells the frustum query culls before the cells themselves
+	static constexpr i32 FRUSTUM_BLOCK_CELLS = 8;
+
+	[[nodiscard]] glm::ivec3 getCell(const glm::vec3& point) const;
+	[[nodiscard]] static u64 getKey(const glm::ivec3& cell);
+	[[nodiscard]] u32 getBucket(u64 key) const;
+	void push(std::atomic<u32>& head, u32 entry);
+	// Range of the cells holding objects, false when there is none
+	bool getOccupiedCells(glm::ivec3& min, glm::ivec3& max) const;
+	// Clamps the cells [lo, hi] to those holding objects, false when none is left
+	bool clampToOccupied(glm::ivec3& lo, glm::ivec3& hi) const;
+	// Calls fn(object) for the objects of the cells [lo, hi] and the oversized ones. Returns false without calling fn
+	// when the cells outnumber the objects, a scan of the objects is then cheaper.
+	template <typename Fn>
+	bool forEachObject(glm::ivec3 lo, glm::ivec3 hi, Fn&& fn) const;
+	template <typename Fn>
+	void forEachObjectInCell(u32 head, u64 key, Fn&& fn) const;
+	// Frustum query over the occupied cells. Returns false, possibly with part of the objects appended, once it has
+	// tested more blocks and cells than there are objects, a scan of the objects is then cheaper.
+	bool queryFrustumCells(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const;
+
+	float mCellSize;
+	float mInverseCellSize;
+	u32 mBucketMask = 0;
+	// One list of entries per bucket, followed by the list of the oversized boxes
+	std::unique_ptr<std::atomic<u32>[]> mHeads{};
+	std::vector<GridEntry> mEntries{};
+	std::atomic<u32> mEntryCount{0};
+	std::atomic<u32> mStaleEntries{0};
+	// Per object, the stamp is bumped on every change of cell
+	std::vector<Aabb> mBoxes{};
+	std::vector<u64> mKeys{};
+	std::vector<u32> mStamps{};
+	// Cells holding at least one object, only ever grown by the updates
+	std::array<std::atomic<i32>, 3> mOccupiedMin{};
+	std::array<std::atomic<i32>, 3> mOccupiedMax{};
+};
+
+}  // namespace vke
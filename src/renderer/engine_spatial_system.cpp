@@ -0,0 +1,163 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "engine_spatial_system.hpp"
+
+#include <chrono>
+
+namespace vke {
+
+VkEngineSpatialSystem::~VkEngineSpatialSystem() {
+	if (mRebuildThread.joinable()) {
+		mRebuildThread.join();
+	}
+}
+
+void VkEngineSpatialSystem::setIndexType(const SpatialIndexType type) {
+	if (type != mIndexType) {
+		mIndexType = type;
+		mBuilt = false;
+		mStats.costRatio = 1.f;
+	}
+}
+
+void VkEngineSpatialSystem::queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const {
+	if (mIndexType == SpatialIndexType::Grid) {
+		mGrid.queryFrustum(planes, objects);
+	} else {
+		mBvh.queryFrustum(planes, objects);
+	}
+}
+
+u32 VkEngineSpatialSystem::raycast(const Ray& ray, float& distance) const {
+	return mIndexType == SpatialIndexType::Grid ? mGrid.raycast(ray, distance) : mBvh.raycast(ray, distance);
+}
+
+u32 VkEngineSpatialSystem::queryNearest(const glm::vec3& point, float& distance) const {
+	return mIndexType == SpatialIndexType::Grid ? mGrid.queryNearest(point, distance)
+	                                            : mBvh.queryNearest(point, distance);
+}
+
+void VkEngineSpatialSystem::queryRadius(const glm::vec3& center, const float radius, std::vector<u32>& objects) const {
+	if (mIndexType == SpatialIndexType::Grid) {
+		mGrid.queryRadius(center, radius, objects);
+	} else {
+		mBvh.queryRadius(center, radius, objects);
+	}
+}
+
+void VkEngineSpatialSystem::update(const VkEngineWorld& world) {
+	const auto start = std::chrono::high_resolution_clock::now();
+	const bool structureChanged = !mBuilt || mStructureVersion != world.getStructureVersion();
+	const bool grid = mIndexType == SpatialIndexType::Grid;
+
+	// A rebuild started before a structural change numbers the objects the old way and is dropped
+	bool rebuilt = false;
+	if (mRebuilding && mRebuildDone.load(std::memory_order::acquire)) {
+		mRebuildThread.join();
+		mRebuilding = false;
+		if (!structureChanged && mRebuildVersion == mStructureVersion) {
+			std::swap(mBvh, mRebuildBvh);
+			mBuildCost = mRebuildCost;
+			rebuilt = true;
+			++mStats.rebuilds;
+		}
+	}
+
+	world.collectChunks<WorldMatrixComponent, RenderComponent>(mChunks);
+	mChunkOffsets.resize(mChunks.size());
+	u32 objectCount = 0;
+	for (size_t c = 0; c < mChunks.size(); ++c) {
+		mChunkOffsets[c] = objectCount;
+		objectCount += mChunks[c].count;
+	}
+	mObjectEntities.resize(objectCount);
+	mBoxes.resize(objectCount);
+	mMoved.resize(objectCount);
+	if (grid) {
+		if (structureChanged) {
+			mGrid.reset(objectCount);
+		}
+		mGrid.beginUpdate();
+	}
+
+	mThreadPool.parallelFor(static_cast<u32>(mChunks.size()), CHUNKS_PER_TASK,
+	                        [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+		                        for (u32 c = begin; c < end; ++c) {
+			                        const EcsChunk& chunk = mChunks[c];
+			                        const Entity* entities = chunk.getEntities();
+			                        const auto* matrices = chunk.getColumn<WorldMatrixComponent>();
+			                        const auto* renders = chunk.getColumn<RenderComponent>();
+			                        for (u32 row = 0; row < chunk.count; ++row) {
+				                        const u32 i = mChunkOffsets[c] + row;
+				                        // An object whose mesh was released shrinks to a point at its origin, the
+				                        // renderer skips drawing it
+				                        const VkEngineModel* model = mResources.get(renders[row].mesh);
+				                        const Aabb bounds = model != nullptr ? Aabb{.min = model->getBoundsMin(),
+				                                                                    .max = model->getBoundsMax()}
+				                                                             : Aabb{.min = glm::vec3{0.f},
+				                                                                    .max = glm::vec3{0.f}};
+				                        const Aabb box = Aabb::transform(bounds, matrices[row].matrix);
+				                        mMoved[i] = box != mBoxes[i] ? 1 : 0;
+				                        mBoxes[i] = box;
+				                        mObjectEntities[i] = entities[row];
+				                        // Lock free, the grid takes the objects straight from the workers
+				                        if (grid && (structureChanged || mMoved[i] != 0)) {
+					                        mGrid.update(i, box);
+				                        }
+			                        }
+		                        }
+	                        });
+
+	mMovedObjects.clear();
+	for (u32 i = 0; i < objectCount; ++i) {
+		if (mMoved[i] != 0) {
+			mMovedObjects.push_back(i);
+		}
+	}
+
+	if (grid) {
+		if (structureChanged) {
+			mBuilt = true;
+			mStructureVersion = world.getStructureVersion();
+			++mStats.builds;
+		}
+	} else if (structureChanged) {
+		mBvh.build(mBoxes);
+		mBuildCost = mBvh.computeCost();
+		mBuilt = true;
+		mStructureVersion = world.getStructureVersion();
+		++mStats.builds;
+	} else {
+		// The objects may have moved since the boxes of the rebuild were copied
+		if (rebuilt) {
+			mBvh.refit(mBoxes);
+		} else if (!mMovedObjects.empty()) {
+			mBvh.refit(mBoxes, mMovedObjects);
+		}
+	}
+
+	if (!grid && (structureChanged || rebuilt || !mMovedObjects.empty())) {
+		mStats.costRatio = mBuildCost > 0.f ? mBvh.computeCost() / mBuildCost : 1.f;
+	}
+
+	if (!grid && !mRebuilding && mStats.costRatio > REBUILD_COST_RATIO) {
+		mRebuildBoxes = mBoxes;
+		mRebuildVersion = mStructureVersion;
+		mRebuilding = true;
+		mRebuildDone.store(false, std::memory_order::relaxed);
+		mRebuildThread = std::thread([this]() {
+			mRebuildBvh.build(mRebuildBoxes);
+			mRebuildCost = mRebuildBvh.computeCost();
+			mRebuildDone.store(true, std::memory_order::release);
+		});
+	}
+
+	mStats.objects = objectCount;
+	mStats.movedObjects = static_cast<u32>(mMovedObjects.size());
+	mStats.updateMs =
+	    std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+}  // namespace vke
@@ -0,0 +1,118 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "core/engine_ecs.hpp"
+#include "core/engine_resources.hpp"
+#include "engine_bvh.hpp"
+#include "engine_spatial.hpp"
+#include "engine_spatial_grid.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+namespace vke {
+
+enum class SpatialIndexType : u8 {
+	// Cheapest queries, but refits loosen it and it has to be rebuilt once too many objects moved far
+	Bvh,
+	// Constant cost per moved object, for scenes where most objects move every frame
+	Grid,
+};
+
+struct SpatialStats {
+	u32 objects = 0;
+	u32 movedObjects = 0;
+	// Synchronous builds after a structural change, and background rebuilds swapped in
+	u32 builds = 0;
+	u32 rebuilds = 0;
+	// Cost of the tree against its cost when built, the refits only ever raise it
+	float costRatio = 1.f;
+	float updateMs = 0.f;
+};
+
+// Keeps a spatial index over the world boxes of the entities with a WorldMatrixComponent and a RenderComponent. The
+// objects are numbered chunk after chunk like the render system numbers them, so both agree on an index as long as
+// the structure of the world stays the same.
+//
+// With a BVH the moved objects are refitted in place, and once the refits have loosened the tree past
+// REBUILD_COST_RATIO a fresh one is built on a thread of its own from a copy of the boxes and swapped in by a later
+// update. The build takes several frames worth of work in one piece, so it stays off the pool: a worker or a waiting
+// thread picking it up would stall the frame until it finishes. With a grid the moved objects are placed again by the
+// jobs computing their boxes.
+class VkEngineSpatialSystem : NO_COPY_NOR_MOVE {
+   public:
+	// ECS chunks whose boxes a single worker computes at once
+	static constexpr u32 CHUNKS_PER_TASK = 16;
+	static constexpr float REBUILD_COST_RATIO = 1.3f;
+	static constexpr u32 NO_OBJECT = VkEngineBvh::NO_OBJECT;
+	static_assert(NO_OBJECT == VkEngineSpatialGrid::NO_OBJECT);
+
+	VkEngineSpatialSystem(ThreadPool& threadPool, const VkEngineResourceRegistry& resources)
+	    : mThreadPool(threadPool), mResources(resources) {}
+
+	// Waits for the background rebuild, its thread points into the system
+	~VkEngineSpatialSystem();
+
+	// Builds the index again after a structural change of the world, moves the moved objects in it otherwise. Must not
+	// run concurrently with the queries.
+	void update(const VkEngineWorld& world);
+
+	// Whether the object indices are those of `world`, no entity was created, destroyed or changed archetype since
+	// the last update
+	[[nodiscard]] bool isCurrent(const VkEngineWorld& world) const {
+		return mBuilt && mStructureVersion == world.getStructureVersion();
+	}
+
+	// The index is built again by the next update
+	void setIndexType(SpatialIndexType type);
+	[[nodiscard]] SpatialIndexType getIndexType() const { return mIndexType; }
+
+	// Queries of the index in use, see VkEngineBvh
+	void queryFrustum(const FrustumPlanesSoA& planes, std::vector<u32>& objects) const;
+	u32 raycast(const Ray& ray, float& distance) const;
+	u32 queryNearest(const glm::vec3& point, float& distance) const;
+	void queryRadius(const glm::vec3& center, float radius, std::vector<u32>& objects) const;
+
+	[[nodiscard]] const VkEngineBvh& getBvh() const { return mBvh; }
+	[[nodiscard]] const VkEngineSpatialGrid& getGrid() const { return mGrid; }
+	[[nodiscard]] Entity getEntity(const u32 object) const { return mObjectEntities[object]; }
+	[[nodiscard]] const std::vector<Aabb>& getBoxes() const { return mBoxes; }
+	[[nodiscard]] const SpatialStats& getStats() const { return mStats; }
+
+   private:
+	ThreadPool& mThreadPool;
+	const VkEngineResourceRegistry& mResources;
+	SpatialIndexType mIndexType = SpatialIndexType::Bvh;
+	VkEngineBvh mBvh{};
+	VkEngineSpatialGrid mGrid{};
+	float mBuildCost = 0.f;
+	bool mBuilt = false;
+	u64 mStructureVersion = 0;
+
+	std::vector<EcsChunk> mChunks{};
+	std::vector<u32> mChunkOffsets{};
+	std::vector<Entity> mObjectEntities{};
+	std::vector<Aabb> mBoxes{};
+	// Whether the box of the object changed in the last update
+	std::vector<u8> mMoved{};
+	std::vector<u32> mMovedObjects{};
+
+	// Only touched by the rebuild thread until mRebuildDone is set
+	VkEngineBvh mRebuildBvh{};
+	std::vector<Aabb> mRebuildBoxes{};
+	float mRebuildCost = 0.f;
+	u64 mRebuildVersion = 0;
+	std::thread mRebuildThread{};
+	std::atomic<bool> mRebuildDone{false};
+	bool mRebuilding = false;
+
+	SpatialStats mStats{};
+};
+
+}  // namespace vke
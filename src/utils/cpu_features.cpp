@@ -0,0 +1,47 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "cpu_features.hpp"
+
+#if defined(VKE_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace vke {
+
+bool hasAvx2() {
+	static const bool supported = [] {
+#if defined(VKE_X86) && (defined(__GNUC__) || defined(__clang__))
+		// Also checks that the OS saves the ymm registers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(VKE_X86) && defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuid(info, 1);
+		constexpr int fma = 1 << 12;
+		constexpr int osxsave = 1 << 27;
+		constexpr int avx = 1 << 28;
+		if ((info[2] & (fma | osxsave | avx)) != (fma | osxsave | avx)) {
+			return false;
+		}
+		// xmm and ymm state enabled by the OS
+		if ((_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		constexpr int avx2 = 1 << 5;
+		return (info[1] & avx2) != 0;
+#else
+		return false;
+#endif
+	}();
+	return supported;
+}
+
+}  // namespace vke
@@ -0,0 +1,26 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+// x86-64 builds compile the AVX2 variants of the SIMD kernels next to the SSE2 ones, which every x86-64 CPU has, and
+// pick one at runtime, so the binary still runs on CPUs without AVX2
+#if defined(__x86_64__) || defined(_M_X64)
+#define VKE_X86 1
+#endif
+
+// Lets a single function use AVX2 and FMA without the rest of the translation unit being compiled for them. MSVC
+// accepts the intrinsics anywhere and needs no attribute.
+#if defined(VKE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define VKE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define VKE_TARGET_AVX2
+#endif
+
+namespace vke {
+
+// True when both the CPU and the OS support AVX2 and FMA, checked once
+[[nodiscard]] bool hasAvx2();
+
+}  // namespace vke
@@ -0,0 +1,347 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include "thread_pool.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+// Set by the worker threads, any other thread is worker 0
+thread_local const ThreadPool* tCurrentPool = nullptr;
+thread_local u32 tWorkerIndex = 0;
+
+// Rounds of failed steals before an idle worker goes to sleep
+constexpr u32 IDLE_SPINS = 64;
+
+// Ring slots tried before a job is allocated on the heap
+constexpr u32 JOB_SLOT_PROBES = 8;
+
+// Chunks [firstChunk, lastChunk) of a parallelFor
+struct RangeJobData {
+	ThreadPool* pool = nullptr;
+	const ThreadPool::RangeFunc* fn = nullptr;
+	u32 count = 0;
+	u32 grain = 0;
+	u32 firstChunk = 0;
+	u32 lastChunk = 0;
+};
+static_assert(sizeof(RangeJobData) <= Job::DATA_SIZE);
+
+RangeJobData& getRange(Job& job) { return *std::launder(reinterpret_cast<RangeJobData*>(job.data.data())); }
+
+void pinToCore(std::thread& thread, const u32 core) {
+#if defined(_WIN32)
+	SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1} << core);
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+	(void)thread;
+	(void)core;
+#endif
+}
+}  // namespace
+
+
+bool JobDeque::push(Job* job) {
+	const i64 bottom = mBottom.load(std::memory_order::relaxed);
+	const i64 top = mTop.load(std::memory_order::acquire);
+	if (bottom - top >= CAPACITY) {
+		return false;
+	}
+
+	mJobs[bottom & (CAPACITY - 1)].store(job, std::memory_order::relaxed);
+	mBottom.store(bottom + 1, std::memory_order::release);
+	return true;
+}
+
+Job* JobDeque::pop() {
+	const i64 bottom = mBottom.load(std::memory_order::relaxed) - 1;
+	mBottom.store(bottom, std::memory_order::relaxed);
+	std::atomic_thread_fence(std::memory_order::seq_cst);
+	i64 top = mTop.load(std::memory_order::relaxed);
+
+	if (top > bottom) {
+		mBottom.store(bottom + 1, std::memory_order::relaxed);
+		return nullptr;
+	}
+
+	Job* job = mJobs[bottom & (CAPACITY - 1)].load(std::memory_order::relaxed);
+	if (top == bottom) {
+		// Last job, races with the thieves for it
+		if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order::seq_cst, std::memory_order::relaxed)) {
+			job = nullptr;
+		}
+		mBottom.store(bottom + 1, std::memory_order::relaxed);
+	}
+	return job;
+}
+
+Job* JobDeque::steal() {
+	i64 top = mTop.load(std::memory_order::acquire);
+	std::atomic_thread_fence(std::memory_order::seq_cst);
+	const i64 bottom = mBottom.load(std::memory_order::acquire);
+	if (top >= bottom) {
+		return nullptr;
+	}
+
+	Job* job = mJobs[top & (CAPACITY - 1)].load(std::memory_order::relaxed);
+	if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order::seq_cst, std::memory_order::relaxed)) {
+		return nullptr;
+	}
+	return job;
+}
+
+bool JobDeque::isEmpty() const {
+	return mBottom.load(std::memory_order::relaxed) <= mTop.load(std::memory_order::relaxed);
+}
+
+
+ThreadPool::ThreadPool(const u32 workerCount, const bool pinThreads) {
+	mWorkers.reserve(workerCount + 1);
+	for (u32 i = 0; i <= workerCount; ++i) {
+		mWorkers.push_back(std::make_unique<Worker>());
+		mWorkers.back()->random = 0x9e3779b9u * (i + 1);
+	}
+
+	mThreads.reserve(workerCount);
+	for (u32 i = 0; i < workerCount; ++i) {
+		mThreads.emplace_back([this, i]() { workerLoop(i + 1); });
+		if (pinThreads) {
+			pinToCore(mThreads.back(), (i + 1) % std::max(std::thread::hardware_concurrency(), 1u));
+		}
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	mStopping.store(true);
+	{
+		std::lock_guard lock(mSleepMutex);
+	}
+	mWakeCondition.notify_all();
+	for (auto& thread : mThreads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::parallelFor(const u32 count, const u32 grain, const RangeFunc& fn) {
+	if (count == 0) {
+		return;
+	}
+
+	const u32 chunkSize = std::max(grain, 1u);
+	const u32 chunkCount = (count + chunkSize - 1) / chunkSize;
+	const u32 workerIndex = getCurrentWorker();
+
+	if (chunkCount == 1 || mThreads.empty()) {
+		for (u32 begin = 0; begin < count; begin += chunkSize) {
+			fn(begin, std::min(begin + chunkSize, count), workerIndex);
+		}
+		return;
+	}
+
+	// The whole range starts on this thread, the other threads get their share by stealing the halves it splits off
+	JobCounter counter;
+	Job root{.counter = &counter};
+	new (root.data.data()) RangeJobData{
+	    .pool = this, .fn = &fn, .count = count, .grain = chunkSize, .firstChunk = 0, .lastChunk = chunkCount};
+	root.function = &ThreadPool::runRange;
+	counter.mPending.store(1, std::memory_order::relaxed);
+
+	execute(root, workerIndex);
+	wait(counter);
+}
+
+void ThreadPool::wait(JobCounter& counter) {
+	const u32 workerIndex = getCurrentWorker();
+	while (!counter.isDone()) {
+		if (Job* job = findJob(workerIndex)) {
+			execute(*job, workerIndex);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	// The job that finished the group may still be inside the counter, it must leave before the counter can go
+	std::lock_guard lock(counter.mMutex);
+}
+
+bool ThreadPool::tryRunJob() {
+	const u32 workerIndex = getCurrentWorker();
+	if (Job* job = findJob(workerIndex)) {
+		execute(*job, workerIndex);
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::runRange(Job& job, const u32 workerIndex) {
+	RangeJobData& range = getRange(job);
+	ThreadPool& pool = *range.pool;
+
+	while (range.firstChunk < range.lastChunk) {
+		// Offers the upper half of what is left whenever nothing else is queued here for the thieves to take
+		if (range.lastChunk - range.firstChunk > 1 && pool.mWorkers[workerIndex]->deque.isEmpty()) {
+			const u32 middle = range.firstChunk + (range.lastChunk - range.firstChunk) / 2;
+			Job& upper = pool.allocateJob(workerIndex);
+			new (upper.data.data()) RangeJobData{range};
+			getRange(upper).firstChunk = middle;
+			upper.function = &ThreadPool::runRange;
+			range.lastChunk = middle;
+			pool.schedule(upper, *job.counter, nullptr, workerIndex);
+			continue;
+		}
+
+		const u32 begin = range.firstChunk * range.grain;
+		(*range.fn)(begin, std::min(begin + range.grain, range.count), workerIndex);
+		++range.firstChunk;
+	}
+}
+
+u32 ThreadPool::getCurrentWorker() const { return tCurrentPool == this ? tWorkerIndex : 0; }
+
+Job& ThreadPool::allocateJob(const u32 workerIndex) {
+	Worker& worker = *mWorkers[workerIndex];
+	// Skips the slots of jobs still queued, parked on a dependency or running
+	for (u32 probe = 0; probe < JOB_SLOT_PROBES; ++probe) {
+		Job& job = worker.jobs[worker.nextJob++ % JOB_RING_SIZE];
+		if (!job.inUse.load(std::memory_order::acquire)) {
+			job.inUse.store(true, std::memory_order::relaxed);
+			job.counter = nullptr;
+			return job;
+		}
+	}
+
+	Job* job = new Job{.heapAllocated = true};
+	job->inUse.store(true, std::memory_order::relaxed);
+	return *job;
+}
+
+void ThreadPool::schedule(Job& job, JobCounter& counter, JobCounter* dependency, const u32 workerIndex) {
+	job.counter = &counter;
+	counter.mPending.fetch_add(1, std::memory_order::relaxed);
+
+	if (dependency != nullptr) {
+		std::lock_guard lock(dependency->mMutex);
+		if (!dependency->isDone()) {
+			dependency->mContinuations.push_back(&job);
+			return;
+		}
+	}
+	push(job, workerIndex);
+}
+
+void ThreadPool::push(Job& job, const u32 workerIndex) {
+	// Counted before it can be stolen, a thief taking it off first would wrap the count around and keep the sleeping
+	// workers spinning
+	mQueuedJobs.fetch_add(1);
+	if (!mWorkers[workerIndex]->deque.push(&job)) {
+		// Deque full, the pushing thread runs the job itself
+		mQueuedJobs.fetch_sub(1, std::memory_order::relaxed);
+		execute(job, workerIndex);
+		return;
+	}
+
+	// Pairs with a worker counting itself as sleeping before it checks mQueuedJobs: either it sees the job or it is
+	// counted here, and taking the mutex makes sure it is waiting before being notified
+	if (mSleepingWorkers.load() > 0) {
+		{
+			std::lock_guard lock(mSleepMutex);
+		}
+		mWakeCondition.notify_one();
+	}
+}
+
+Job* ThreadPool::findJob(const u32 workerIndex) {
+	Worker& worker = *mWorkers[workerIndex];
+	if (Job* job = worker.deque.pop()) {
+		mQueuedJobs.fetch_sub(1, std::memory_order::relaxed);
+		return job;
+	}
+
+	worker.random ^= worker.random << 13;
+	worker.random ^= worker.random >> 17;
+	worker.random ^= worker.random << 5;
+	const auto workerCount = static_cast<u32>(mWorkers.size());
+	for (u32 i = 0; i < workerCount; ++i) {
+		const u32 victim = (worker.random + i) % workerCount;
+		if (victim == workerIndex) {
+			continue;
+		}
+		if (Job* job = mWorkers[victim]->deque.steal()) {
+			mQueuedJobs.fetch_sub(1, std::memory_order::relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void ThreadPool::execute(Job& job, const u32 workerIndex) {
+	job.function(job, workerIndex);
+
+	JobCounter& counter = *job.counter;
+	std::vector<Job*> continuations;
+	// Lock free unless this job is the last of the group: the count only reaches zero under the mutex, so that the
+	// continuations are taken in one go and wait() cannot return while this job is still inside the counter
+	u32 pending = counter.mPending.load(std::memory_order::relaxed);
+	while (true) {
+		if (pending == 1) {
+			std::lock_guard lock(counter.mMutex);
+			if (counter.mPending.compare_exchange_strong(pending, 0, std::memory_order::acq_rel,
+			                                             std::memory_order::relaxed)) {
+				continuations.swap(counter.mContinuations);
+				break;
+			}
+		} else if (counter.mPending.compare_exchange_weak(pending, pending - 1, std::memory_order::acq_rel,
+		                                                  std::memory_order::relaxed)) {
+			break;
+		}
+	}
+	for (Job* continuation : continuations) {
+		push(*continuation, workerIndex);
+	}
+
+	if (job.heapAllocated) {
+		delete &job;
+	} else {
+		job.inUse.store(false, std::memory_order::release);
+	}
+}
+
+void ThreadPool::workerLoop(const u32 workerIndex) {
+	tCurrentPool = this;
+	tWorkerIndex = workerIndex;
+
+	u32 idleSpins = 0;
+	while (!mStopping.load(std::memory_order::relaxed)) {
+		if (Job* job = findJob(workerIndex)) {
+			execute(*job, workerIndex);
+			idleSpins = 0;
+			continue;
+		}
+		if (++idleSpins < IDLE_SPINS) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		idleSpins = 0;
+		std::unique_lock lock(mSleepMutex);
+		mSleepingWorkers.fetch_add(1);
+		mWakeCondition.wait(lock, [this]() { return mStopping.load() || mQueuedJobs.load() > 0; });
+		mSleepingWorkers.fetch_sub(1);
+	}
+}
@@ -0,0 +1,159 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "types.hpp"
+
+class JobCounter;
+
+// Unit of work of the pool, a function with its arguments stored inline so that scheduling does not allocate
+struct Job {
+	static constexpr size_t DATA_SIZE = 48;
+
+	void (*function)(Job& job, u32 workerIndex) = nullptr;
+	JobCounter* counter = nullptr;
+	// Set from allocation until the job has run, a ring slot still queued, parked or running is not handed out again
+	std::atomic<bool> inUse{false};
+	// Taken from the heap because the ring was full of live jobs, freed once it has run
+	bool heapAllocated = false;
+	alignas(16) std::array<std::byte, DATA_SIZE> data{};
+};
+
+// Jobs of a group still to finish, waited on with ThreadPool::wait. The jobs depending on the group are parked here
+// and scheduled once the count drops to zero.
+class JobCounter : NO_COPY_NOR_MOVE {
+   public:
+	[[nodiscard]] bool isDone() const { return mPending.load(std::memory_order::acquire) == 0; }
+
+   private:
+	friend class ThreadPool;
+
+	std::atomic<u32> mPending{0};
+	// Held by the job finishing the group while it takes the continuations, and by the threads parking jobs on it
+	std::mutex mMutex{};
+	std::vector<Job*> mContinuations{};
+};
+
+// Chase-Lev deque. The owner pushes and pops at the bottom, the other threads steal from the top: the oldest jobs,
+// which for a split range are the largest halves.
+class JobDeque : NO_COPY_NOR_MOVE {
+   public:
+	static constexpr i64 CAPACITY = 4096;
+
+	// Owner only, false when full
+	bool push(Job* job);
+	// Owner only
+	Job* pop();
+	Job* steal();
+	// Owner only, a thief may have emptied it since
+	[[nodiscard]] bool isEmpty() const;
+
+   private:
+	alignas(64) std::atomic<i64> mTop{0};
+	alignas(64) std::atomic<i64> mBottom{0};
+	std::array<std::atomic<Job*>, CAPACITY> mJobs{};
+};
+
+// Work stealing scheduler. Every thread owns a deque of jobs and steals from the others once its own runs dry, idle
+// workers sleep until a job is queued. The thread creating the pool takes part as worker 0 whenever it waits, so a
+// pool of N workers runs on N + 1 threads. Only that thread and the jobs themselves may schedule and wait.
+class ThreadPool : NO_COPY_NOR_MOVE {
+   public:
+	// fn(begin, end, workerIndex), workerIndex is in [0, getThreadCount())
+	using RangeFunc = std::function<void(u32, u32, u32)>;
+
+	// Jobs a thread keeps storage for, the slots are recycled once their job has run and the jobs allocated while the
+	// ring is full of live ones go to the heap
+	static constexpr u32 JOB_RING_SIZE = 4096;
+
+	// With `pinThreads`, worker i only runs on core i, core 0 is left to the thread creating the pool
+	explicit ThreadPool(u32 workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1,
+	                    bool pinThreads = false);
+
+	~ThreadPool();
+
+	[[nodiscard]] u32 getThreadCount() const { return static_cast<u32>(mWorkers.size()); }
+
+	// Splits [0, count) into chunks of `grain` items, each handed to fn on its own, and blocks until every chunk has
+	// been processed. The chunks are dealt out adaptively: a range is only halved when the deque of the thread running
+	// it is empty, so the idle threads steal large halves and a busy pool pays for few splits. A worker runs a single
+	// chunk at a time, so per worker scratch is safe as long as fn does not itself wait on the pool.
+	void parallelFor(u32 count, u32 grain, const RangeFunc& fn);
+
+	// Schedules fn() or fn(workerIndex) as a job of `counter`, only once `dependency` is done when given. The closure
+	// is stored inline in the job, capture by reference or capture a pointer to larger state.
+	template <typename Fn>
+	void run(Fn&& fn, JobCounter& counter, JobCounter* dependency = nullptr);
+
+	// Runs queued jobs until `counter` is done
+	void wait(JobCounter& counter);
+
+	// Runs one queued job if there is any, for a thread waiting on something else than a counter
+	bool tryRunJob();
+
+   private:
+	struct Worker {
+		JobDeque deque{};
+		std::array<Job, JOB_RING_SIZE> jobs{};
+		u32 nextJob = 0;
+		// xorshift state picking the first victim to steal from
+		u32 random = 0;
+	};
+
+	static void runRange(Job& job, u32 workerIndex);
+
+	[[nodiscard]] u32 getCurrentWorker() const;
+	Job& allocateJob(u32 workerIndex);
+	// Counts the job in `counter` and queues it, or parks it on `dependency`
+	void schedule(Job& job, JobCounter& counter, JobCounter* dependency, u32 workerIndex);
+	void push(Job& job, u32 workerIndex);
+	Job* findJob(u32 workerIndex);
+	void execute(Job& job, u32 workerIndex);
+	void workerLoop(u32 workerIndex);
+
+	// Index 0 belongs to the thread that created the pool
+	std::vector<std::unique_ptr<Worker>> mWorkers{};
+	std::vector<std::thread> mThreads{};
+
+	// Jobs sitting in the deques, the sleeping workers wait for it to become non zero
+	std::atomic<u32> mQueuedJobs{0};
+	std::atomic<u32> mSleepingWorkers{0};
+	std::atomic<bool> mStopping{false};
+	std::mutex mSleepMutex{};
+	std::condition_variable mWakeCondition{};
+};
+
+template <typename Fn>
+void ThreadPool::run(Fn&& fn, JobCounter& counter, JobCounter* dependency) {
+	using Closure = std::decay_t<Fn>;
+	static_assert(sizeof(Closure) <= Job::DATA_SIZE && alignof(Closure) <= 16, "Closure too large for a job");
+
+	const u32 workerIndex = getCurrentWorker();
+	Job& job = allocateJob(workerIndex);
+	new (job.data.data()) Closure(std::forward<Fn>(fn));
+	job.function = [](Job& self, const u32 selfWorkerIndex) {
+		auto& closure = *std::launder(reinterpret_cast<Closure*>(self.data.data()));
+		if constexpr (std::is_invocable_v<Closure&, u32>) {
+			closure(selfWorkerIndex);
+		} else {
+			closure();
+		}
+		closure.~Closure();
+	};
+	schedule(job, counter, dependency, workerIndex);
+}
@@ -0,0 +1,182 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "renderer/engine_bvh.hpp"
+#include "renderer/engine_camera.hpp"
+
+namespace vke {
+namespace {
+constexpr float TOLERANCE = 1e-4f;
+constexpr u32 QUERY_COUNT = 200;
+
+// Boxes of 0.1 to 3 units scattered over a 100 unit cube, some overlapping
+std::vector<Aabb> makeBoxes(const u32 count, const u32 seed) {
+	std::mt19937 random{seed};
+	std::uniform_real_distribution position{-50.f, 50.f};
+	std::uniform_real_distribution size{.1f, 3.f};
+	std::vector<Aabb> boxes(count);
+	for (Aabb& box : boxes) {
+		box.min = {position(random), position(random), position(random)};
+		box.max = box.min + glm::vec3{size(random), size(random), size(random)};
+	}
+	return boxes;
+}
+
+glm::vec3 randomPoint(std::mt19937& random) {
+	std::uniform_real_distribution position{-60.f, 60.f};
+	return {position(random), position(random), position(random)};
+}
+
+FrustumPlanesSoA randomFrustum(std::mt19937& random) {
+	VkEngineCamera camera{};
+	camera.setViewTarget(randomPoint(random), randomPoint(random));
+	camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, 0.1f, 60.f);
+	return toPlanesSoA(camera.extractFrustumPlanes());
+}
+
+std::vector<u32> sorted(std::vector<u32> objects) {
+	std::ranges::sort(objects);
+	return objects;
+}
+
+// Brute force answers over every box, what the tree must agree with
+std::vector<u32> frustumReference(const std::vector<Aabb>& boxes, const FrustumPlanesSoA& planes) {
+	std::vector<u32> objects;
+	for (u32 i = 0; i < boxes.size(); ++i) {
+		if (testFrustum(planes, boxes[i]) != FrustumTest::Outside) {
+			objects.push_back(i);
+		}
+	}
+	return objects;
+}
+
+std::vector<u32> radiusReference(const std::vector<Aabb>& boxes, const glm::vec3& center, const float radius) {
+	std::vector<u32> objects;
+	for (u32 i = 0; i < boxes.size(); ++i) {
+		if (distanceSquared(boxes[i], center) <= radius * radius) {
+			objects.push_back(i);
+		}
+	}
+	return objects;
+}
+
+float raycastReference(const std::vector<Aabb>& boxes, const Ray& ray) {
+	float closest = ray.maxDistance;
+	for (const Aabb& box : boxes) {
+		float distance = 0.f;
+		if (intersectRay(box, ray.origin, 1.f / ray.direction, ray.maxDistance, distance)) {
+			closest = std::min(closest, distance);
+		}
+	}
+	return closest;
+}
+
+float nearestReference(const std::vector<Aabb>& boxes, const glm::vec3& point) {
+	float closest = std::numeric_limits<float>::max();
+	for (const Aabb& box : boxes) {
+		closest = std::min(closest, distanceSquared(box, point));
+	}
+	return std::sqrt(closest);
+}
+
+void expectMatchesBruteForce(const VkEngineBvh& bvh, const std::vector<Aabb>& boxes, const u32 seed) {
+	std::mt19937 random{seed};
+	std::vector<u32> objects;
+	for (u32 q = 0; q < QUERY_COUNT; ++q) {
+		const FrustumPlanesSoA planes = randomFrustum(random);
+		objects.clear();
+		bvh.queryFrustum(planes, objects);
+		ASSERT_EQ(sorted(objects), frustumReference(boxes, planes)) << "frustum " << q;
+
+		const glm::vec3 center = randomPoint(random);
+		const float radius = std::uniform_real_distribution{0.f, 15.f}(random);
+		objects.clear();
+		bvh.queryRadius(center, radius, objects);
+		ASSERT_EQ(sorted(objects), radiusReference(boxes, center, radius)) << "radius " << q;
+
+		// The object hit may be any of those entered at the same distance, the distance is what must match
+		const Ray ray{.origin = randomPoint(random),
+		              .direction = glm::normalize(randomPoint(random) - center + glm::vec3{0.f, 0.f, 1e-3f})};
+		float distance = 0.f;
+		const u32 hit = bvh.raycast(ray, distance);
+		const float expectedDistance = raycastReference(boxes, ray);
+		if (expectedDistance == ray.maxDistance) {
+			EXPECT_EQ(hit, VkEngineBvh::NO_OBJECT) << "ray " << q;
+		} else {
+			ASSERT_NE(hit, VkEngineBvh::NO_OBJECT) << "ray " << q;
+			EXPECT_NEAR(distance, expectedDistance, TOLERANCE) << "ray " << q;
+			float hitDistance = 0.f;
+			EXPECT_TRUE(intersectRay(boxes[hit], ray.origin, 1.f / ray.direction, ray.maxDistance, hitDistance));
+			EXPECT_NEAR(hitDistance, expectedDistance, TOLERANCE) << "ray " << q;
+		}
+
+		const glm::vec3 point = randomPoint(random);
+		const u32 nearest = bvh.queryNearest(point, distance);
+		ASSERT_NE(nearest, VkEngineBvh::NO_OBJECT);
+		EXPECT_NEAR(distance, nearestReference(boxes, point), TOLERANCE) << "nearest " << q;
+		EXPECT_NEAR(std::sqrt(distanceSquared(boxes[nearest], point)), distance, TOLERANCE) << "nearest " << q;
+	}
+}
+}  // namespace
+
+TEST(Bvh, EmptyTreeFindsNothing) {
+	VkEngineBvh bvh;
+	bvh.build({});
+	EXPECT_EQ(bvh.getObjectCount(), 0u);
+
+	std::vector<u32> objects;
+	bvh.queryRadius(glm::vec3{0.f}, 100.f, objects);
+	EXPECT_TRUE(objects.empty());
+	float distance = 0.f;
+	EXPECT_EQ(bvh.raycast(Ray{}, distance), VkEngineBvh::NO_OBJECT);
+	EXPECT_EQ(bvh.queryNearest(glm::vec3{0.f}, distance), VkEngineBvh::NO_OBJECT);
+}
+
+TEST(Bvh, QueriesMatchBruteForce) {
+	// Fewer objects than a leaf holds, then enough for a deep tree
+	for (const u32 count : {1u, 3u, 37u, 5000u}) {
+		const std::vector<Aabb> boxes = makeBoxes(count, count);
+		VkEngineBvh bvh;
+		bvh.build(boxes);
+		EXPECT_EQ(bvh.getObjectCount(), count);
+		expectMatchesBruteForce(bvh, boxes, count + 1);
+	}
+}
+
+TEST(Bvh, RefitKeepsQueriesExact) {
+	std::vector<Aabb> boxes = makeBoxes(5000, 11);
+	VkEngineBvh bvh;
+	bvh.build(boxes);
+	const float buildCost = bvh.computeCost();
+
+	// Few objects moved far walk up from their leaves, most of them moved sweep the whole tree
+	std::mt19937 random{12};
+	for (const u32 movedCount : {50u, 4000u}) {
+		std::vector<u32> moved;
+		for (u32 i = 0; i < movedCount; ++i) {
+			const u32 object = static_cast<u32>(random() % boxes.size());
+			const glm::vec3 offset = randomPoint(random) * 0.5f;
+			boxes[object] = {.min = boxes[object].min + offset, .max = boxes[object].max + offset};
+			moved.push_back(object);
+		}
+		std::ranges::sort(moved);
+		const auto [first, last] = std::ranges::unique(moved);
+		moved.erase(first, last);
+
+		bvh.refit(boxes, moved);
+		expectMatchesBruteForce(bvh, boxes, movedCount);
+	}
+	EXPECT_GE(bvh.computeCost(), buildCost);
+
+	bvh.refit(boxes);
+	expectMatchesBruteForce(bvh, boxes, 13);
+}
+
+}  // namespace vke
@@ -0,0 +1,327 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "core/engine_ecs.hpp"
+
+namespace vke {
+namespace {
+struct ValueComponent {
+	u32 value = 0;
+};
+
+struct TagComponent {
+	u32 value = 0;
+};
+
+// Not trivially copyable, the storage has to move and destroy it through its ComponentInfo
+struct OwningComponent {
+	std::shared_ptr<u32> value{};
+};
+
+// The value component of every living entity matches the one it was given, wherever the rows were moved to
+void expectValues(const VkEngineWorld& world, const std::vector<Entity>& entities,
+                  const std::vector<u32>& expected) {
+	for (size_t i = 0; i < entities.size(); ++i) {
+		const ValueComponent* component = world.getComponent<ValueComponent>(entities[i]);
+		ASSERT_NE(component, nullptr) << "entity " << i;
+		EXPECT_EQ(component->value, expected[i]) << "entity " << i;
+	}
+}
+}  // namespace
+
+TEST(Ecs, CreateAndGet) {
+	VkEngineWorld world;
+	const Entity entity = world.createEntity(ValueComponent{7});
+	EXPECT_TRUE(world.isAlive(entity));
+	EXPECT_EQ(world.getEntityCount(), 1u);
+	ASSERT_NE(world.getComponent<ValueComponent>(entity), nullptr);
+	EXPECT_EQ(world.getComponent<ValueComponent>(entity)->value, 7u);
+	EXPECT_EQ(world.getComponent<TagComponent>(entity), nullptr);
+}
+
+TEST(Ecs, AddAndRemoveMoveBetweenArchetypes) {
+	VkEngineWorld world;
+	std::vector<Entity> entities;
+	std::vector<u32> values;
+	for (u32 i = 0; i < 1000; ++i) {
+		entities.push_back(world.createEntity(ValueComponent{i}));
+		values.push_back(i);
+	}
+
+	// Every other entity leaves, the rows left behind are filled from the end of the archetype
+	for (u32 i = 0; i < 1000; i += 2) {
+		world.addComponent(entities[i], TagComponent{i * 3});
+	}
+	EXPECT_EQ(world.count<ValueComponent>(), 1000u);
+	EXPECT_EQ((world.count<ValueComponent, TagComponent>()), 500u);
+	expectValues(world, entities, values);
+	for (u32 i = 0; i < 1000; ++i) {
+		const TagComponent* tag = world.getComponent<TagComponent>(entities[i]);
+		if (i % 2 == 0) {
+			ASSERT_NE(tag, nullptr);
+			EXPECT_EQ(tag->value, i * 3);
+		} else {
+			EXPECT_EQ(tag, nullptr);
+		}
+	}
+
+	// Adding a component the entity already has replaces it in place
+	const u64 version = world.getStructureVersion();
+	world.addComponent(entities[0], TagComponent{99});
+	EXPECT_EQ(world.getComponent<TagComponent>(entities[0])->value, 99u);
+	EXPECT_EQ(world.getStructureVersion(), version);
+
+	for (u32 i = 0; i < 1000; i += 2) {
+		world.removeComponent<TagComponent>(entities[i]);
+	}
+	EXPECT_EQ(world.count<TagComponent>(), 0u);
+	expectValues(world, entities, values);
+	EXPECT_GT(world.getStructureVersion(), version);
+}
+
+TEST(Ecs, DestroyMovesTheLastRowIntoTheHole) {
+	VkEngineWorld world;
+	std::vector<Entity> entities;
+	std::vector<u32> values;
+	for (u32 i = 0; i < 100; ++i) {
+		entities.push_back(world.createEntity(ValueComponent{i}));
+		values.push_back(i);
+	}
+
+	world.destroyEntity(entities[10]);
+	EXPECT_FALSE(world.isAlive(entities[10]));
+	EXPECT_EQ(world.getComponent<ValueComponent>(entities[10]), nullptr);
+	entities.erase(entities.begin() + 10);
+	values.erase(values.begin() + 10);
+	EXPECT_EQ(world.getEntityCount(), 99u);
+	expectValues(world, entities, values);
+
+	// Destroying twice only warns
+	world.destroyEntity(Entity{.index = 0, .generation = 5});
+	EXPECT_EQ(world.getEntityCount(), 99u);
+}
+
+TEST(Ecs, BatchDestroyMatchesOneByOne) {
+	constexpr u32 ENTITY_COUNT = 5000;
+	std::mt19937 random{1};
+	VkEngineWorld batched;
+	VkEngineWorld single;
+	std::vector<Entity> batchedEntities;
+	std::vector<Entity> singleEntities;
+	batched.createEntities(ENTITY_COUNT, batchedEntities, ValueComponent{});
+	for (u32 i = 0; i < ENTITY_COUNT; ++i) {
+		*batched.getComponent<ValueComponent>(batchedEntities[i]) = ValueComponent{i};
+		singleEntities.push_back(single.createEntity(ValueComponent{i}));
+	}
+
+	std::vector<u32> order(ENTITY_COUNT);
+	std::iota(order.begin(), order.end(), 0u);
+	std::ranges::shuffle(order, random);
+	order.resize(ENTITY_COUNT / 3);
+
+	std::vector<Entity> doomed;
+	for (const u32 i : order) {
+		doomed.push_back(batchedEntities[i]);
+		single.destroyEntity(singleEntities[i]);
+	}
+	// A dead handle in the batch is skipped
+	doomed.push_back(doomed.front());
+	batched.destroyEntities(doomed);
+
+	EXPECT_EQ(batched.getEntityCount(), single.getEntityCount());
+	std::vector<bool> destroyed(ENTITY_COUNT);
+	for (const u32 i : order) {
+		destroyed[i] = true;
+	}
+	for (u32 i = 0; i < ENTITY_COUNT; ++i) {
+		EXPECT_EQ(batched.isAlive(batchedEntities[i]), !destroyed[i]);
+		if (!destroyed[i]) {
+			EXPECT_EQ(batched.getComponent<ValueComponent>(batchedEntities[i])->value, i);
+		}
+	}
+}
+
+TEST(Ecs, SlotsAreReusedWithTheNextGeneration) {
+	VkEngineWorld world;
+	const Entity first = world.createEntity(ValueComponent{1});
+	world.destroyEntity(first);
+
+	const Entity second = world.createEntity(ValueComponent{2});
+	EXPECT_EQ(second.index, first.index);
+	EXPECT_EQ(second.generation, first.generation + 1);
+	EXPECT_FALSE(world.isAlive(first));
+	EXPECT_EQ(world.getComponent<ValueComponent>(first), nullptr);
+	EXPECT_EQ(world.getComponent<ValueComponent>(second)->value, 2u);
+
+	world.clear();
+	EXPECT_FALSE(world.isAlive(second));
+	EXPECT_EQ(world.getEntityCount(), 0u);
+	const Entity third = world.createEntity(ValueComponent{3});
+	EXPECT_EQ(third.index, first.index);
+	EXPECT_EQ(third.generation, second.generation + 1);
+}
+
+TEST(Ecs, NonTrivialComponentsAreMovedAndDestroyed) {
+	const auto value = std::make_shared<u32>(5);
+	{
+		VkEngineWorld world;
+		std::vector<Entity> entities;
+		for (u32 i = 0; i < 10; ++i) {
+			entities.push_back(world.createEntity(OwningComponent{value}));
+		}
+		EXPECT_EQ(value.use_count(), 11);
+
+		world.addComponent(entities[3], TagComponent{});
+		EXPECT_EQ(value.use_count(), 11);
+		EXPECT_EQ(*world.getComponent<OwningComponent>(entities[3])->value, 5u);
+
+		world.destroyEntity(entities[0]);
+		world.removeComponent<OwningComponent>(entities[3]);
+		EXPECT_EQ(value.use_count(), 9);
+
+		world.clear();
+		EXPECT_EQ(value.use_count(), 1);
+		world.createEntity(OwningComponent{value});
+	}
+	// The archetypes destroy the rows they still hold
+	EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(Ecs, ChunkQueriesVisitEveryEntityOnce) {
+	VkEngineWorld world;
+	std::vector<Entity> entities;
+	world.createEntities(3000, entities, ValueComponent{});
+	world.createEntities(2000, entities, ValueComponent{}, TagComponent{});
+	world.createEntities(100, entities, TagComponent{});
+
+	std::vector<u32> visits(entities.size());
+	std::vector<EcsChunk> chunks;
+	world.collectChunks<ValueComponent>(chunks);
+	u32 total = 0;
+	for (const EcsChunk& chunk : chunks) {
+		EXPECT_LE(chunk.count, chunk.archetype->getChunkCapacity());
+		for (u32 row = 0; row < chunk.count; ++row) {
+			++visits[chunk.getEntities()[row].index];
+		}
+		total += chunk.count;
+	}
+	EXPECT_EQ(total, 5000u);
+	for (u32 i = 0; i < entities.size(); ++i) {
+		EXPECT_EQ(visits[entities[i].index], i < 5000 ? 1u : 0u);
+	}
+
+	u32 both = 0;
+	world.forEach<ValueComponent, TagComponent>([&](Entity, ValueComponent&, TagComponent&) { ++both; });
+	EXPECT_EQ(both, 2000u);
+}
+
+TEST(Ecs, BatchedSpawnFillsTheFreedSlotsAndChunks) {
+	VkEngineWorld world;
+	std::vector<Entity> entities;
+	world.createEntities(3000, entities, TransformComponent{}, WorldMatrixComponent{}, RenderComponent{});
+	std::vector<EcsChunk> chunks;
+	world.collectChunks<RenderComponent>(chunks);
+	const size_t chunkCount = chunks.size();
+	const std::byte* firstChunk = chunks.front().data;
+
+	std::vector<Entity> freed(entities.begin() + 1000, entities.begin() + 2000);
+	world.destroyEntities(freed);
+	EXPECT_EQ(world.getEntityCount(), 2000u);
+
+	// The batch takes the freed slots with their next generation before growing, and the chunks emptied by the despawn
+	std::vector<Entity> respawned;
+	world.createEntities(1500, respawned, TransformComponent{}, WorldMatrixComponent{},
+	                     RenderComponent{.materialIndex = 3});
+	EXPECT_EQ(respawned.size(), 1500u);
+	std::vector<u32> freedIndices;
+	for (const Entity entity : freed) {
+		freedIndices.push_back(entity.index);
+	}
+	std::ranges::sort(freedIndices);
+	u32 reused = 0;
+	for (const Entity entity : respawned) {
+		EXPECT_TRUE(world.isAlive(entity));
+		EXPECT_EQ(world.getComponent<RenderComponent>(entity)->materialIndex, 3u);
+		if (std::ranges::binary_search(freedIndices, entity.index)) {
+			EXPECT_EQ(entity.generation, 1u);
+			++reused;
+		}
+	}
+	EXPECT_EQ(reused, 1000u);
+	for (const Entity entity : freed) {
+		EXPECT_FALSE(world.isAlive(entity));
+	}
+
+	// Only the 500 entities past the first population need new chunks
+	world.collectChunks<RenderComponent>(chunks);
+	const u32 capacity = chunks.front().archetype->getChunkCapacity();
+	EXPECT_EQ(world.count<RenderComponent>(), 3500u);
+	EXPECT_EQ(chunks.front().data, firstChunk);
+	EXPECT_LE(chunks.size(), chunkCount + (500 + capacity - 1) / capacity);
+}
+
+TEST(Ecs, BatchDestroySpansArchetypes) {
+	VkEngineWorld world;
+	std::vector<Entity> plain;
+	std::vector<Entity> tagged;
+	world.createEntities(700, plain, ValueComponent{});
+	world.createEntities(700, tagged, ValueComponent{}, TagComponent{});
+	for (u32 i = 0; i < 700; ++i) {
+		world.getComponent<ValueComponent>(plain[i])->value = i;
+		world.getComponent<ValueComponent>(tagged[i])->value = 1000 + i;
+	}
+
+	// Every third entity of both archetypes in one interleaved batch
+	std::vector<Entity> doomed;
+	for (u32 i = 0; i < 700; i += 3) {
+		doomed.push_back(tagged[i]);
+		doomed.push_back(plain[i]);
+	}
+	world.destroyEntities(doomed);
+
+	EXPECT_EQ(world.getEntityCount(), 1400u - static_cast<u32>(doomed.size()));
+	EXPECT_EQ((world.count<ValueComponent, TagComponent>()), 700u - static_cast<u32>(doomed.size()) / 2);
+	for (u32 i = 0; i < 700; ++i) {
+		EXPECT_EQ(world.isAlive(plain[i]), i % 3 != 0);
+		EXPECT_EQ(world.isAlive(tagged[i]), i % 3 != 0);
+		if (i % 3 != 0) {
+			EXPECT_EQ(world.getComponent<ValueComponent>(plain[i])->value, i);
+			EXPECT_EQ(world.getComponent<ValueComponent>(tagged[i])->value, 1000 + i);
+		}
+	}
+}
+
+TEST(Ecs, RepeatedChurnKeepsTheSurvivors) {
+	VkEngineWorld world;
+	std::mt19937 random{5};
+	std::vector<Entity> survivors;
+	world.createEntities(100, survivors, ValueComponent{});
+	for (u32 i = 0; i < 100; ++i) {
+		world.getComponent<ValueComponent>(survivors[i])->value = i;
+	}
+
+	std::vector<Entity> transient;
+	for (u32 frame = 0; frame < 50; ++frame) {
+		world.createEntities(1 + static_cast<u32>(random() % 2000), transient, ValueComponent{.value = ~0u});
+		std::ranges::shuffle(transient, random);
+		world.destroyEntities(transient);
+		transient.clear();
+	}
+
+	EXPECT_EQ(world.getEntityCount(), 100u);
+	for (u32 i = 0; i < 100; ++i) {
+		ASSERT_TRUE(world.isAlive(survivors[i]));
+		EXPECT_EQ(world.getComponent<ValueComponent>(survivors[i])->value, i);
+	}
+}
+
+}  // namespace vke
@@ -0,0 +1,149 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_frustum_culling.hpp"
+#include "renderer/engine_spatial.hpp"
+
+namespace vke {
+namespace {
+constexpr std::array KERNELS{CullingKernel::Scalar, CullingKernel::Sse2, CullingKernel::Avx2};
+// Spheres closer than this to a plane of the frustum are left out of the random scenes, so that the kernels summing
+// the plane terms in another order can not disagree on them
+constexpr float BOUNDARY_MARGIN = 1e-3f;
+
+FrustumPlanesSoA makePlanes() {
+	VkEngineCamera camera{};
+	camera.setViewTarget({-3.f, -2.f, -6.f}, {1.f, 0.f, 4.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), 16.f / 9.f, 0.1f, 40.f);
+	return toPlanesSoA(camera.extractFrustumPlanes());
+}
+
+float planeDistance(const FrustumPlanesSoA& planes, const u32 p, const glm::vec3& center) {
+	return planes.nx[p] * center.x + planes.ny[p] * center.y + planes.nz[p] * center.z + planes.d[p];
+}
+
+// Spheres around the frustum, about half of them visible
+BoundingSpheresSoA makeSpheres(const FrustumPlanesSoA& planes, const u32 count, const u32 seed) {
+	std::mt19937 random{seed};
+	std::uniform_real_distribution position{-30.f, 30.f};
+	std::uniform_real_distribution radius{0.f, 3.f};
+
+	BoundingSpheresSoA spheres{};
+	spheres.resize(count);
+	for (u32 i = 0; i < count; ++i) {
+		glm::vec3 center{};
+		float r = 0.f;
+		bool nearBoundary = true;
+		while (nearBoundary) {
+			center = {position(random), position(random), position(random)};
+			r = radius(random);
+			nearBoundary = false;
+			for (u32 p = 0; p < 6; ++p) {
+				nearBoundary |= std::abs(planeDistance(planes, p, center) + r) < BOUNDARY_MARGIN;
+			}
+		}
+		spheres.centerX[i] = center.x;
+		spheres.centerY[i] = center.y;
+		spheres.centerZ[i] = center.z;
+		spheres.radius[i] = r;
+	}
+	return spheres;
+}
+
+std::vector<u32> cullReference(const FrustumPlanesSoA& planes, const BoundingSpheresSoA& spheres, const u32 begin,
+                               const u32 end) {
+	std::vector<u32> visible;
+	for (u32 i = begin; i < end; ++i) {
+		const glm::vec3 center{spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]};
+		bool inside = true;
+		for (u32 p = 0; p < 6; ++p) {
+			inside = inside && planeDistance(planes, p, center) >= -spheres.radius[i];
+		}
+		if (inside) {
+			visible.push_back(i);
+		}
+	}
+	return visible;
+}
+
+std::vector<u32> cullWith(const CullingKernel kernel, const FrustumPlanesSoA& planes,
+                          const BoundingSpheresSoA& spheres, const u32 begin, const u32 end) {
+	std::vector<u32> visible(end - begin);
+	visible.resize(cullSpheres(kernel, planes, spheres, begin, end, visible.data()));
+	return visible;
+}
+}  // namespace
+
+TEST(FrustumCulling, DefaultKernelIsSupported) {
+	EXPECT_TRUE(isCullingKernelSupported(CullingKernel::Scalar));
+	EXPECT_TRUE(isCullingKernelSupported(getCullingKernel()));
+}
+
+TEST(FrustumCulling, KernelsMatchScalarReference) {
+	const FrustumPlanesSoA planes = makePlanes();
+	// Counts around the 8 wide iterations, ranges starting off a multiple of 8 leave a tail on both sides
+	for (const u32 count : {0u, 1u, 7u, 8u, 9u, 15u, 16u, 17u, 63u, 100u, 1000u, 4097u}) {
+		const BoundingSpheresSoA spheres = makeSpheres(planes, count + 3, count);
+		for (const u32 begin : {0u, 3u}) {
+			const std::vector<u32> expected = cullReference(planes, spheres, begin, begin + count);
+			for (const CullingKernel kernel : KERNELS) {
+				if (!isCullingKernelSupported(kernel)) {
+					continue;
+				}
+				EXPECT_EQ(cullWith(kernel, planes, spheres, begin, begin + count), expected)
+				    << "kernel " << static_cast<int>(kernel) << ", " << count << " spheres from " << begin;
+			}
+		}
+	}
+}
+
+TEST(FrustumCulling, TouchingSpheresAreVisibleInEveryLane) {
+	// Only the plane x >= 0 culls, a sphere whose surface touches it is kept
+	FrustumPlanesSoA planes{};
+	planes.nx[0] = 1.f;
+	for (u32 p = 1; p < 6; ++p) {
+		planes.d[p] = 1.f;
+	}
+
+	for (u32 lane = 0; lane < 11; ++lane) {
+		BoundingSpheresSoA spheres{};
+		spheres.resize(11);
+		for (u32 i = 0; i < 11; ++i) {
+			spheres.centerX[i] = -2.f;
+			spheres.radius[i] = 1.f;
+		}
+		spheres.centerX[lane] = -1.f;
+
+		for (const CullingKernel kernel : KERNELS) {
+			if (isCullingKernelSupported(kernel)) {
+				EXPECT_EQ(cullWith(kernel, planes, spheres, 0, 11), std::vector<u32>{lane});
+			}
+		}
+	}
+}
+
+TEST(FrustumCulling, CullerKeepsIndicesSortedAcrossChunks) {
+	const FrustumPlanesSoA planes = makePlanes();
+	const u32 count = 3 * VkEngineFrustumCuller::CHUNK_SIZE + 5;
+	const BoundingSpheresSoA spheres = makeSpheres(planes, count, 42);
+
+	ThreadPool threadPool(3);
+	VkEngineFrustumCuller culler(threadPool);
+	std::vector<u32> visible;
+	culler.cull(planes, spheres, visible);
+
+	const std::vector<u32> expected = cullReference(planes, spheres, 0, count);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_LT(expected.size(), count);
+	EXPECT_EQ(visible, expected);
+}
+
+}  // namespace vke
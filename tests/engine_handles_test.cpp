@@ -0,0 +1,132 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "core/engine_handles.hpp"
+
+namespace vke {
+namespace {
+// Counts its destructions so that the tests see when the pool really lets go of a resource
+struct TrackedResource {
+	explicit TrackedResource(u32* destroyed, const u32 id = 0) : pDestroyed(destroyed), mId(id) {}
+	~TrackedResource() { ++*pDestroyed; }
+
+	u32* pDestroyed;
+	u32 mId;
+};
+
+using TrackedPool = ResourcePool<TrackedResource>;
+using TrackedHandle = ResourceHandle<TrackedResource>;
+}  // namespace
+
+TEST(ResourceHandle, PacksIndexAndGeneration) {
+	const TrackedHandle handle = TrackedHandle::make(12345, 67);
+	EXPECT_EQ(handle.getIndex(), 12345u);
+	EXPECT_EQ(handle.getGeneration(), 67u);
+	EXPECT_TRUE(handle.isValid());
+	EXPECT_FALSE(TrackedHandle{}.isValid());
+}
+
+TEST(ResourcePool, GetResolvesLiveHandles) {
+	u32 destroyed = 0;
+	TrackedPool pool;
+	const TrackedHandle first = pool.add(std::make_unique<TrackedResource>(&destroyed, 1));
+	const TrackedHandle second = pool.add(std::make_unique<TrackedResource>(&destroyed, 2));
+
+	ASSERT_NE(pool.get(first), nullptr);
+	ASSERT_NE(pool.get(second), nullptr);
+	EXPECT_EQ(pool.get(first)->mId, 1u);
+	EXPECT_EQ(pool.get(second)->mId, 2u);
+	EXPECT_EQ(pool.getCount(), 2u);
+	EXPECT_EQ(pool.getCapacity(), 2u);
+
+	EXPECT_EQ(pool.get(TrackedHandle{}), nullptr);
+	EXPECT_EQ(pool.get(TrackedHandle::make(7, 0)), nullptr);
+}
+
+TEST(ResourcePool, ReleaseInvalidatesNowAndDestroysAtItsFrame) {
+	u32 destroyed = 0;
+	TrackedPool pool;
+	const TrackedHandle handle = pool.add(std::make_unique<TrackedResource>(&destroyed));
+
+	pool.release(handle, 3);
+	EXPECT_EQ(pool.get(handle), nullptr);
+	EXPECT_EQ(pool.getCount(), 0u);
+	EXPECT_EQ(pool.getReleasedCount(), 1u);
+
+	// Frames still in flight may use it
+	pool.collect(2);
+	EXPECT_EQ(destroyed, 0u);
+
+	pool.collect(3);
+	EXPECT_EQ(destroyed, 1u);
+	EXPECT_EQ(pool.getReleasedCount(), 0u);
+}
+
+TEST(ResourcePool, CollectOnlyDestroysTheReadyReleases) {
+	u32 destroyed = 0;
+	TrackedPool pool;
+	const TrackedHandle early = pool.add(std::make_unique<TrackedResource>(&destroyed));
+	const TrackedHandle late = pool.add(std::make_unique<TrackedResource>(&destroyed));
+	pool.release(early, 1);
+	pool.release(late, 4);
+
+	pool.collect(2);
+	EXPECT_EQ(destroyed, 1u);
+	EXPECT_EQ(pool.getReleasedCount(), 1u);
+
+	pool.collect(4);
+	EXPECT_EQ(destroyed, 2u);
+}
+
+TEST(ResourcePool, RecycledSlotLeavesOldHandlesStale) {
+	u32 destroyed = 0;
+	TrackedPool pool;
+	const TrackedHandle old = pool.add(std::make_unique<TrackedResource>(&destroyed, 1));
+	pool.release(old, 0);
+	pool.collect(0);
+
+	const TrackedHandle reused = pool.add(std::make_unique<TrackedResource>(&destroyed, 2));
+	EXPECT_EQ(reused.getIndex(), old.getIndex());
+	EXPECT_NE(reused.getGeneration(), old.getGeneration());
+	EXPECT_NE(reused, old);
+	EXPECT_EQ(pool.get(old), nullptr);
+	ASSERT_NE(pool.get(reused), nullptr);
+	EXPECT_EQ(pool.get(reused)->mId, 2u);
+	EXPECT_EQ(pool.getCapacity(), 1u);
+}
+
+TEST(ResourcePool, GenerationWrapsAroundItsMask) {
+	u32 destroyed = 0;
+	TrackedPool pool;
+	TrackedHandle handle{};
+	for (u32 i = 0; i <= TrackedHandle::GENERATION_MASK; ++i) {
+		handle = pool.add(std::make_unique<TrackedResource>(&destroyed));
+		EXPECT_EQ(handle.getGeneration(), i);
+		pool.release(handle, i);
+		pool.collect(i);
+	}
+
+	handle = pool.add(std::make_unique<TrackedResource>(&destroyed));
+	EXPECT_EQ(handle.getGeneration(), 0u);
+	EXPECT_TRUE(handle.isValid());
+	EXPECT_NE(pool.get(handle), nullptr);
+	EXPECT_EQ(destroyed, TrackedHandle::GENERATION_MASK + 1);
+}
+
+TEST(ResourcePool, DestroysLiveResourcesWithThePool) {
+	u32 destroyed = 0;
+	{
+		TrackedPool pool;
+		pool.add(std::make_unique<TrackedResource>(&destroyed));
+		const TrackedHandle released = pool.add(std::make_unique<TrackedResource>(&destroyed));
+		pool.release(released, 10);
+	}
+	EXPECT_EQ(destroyed, 2u);
+}
+
+}  // namespace vke
@@ -0,0 +1,129 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_occlusion_culling.hpp"
+
+namespace vke {
+namespace {
+// 4 x 4 wall at z = 5 in front of a camera at the origin looking down +z
+constexpr std::array<glm::vec3, 4> WALL_POSITIONS{
+    {{-2.f, -2.f, 0.f}, {2.f, -2.f, 0.f}, {2.f, 2.f, 0.f}, {-2.f, 2.f, 0.f}}};
+constexpr std::array<u32, 6> WALL_INDICES{0, 1, 2, 2, 3, 0};
+
+glm::mat4 makeViewProjection() {
+	VkEngineCamera camera{};
+	camera.setViewDirection({0.f, 0.f, 0.f}, {0.f, 0.f, 1.f});
+	camera.setPerspectiveProjection(glm::radians(60.f), static_cast<float>(VkEngineOcclusionCuller::WIDTH) /
+	                                                        static_cast<float>(VkEngineOcclusionCuller::HEIGHT),
+	                                0.1f, 100.f);
+	return camera.getProjectionMatrix() * camera.getViewMatrix();
+}
+
+BoundingSpheresSoA makeSpheres(const std::vector<glm::vec4>& centerRadius) {
+	BoundingSpheresSoA spheres{};
+	spheres.resize(static_cast<u32>(centerRadius.size()));
+	for (u32 i = 0; i < centerRadius.size(); ++i) {
+		spheres.centerX[i] = centerRadius[i].x;
+		spheres.centerY[i] = centerRadius[i].y;
+		spheres.centerZ[i] = centerRadius[i].z;
+		spheres.radius[i] = centerRadius[i].w;
+	}
+	return spheres;
+}
+
+std::vector<u32> allIndices(const u32 count) {
+	std::vector<u32> indices(count);
+	for (u32 i = 0; i < count; ++i) {
+		indices[i] = i;
+	}
+	return indices;
+}
+
+class OcclusionCullingTest : public ::testing::Test {
+   protected:
+	void rasterizeWall(const glm::mat4& world) {
+		mCuller.beginFrame(makeViewProjection());
+		mCuller.addOccluder(WALL_POSITIONS, WALL_INDICES, world);
+		mCuller.rasterize();
+	}
+
+	ThreadPool mThreadPool{2};
+	VkEngineOcclusionCuller mCuller{mThreadPool};
+};
+}  // namespace
+
+TEST_F(OcclusionCullingTest, WallHidesOnlyWhatIsFullyBehindIt) {
+	rasterizeWall(glm::translate(glm::mat4{1.f}, {0.f, 0.f, 5.f}));
+	EXPECT_EQ(mCuller.getStats().occluderTriangles, 2u);
+
+	const BoundingSpheresSoA spheres = makeSpheres({
+	    {0.f, 0.f, 20.f, 1.f},   // 0: behind the middle of the wall
+	    {5.f, 5.f, 20.f, 1.f},   // 1: behind a corner of the wall
+	    {0.f, 0.f, 3.f, .5f},    // 2: between the camera and the wall
+	    {12.f, 0.f, 20.f, 1.f},  // 3: behind, past the side of the wall
+	    {8.f, 0.f, 20.f, 1.f},   // 4: behind, straddling the side of the wall
+	    {0.f, 0.f, 4.5f, 1.f},   // 5: crossing the wall
+	    {0.f, 0.f, -10.f, 1.f},  // 6: behind the camera
+	});
+	std::vector<u32> visible = allIndices(spheres.size());
+	mCuller.cull(spheres, visible);
+
+	EXPECT_EQ(visible, (std::vector<u32>{2, 3, 4, 5, 6}));
+	EXPECT_EQ(mCuller.getStats().testedObjects, 7u);
+	EXPECT_EQ(mCuller.getStats().occludedObjects, 2u);
+}
+
+TEST_F(OcclusionCullingTest, OccluderCrossingTheNearPlaneIsDropped) {
+	// Rotated to lie along the view direction, half of the wall is behind the camera
+	rasterizeWall(glm::rotate(glm::mat4{1.f}, glm::radians(90.f), {1.f, 0.f, 0.f}));
+	EXPECT_EQ(mCuller.getStats().occluderTriangles, 0u);
+
+	const BoundingSpheresSoA spheres = makeSpheres({{0.f, 0.f, 20.f, 1.f}});
+	std::vector<u32> visible = allIndices(1);
+	mCuller.cull(spheres, visible);
+	EXPECT_EQ(visible, std::vector<u32>{0});
+}
+
+TEST_F(OcclusionCullingTest, CullKeepsOrderAcrossChunks) {
+	rasterizeWall(glm::translate(glm::mat4{1.f}, {0.f, 0.f, 5.f}));
+
+	// Every third object is out in the open, the others are behind the wall
+	const u32 count = 3 * VkEngineOcclusionCuller::CHUNK_SIZE + 17;
+	std::vector<glm::vec4> centerRadius(count);
+	for (u32 i = 0; i < count; ++i) {
+		centerRadius[i] = {i % 3 == 0 ? 15.f : 0.f, 0.f, 20.f + static_cast<float>(i % 7), .5f};
+	}
+	const BoundingSpheresSoA spheres = makeSpheres(centerRadius);
+
+	// Tested in descending order so that the kept indices are not simply ascending
+	std::vector<u32> visible(count);
+	std::vector<u32> expected;
+	for (u32 i = 0; i < count; ++i) {
+		visible[i] = count - 1 - i;
+		if (visible[i] % 3 == 0) {
+			expected.push_back(visible[i]);
+		}
+	}
+	mCuller.cull(spheres, visible);
+	EXPECT_EQ(visible, expected);
+}
+
+TEST_F(OcclusionCullingTest, NothingIsCulledWithoutOccluders) {
+	mCuller.beginFrame(makeViewProjection());
+	mCuller.rasterize();
+
+	const BoundingSpheresSoA spheres = makeSpheres({{0.f, 0.f, 20.f, 1.f}, {0.f, 0.f, 50.f, 1.f}});
+	std::vector<u32> visible = allIndices(2);
+	mCuller.cull(spheres, visible);
+	EXPECT_EQ(visible, (std::vector<u32>{0, 1}));
+}
+
+}  // namespace vke
@@ -0,0 +1,156 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "core/engine_transform_system.hpp"
+
+namespace vke {
+namespace {
+constexpr float TOLERANCE = 1e-4f;
+
+TransformComponent makeTransform(std::mt19937& random) {
+	std::uniform_real_distribution position{-2.f, 2.f};
+	std::uniform_real_distribution angle{-1.f, 1.f};
+	std::uniform_real_distribution scale{.8f, 1.2f};
+	TransformComponent transform{};
+	transform.setTranslation({position(random), position(random), position(random)});
+	transform.setRotation(eulerToQuat({angle(random), angle(random), angle(random)}));
+	transform.setScale({scale(random), scale(random), scale(random)});
+	return transform;
+}
+
+// World matrix of the entity by walking up to its root, the way the scene graph must compose them
+glm::mat4 referenceWorldMatrix(const VkEngineWorld& world, const Entity entity) {
+	glm::mat4 matrix = world.getComponent<TransformComponent>(entity)->mat4();
+	const auto* hierarchy = world.getComponent<HierarchyComponent>(entity);
+	for (Entity parent = hierarchy != nullptr ? hierarchy->parent : Entity{}; world.isAlive(parent);) {
+		matrix = world.getComponent<TransformComponent>(parent)->mat4() * matrix;
+		hierarchy = world.getComponent<HierarchyComponent>(parent);
+		parent = hierarchy != nullptr ? hierarchy->parent : Entity{};
+	}
+	return matrix;
+}
+
+class SceneGraphTest : public ::testing::Test {
+   protected:
+	Entity addNode() { return mWorld.createEntity(makeTransform(mRandom), WorldMatrixComponent{}); }
+
+	// A random forest: each node picks an earlier one as parent, or none
+	void buildForest(const u32 count) {
+		for (u32 i = 0; i < count; ++i) {
+			mNodes.push_back(addNode());
+			if (i > 0 && mRandom() % 8 != 0) {
+				ASSERT_TRUE(getSceneGraph().setParent(mWorld, mNodes.back(), mNodes[mRandom() % i]));
+			}
+		}
+	}
+
+	void expectMatricesCurrent() {
+		for (const Entity node : mNodes) {
+			const glm::mat4& actual = mWorld.getComponent<WorldMatrixComponent>(node)->matrix;
+			const glm::mat4 expected = referenceWorldMatrix(mWorld, node);
+			for (int column = 0; column < 4; ++column) {
+				for (int row = 0; row < 4; ++row) {
+					ASSERT_NEAR(actual[column][row], expected[column][row], TOLERANCE)
+					    << "node " << node.index << ", column " << column << ", row " << row;
+				}
+			}
+		}
+	}
+
+	VkEngineSceneGraph& getSceneGraph() { return mTransformSystem.getSceneGraph(); }
+
+	std::mt19937 mRandom{7};
+	ThreadPool mThreadPool{2};
+	VkEngineWorld mWorld{};
+	std::vector<Entity> mNodes{};
+	VkEngineTransformSystem mTransformSystem{mThreadPool};
+};
+}  // namespace
+
+TEST_F(SceneGraphTest, ChildrenComposeWithTheirAncestors) {
+	buildForest(5000);
+	mTransformSystem.update(mWorld);
+	expectMatricesCurrent();
+}
+
+TEST_F(SceneGraphTest, MovingANodeRebuildsItsSubtreeOnly) {
+	// root -> a -> b -> c, and a second root with one child
+	for (u32 i = 0; i < 6; ++i) {
+		mNodes.push_back(addNode());
+	}
+	VkEngineSceneGraph& sceneGraph = getSceneGraph();
+	sceneGraph.setParent(mWorld, mNodes[1], mNodes[0]);
+	sceneGraph.setParent(mWorld, mNodes[2], mNodes[1]);
+	sceneGraph.setParent(mWorld, mNodes[3], mNodes[2]);
+	sceneGraph.setParent(mWorld, mNodes[5], mNodes[4]);
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(sceneGraph.getStats().nodes, 6u);
+	EXPECT_EQ(sceneGraph.getStats().levels, 4u);
+
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(sceneGraph.getStats().updatedNodes, 0u);
+
+	mWorld.getComponent<TransformComponent>(mNodes[1])->setTranslation({5.f, 0.f, 0.f});
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(sceneGraph.getStats().updatedNodes, 3u);
+	expectMatricesCurrent();
+
+	mWorld.getComponent<TransformComponent>(mNodes[0])->setScale({2.f, 2.f, 2.f});
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(sceneGraph.getStats().updatedNodes, 4u);
+	expectMatricesCurrent();
+}
+
+TEST_F(SceneGraphTest, WideLevelsAreSplitOverThePool) {
+	// Far more siblings than a single task takes
+	mNodes.push_back(addNode());
+	for (u32 i = 0; i < 5 * VkEngineSceneGraph::NODES_PER_TASK + 3; ++i) {
+		mNodes.push_back(addNode());
+		getSceneGraph().setParent(mWorld, mNodes.back(), mNodes.front());
+	}
+	mTransformSystem.update(mWorld);
+	expectMatricesCurrent();
+
+	mWorld.getComponent<TransformComponent>(mNodes.front())->setTranslation({0.f, 3.f, 0.f});
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(getSceneGraph().getStats().updatedNodes, static_cast<u32>(mNodes.size()));
+	expectMatricesCurrent();
+}
+
+TEST_F(SceneGraphTest, CyclesAreRefused) {
+	for (u32 i = 0; i < 3; ++i) {
+		mNodes.push_back(addNode());
+	}
+	VkEngineSceneGraph& sceneGraph = getSceneGraph();
+	EXPECT_TRUE(sceneGraph.setParent(mWorld, mNodes[1], mNodes[0]));
+	EXPECT_TRUE(sceneGraph.setParent(mWorld, mNodes[2], mNodes[1]));
+	EXPECT_FALSE(sceneGraph.setParent(mWorld, mNodes[0], mNodes[2]));
+	EXPECT_FALSE(sceneGraph.setParent(mWorld, mNodes[0], mNodes[0]));
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(sceneGraph.getStats().nodes, 3u);
+	expectMatricesCurrent();
+}
+
+TEST_F(SceneGraphTest, ReparentingAndDestroyingRelayOut) {
+	buildForest(500);
+	mTransformSystem.update(mWorld);
+
+	getSceneGraph().clearParent(mWorld, mNodes[100]);
+	ASSERT_TRUE(getSceneGraph().setParent(mWorld, mNodes[200], mNodes[10]));
+	mTransformSystem.update(mWorld);
+	expectMatricesCurrent();
+
+	// The children of a destroyed node become roots
+	mWorld.destroyEntity(mNodes[0]);
+	mNodes.erase(mNodes.begin());
+	mTransformSystem.update(mWorld);
+	expectMatricesCurrent();
+}
+
+}  // namespace vke
@@ -0,0 +1,201 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "renderer/engine_camera.hpp"
+#include "renderer/engine_spatial_grid.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace vke {
+namespace {
+constexpr float TOLERANCE = 1e-4f;
+constexpr u32 QUERY_COUNT = 200;
+
+// Mostly boxes smaller than a cell, one in twenty larger than one to land in the oversized list
+Aabb randomBox(std::mt19937& random) {
+	std::uniform_real_distribution position{-50.f, 50.f};
+	std::uniform_real_distribution size{.1f, 3.f};
+	std::uniform_real_distribution largeSize{5.f, 20.f};
+	const bool large = random() % 20 == 0;
+	Aabb box{};
+	box.min = {position(random), position(random), position(random)};
+	box.max = box.min + (large ? glm::vec3{largeSize(random), size(random), largeSize(random)}
+	                           : glm::vec3{size(random), size(random), size(random)});
+	return box;
+}
+
+glm::vec3 randomPoint(std::mt19937& random) {
+	std::uniform_real_distribution position{-60.f, 60.f};
+	return {position(random), position(random), position(random)};
+}
+
+std::vector<u32> sorted(std::vector<u32> objects) {
+	std::ranges::sort(objects);
+	return objects;
+}
+
+// Brute force answers over every box, what the grid must agree with
+void expectMatchesBruteForce(const VkEngineSpatialGrid& grid, const std::vector<Aabb>& boxes, const u32 seed) {
+	std::mt19937 random{seed};
+	std::vector<u32> objects;
+	for (u32 q = 0; q < QUERY_COUNT; ++q) {
+		VkEngineCamera camera{};
+		camera.setViewTarget(randomPoint(random), randomPoint(random));
+		camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, 0.1f, 60.f);
+		const FrustumPlanesSoA planes = toPlanesSoA(camera.extractFrustumPlanes());
+		std::vector<u32> expected;
+		for (u32 i = 0; i < boxes.size(); ++i) {
+			if (testFrustum(planes, boxes[i]) != FrustumTest::Outside) {
+				expected.push_back(i);
+			}
+		}
+		objects.clear();
+		grid.queryFrustum(planes, objects);
+		ASSERT_EQ(sorted(objects), expected) << "frustum " << q;
+
+		const glm::vec3 center = randomPoint(random);
+		const float radius = std::uniform_real_distribution{0.f, 15.f}(random);
+		expected.clear();
+		for (u32 i = 0; i < boxes.size(); ++i) {
+			if (distanceSquared(boxes[i], center) <= radius * radius) {
+				expected.push_back(i);
+			}
+		}
+		objects.clear();
+		grid.queryRadius(center, radius, objects);
+		ASSERT_EQ(sorted(objects), expected) << "radius " << q;
+
+		// The object hit may be any of those entered at the same distance, the distance is what must match
+		const Ray ray{.origin = randomPoint(random),
+		              .direction = glm::normalize(randomPoint(random) - center + glm::vec3{0.f, 0.f, 1e-3f}),
+		              .maxDistance = 200.f};
+		float expectedDistance = ray.maxDistance;
+		for (const Aabb& box : boxes) {
+			float distance = 0.f;
+			if (intersectRay(box, ray.origin, 1.f / ray.direction, ray.maxDistance, distance)) {
+				expectedDistance = std::min(expectedDistance, distance);
+			}
+		}
+		float distance = 0.f;
+		const u32 hit = grid.raycast(ray, distance);
+		if (expectedDistance == ray.maxDistance) {
+			EXPECT_EQ(hit, VkEngineSpatialGrid::NO_OBJECT) << "ray " << q;
+		} else {
+			ASSERT_NE(hit, VkEngineSpatialGrid::NO_OBJECT) << "ray " << q;
+			EXPECT_NEAR(distance, expectedDistance, TOLERANCE) << "ray " << q;
+		}
+
+		const glm::vec3 point = randomPoint(random);
+		float expectedSquared = std::numeric_limits<float>::max();
+		for (const Aabb& box : boxes) {
+			expectedSquared = std::min(expectedSquared, distanceSquared(box, point));
+		}
+		const u32 nearest = grid.queryNearest(point, distance);
+		ASSERT_NE(nearest, VkEngineSpatialGrid::NO_OBJECT) << "nearest " << q;
+		EXPECT_NEAR(distance, std::sqrt(expectedSquared), TOLERANCE) << "nearest " << q;
+		EXPECT_NEAR(std::sqrt(distanceSquared(boxes[nearest], point)), distance, TOLERANCE) << "nearest " << q;
+	}
+}
+
+class SpatialGridTest : public ::testing::Test {
+   protected:
+	void place(const u32 count) {
+		mBoxes.resize(count);
+		mGrid.reset(count);
+		mGrid.beginUpdate();
+		for (u32 i = 0; i < count; ++i) {
+			mBoxes[i] = randomBox(mRandom);
+			mGrid.update(i, mBoxes[i]);
+		}
+	}
+
+	// Moves `count` distinct objects, from the workers of the pool like the spatial system does
+	void move(const u32 count, const float distance) {
+		std::vector<u32> moved(mBoxes.size());
+		std::iota(moved.begin(), moved.end(), 0u);
+		std::ranges::shuffle(moved, mRandom);
+		moved.resize(count);
+		std::uniform_real_distribution offset{-distance, distance};
+		for (const u32 object : moved) {
+			const glm::vec3 delta{offset(mRandom), offset(mRandom), offset(mRandom)};
+			mBoxes[object] = {.min = mBoxes[object].min + delta, .max = mBoxes[object].max + delta};
+		}
+
+		mGrid.beginUpdate();
+		mThreadPool.parallelFor(count, 64, [&](const u32 begin, const u32 end, u32 /*workerIndex*/) {
+			for (u32 i = begin; i < end; ++i) {
+				mGrid.update(moved[i], mBoxes[moved[i]]);
+			}
+		});
+	}
+
+	std::mt19937 mRandom{21};
+	ThreadPool mThreadPool{3};
+	VkEngineSpatialGrid mGrid{};
+	std::vector<Aabb> mBoxes{};
+};
+}  // namespace
+
+TEST_F(SpatialGridTest, EmptyGridFindsNothing) {
+	mGrid.reset(0);
+	std::vector<u32> objects;
+	mGrid.queryRadius(glm::vec3{0.f}, 100.f, objects);
+	EXPECT_TRUE(objects.empty());
+	float distance = 0.f;
+	EXPECT_EQ(mGrid.raycast(Ray{.maxDistance = 100.f}, distance), VkEngineSpatialGrid::NO_OBJECT);
+	EXPECT_EQ(mGrid.queryNearest(glm::vec3{0.f}, distance), VkEngineSpatialGrid::NO_OBJECT);
+}
+
+TEST_F(SpatialGridTest, QueriesMatchBruteForce) {
+	for (const u32 count : {1u, 37u, 5000u}) {
+		place(count);
+		EXPECT_EQ(mGrid.getObjectCount(), count);
+		expectMatchesBruteForce(mGrid, mBoxes, count);
+	}
+}
+
+TEST_F(SpatialGridTest, ConcurrentMovesKeepQueriesExact) {
+	place(5000);
+	// Within their cell, then across cells
+	move(2000, 0.1f);
+	expectMatchesBruteForce(mGrid, mBoxes, 1);
+	move(5000, 10.f);
+	expectMatchesBruteForce(mGrid, mBoxes, 2);
+	EXPECT_GT(mGrid.getStaleEntryCount(), 0u);
+}
+
+TEST_F(SpatialGridTest, CompactionDropsStaleEntries) {
+	place(2000);
+	for (u32 frame = 0; frame < 20; ++frame) {
+		move(2000, 10.f);
+	}
+	// Every object moved across cells each frame, the entries only stay bounded if compaction reclaimed them
+	EXPECT_LE(mGrid.getEntryCount(), 4u * 2000u);
+	EXPECT_LE(mGrid.getStaleEntryCount(), mGrid.getEntryCount());
+	expectMatchesBruteForce(mGrid, mBoxes, 3);
+}
+
+TEST_F(SpatialGridTest, FarOutlierKeepsQueriesExact) {
+	place(5000);
+	// The occupied cells now span billions of mostly empty blocks, the frustum query must not walk them
+	mBoxes[0] = {.min = glm::vec3{1e5f}, .max = glm::vec3{1e5f + 1.f}};
+	mGrid.beginUpdate();
+	mGrid.update(0, mBoxes[0]);
+	expectMatchesBruteForce(mGrid, mBoxes, 4);
+
+	VkEngineCamera camera{};
+	camera.setViewTarget(glm::vec3{1e5f - 20.f}, glm::vec3{1e5f});
+	camera.setPerspectiveProjection(glm::radians(50.f), 1.f, 0.1f, 60.f);
+	std::vector<u32> objects;
+	mGrid.queryFrustum(toPlanesSoA(camera.extractFrustumPlanes()), objects);
+	EXPECT_EQ(objects, std::vector<u32>{0});
+}
+
+}  // namespace vke
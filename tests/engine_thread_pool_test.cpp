@@ -0,0 +1,188 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+namespace {
+// Enough for the thieves and the owner to meet on the last jobs of the deque many times over
+constexpr u32 RACE_JOBS = 200'000;
+
+TEST(JobDeque, OwnerPopsNewestThievesStealOldest) {
+	JobDeque deque;
+	std::array<Job, 3> jobs{};
+	EXPECT_TRUE(deque.isEmpty());
+	EXPECT_EQ(deque.pop(), nullptr);
+	EXPECT_EQ(deque.steal(), nullptr);
+
+	for (Job& job : jobs) {
+		EXPECT_TRUE(deque.push(&job));
+	}
+	EXPECT_FALSE(deque.isEmpty());
+	EXPECT_EQ(deque.pop(), &jobs[2]);
+	EXPECT_EQ(deque.steal(), &jobs[0]);
+	EXPECT_EQ(deque.pop(), &jobs[1]);
+	EXPECT_TRUE(deque.isEmpty());
+	EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(JobDeque, PushFailsWhenFullAndWraps) {
+	JobDeque deque;
+	Job job{};
+	for (i64 i = 0; i < JobDeque::CAPACITY; ++i) {
+		ASSERT_TRUE(deque.push(&job));
+	}
+	EXPECT_FALSE(deque.push(&job));
+
+	// Stealing frees the slots at the top, the next pushes wrap around the ring
+	for (i64 i = 0; i < JobDeque::CAPACITY / 2; ++i) {
+		ASSERT_EQ(deque.steal(), &job);
+	}
+	for (i64 i = 0; i < JobDeque::CAPACITY / 2; ++i) {
+		ASSERT_TRUE(deque.push(&job));
+	}
+	EXPECT_FALSE(deque.push(&job));
+}
+
+TEST(JobDeque, EveryJobIsTakenOnceUnderConcurrentSteals) {
+	constexpr u32 THIEVES = 3;
+	std::vector<Job> jobs(RACE_JOBS);
+	std::vector<std::atomic<u32>> taken(RACE_JOBS);
+	const auto take = [&](const Job* job) { taken[job - jobs.data()].fetch_add(1, std::memory_order::relaxed); };
+
+	JobDeque deque;
+	std::atomic<bool> done{false};
+	std::vector<std::thread> thieves;
+	for (u32 t = 0; t < THIEVES; ++t) {
+		thieves.emplace_back([&]() {
+			while (!done.load(std::memory_order::acquire) || !deque.isEmpty()) {
+				if (const Job* job = deque.steal()) {
+					take(job);
+				}
+			}
+		});
+	}
+
+	// The owner drains the deque every few jobs so that its pops keep racing the thieves for the last one
+	bool pushed = true;
+	for (u32 i = 0; i < RACE_JOBS && pushed; ++i) {
+		pushed = deque.push(&jobs[i]);
+		if (i % 4 == 3) {
+			while (const Job* job = deque.pop()) {
+				take(job);
+			}
+		}
+	}
+	while (const Job* job = deque.pop()) {
+		take(job);
+	}
+	done.store(true, std::memory_order::release);
+	for (std::thread& thief : thieves) {
+		thief.join();
+	}
+
+	ASSERT_TRUE(pushed);
+	for (u32 i = 0; i < RACE_JOBS; ++i) {
+		ASSERT_EQ(taken[i].load(), 1u) << "job " << i;
+	}
+}
+
+TEST(ThreadPool, ParallelForCoversEveryIndexOnce) {
+	for (const u32 workers : {0u, 1u, 3u}) {
+		ThreadPool pool(workers);
+		for (const u32 count : {0u, 1u, 7u, 1000u, 100'003u}) {
+			for (const u32 grain : {0u, 1u, 3u, 64u, 200'000u}) {
+				std::vector<std::atomic<u32>> visits(count);
+				std::atomic<bool> badWorker{false};
+				std::atomic<bool> badChunk{false};
+				pool.parallelFor(count, grain, [&](const u32 begin, const u32 end, const u32 workerIndex) {
+					badWorker = badWorker || workerIndex >= pool.getThreadCount();
+					// A chunk is `grain` items, only the last one may be shorter
+					badChunk = badChunk || begin % std::max(grain, 1u) != 0 ||
+					           (end - begin != std::max(grain, 1u) && end != count);
+					for (u32 i = begin; i < end; ++i) {
+						visits[i].fetch_add(1, std::memory_order::relaxed);
+					}
+				});
+
+				EXPECT_FALSE(badWorker);
+				EXPECT_FALSE(badChunk) << count << " items by " << grain;
+				for (u32 i = 0; i < count; ++i) {
+					ASSERT_EQ(visits[i].load(), 1u)
+					    << "index " << i << " of " << count << " by " << grain << " on " << workers + 1 << " threads";
+				}
+			}
+		}
+	}
+}
+
+TEST(ThreadPool, NestedParallelForCompletes) {
+	ThreadPool pool(3);
+	std::vector<std::atomic<u32>> visits(64 * 100);
+	pool.parallelFor(64, 1, [&](const u32 outerBegin, u32, u32) {
+		pool.parallelFor(100, 7, [&](const u32 begin, const u32 end, u32) {
+			for (u32 i = begin; i < end; ++i) {
+				visits[outerBegin * 100 + i].fetch_add(1, std::memory_order::relaxed);
+			}
+		});
+	});
+	for (const auto& visit : visits) {
+		ASSERT_EQ(visit.load(), 1u);
+	}
+}
+
+TEST(ThreadPool, RunWaitsForTheJobsAndTheirDependencies) {
+	ThreadPool pool(3);
+	std::atomic<u32> first{0};
+	std::atomic<u32> secondSawFirst{0};
+	JobCounter firstCounter;
+	JobCounter secondCounter;
+	for (u32 i = 0; i < 100; ++i) {
+		pool.run([&]() { first.fetch_add(1); }, firstCounter);
+	}
+	for (u32 i = 0; i < 100; ++i) {
+		pool.run([&]() { secondSawFirst.fetch_add(first.load() == 100 ? 1 : 0); }, secondCounter, &firstCounter);
+	}
+	pool.wait(secondCounter);
+	EXPECT_TRUE(firstCounter.isDone());
+	EXPECT_EQ(first.load(), 100u);
+	EXPECT_EQ(secondSawFirst.load(), 100u);
+}
+
+TEST(ThreadPool, JobsPastTheRingRunOnceBesideParkedContinuations) {
+	constexpr u32 JOBS = 3 * ThreadPool::JOB_RING_SIZE;
+	ThreadPool pool(3);
+	std::vector<std::atomic<u32>> runs(2 * JOBS);
+	std::atomic<bool> open{false};
+	JobCounter firstCounter;
+	JobCounter secondCounter;
+
+	// Holds the first group open so that every continuation stays parked, and its ring slot live, while the ring wraps
+	const auto gate = [&open]() {
+		while (!open.load()) {
+			std::this_thread::yield();
+		}
+	};
+	pool.run(gate, firstCounter);
+	for (u32 i = 0; i < JOBS; ++i) {
+		pool.run([&runs, i]() { runs[JOBS + i].fetch_add(1, std::memory_order::relaxed); }, secondCounter,
+		         &firstCounter);
+	}
+	for (u32 i = 0; i < JOBS; ++i) {
+		pool.run([&runs, i]() { runs[i].fetch_add(1, std::memory_order::relaxed); }, firstCounter);
+	}
+	open.store(true);
+	pool.wait(firstCounter);
+	pool.wait(secondCounter);
+
+	for (u32 i = 0; i < 2 * JOBS; ++i) {
+		ASSERT_EQ(runs[i].load(), 1u) << "job " << i;
+	}
+}
+}  // namespace
@@ -0,0 +1,163 @@
+//
+// Created by zphrfx on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+#include "core/engine_transform_system.hpp"
+
+namespace vke {
+namespace {
+constexpr float TOLERANCE = 1e-5f;
+
+glm::mat4 referenceWorldMatrix(const TransformComponent& transform) {
+	const glm::mat4 world =
+	    glm::translate(glm::mat4{1.f}, transform.getTranslation()) * glm::mat4_cast(transform.getRotation());
+	return glm::scale(world, transform.getScale());
+}
+
+TransformComponent randomTransform(std::mt19937& random) {
+	std::uniform_real_distribution position{-50.f, 50.f};
+	std::uniform_real_distribution angle{-3.f, 3.f};
+	std::uniform_real_distribution scale{.1f, 4.f};
+
+	TransformComponent transform{};
+	transform.setTranslation({position(random), position(random), position(random)});
+	transform.setRotation(eulerToQuat({angle(random), angle(random), angle(random)}));
+	transform.setScale({scale(random), scale(random), scale(random)});
+	return transform;
+}
+
+void expectNear(const glm::mat4& actual, const glm::mat4& expected) {
+	for (int column = 0; column < 4; ++column) {
+		for (int row = 0; row < 4; ++row) {
+			const float tolerance = TOLERANCE * std::max(1.f, std::abs(expected[column][row]));
+			EXPECT_NEAR(actual[column][row], expected[column][row], tolerance)
+			    << "column " << column << ", row " << row;
+		}
+	}
+}
+}  // namespace
+
+TEST(TransformComponent, MatrixMatchesTheGlmChain) {
+	std::mt19937 random{1};
+	for (u32 i = 0; i < 100; ++i) {
+		const TransformComponent transform = randomTransform(random);
+		expectNear(transform.mat4(), referenceWorldMatrix(transform));
+	}
+}
+
+TEST(TransformComponent, EulerRotationMatchesTheRotateChain) {
+	// The Y, X, Z chain of glm::rotate the Euler transforms were built with
+	std::mt19937 random{2};
+	std::uniform_real_distribution angle{-3.f, 3.f};
+	for (u32 i = 0; i < 100; ++i) {
+		const glm::vec3 angles{angle(random), angle(random), angle(random)};
+		glm::mat4 expected = glm::rotate(glm::mat4{1.f}, angles.y, {0.f, 1.f, 0.f});
+		expected = glm::rotate(expected, angles.x, {1.f, 0.f, 0.f});
+		expected = glm::rotate(expected, angles.z, {0.f, 0.f, 1.f});
+		expectNear(glm::mat4_cast(eulerToQuat(angles)), expected);
+	}
+}
+
+TEST(TransformComponent, PitchYawRoundTrips) {
+	const glm::vec2 pitchYaw = quatToPitchYaw(eulerToQuat({.4f, -1.2f, 0.f}));
+	EXPECT_NEAR(pitchYaw.x, .4f, TOLERANCE);
+	EXPECT_NEAR(pitchYaw.y, -1.2f, TOLERANCE);
+}
+
+TEST(TransformComponent, SettersMarkDirty) {
+	TransformComponent transform{};
+	EXPECT_TRUE(transform.isDirty());
+	transform.clearDirty();
+	transform.setScale(glm::vec3{2.f});
+	EXPECT_TRUE(transform.isDirty());
+}
+
+TEST(BuildWorldMatrices, MatchesTheGlmChainForEveryTail) {
+	std::mt19937 random{3};
+	// Counts around the 4 and 8 lane iterations
+	for (u32 count = 0; count <= 19; ++count) {
+		TransformBatchSoA batch{};
+		batch.resize(count);
+		std::vector<TransformComponent> transforms(count);
+		for (u32 lane = 0; lane < count; ++lane) {
+			transforms[lane] = randomTransform(random);
+			// Scattered, the batch writes through its indices
+			batch.set(lane, transforms[lane], count - 1 - lane);
+		}
+
+		std::vector<WorldMatrixComponent> matrices(count);
+		buildWorldMatrices(batch, count, matrices.data());
+		for (u32 lane = 0; lane < count; ++lane) {
+			expectNear(matrices[count - 1 - lane].matrix, referenceWorldMatrix(transforms[lane]));
+		}
+	}
+}
+
+class TransformSystemTest : public ::testing::Test {
+   protected:
+	void SetUp() override {
+		std::mt19937 random{4};
+		for (u32 i = 0; i < ENTITY_COUNT; ++i) {
+			mEntities.push_back(mWorld.createEntity(randomTransform(random), WorldMatrixComponent{}));
+		}
+	}
+
+	void expectMatricesCurrent() {
+		for (const Entity entity : mEntities) {
+			expectNear(mWorld.getComponent<WorldMatrixComponent>(entity)->matrix,
+			           referenceWorldMatrix(*mWorld.getComponent<TransformComponent>(entity)));
+		}
+	}
+
+	// Spans several chunks and leaves a partial one
+	static constexpr u32 ENTITY_COUNT = 2000;
+
+	ThreadPool mThreadPool{2};
+	VkEngineWorld mWorld{};
+	std::vector<Entity> mEntities{};
+	VkEngineTransformSystem mTransformSystem{mThreadPool};
+};
+
+TEST_F(TransformSystemTest, FirstUpdateBuildsEveryMatrix) {
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(mTransformSystem.getStats().updatedTransforms, ENTITY_COUNT);
+	expectMatricesCurrent();
+	for (const Entity entity : mEntities) {
+		EXPECT_FALSE(mWorld.getComponent<TransformComponent>(entity)->isDirty());
+	}
+}
+
+TEST_F(TransformSystemTest, OnlyDirtyTransformsAreRebuilt) {
+	mTransformSystem.update(mWorld);
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(mTransformSystem.getStats().updatedTransforms, 0u);
+
+	u32 moved = 0;
+	for (u32 i = 0; i < ENTITY_COUNT; i += 7) {
+		auto& transform = *mWorld.getComponent<TransformComponent>(mEntities[i]);
+		transform.setTranslation(transform.getTranslation() + glm::vec3{1.f, 2.f, 3.f});
+		++moved;
+	}
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(mTransformSystem.getStats().updatedTransforms, moved);
+	expectMatricesCurrent();
+}
+
+TEST_F(TransformSystemTest, InvalidateRebuildsEveryMatrix) {
+	mTransformSystem.update(mWorld);
+	// Overwritten behind the system's back, only a full rebuild restores it
+	mWorld.getComponent<WorldMatrixComponent>(mEntities[5])->matrix = glm::mat4{0.f};
+
+	mTransformSystem.invalidate();
+	mTransformSystem.update(mWorld);
+	EXPECT_EQ(mTransformSystem.getStats().updatedTransforms, ENTITY_COUNT);
+	expectMatricesCurrent();
+}
+
+}  // namespace vke